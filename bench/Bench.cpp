@@ -0,0 +1,475 @@
+/**
+ * @file  Bench.cpp
+ * @brief ベンチマークプログラム実装ファイル
+ *
+ * Corpusクラスで生成したCSVデータについて、Reader::read、Util::load、Writer::write、Util::saveの
+ * スループット(MB/s, records/s)、CSVレコードあたりのメモリ割り当て回数、最大常駐メモリを計測し、
+ * JSON形式またはCSV形式で標準出力に出力します。
+ * ハードウェアパフォーマンスカウンタが使える場合は、その値も入力バイトあたりとCSVレコードあたりで出力します。
+ */
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "csl/csv/Reader.hpp"
+#include "csl/csv/Util.hpp"
+#include "csl/csv/Writer.hpp"
+#include "Corpus.hpp"
+#include "Counters.hpp"
+
+namespace {
+
+/**
+ * @brief プログラム開始以降のメモリ割り当て回数です。
+ */
+std::atomic<unsigned long long> allocationCount(0);
+
+} // namespace
+
+void* operator new(std::size_t size)
+{
+  allocationCount.fetch_add(1, std::memory_order_relaxed);
+  void* p = std::malloc(size > 0 ? size : 1);
+  if (p == NULL) {
+    throw std::bad_alloc();
+  }
+  return p;
+}
+
+void* operator new[](std::size_t size)
+{
+  return operator new(size);
+}
+
+void operator delete(void* p) noexcept
+{
+  std::free(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+  std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+  std::free(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept
+{
+  std::free(p);
+}
+
+namespace {
+
+using csl::csv::Config;
+using csl::csv::Reader;
+using csl::csv::Util;
+using csl::csv::Writer;
+using csl::csv::bench::Corpus;
+using csl::csv::bench::Counters;
+
+typedef std::vector<std::vector<std::string> > Table;
+
+/**
+ * @brief 計測対象の操作の名前です。
+ */
+const char* const OPERATIONS[] = {
+  "Reader::read",
+  "Reader::read(LazyRecord)",
+  "Util::load",
+  "Util::load(EncodedTable)",
+  "Writer::write",
+  "Util::save",
+};
+
+/**
+ * @brief コマンドライン引数で指定する設定です。
+ */
+struct Options
+{
+  std::size_t size;               ///< 生成するCSVデータのバイト数
+  std::size_t repeat;             ///< 計測の繰り返し回数(最良値を採用)
+  std::string format;             ///< 出力形式(json, csv)
+  std::string directory;          ///< 一時ファイルを置くディレクトリ
+  std::vector<std::string> kinds; ///< 計測するCSVデータの種類(空の場合はすべて)
+};
+
+/**
+ * @brief 1つの計測結果です。
+ */
+struct Result
+{
+  std::string kind;
+  std::string operation;
+  std::size_t bytes;
+  std::size_t records;
+  double seconds;
+  unsigned long long allocations;
+  long peakRss;
+  bool available[Counters::COUNTER_SIZE];
+  unsigned long long counts[Counters::COUNTER_SIZE];
+};
+
+/**
+ * @brief 指定された操作を1回実行し、処理したCSVレコード数を返します。
+ */
+std::size_t run(const std::string& operation, const std::string& filepath,
+		const Config& config, const Table& table)
+{
+  if (operation == "Reader::read") {
+    std::ifstream stream(filepath.c_str(), std::ifstream::binary);
+    Reader reader(stream, config);
+    std::vector<std::string> record;
+    std::size_t records = 0;
+    while (reader.hasNext()) {
+      reader.read(record);
+      record.clear();
+      records++;
+    }
+    return records;
+  }
+  if (operation == "Reader::read(LazyRecord)") {
+    std::ifstream stream(filepath.c_str(), std::ifstream::binary);
+    Reader reader(stream, config);
+    csl::csv::LazyRecord record;
+    std::size_t records = 0;
+    while (reader.hasNext()) {
+      reader.read(record);
+      records++;
+    }
+    return records;
+  }
+  if (operation == "Util::load") {
+    Table csv;
+    Util::load(filepath, config, csv);
+    return csv.size();
+  }
+  if (operation == "Util::load(EncodedTable)") {
+    csl::csv::EncodedTable encoded;
+    Util::load(filepath, config, encoded);
+    return encoded.getRowCount();
+  }
+  if (operation == "Writer::write") {
+    std::ofstream stream((filepath + ".out").c_str(), std::ofstream::binary);
+    Writer writer(stream, config);
+    for (std::size_t i = 0; i < table.size(); i++) {
+      writer.write(table[i]);
+    }
+    return table.size();
+  }
+  if (operation == "Util::save") {
+    Util::save(filepath + ".out", config, table);
+    return table.size();
+  }
+  throw std::invalid_argument("Unknown operation: " + operation);
+}
+
+/**
+ * @brief 指定された操作を子プロセスで1回実行し、子プロセスの最大常駐メモリ(KiB)を返します。
+ *
+ * 子プロセスの最大常駐メモリは、fork時点の常駐メモリ(生成したCSVデータなど)から始まり、その操作の分だけ増えます。
+ * 測れなかった場合は-1を返します。
+ */
+long measurePeakRss(const std::string& operation, const std::string& filepath,
+		    const Config& config, const Table& table)
+{
+  std::cout.flush();
+  const pid_t pid = fork();
+  if (pid < 0) {
+    return -1;
+  }
+
+  if (pid == 0) {
+    try {
+      run(operation, filepath, config, table);
+    } catch (...) {
+      _exit(1);
+    }
+    _exit(0); // skip destructors and buffers shared with the parent
+  }
+
+  int status = 0;
+  struct rusage usage;
+  pid_t result;
+  do {
+    result = wait4(pid, &status, 0, &usage);
+  } while (result < 0 && errno == EINTR);
+
+  if (result != pid || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+    return -1;
+  }
+  return usage.ru_maxrss;
+}
+
+/**
+ * @brief 指定された種類のCSVデータを生成し、すべての操作を計測します。
+ */
+void measure(const std::string& kind, const Options& options, Counters& counters,
+	     std::vector<Result>& results)
+{
+  const std::string filepath = options.directory + "/bench-" + kind + ".csv";
+  Config config;
+  Corpus::getConfig(kind, config);
+
+  std::size_t bytes;
+  {
+    std::string data;
+    Corpus::generate(kind, options.size, data);
+    bytes = data.size();
+    std::ofstream stream(filepath.c_str(), std::ofstream::binary);
+    stream.write(data.data(), static_cast<std::streamsize>(data.size()));
+    if (!stream) {
+      throw std::ios_base::failure("Failed to write: " + filepath);
+    }
+  }
+
+  Table table;
+  Util::load(filepath, config, table);
+
+  for (std::size_t i = 0; i < sizeof(OPERATIONS) / sizeof(OPERATIONS[0]); i++) {
+    Result result;
+    result.kind = kind;
+    result.operation = OPERATIONS[i];
+    result.bytes = bytes;
+    result.records = 0;
+    result.seconds = -1;
+    result.allocations = 0;
+    for (int k = 0; k < Counters::COUNTER_SIZE; k++) {
+      result.available[k] = false;
+      result.counts[k] = 0;
+    }
+
+    for (std::size_t j = 0; j < options.repeat; j++) {
+      const unsigned long long allocations = allocationCount.load();
+      const std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+      counters.start();
+      const std::size_t records = run(OPERATIONS[i], filepath, config, table);
+      counters.stop();
+      const std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+      const double seconds = std::chrono::duration<double>(end - begin).count();
+
+      if (result.seconds < 0 || seconds < result.seconds) {
+	result.records = records;
+	result.seconds = seconds;
+	result.allocations = allocationCount.load() - allocations;
+	for (int k = 0; k < Counters::COUNTER_SIZE; k++) {
+	  const Counters::Counter counter = static_cast<Counters::Counter>(k);
+	  result.available[k] = counters.isAvailable(counter);
+	  result.counts[k] = counters.getValue(counter);
+	}
+      }
+    }
+
+    result.peakRss = measurePeakRss(OPERATIONS[i], filepath, config, table);
+    results.push_back(result);
+  }
+
+  std::remove(filepath.c_str());
+  std::remove((filepath + ".out").c_str());
+}
+
+/**
+ * @brief 計測結果の項目名を返します。
+ */
+void getColumns(std::vector<std::string>& columns)
+{
+  static const char* const COLUMNS[] = {
+    "kind",
+    "operation",
+    "bytes",
+    "records",
+    "seconds",
+    "mb_per_sec",
+    "records_per_sec",
+    "allocs_per_record",
+    "peak_rss_kb",
+  };
+
+  columns.assign(COLUMNS, COLUMNS + sizeof(COLUMNS) / sizeof(COLUMNS[0]));
+  for (int k = 0; k < Counters::COUNTER_SIZE; k++) {
+    const std::string name = Counters::getName(static_cast<Counters::Counter>(k));
+    columns.push_back(name + "_per_byte");
+    columns.push_back(name + "_per_record");
+  }
+}
+
+/**
+ * @brief 計測結果から表示用の値を求めます。使えなかったカウンタの値は空文字列になります。
+ */
+void describe(const Result& result, std::vector<std::string>& fields)
+{
+  const double seconds = (result.seconds > 0) ? result.seconds : 1e-9;
+  const double records = (result.records > 0) ? static_cast<double>(result.records) : 1;
+  std::ostringstream mbps;
+  std::ostringstream rps;
+  std::ostringstream apr;
+  std::ostringstream secs;
+
+  mbps << static_cast<double>(result.bytes) / seconds / (1024 * 1024);
+  rps << static_cast<double>(result.records) / seconds;
+  apr << static_cast<double>(result.allocations) / records;
+  secs << result.seconds;
+
+  fields.clear();
+  fields.push_back(result.kind);
+  fields.push_back(result.operation);
+  fields.push_back(std::to_string(result.bytes));
+  fields.push_back(std::to_string(result.records));
+  fields.push_back(secs.str());
+  fields.push_back(mbps.str());
+  fields.push_back(rps.str());
+  fields.push_back(apr.str());
+  fields.push_back(result.peakRss >= 0 ? std::to_string(result.peakRss) : std::string());
+
+  for (int k = 0; k < Counters::COUNTER_SIZE; k++) {
+    if (!result.available[k]) {
+      fields.push_back("");
+      fields.push_back("");
+      continue;
+    }
+    std::ostringstream perByte;
+    std::ostringstream perRecord;
+    perByte << static_cast<double>(result.counts[k]) / static_cast<double>(result.bytes > 0 ? result.bytes : 1);
+    perRecord << static_cast<double>(result.counts[k]) / records;
+    fields.push_back(perByte.str());
+    fields.push_back(perRecord.str());
+  }
+}
+
+/**
+ * @brief 計測結果をCSV形式で出力します。
+ */
+void printCsv(const std::vector<Result>& results)
+{
+  Writer writer(std::cout);
+  std::vector<std::string> fields;
+
+  getColumns(fields);
+  writer.write(fields);
+
+  for (std::size_t i = 0; i < results.size(); i++) {
+    describe(results[i], fields);
+    writer.write(fields);
+  }
+}
+
+/**
+ * @brief 計測結果をJSON形式で出力します。
+ */
+void printJson(const std::vector<Result>& results)
+{
+  std::vector<std::string> columns;
+  std::vector<std::string> fields;
+
+  getColumns(columns);
+  std::cout << "[\n";
+  for (std::size_t i = 0; i < results.size(); i++) {
+    describe(results[i], fields);
+    std::cout << "  {";
+    for (std::size_t j = 0; j < fields.size(); j++) {
+      std::cout << (j > 0 ? ", " : "") << '"' << columns[j] << "\": ";
+      if (j < 2) {
+	std::cout << '"' << fields[j] << '"'; // kind and operation names need no escaping
+      } else if (fields[j].empty()) {
+	std::cout << "null"; // the counter is unavailable
+      } else {
+	std::cout << fields[j];
+      }
+    }
+    std::cout << (i + 1 < results.size() ? "},\n" : "}\n");
+  }
+  std::cout << "]\n";
+}
+
+/**
+ * @brief 使い方を表示します。
+ */
+void usage(const char* program)
+{
+  std::cerr << "usage: " << program
+	    << " [--size=BYTES] [--repeat=N] [--format=json|csv] [--dir=DIRECTORY] [--kind=KIND]..."
+	    << std::endl;
+}
+
+/**
+ * @brief コマンドライン引数を解釈します。
+ */
+bool parse(int argc, char* argv[], Options& options)
+{
+  options.size = 8 * 1024 * 1024;
+  options.repeat = 3;
+  options.format = "json";
+  options.directory = "bin";
+
+  for (int i = 1; i < argc; i++) {
+    const std::string arg = argv[i];
+    const std::string::size_type eq = arg.find('=');
+    const std::string name = arg.substr(0, eq);
+    const std::string value = (eq == std::string::npos) ? "" : arg.substr(eq + 1);
+
+    if (name == "--size") {
+      options.size = std::strtoul(value.c_str(), NULL, 10);
+    } else if (name == "--repeat") {
+      options.repeat = std::strtoul(value.c_str(), NULL, 10);
+    } else if (name == "--format" && (value == "json" || value == "csv")) {
+      options.format = value;
+    } else if (name == "--dir" && !value.empty()) {
+      options.directory = value;
+    } else if (name == "--kind" && !value.empty()) {
+      options.kinds.push_back(value);
+    } else {
+      return false;
+    }
+  }
+
+  if (options.repeat == 0) {
+    options.repeat = 1;
+  }
+  if (options.kinds.empty()) {
+    Corpus::getKinds(options.kinds);
+  }
+  return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+  Options options;
+  if (!parse(argc, argv, options)) {
+    usage(argv[0]);
+    return 2;
+  }
+
+  try {
+    Counters counters;
+    std::vector<Result> results;
+    for (std::size_t i = 0; i < options.kinds.size(); i++) {
+      measure(options.kinds[i], options, counters, results);
+    }
+
+    if (options.format == "csv") {
+      printCsv(results);
+    } else {
+      printJson(results);
+    }
+  } catch (const std::exception& e) {
+    std::cerr << argv[0] << ": " << e.what() << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
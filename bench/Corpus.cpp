@@ -0,0 +1,183 @@
+/**
+ * @file  Corpus.cpp
+ * @brief Corpusクラス実装ファイル
+ */
+#include "Corpus.hpp"
+#include <stdexcept>
+#include <stdint.h>
+
+namespace csl {
+namespace csv {
+namespace bench {
+
+namespace {
+
+/**
+ * @brief 生成するCSVデータの種類です。
+ */
+const char* const KINDS[] = {
+  "narrow",  // few short fields
+  "wide",    // many short fields
+  "quoted",  // every field quoted, with escaped quote marks
+  "crlf",    // quoted fields with embedded CRLF
+  "comment", // comment lines between records
+  "long",    // kilobyte-sized fields
+  "utf8",    // non-ASCII (UTF-8) fields
+};
+
+/**
+ * @brief 環境に依存しない疑似乱数生成器(xorshift64*)です。
+ */
+class Random
+{
+public:
+  Random(uint64_t seed)
+    : state(seed)
+  {
+  }
+
+  uint64_t next(void)
+  {
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+    return state * 0x2545F4914F6CDD1DULL;
+  }
+
+  std::size_t below(std::size_t bound)
+  {
+    return static_cast<std::size_t>(next() % bound);
+  }
+
+private:
+  uint64_t state;
+};
+
+/**
+ * @brief 英小文字からなる指定された長さの単語を追加します。
+ */
+void appendWord(Random& random, std::size_t length, std::string& data)
+{
+  for (std::size_t i = 0; i < length; i++) {
+    data.push_back(static_cast<char>('a' + random.below(26)));
+  }
+}
+
+/**
+ * @brief 指定された種類のCSVレコードを1つ追加します。
+ */
+void appendRecord(const std::string& kind, Random& random, std::size_t index, std::string& data)
+{
+  static const char* const JAPANESE[] = {
+    "東京都", "大阪府", "北海道", "沖縄県", "データ", "ベンチマーク", "品目", "数量",
+  };
+
+  if (kind == "narrow") {
+    data.append(std::to_string(index));
+    data.push_back(',');
+    appendWord(random, 3 + random.below(8), data);
+    data.push_back(',');
+    data.append(std::to_string(random.below(100000)));
+    data.push_back(',');
+    appendWord(random, 1 + random.below(4), data);
+  } else if (kind == "wide") {
+    for (std::size_t i = 0; i < 64; i++) {
+      if (i > 0) {
+	data.push_back(',');
+      }
+      data.append(std::to_string(random.below(1000)));
+    }
+  } else if (kind == "quoted") {
+    for (std::size_t i = 0; i < 8; i++) {
+      if (i > 0) {
+	data.push_back(',');
+      }
+      data.push_back('"');
+      appendWord(random, 2 + random.below(6), data);
+      data.append(random.below(2) ? "\"\"" : ",");
+      appendWord(random, 2 + random.below(6), data);
+      data.push_back('"');
+    }
+  } else if (kind == "crlf") {
+    data.append(std::to_string(index));
+    data.append(",\"");
+    for (std::size_t i = 1 + random.below(4); i > 0; i--) {
+      appendWord(random, 4 + random.below(12), data);
+      data.append("\r\n");
+    }
+    data.append("\",");
+    appendWord(random, 5, data);
+  } else if (kind == "comment") {
+    if (random.below(2)) {
+      data.append("# ");
+      appendWord(random, 10 + random.below(30), data);
+      data.append("\r\n");
+    }
+    data.append(std::to_string(index));
+    data.push_back(',');
+    appendWord(random, 3 + random.below(8), data);
+  } else if (kind == "long") {
+    for (std::size_t i = 0; i < 3; i++) {
+      if (i > 0) {
+	data.push_back(',');
+      }
+      appendWord(random, 1024 + random.below(3072), data);
+    }
+  } else if (kind == "utf8") {
+    for (std::size_t i = 0; i < 6; i++) {
+      if (i > 0) {
+	data.push_back(',');
+      }
+      data.append(JAPANESE[random.below(sizeof(JAPANESE) / sizeof(JAPANESE[0]))]);
+      data.append(JAPANESE[random.below(sizeof(JAPANESE) / sizeof(JAPANESE[0]))]);
+    }
+  } else {
+    throw std::invalid_argument("Unknown corpus: " + kind);
+  }
+
+  data.append("\r\n");
+}
+
+} // namespace
+
+/**
+ * @brief 生成できるCSVデータの種類を返します。
+ * @param kinds CSVデータの種類
+ */
+void Corpus::getKinds(std::vector<std::string>& kinds)
+{
+  kinds.assign(KINDS, KINDS + sizeof(KINDS) / sizeof(KINDS[0]));
+}
+
+/**
+ * @brief 指定された種類のCSVデータを、指定されたバイト数を超えるまで生成します。
+ * @param kind CSVデータの種類
+ * @param size バイト数
+ * @param data CSVデータ
+ * @exception std::invalid_argument 種類が不明な場合
+ */
+void Corpus::generate(const std::string& kind, const std::size_t size, std::string& data)
+{
+  Random random(0x9E3779B97F4A7C15ULL);
+
+  data.clear();
+  data.reserve(size + 16 * 1024);
+
+  for (std::size_t i = 0; data.size() < size; i++) {
+    appendRecord(kind, random, i, data);
+  }
+}
+
+/**
+ * @brief 指定された種類のCSVデータを読み書きするための設定を返します。
+ * @param kind CSVデータの種類
+ * @param config Configオブジェクト
+ */
+void Corpus::getConfig(const std::string& kind, Config& config)
+{
+  config.setCommentEnabled(kind == "comment");
+}
+
+} // namespace bench
+} // namespace csv
+} // namespace csl
@@ -0,0 +1,40 @@
+/**
+ * @file  Corpus.hpp
+ * @brief Corpusクラスヘッダーファイル
+ */
+#ifndef CSL_CSV_BENCH_CORPUS_HPP_
+#define CSL_CSV_BENCH_CORPUS_HPP_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "csl/csv/Config.hpp"
+
+namespace csl {
+namespace csv {
+namespace bench {
+
+/**
+ * @brief ベンチマーク用のCSVデータを決定的に生成します。
+ *
+ * 同じ種類と大きさを指定すれば、どの環境でも同じバイト列を生成します。
+ */
+class Corpus
+{
+public:
+  static void getKinds(std::vector<std::string>& kinds);
+  static void generate(const std::string& kind, const std::size_t size, std::string& data);
+  static void getConfig(const std::string& kind, Config& config);
+
+private:
+  Corpus(void);
+  ~Corpus(void);
+  Corpus(const Corpus& corpus);
+  Corpus& operator=(const Corpus& corpus);
+};
+
+} // namespace bench
+} // namespace csv
+} // namespace csl
+
+#endif // #ifndef CSL_CSV_BENCH_CORPUS_HPP_
@@ -0,0 +1,176 @@
+/**
+ * @file  Counters.cpp
+ * @brief Countersクラス実装ファイル
+ */
+#include "Counters.hpp"
+#include <cstring>
+#include <unistd.h>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
+
+namespace csl {
+namespace csv {
+namespace bench {
+
+namespace {
+
+#ifdef __linux__
+/**
+ * @brief 各カウンタに対応するperf_event_openのイベントです。
+ */
+const unsigned long long EVENTS[Counters::COUNTER_SIZE] = {
+  PERF_COUNT_HW_CPU_CYCLES,
+  PERF_COUNT_HW_INSTRUCTIONS,
+  PERF_COUNT_HW_BRANCH_MISSES,
+  PERF_COUNT_HW_CACHE_MISSES,
+};
+
+/**
+ * @brief 現在のプロセスのユーザー空間だけを数えるカウンタを、停止した状態で開きます。
+ * @return ファイル記述子、開けなかった場合は-1
+ */
+int openCounter(const unsigned long long event)
+{
+  struct perf_event_attr attr;
+  std::memset(&attr, 0, sizeof(attr));
+  attr.type = PERF_TYPE_HARDWARE;
+  attr.size = sizeof(attr);
+  attr.config = event;
+  attr.disabled = 1;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+  return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+}
+#endif
+
+} // namespace
+
+/**
+ * @brief 使えるカウンタを開いて、Countersオブジェクトを構築します。
+ */
+Counters::Counters(void)
+{
+  for (int i = 0; i < COUNTER_SIZE; i++) {
+#ifdef __linux__
+    fds[i] = openCounter(EVENTS[i]);
+#else
+    fds[i] = -1;
+#endif
+    values[i] = 0;
+    counted[i] = false;
+  }
+}
+
+/**
+ * @brief カウンタを閉じて、Countersオブジェクトを破棄します。
+ */
+Counters::~Counters(void)
+{
+  for (int i = 0; i < COUNTER_SIZE; i++) {
+    if (fds[i] >= 0) {
+      close(fds[i]);
+    }
+  }
+}
+
+/**
+ * @brief カウンタを0に戻して、計測を始めます。
+ */
+void Counters::start(void)
+{
+#ifdef __linux__
+  for (int i = 0; i < COUNTER_SIZE; i++) {
+    if (fds[i] >= 0) {
+      ioctl(fds[i], PERF_EVENT_IOC_RESET, 0);
+      ioctl(fds[i], PERF_EVENT_IOC_ENABLE, 0);
+    }
+  }
+#endif
+}
+
+/**
+ * @brief 計測を止めて、カウンタの値を読み取ります。
+ *
+ * カウンタが多重化されて計測区間の一部でしか動いていなかった場合は、有効だった時間と動いていた時間の比で値を補正します。
+ * 一度も動かなかったカウンタの値は、その計測区間では取得できません。
+ * 読み取れなかったカウンタは、以降使えないものとして扱います。
+ */
+void Counters::stop(void)
+{
+#ifdef __linux__
+  for (int i = 0; i < COUNTER_SIZE; i++) {
+    if (fds[i] >= 0) {
+      ioctl(fds[i], PERF_EVENT_IOC_DISABLE, 0);
+    }
+  }
+  for (int i = 0; i < COUNTER_SIZE; i++) {
+    values[i] = 0;
+    counted[i] = false;
+    if (fds[i] < 0) {
+      continue;
+    }
+
+    unsigned long long data[3]; // value, time enabled, time running
+    if (read(fds[i], data, sizeof(data)) != sizeof(data)) {
+      close(fds[i]);
+      fds[i] = -1;
+      continue;
+    }
+    if (data[2] == 0) {
+      continue; // never scheduled on the PMU
+    }
+    if (data[2] < data[1]) {
+      values[i] = static_cast<unsigned long long>(static_cast<long double>(data[0]) * data[1] / data[2]);
+    } else {
+      values[i] = data[0];
+    }
+    counted[i] = true;
+  }
+#endif
+}
+
+/**
+ * @brief 直前の計測区間で、指定されたカウンタの値が取得できたかどうかを返します。
+ * @param counter カウンタ
+ * @return 取得できた場合はtrue
+ */
+bool Counters::isAvailable(const Counter counter) const
+{
+  return fds[counter] >= 0 && counted[counter];
+}
+
+/**
+ * @brief 直前の計測区間での、指定されたカウンタの値(多重化を補正した値)を返します。
+ * @param counter カウンタ
+ * @return カウンタの値
+ */
+unsigned long long Counters::getValue(const Counter counter) const
+{
+  return values[counter];
+}
+
+/**
+ * @brief 指定されたカウンタの名前を返します。
+ * @param counter カウンタ
+ * @return カウンタの名前
+ */
+const char* Counters::getName(const Counter counter)
+{
+  static const char* const NAMES[COUNTER_SIZE] = {
+    "cycles",
+    "instructions",
+    "branch_misses",
+    "cache_misses",
+  };
+
+  return NAMES[counter];
+}
+
+} // namespace bench
+} // namespace csv
+} // namespace csl
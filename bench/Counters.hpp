@@ -0,0 +1,63 @@
+/**
+ * @file  Counters.hpp
+ * @brief Countersクラスヘッダーファイル
+ */
+#ifndef CSL_CSV_BENCH_COUNTERS_HPP_
+#define CSL_CSV_BENCH_COUNTERS_HPP_
+
+#include <cstddef>
+
+namespace csl {
+namespace csv {
+namespace bench {
+
+/**
+ * @brief 計測区間のハードウェアパフォーマンスカウンタを読み取ります。
+ *
+ * Linuxのperf_event_openを使用します。カウンタが使えない環境(コンテナなど)では、そのカウンタの値は取得できません。
+ * カウンタが多重化された場合、値は有効だった時間と動いていた時間の比で補正した推定値になります。
+ */
+class Counters
+{
+public:
+  /**
+   * @brief 読み取るカウンタです。
+   */
+  enum Counter {
+    CYCLES,        ///< CPUサイクル数
+    INSTRUCTIONS,  ///< 実行した命令数
+    BRANCH_MISSES, ///< 分岐予測ミス数
+    CACHE_MISSES,  ///< キャッシュミス数
+    COUNTER_SIZE,  ///< カウンタの数
+  };
+
+public:
+  Counters(void);
+
+public:
+  ~Counters(void);
+
+public:
+  void start(void);
+  void stop(void);
+  bool isAvailable(const Counter counter) const;
+  unsigned long long getValue(const Counter counter) const;
+
+public:
+  static const char* getName(const Counter counter);
+
+private:
+  int fds[COUNTER_SIZE];
+  unsigned long long values[COUNTER_SIZE];
+  bool counted[COUNTER_SIZE];
+
+private:
+  Counters(const Counters& counters);
+  Counters& operator=(const Counters& counters);
+};
+
+} // namespace bench
+} // namespace csv
+} // namespace csl
+
+#endif // #ifndef CSL_CSV_BENCH_COUNTERS_HPP_
@@ -0,0 +1,101 @@
+/**
+ * @file  Aggregator.hpp
+ * @brief Aggregatorクラスヘッダーファイル
+ */
+#ifndef CSL_CSV_AGGREGATOR_HPP_
+#define CSL_CSV_AGGREGATOR_HPP_
+
+#include <cstddef>
+#include <istream>
+#include <string>
+#include <vector>
+#include "csl/csv/Config.hpp"
+#include "csl/csv/Dictionary.hpp"
+#include "csl/csv/LazyRecord.hpp"
+#include "csl/csv/Writer.hpp"
+
+namespace csl {
+namespace csv {
+
+/**
+ * @brief CSVデータを読み込みながら、指定された列の値ごとのグループに集計します。
+ *
+ * CSVレコードは保持せず、グループごとのキーと集計値だけを保持するため、メモリ使用量はグループの数に比例します。
+ * ファイルを複数のスレッドで集計する場合は、Splitterで分けた範囲ごとに別々のハッシュ表に集計してから、範囲の順に併合します。
+ * 集計結果のグループは、入力に最初に現れた順に並びます。
+ * キーの列がないCSVレコードは、その列を空文字列として扱います。フィールドのないCSVレコードは集計しません。
+ */
+class Aggregator
+{
+public:
+  /**
+   * @brief 集計関数です。
+   */
+  enum Function {
+    FUNCTION_COUNT, ///< CSVレコードの数
+    FUNCTION_SUM,   ///< 数値の合計
+    FUNCTION_MIN,   ///< 数値の最小値
+    FUNCTION_MAX,   ///< 数値の最大値
+  };
+
+public:
+  Aggregator(void);
+
+public:
+  ~Aggregator(void);
+
+public:
+  void addGroup(const std::size_t column);
+  void addAggregate(const Function function, const std::size_t column);
+  void setThreadCount(const std::size_t threadCount);
+  std::size_t getThreadCount(void) const;
+
+  void aggregate(std::istream& stream);
+  void aggregate(std::istream& stream, const Config& config);
+  void aggregate(const std::string& filepath);
+  void aggregate(const std::string& filepath, const Config& config);
+
+  std::size_t size(void) const;
+  void getResult(std::vector<std::vector<std::string> >& csv) const;
+  void write(Writer& writer) const;
+  void clear(void);
+
+private:
+  /**
+   * @brief 集計関数と対象の列です。
+   */
+  struct Aggregate
+  {
+    Function function;   ///< 集計関数
+    std::size_t column;  ///< 列の番号
+  };
+
+  /**
+   * @brief グループのハッシュ表です。
+   */
+  struct Table
+  {
+    Dictionary groups;           ///< グループのキー(グループの番号を割り当てる)
+    std::vector<double> values;  ///< グループの番号順の集計値
+  };
+
+private:
+  std::vector<std::size_t> columns;
+  std::vector<Aggregate> aggregates;
+  std::size_t threadCount;
+  Table table;
+
+private:
+  void add(Table& table, const LazyRecord& record, std::string& key) const;
+  void merge(const Table& source);
+  void getRecord(const std::size_t group, std::vector<std::string>& record) const;
+
+private:
+  Aggregator(const Aggregator& aggregator);
+  Aggregator& operator=(const Aggregator& aggregator);
+};
+
+} // namespace csv
+} // namespace csl
+
+#endif // #ifndef CSL_CSV_AGGREGATOR_HPP_
@@ -0,0 +1,159 @@
+/**
+ * @file  Automaton.hpp
+ * @brief Automatonクラスヘッダーファイル
+ */
+#ifndef CSL_CSV_AUTOMATON_HPP_
+#define CSL_CSV_AUTOMATON_HPP_
+
+#include <cstddef>
+#include "csl/csv/Config.hpp"
+
+namespace csl {
+namespace csv {
+
+/**
+ * @brief 状態の数です。
+ */
+constexpr std::size_t AUTOMATON_STATES = 4;
+
+/**
+ * @brief 文字の種類の数です。
+ */
+constexpr std::size_t AUTOMATON_CLASSES = 5;
+
+/**
+ * @brief Configオブジェクトから作った表で、CSVデータを1バイトずつ解析する決定性有限オートマトンです。
+ *
+ * 256通りのバイトを文字の種類に分ける表と、状態と文字の種類から次の状態と動作を引く表を持ち、1バイトごとに表を2回引くだけで遷移します。
+ * 区切り文字、囲み文字などの比較は表を作るときに済ませるため、解析中にConfigオブジェクトを参照しません。
+ * 行の先頭でしか意味を持たないコメント文字と、フィールドの値を取り出すときに使う囲み文字も、表を作るときに保持します。
+ * 表を作った後にConfigオブジェクトを変更しても、表には反映されません。
+ * ReaderクラスとScannerクラスはこの表で解析し、他の実装の結果を確かめる基準にもなります。
+ */
+class Automaton
+{
+public:
+  /**
+   * @brief 状態です。
+   */
+  enum State {
+    STATE_NORMAL,   ///< 囲み文字の外
+    STATE_QUOTE,    ///< 囲み文字の中
+    STATE_ESCAPE,   ///< 囲み文字の中で囲み文字を読んだ直後(閉じる囲み文字かエスケープ)
+    STATE_AFTER_CR, ///< 囲み文字の外でCRを読んだ直後
+  };
+
+  /**
+   * @brief 文字の種類です。
+   */
+  enum Class {
+    CLASS_OTHER,   ///< その他の文字
+    CLASS_DELIMIT, ///< 区切り文字
+    CLASS_QUOTE,   ///< 囲み文字(囲み文字が有効な場合)
+    CLASS_CR,      ///< CR
+    CLASS_LF,      ///< LF
+  };
+
+  /**
+   * @brief 遷移で行う動作です(ビットの組み合わせ)。
+   */
+  enum Action {
+    ACTION_APPEND_CR   = 0x01, ///< 直前のCRをフィールドに追加する
+    ACTION_APPEND      = 0x02, ///< 読んだ文字をフィールドに追加する
+    ACTION_END_FIELD   = 0x04, ///< フィールドを終える
+    ACTION_END_RECORD  = 0x08, ///< CSVレコードを終える(直前のCRとこの文字のLFは改行)
+    ACTION_QUOTED      = 0x10, ///< 囲み文字で囲まれたフィールドを始める
+    ACTION_ESCAPED     = 0x20, ///< エスケープされた囲み文字を読んだ
+    ACTION_LINE_BREAK  = 0x40, ///< フィールドがCRまたはLFを含む
+  };
+
+  /**
+   * @brief 遷移です。
+   */
+  struct Transition
+  {
+    unsigned char state;    ///< 次の状態
+    unsigned char actions;  ///< 動作
+  };
+
+public:
+  Automaton(void);
+  Automaton(const Config& config);
+
+public:
+  ~Automaton(void);
+
+public:
+  void compile(const Config& config);
+  unsigned char classify(const char c) const;
+  Transition step(const unsigned char state, const char c) const;
+  bool isCommentMark(const char c) const;
+  bool getQuoteEnabled(void) const;
+  char getQuoteMark(void) const;
+
+private:
+  unsigned char classes[256];
+  Transition transitions[AUTOMATON_STATES][AUTOMATON_CLASSES];
+  bool commentEnabled;
+  char commentMark;
+  bool quoteEnabled;
+  char quoteMark;
+
+private:
+  Automaton(const Automaton& automaton);
+  Automaton& operator=(const Automaton& automaton);
+};
+
+/**
+ * @brief 文字の種類を返します。
+ * @param c 文字
+ * @return 文字の種類
+ */
+inline unsigned char Automaton::classify(const char c) const
+{
+  return classes[static_cast<unsigned char>(c)];
+}
+
+/**
+ * @brief 指定された状態で文字を読んだときの遷移を返します。
+ * @param state 状態
+ * @param c 文字
+ * @return 遷移
+ */
+inline Automaton::Transition Automaton::step(const unsigned char state, const char c) const
+{
+  return transitions[state][classes[static_cast<unsigned char>(c)]];
+}
+
+/**
+ * @brief 行の先頭の文字がコメント行を始めるかどうかを返します。
+ * @param c 行の先頭の文字
+ * @return コメント行が有効で、文字がコメント文字の場合はtrue
+ */
+inline bool Automaton::isCommentMark(const char c) const
+{
+  return commentEnabled && c == commentMark;
+}
+
+/**
+ * @brief 表を作ったときに囲み文字が有効だったかどうかを返します。
+ * @return 囲み文字が有効な場合はtrue
+ */
+inline bool Automaton::getQuoteEnabled(void) const
+{
+  return quoteEnabled;
+}
+
+/**
+ * @brief 表を作ったときの囲み文字を返します。
+ * @return 囲み文字
+ */
+inline char Automaton::getQuoteMark(void) const
+{
+  return quoteMark;
+}
+
+} // namespace csv
+} // namespace csl
+
+#endif // #ifndef CSL_CSV_AUTOMATON_HPP_
@@ -0,0 +1,138 @@
+/**
+ * @file  CachedTable.hpp
+ * @brief CachedTableクラスヘッダーファイル
+ */
+#ifndef CSL_CSV_CACHEDTABLE_HPP_
+#define CSL_CSV_CACHEDTABLE_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "csl/csv/Config.hpp"
+
+namespace csl {
+namespace csv {
+
+/**
+ * @brief 読み込み済みのCSVデータを列ごとのバイナリ形式で保存したキャッシュファイルを、解釈せずにメモリへマップして読み出します。
+ *
+ * キャッシュファイルには形式のバージョンと、元のCSV形式ファイルのサイズ、更新時刻、ハッシュ値、読み込んだときの設定を記録します。
+ * 元のファイルを指定して構築した場合は、キャッシュファイルが古ければCSV形式ファイルを読み込み直してキャッシュファイルを作り直します。
+ * すべての値が整数として表せる列は、64ビット整数の列として保存します。
+ */
+class CachedTable
+{
+public:
+  CachedTable(const std::string& cachepath);
+  CachedTable(const std::string& filepath,
+	      const std::string& cachepath);
+  CachedTable(const std::string& filepath,
+	      const Config& config,
+	      const std::string& cachepath);
+
+public:
+  virtual ~CachedTable(void);
+
+public:
+  bool isRebuilt(void) const;
+  std::size_t getRowCount(void) const;
+  std::size_t getColumnCount(void) const;
+  std::size_t getFieldCount(const std::size_t row) const;
+  bool isInteger(const std::size_t column) const;
+  const char* getData(const std::size_t row, const std::size_t column) const;
+  std::size_t getSize(const std::size_t row, const std::size_t column) const;
+  std::int64_t getInteger(const std::size_t row, const std::size_t column) const;
+  std::string get(const std::size_t row, const std::size_t column) const;
+  void getRecord(const std::size_t row, std::vector<std::string>& record) const;
+
+public:
+  static void save(const std::string& cachepath,
+		   const std::string& filepath,
+		   const std::vector<std::vector<std::string> >& csv);
+  static void save(const std::string& cachepath,
+		   const std::string& filepath,
+		   const Config& config,
+		   const std::vector<std::vector<std::string> >& csv);
+  static bool isFresh(const std::string& cachepath,
+		      const std::string& filepath,
+		      const Config& config);
+
+protected:
+  /**
+   * @brief キャッシュファイルに記録する元のCSV形式ファイルの状態です。
+   */
+  struct Source
+  {
+    std::uint64_t size;     ///< バイト数
+    std::int64_t mtime;     ///< 更新時刻(秒)
+    std::int64_t mtimeNsec; ///< 更新時刻(ナノ秒)
+    std::uint64_t hash;     ///< ハッシュ値
+  };
+
+protected:
+  CachedTable(void);
+
+protected:
+  static std::uint64_t measure(const std::vector<std::vector<std::string> >& csv);
+  static void inspect(const std::string& filepath, Source& source);
+  static void save(const std::string& cachepath,
+		   const Source& source,
+		   const Config& config,
+		   const std::vector<std::vector<std::string> >& csv);
+  static void write(std::ostream& stream,
+		    const std::string& filepath,
+		    const Config& config,
+		    const std::vector<std::vector<std::string> >& csv);
+  static void write(std::ostream& stream,
+		    const Source* source,
+		    const Config& config,
+		    const std::vector<std::vector<std::string> >& csv);
+  void map(const int fd, const std::string& cachepath);
+
+private:
+  /**
+   * @brief マップした1つの列です。
+   */
+  struct Column
+  {
+    bool integer;                  ///< 64ビット整数の列かどうか
+    const std::uint64_t* offsets;  ///< 文字列の列の場合の行ごとの開始位置(行数+1個)
+    const char* bytes;             ///< 文字列の列の場合の値を連結したバイト列
+    std::size_t size;              ///< 文字列の列の場合のバイト列のバイト数
+    const std::int64_t* values;    ///< 64ビット整数の列の場合の行ごとの値
+  };
+
+private:
+  void* address;
+  std::size_t length;
+  std::size_t rowCount;
+  const std::uint32_t* fieldCounts;
+  std::vector<Column> columns;
+  bool rebuilt;
+
+private:
+  void load(const std::string& filepath,
+	    const Config& config,
+	    const std::string& cachepath);
+  void open(const std::string& cachepath);
+  void close(void);
+  const Column& at(const std::size_t row, const std::size_t column) const;
+  void locate(const std::size_t row, const std::size_t column,
+	      const char*& data, std::size_t& size) const;
+
+private:
+  CachedTable(const CachedTable& table);
+  CachedTable& operator=(const CachedTable& table);
+};
+
+/**
+ * @brief キャッシュファイル形式のバージョンです。形式を変えた場合は増やします。
+ */
+constexpr std::uint32_t CACHE_VERSION = 1;
+
+} // namespace csv
+} // namespace csl
+
+#endif // #ifndef CSL_CSV_CACHEDTABLE_HPP_
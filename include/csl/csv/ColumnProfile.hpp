@@ -0,0 +1,60 @@
+/**
+ * @file  ColumnProfile.hpp
+ * @brief ColumnProfileクラスヘッダーファイル
+ */
+#ifndef CSL_CSV_COLUMNPROFILE_HPP_
+#define CSL_CSV_COLUMNPROFILE_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include "csl/csv/HyperLogLog.hpp"
+#include "csl/csv/QuantileSketch.hpp"
+
+namespace csl {
+namespace csv {
+
+/**
+ * @brief 1つの列の統計情報です。
+ *
+ * 値の数、空の値の数、値の長さの最小値と最大値、数値の最小値、最大値、平均、分位数、値の種類の数を、値を保持せずに求めます。
+ * 分位数はQuantileSketch、値の種類の数はHyperLogLogによる近似値です。
+ * 同じ列のColumnProfileどうしは併合できます。
+ */
+class ColumnProfile
+{
+public:
+  ColumnProfile(void);
+
+public:
+  ~ColumnProfile(void);
+
+public:
+  void add(const char* data, const std::size_t size);
+  void addMissing(const std::uint64_t count);
+  void merge(const ColumnProfile& profile);
+
+  std::uint64_t getCount(void) const;
+  std::uint64_t getEmptyCount(void) const;
+  std::size_t getMinLength(void) const;
+  std::size_t getMaxLength(void) const;
+  std::uint64_t getNumericCount(void) const;
+  double getMinimum(void) const;
+  double getMaximum(void) const;
+  double getMean(void) const;
+  double getQuantile(const double q) const;
+  std::uint64_t getDistinctCount(void) const;
+
+private:
+  std::uint64_t count;
+  std::uint64_t emptyCount;
+  std::size_t minLength;
+  std::size_t maxLength;
+  double sum;
+  HyperLogLog distinct;
+  QuantileSketch quantiles;
+};
+
+} // namespace csv
+} // namespace csl
+
+#endif // #ifndef CSL_CSV_COLUMNPROFILE_HPP_
@@ -0,0 +1,65 @@
+/**
+ * @file  Deduplicator.hpp
+ * @brief Deduplicatorクラスヘッダーファイル
+ */
+#ifndef CSL_CSV_DEDUPLICATOR_HPP_
+#define CSL_CSV_DEDUPLICATOR_HPP_
+
+#include <cstddef>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "csl/csv/Config.hpp"
+#include "csl/csv/Digest.hpp"
+
+namespace csl {
+namespace csv {
+
+/**
+ * @brief CSVデータを読み込みながら、重複したCSVレコードを取り除いて書き込みます。
+ *
+ * キーの列を追加しない場合はCSVレコード全体、追加した場合はキーの列が等しいCSVレコードを重複とみなし、最初の1件だけを書き込みます。
+ * CSVレコードは保持せず、書き込んだCSVレコードのDigest(128ビット)だけをハッシュ表に保持します。
+ * 異なるCSVレコードのDigestが一致する確率は無視できるほど小さいものとして扱います。
+ */
+class Deduplicator
+{
+public:
+  Deduplicator(void);
+
+public:
+  ~Deduplicator(void);
+
+public:
+  void addKey(const std::size_t column);
+  void clearKeys(void);
+
+  void dedup(std::istream& in, std::ostream& out);
+  void dedup(std::istream& in, const Config& config, std::ostream& out);
+  void dedup(const std::string& inpath, const std::string& outpath);
+  void dedup(const std::string& inpath, const Config& config, const std::string& outpath);
+
+  std::size_t getRecordCount(void) const;
+  std::size_t getDuplicateCount(void) const;
+
+private:
+  std::vector<std::size_t> keys;
+  std::vector<Digest> slots;
+  std::vector<bool> occupied;
+  std::size_t recordCount;
+  std::size_t duplicateCount;
+
+private:
+  bool insert(const Digest& digest);
+  void grow(void);
+
+private:
+  Deduplicator(const Deduplicator& deduplicator);
+  Deduplicator& operator=(const Deduplicator& deduplicator);
+};
+
+} // namespace csv
+} // namespace csl
+
+#endif // #ifndef CSL_CSV_DEDUPLICATOR_HPP_
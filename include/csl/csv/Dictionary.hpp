@@ -0,0 +1,51 @@
+/**
+ * @file  Dictionary.hpp
+ * @brief Dictionaryクラスヘッダーファイル
+ */
+#ifndef CSL_CSV_DICTIONARY_HPP_
+#define CSL_CSV_DICTIONARY_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace csl {
+namespace csv {
+
+/**
+ * @brief 文字列に登録順の整数コードを割り当てる辞書です。
+ *
+ * 同じ文字列は一度だけ保持し、同じコードを返します。
+ */
+class Dictionary
+{
+public:
+  Dictionary(void);
+
+public:
+  ~Dictionary(void);
+
+public:
+  std::uint32_t intern(const char* data, const std::size_t size);
+  std::uint32_t intern(const std::string& value);
+  bool find(const char* data, const std::size_t size, std::uint32_t& code) const;
+  bool find(const std::string& value, std::uint32_t& code) const;
+  const std::string& get(const std::uint32_t code) const;
+  std::size_t size(void) const;
+  void clear(void);
+
+private:
+  std::vector<std::string> values;
+  std::vector<std::uint64_t> hashes;
+  std::vector<std::uint32_t> slots;
+
+private:
+  std::size_t lookup(const char* data, const std::size_t size, const std::uint64_t hash) const;
+  void grow(void);
+};
+
+} // namespace csv
+} // namespace csl
+
+#endif // #ifndef CSL_CSV_DICTIONARY_HPP_
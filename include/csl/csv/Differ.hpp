@@ -0,0 +1,106 @@
+/**
+ * @file  Differ.hpp
+ * @brief Differクラスヘッダーファイル
+ */
+#ifndef CSL_CSV_DIFFER_HPP_
+#define CSL_CSV_DIFFER_HPP_
+
+#include <cstddef>
+#include <ios>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "csl/csv/Config.hpp"
+#include "csl/csv/Digest.hpp"
+
+namespace csl {
+namespace csv {
+
+class LazyRecord;
+class Writer;
+
+/**
+ * @brief 2つのCSVデータの差分(追加、削除、変更されたCSVレコード)を書き込みます。
+ *
+ * 変更前のCSVデータからはCSVレコードごとのDigestと位置だけを保持し、変更後のCSVデータを読み込みながら照合します。
+ * キーの列を追加した場合は、キーの列が等しいCSVレコードどうしを照合し、CSVレコード全体のDigestが異なれば変更とみなします。
+ * キーの列を追加しない場合は、CSVレコード全体が等しいものどうしを照合します(変更はありません)。
+ * 同じキーのCSVレコードが複数ある場合は、それぞれの入力に現れた順に組にします。
+ *
+ * 差分は先頭の列に印を付けて書き込みます。追加(DIFF_ADDED_MARK)と変更(DIFF_CHANGED_MARK、変更後の値)は変更後の順に、
+ * 続けて削除(DIFF_REMOVED_MARK)を変更前の順に書き込みます。削除されたCSVレコードは、保持した位置から読み込み直します。
+ * そのため、変更前の入力ストリームは位置を移動できる必要があります(パイプなどは使えません)。
+ */
+class Differ
+{
+public:
+  Differ(void);
+
+public:
+  ~Differ(void);
+
+public:
+  void addKey(const std::size_t column);
+  void clearKeys(void);
+
+  void diff(std::istream& before, std::istream& after, std::ostream& out);
+  void diff(std::istream& before, std::istream& after, const Config& config, std::ostream& out);
+  void diff(const std::string& beforepath, const std::string& afterpath, const std::string& outpath);
+  void diff(const std::string& beforepath,
+	    const std::string& afterpath,
+	    const Config& config,
+	    const std::string& outpath);
+
+  std::size_t getAddedCount(void) const;
+  std::size_t getRemovedCount(void) const;
+  std::size_t getChangedCount(void) const;
+
+private:
+  /**
+   * @brief 変更前のCSVレコードです。
+   */
+  struct Entry
+  {
+    Digest key;             ///< キーの列のハッシュ値
+    Digest row;             ///< CSVレコード全体のハッシュ値
+    std::streamoff offset;  ///< CSVレコードの開始位置
+    std::size_t matched;    ///< 同じキーの先頭の場合、照合済みのCSVレコードの数
+  };
+
+private:
+  std::vector<std::size_t> keys;
+  std::size_t addedCount;
+  std::size_t removedCount;
+  std::size_t changedCount;
+
+private:
+  void emit(Writer& writer,
+	    const std::string& mark,
+	    const LazyRecord& record,
+	    std::vector<std::string>& fields) const;
+
+private:
+  Differ(const Differ& differ);
+  Differ& operator=(const Differ& differ);
+};
+
+/**
+ * @brief 追加されたCSVレコードの印です。
+ */
+constexpr const char* DIFF_ADDED_MARK = "+";
+
+/**
+ * @brief 削除されたCSVレコードの印です。
+ */
+constexpr const char* DIFF_REMOVED_MARK = "-";
+
+/**
+ * @brief 変更されたCSVレコードの印です。
+ */
+constexpr const char* DIFF_CHANGED_MARK = "~";
+
+} // namespace csv
+} // namespace csl
+
+#endif // #ifndef CSL_CSV_DIFFER_HPP_
@@ -0,0 +1,53 @@
+/**
+ * @file  Digest.hpp
+ * @brief Digestクラスヘッダーファイル
+ */
+#ifndef CSL_CSV_DIGEST_HPP_
+#define CSL_CSV_DIGEST_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace csl {
+namespace csv {
+
+class LazyRecord;
+
+/**
+ * @brief CSVレコード全体、または指定された列の128ビットハッシュ値です。
+ *
+ * フィールドは囲み文字とエスケープを解釈した値で求めるため、囲み文字の有無が違うだけのCSVレコードは同じ値になります。
+ * Hashを異なる初期値で2回適用した64ビットの値2つを組み合わせます。
+ */
+class Digest
+{
+public:
+  Digest(void);
+  Digest(const LazyRecord& record);
+  Digest(const LazyRecord& record, const std::vector<std::size_t>& columns);
+
+public:
+  ~Digest(void);
+
+public:
+  std::uint64_t getHigh(void) const;
+  std::uint64_t getLow(void) const;
+
+  bool operator==(const Digest& digest) const;
+  bool operator!=(const Digest& digest) const;
+  bool operator<(const Digest& digest) const;
+
+private:
+  std::uint64_t high;
+  std::uint64_t low;
+
+private:
+  void add(const LazyRecord& record, const std::size_t index);
+  void finish(const std::size_t count);
+};
+
+} // namespace csv
+} // namespace csl
+
+#endif // #ifndef CSL_CSV_DIGEST_HPP_
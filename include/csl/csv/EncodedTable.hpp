@@ -0,0 +1,81 @@
+/**
+ * @file  EncodedTable.hpp
+ * @brief EncodedTableクラスヘッダーファイル
+ */
+#ifndef CSL_CSV_ENCODEDTABLE_HPP_
+#define CSL_CSV_ENCODEDTABLE_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "csl/csv/Dictionary.hpp"
+#include "csl/csv/LazyRecord.hpp"
+
+namespace csl {
+namespace csv {
+
+/**
+ * @brief 種類の少ない列を辞書で整数コードに符号化して保持するCSVデータです。
+ *
+ * 列ごとに保持し、符号化した列の値は列ごとのDictionaryオブジェクトに一度だけ保持します。
+ * setEncodedで指定した列は常に符号化し、それ以外の列は異なる値の数がsetAutoEncodeLimitの上限を超えるまで符号化します。
+ * 上限を超えた列は、その時点で文字列の列に戻します。
+ */
+class EncodedTable
+{
+public:
+  EncodedTable(void);
+
+public:
+  ~EncodedTable(void);
+
+public:
+  void setEncoded(const std::size_t column, const bool encoded);
+  void setAutoEncodeLimit(const std::size_t limit);
+  void clear(void);
+  void add(const std::vector<std::string>& record);
+  void add(const LazyRecord& record);
+  std::size_t getRowCount(void) const;
+  std::size_t getColumnCount(void) const;
+  std::size_t getFieldCount(const std::size_t row) const;
+  bool isEncoded(const std::size_t column) const;
+  const std::string& get(const std::size_t row, const std::size_t column) const;
+  std::uint32_t getCode(const std::size_t row, const std::size_t column) const;
+  const Dictionary& getDictionary(const std::size_t column) const;
+  void getRecord(const std::size_t row, std::vector<std::string>& record) const;
+
+private:
+  /**
+   * @brief 1つの列です。
+   */
+  struct Column
+  {
+    bool encoded;                      ///< 符号化しているかどうか
+    Dictionary dictionary;             ///< 符号化している場合の辞書
+    std::vector<std::uint32_t> codes;  ///< 符号化している場合の行ごとのコード
+    std::vector<std::string> values;   ///< 符号化していない場合の行ごとの値
+  };
+
+private:
+  std::vector<Column> columns;
+  std::vector<std::uint32_t> fieldCounts;
+  std::vector<bool> selected;
+  std::size_t autoEncodeLimit;
+
+private:
+  void addField(const std::size_t column, const char* data, const std::size_t size);
+  void addColumn(void);
+  void decodeColumn(Column& column);
+  const Column& at(const std::size_t row, const std::size_t column) const;
+};
+
+/**
+ * @brief 指定されていない列を自動的に符号化する、異なる値の数の上限のデフォルト値です。
+ */
+constexpr std::size_t ENCODE_AUTO_LIMIT = 4096;
+
+} // namespace csv
+} // namespace csl
+
+#endif // #ifndef CSL_CSV_ENCODEDTABLE_HPP_
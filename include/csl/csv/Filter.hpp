@@ -0,0 +1,83 @@
+/**
+ * @file  Filter.hpp
+ * @brief Filterクラスヘッダーファイル
+ */
+#ifndef CSL_CSV_FILTER_HPP_
+#define CSL_CSV_FILTER_HPP_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "csl/csv/Dictionary.hpp"
+#include "csl/csv/LazyRecord.hpp"
+
+namespace csl {
+namespace csv {
+
+class Reader;
+
+/**
+ * @brief CSVレコードを選ぶための、列ごとの条件の集まりです。
+ *
+ * すべての条件を満たすCSVレコードだけを選びます。条件の列がないCSVレコードは選びません。
+ * Reader::read(LazyRecord&, const Filter&)では、条件の列を読み込んだ時点で読み込んだままのフィールドを調べ、
+ * 条件を満たさなければ残りのフィールドを解釈せずに読み飛ばします。
+ */
+class Filter
+{
+public:
+  Filter(void);
+
+public:
+  ~Filter(void);
+
+public:
+  void addEquals(const std::size_t column, const std::string& value);
+  void addPrefix(const std::size_t column, const std::string& prefix);
+  void addIn(const std::size_t column, const std::vector<std::string>& values);
+  void addRange(const std::size_t column, const double minimum, const double maximum);
+  void clear(void);
+  bool empty(void) const;
+  bool matches(const std::vector<std::string>& record) const;
+  bool matches(const LazyRecord& record) const;
+
+private:
+  /**
+   * @brief 条件の種類です。
+   */
+  enum Type {
+    TYPE_EQUALS,  ///< 等しい
+    TYPE_PREFIX,  ///< 前方一致
+    TYPE_IN,      ///< いずれかに等しい
+    TYPE_RANGE,   ///< 数値の範囲
+  };
+
+  /**
+   * @brief 1つの条件です。
+   */
+  struct Predicate
+  {
+    Type type;          ///< 条件の種類
+    std::string value;  ///< TYPE_EQUALSとTYPE_PREFIXの値
+    Dictionary values;  ///< TYPE_INの値
+    double minimum;     ///< TYPE_RANGEの最小値
+    double maximum;     ///< TYPE_RANGEの最大値
+  };
+
+private:
+  std::vector<std::vector<Predicate> > columns;
+
+private:
+  Predicate& add(const std::size_t column, const Type type);
+  bool test(const std::size_t column, const char* data, const std::size_t size) const;
+  bool test(const LazyRecord& record, const std::size_t column) const;
+  std::size_t getColumnCount(void) const;
+
+private:
+  friend class Reader;
+};
+
+} // namespace csv
+} // namespace csl
+
+#endif // #ifndef CSL_CSV_FILTER_HPP_
@@ -0,0 +1,96 @@
+/**
+ * @file  Follower.hpp
+ * @brief Followerクラスヘッダーファイル
+ */
+#ifndef CSL_CSV_FOLLOWER_HPP_
+#define CSL_CSV_FOLLOWER_HPP_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <ios>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include "csl/csv/Automaton.hpp"
+#include "csl/csv/Config.hpp"
+
+namespace csl {
+namespace csv {
+
+/**
+ * @brief 追記され続けるCSV形式ファイルを監視して、追記されたCSVレコードだけを読み込みます。
+ */
+class Follower
+{
+public:
+  /**
+   * @brief readで検出したファイルの変化です。
+   */
+  enum Event {
+    EVENT_NONE,      ///< 変化なし
+    EVENT_APPENDED,  ///< 追記された
+    EVENT_TRUNCATED, ///< 切り詰められた
+    EVENT_ROTATED,   ///< 別のファイルに置き換えられた
+  };
+
+public:
+  Follower(const std::string& filepath);
+  Follower(const std::string& filepath, const Config& config);
+
+public:
+  ~Follower(void);
+
+public:
+  Event read(std::vector<std::vector<std::string> >& csv);
+  bool wait(const int timeout);
+  std::streamoff getOffset(void) const;
+
+private:
+  std::string filepath;
+  const Config& config;
+  int fd;
+  int notifyFd;
+  int watchFd;
+  dev_t device;
+  ino_t inode;
+  std::streamoff offset;
+  std::string pending;
+  Automaton automaton;
+  std::size_t scanned;
+  std::size_t complete;
+  unsigned char scanState;
+  bool recordStart;
+  bool commentFlag;
+  bool carriageReturnFlag;
+  std::string tail;
+  struct timespec modified;
+
+private:
+  void open(void);
+  void close(void);
+  void watch(void);
+  void reset(void);
+  bool isTruncated(const struct stat& st);
+  bool readAppended(void);
+  void scan(void);
+  void parse(std::vector<std::vector<std::string> >& csv, const bool flush);
+
+private:
+  Follower(const Follower& follower);
+  Follower& operator=(const Follower& follower);
+};
+
+/**
+ * @brief inotifyが使えない場合にファイルの変化を確認する間隔(ミリ秒)です。
+ */
+constexpr int FOLLOW_POLL_INTERVAL = 100;
+
+/**
+ * @brief 1回のreadで読み込むバイト数の上限です。
+ */
+constexpr std::size_t FOLLOW_READ_LIMIT = 16 * 1024 * 1024;
+
+} // namespace csv
+} // namespace csl
+
+#endif // #ifndef CSL_CSV_FOLLOWER_HPP_
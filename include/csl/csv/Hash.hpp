@@ -0,0 +1,36 @@
+/**
+ * @file  Hash.hpp
+ * @brief Hashクラスヘッダーファイル
+ */
+#ifndef CSL_CSV_HASH_HPP_
+#define CSL_CSV_HASH_HPP_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace csl {
+namespace csv {
+
+/**
+ * @brief バイト列の64ビットハッシュ値を求めます。
+ *
+ * 8バイトずつ乗算と排他的論理和で混ぜ合わせる非暗号学的ハッシュ関数です。
+ * 同じバイト列と初期値からは、どの環境でも同じ値を返します(リトルエンディアンの場合)。
+ */
+class Hash
+{
+public:
+  static std::uint64_t hash(const char* data, const std::size_t size);
+  static std::uint64_t hash(const char* data, const std::size_t size, const std::uint64_t seed);
+
+private:
+  Hash(void);
+  ~Hash(void);
+  Hash(const Hash& hash);
+  Hash& operator=(const Hash& hash);
+};
+
+} // namespace csv
+} // namespace csl
+
+#endif // #ifndef CSL_CSV_HASH_HPP_
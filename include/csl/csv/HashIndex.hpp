@@ -0,0 +1,106 @@
+/**
+ * @file  HashIndex.hpp
+ * @brief HashIndexクラスヘッダーファイル
+ */
+#ifndef CSL_CSV_HASHINDEX_HPP_
+#define CSL_CSV_HASHINDEX_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "csl/csv/ThreadPool.hpp"
+
+namespace csl {
+namespace csv {
+
+/**
+ * @brief 読み込み済みのCSVデータの1つの列をキーとして、CSVレコードを探す索引です。
+ *
+ * キーはコピーせず、ハッシュ値とCSVレコードの番号だけをオープンアドレス法のハッシュ表に保持します。
+ * ハッシュ表はハッシュ値の上位ビットで分けた複数のシャードからなり、シャードごとに並列に構築できます。
+ * 索引はCSVデータを参照するため、CSVデータは索引より長く存在し、変更してはいけません。
+ * その列がないCSVレコードは索引に含めません。
+ */
+class HashIndex
+{
+public:
+  HashIndex(const std::vector<std::vector<std::string> >& csv,
+	    const std::size_t column);
+  HashIndex(const std::vector<std::vector<std::string> >& csv,
+	    const std::size_t column,
+	    ThreadPool& pool);
+  HashIndex(const std::vector<std::vector<std::string> >& csv,
+	    const std::size_t column,
+	    const std::string& filepath,
+	    const std::string& indexpath);
+
+public:
+  ~HashIndex(void);
+
+public:
+  std::size_t getColumn(void) const;
+  std::size_t size(void) const;
+  bool isLoaded(void) const;
+  bool find(const std::string& key, std::size_t& row) const;
+  const std::vector<std::string>* find(const std::string& key) const;
+  void findAll(const std::string& key, std::vector<std::size_t>& rows) const;
+  void save(const std::string& indexpath, const std::string& filepath) const;
+
+private:
+  /**
+   * @brief ハッシュ表の1つのスロットです。
+   */
+  struct Slot
+  {
+    std::uint64_t hash;  ///< キーのハッシュ値
+    std::uint64_t row;   ///< CSVレコードの番号(空きスロットの場合はINDEX_EMPTY)
+  };
+
+  /**
+   * @brief ハッシュ表の1つのシャードです。
+   */
+  struct Shard
+  {
+    std::uint64_t offset;  ///< slotsでの開始位置
+    std::uint64_t mask;    ///< スロット数-1(スロット数は2のべき乗)
+  };
+
+private:
+  const std::vector<std::vector<std::string> >& csv;
+  std::size_t column;
+  std::size_t count;
+  std::vector<Shard> shards;
+  std::vector<Slot> slots;
+  bool loaded;
+
+private:
+  void allocate(const std::vector<std::size_t>& counts);
+  void build(void);
+  void insert(const std::vector<std::uint64_t>& hashes,
+	      const std::vector<std::size_t>& rows,
+	      const std::vector<std::size_t>& starts,
+	      const std::size_t begin,
+	      const std::size_t end);
+  bool load(const std::string& indexpath, const std::string& filepath);
+  const Slot* probe(const std::string& key, const std::uint64_t hash, std::size_t& position) const;
+
+private:
+  HashIndex(const HashIndex& index);
+  HashIndex& operator=(const HashIndex& index);
+};
+
+/**
+ * @brief ハッシュ表のシャードの数です(2のべき乗)。
+ */
+constexpr std::size_t INDEX_SHARDS = 64;
+
+/**
+ * @brief 空きスロットを表すCSVレコードの番号です。
+ */
+constexpr std::uint64_t INDEX_EMPTY = ~static_cast<std::uint64_t>(0);
+
+} // namespace csv
+} // namespace csl
+
+#endif // #ifndef CSL_CSV_HASHINDEX_HPP_
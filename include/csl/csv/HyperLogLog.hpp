@@ -0,0 +1,51 @@
+/**
+ * @file  HyperLogLog.hpp
+ * @brief HyperLogLogクラスヘッダーファイル
+ */
+#ifndef CSL_CSV_HYPERLOGLOG_HPP_
+#define CSL_CSV_HYPERLOGLOG_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace csl {
+namespace csv {
+
+/**
+ * @brief 値の種類の数(異なる値の数)を、一定のメモリで近似的に数えます。
+ *
+ * 2^precision個の6ビット相当のレジスタ(実装は1バイト)を持ち、相対誤差はおよそ1.04/sqrt(2^precision)です。
+ * 同じ精度のHyperLogLogどうしは併合でき、併合の結果はすべての値を1つに追加した場合と同じです。
+ */
+class HyperLogLog
+{
+public:
+  HyperLogLog(void);
+  HyperLogLog(const std::size_t precision);
+
+public:
+  ~HyperLogLog(void);
+
+public:
+  std::size_t getPrecision(void) const;
+  void add(const char* data, const std::size_t size);
+  void addHash(const std::uint64_t hash);
+  void merge(const HyperLogLog& sketch);
+  double estimate(void) const;
+  void clear(void);
+
+private:
+  std::size_t precision;
+  std::vector<std::uint8_t> registers;
+};
+
+/**
+ * @brief デフォルトの精度(レジスタの数の2を底とする対数)です。相対誤差はおよそ0.8%です。
+ */
+constexpr std::size_t HLL_PRECISION = 14;
+
+} // namespace csv
+} // namespace csl
+
+#endif // #ifndef CSL_CSV_HYPERLOGLOG_HPP_
@@ -0,0 +1,159 @@
+/**
+ * @file  Joiner.hpp
+ * @brief Joinerクラスヘッダーファイル
+ */
+#ifndef CSL_CSV_JOINER_HPP_
+#define CSL_CSV_JOINER_HPP_
+
+#include <cstddef>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "csl/csv/Config.hpp"
+#include "csl/csv/HashIndex.hpp"
+#include "csl/csv/ThreadPool.hpp"
+#include "csl/csv/Writer.hpp"
+
+namespace csl {
+namespace csv {
+
+class Reader;
+class TempFiles;
+
+/**
+ * @brief 2つのCSVデータを、それぞれの1つの列の値が等しいCSVレコードどうしで結合します。
+ *
+ * 小さい方の入力(ビルド側)をメモリに読み込んでHashIndexで索引を作り、大きい方の入力(プローブ側)を1件ずつ読み込んで探します。
+ * 結合したCSVレコードはプローブ側の順に書き込みます。プローブ側の1件に複数のCSVレコードが一致した場合は、ビルド側の順に書き込みます。
+ * ビルド側がメモリの上限を超えた場合は、両方の入力をキーのハッシュ値でJOIN_PARTITIONS個の一時ファイルに分け、分けたものごとに結合します。
+ * 分けたもののビルド側がまだメモリの上限を超える場合は、ハッシュ値の別の部分でさらに分け直します(ハッシュ値の上位24ビットを使い切るまで)。
+ * 1つのキーのCSVレコードだけでメモリの上限を超える場合は、分け直しても収まらないため例外を送出します。
+ * この場合の出力は、分けたものごとにプローブ側の順になります。
+ * キーの列がないCSVレコードは、どのCSVレコードとも一致しません。
+ */
+class Joiner
+{
+public:
+  /**
+   * @brief 結合の種類です。
+   */
+  enum Type {
+    JOIN_INNER, ///< 一致したCSVレコードだけを出力する
+    JOIN_LEFT,  ///< 一致しなかったプローブ側のCSVレコードも、ビルド側の列を空文字列にして出力する
+  };
+
+  /**
+   * @brief 出力する列の入力です。
+   */
+  enum Side {
+    SIDE_PROBE, ///< プローブ側
+    SIDE_BUILD, ///< ビルド側
+  };
+
+public:
+  Joiner(const std::size_t probeColumn, const std::size_t buildColumn);
+
+public:
+  ~Joiner(void);
+
+public:
+  void setType(const Type type);
+  Type getType(void) const;
+  void addOutput(const Side side, const std::size_t column);
+  void clearOutputs(void);
+  void setMemoryLimit(const std::size_t memoryLimit);
+  std::size_t getMemoryLimit(void) const;
+  void setTempDirectory(const std::string& tempDirectory);
+  const std::string& getTempDirectory(void) const;
+  void setThreadCount(const std::size_t threadCount);
+  std::size_t getThreadCount(void) const;
+  bool isPartitioned(void) const;
+
+  void join(std::istream& probe, std::istream& build, std::ostream& out);
+  void join(std::istream& probe, std::istream& build, const Config& config, std::ostream& out);
+  void join(const std::string& probepath, const std::string& buildpath, const std::string& outpath);
+  void join(const std::string& probepath,
+	    const std::string& buildpath,
+	    const Config& config,
+	    const std::string& outpath);
+
+private:
+  /**
+   * @brief 出力する列です。
+   */
+  struct Output
+  {
+    Side side;           ///< 入力
+    std::size_t column;  ///< 列の番号
+  };
+
+private:
+  std::size_t probeColumn;
+  std::size_t buildColumn;
+  Type type;
+  std::vector<Output> outputs;
+  std::size_t memoryLimit;
+  std::string tempDirectory;
+  std::size_t threadCount;
+  bool partitioned;
+  std::size_t buildWidth;
+
+private:
+  void run(std::istream& probe,
+	   std::istream& build,
+	   const std::string* probepath,
+	   const Config& config,
+	   std::ostream& out);
+  void probeAll(Reader& reader,
+		const std::vector<std::vector<std::string> >& table,
+		const HashIndex& index,
+		Writer& writer) const;
+  void probeParallel(const std::string& probepath,
+		     const Config& config,
+		     const std::vector<std::vector<std::string> >& table,
+		     const HashIndex& index,
+		     ThreadPool& pool,
+		     std::ostream& out) const;
+  void joinPartitioned(Reader& probe,
+		       Reader& build,
+		       std::vector<std::vector<std::string> >& table,
+		       const Config& config,
+		       std::ostream& out);
+  void joinPartition(TempFiles& files,
+		     const std::string& buildpath,
+		     const std::string& probepath,
+		     const std::size_t bytes,
+		     const std::size_t depth,
+		     std::vector<std::vector<std::string> >& table,
+		     Writer& writer);
+  void match(const std::vector<std::string>& record,
+	     const std::vector<std::vector<std::string> >& table,
+	     const HashIndex& index,
+	     Writer& writer,
+	     std::vector<std::size_t>& rows,
+	     std::vector<std::string>& output) const;
+  void emit(Writer& writer,
+	    const std::vector<std::string>& probe,
+	    const std::vector<std::string>* build,
+	    std::vector<std::string>& output) const;
+
+private:
+  Joiner(const Joiner& joiner);
+  Joiner& operator=(const Joiner& joiner);
+};
+
+/**
+ * @brief デフォルトのメモリの上限(バイト数)です。
+ */
+constexpr std::size_t JOIN_MEMORY_LIMIT = 256 * 1024 * 1024;
+
+/**
+ * @brief ビルド側がメモリの上限を超えた場合に、入力を分ける一時ファイルの数です(2のべき乗)。
+ */
+constexpr std::size_t JOIN_PARTITIONS = 64;
+
+} // namespace csv
+} // namespace csl
+
+#endif // #ifndef CSL_CSV_JOINER_HPP_
@@ -0,0 +1,70 @@
+/**
+ * @file  KeyComparator.hpp
+ * @brief KeyComparatorクラスヘッダーファイル
+ */
+#ifndef CSL_CSV_KEYCOMPARATOR_HPP_
+#define CSL_CSV_KEYCOMPARATOR_HPP_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace csl {
+namespace csv {
+
+/**
+ * @brief CSVレコードを、指定された列をキーとして比較します。
+ *
+ * SorterとMergerが同じ順序で並べるために、それぞれ1つずつ持ちます。
+ * キーの列がないCSVレコードは、その列を空文字列として比較します。
+ */
+class KeyComparator
+{
+public:
+  /**
+   * @brief キーの比較方法です。
+   */
+  enum Collation {
+    COLLATION_STRING,  ///< バイト列として比較する
+    COLLATION_NUMERIC, ///< 数値として比較する(数値でないものは数値の後に文字列として比較する)
+  };
+
+public:
+  KeyComparator(void);
+
+public:
+  ~KeyComparator(void);
+
+public:
+  void addKey(const std::size_t column, const Collation collation);
+  void clearKeys(void);
+  std::size_t getKeyCount(void) const;
+  std::size_t getColumn(const std::size_t key) const;
+  Collation getCollation(const std::size_t key) const;
+  int compare(const std::vector<std::string>& a, const std::vector<std::string>& b) const;
+
+public:
+  static bool parseNumber(const std::string& value, double& number);
+
+private:
+  /**
+   * @brief キーの列と比較方法です。
+   */
+  struct Key
+  {
+    std::size_t column;   ///< 列の番号
+    Collation collation;  ///< 比較方法
+  };
+
+private:
+  std::vector<Key> keys;
+
+private:
+  KeyComparator(const KeyComparator& comparator);
+  KeyComparator& operator=(const KeyComparator& comparator);
+};
+
+} // namespace csv
+} // namespace csl
+
+#endif // #ifndef CSL_CSV_KEYCOMPARATOR_HPP_
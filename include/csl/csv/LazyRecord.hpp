@@ -0,0 +1,80 @@
+/**
+ * @file  LazyRecord.hpp
+ * @brief LazyRecordクラスヘッダーファイル
+ */
+#ifndef CSL_CSV_LAZYRECORD_HPP_
+#define CSL_CSV_LAZYRECORD_HPP_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace csl {
+namespace csv {
+
+class Reader;
+
+/**
+ * @brief フィールドを読み込んだままの形(囲み文字やエスケープを含む)で保持し、アクセスされたときに初めて解釈するCSVレコードです。
+ *
+ * Reader::read(LazyRecord&)で読み込みます。
+ * 読み込み時にはフィールドの境界と、囲み文字、エスケープされた囲み文字、CR/LFを含むかどうかだけを記録します。
+ */
+class LazyRecord
+{
+public:
+  LazyRecord(void);
+
+public:
+  ~LazyRecord(void);
+
+public:
+  void clear(void);
+  std::size_t size(void) const;
+  const char* getRawData(const std::size_t index) const;
+  std::size_t getRawSize(const std::size_t index) const;
+  bool isQuoted(const std::size_t index) const;
+  bool hasEscapedQuotes(const std::size_t index) const;
+  bool hasLineBreaks(const std::size_t index) const;
+  const std::string& get(const std::size_t index) const;
+  void get(const std::size_t index, std::string& field) const;
+
+private:
+  /**
+   * @brief フィールドの性質を表すフラグです。
+   */
+  enum Flag {
+    FLAG_QUOTED = 0x01,      ///< 囲み文字を含む
+    FLAG_ESCAPED = 0x02,     ///< エスケープされた囲み文字を含む
+    FLAG_LINE_BREAK = 0x04,  ///< CRまたはLFを含む
+  };
+
+  /**
+   * @brief 読み込んだままのフィールドの位置と性質です。
+   */
+  struct Field
+  {
+    std::size_t begin;   ///< dataでの開始位置
+    std::size_t size;    ///< バイト数
+    unsigned int flags;  ///< Flagの論理和
+  };
+
+private:
+  std::string data;
+  std::vector<Field> fields;
+  bool quoteEnabled;
+  char quoteMark;
+  mutable std::string scratch;
+
+private:
+  const Field& at(const std::size_t index) const;
+  void decode(const Field& field, std::string& value) const;
+
+private:
+  friend class Reader;
+};
+
+} // namespace csv
+} // namespace csl
+
+#endif // #ifndef CSL_CSV_LAZYRECORD_HPP_
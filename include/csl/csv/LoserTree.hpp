@@ -0,0 +1,99 @@
+/**
+ * @file  LoserTree.hpp
+ * @brief LoserTreeクラスヘッダーファイル
+ */
+#ifndef CSL_CSV_LOSERTREE_HPP_
+#define CSL_CSV_LOSERTREE_HPP_
+
+#include <cstddef>
+#include <vector>
+
+namespace csl {
+namespace csv {
+
+/**
+ * @brief 整列済みの複数の入力を1つに併合するための敗者木です。
+ *
+ * 入力を0からsize-1の番号で表し、各入力の先頭の要素の比較は呼び出し側の関数オブジェクトに任せます。
+ * 関数オブジェクトless(a, b)は、入力aの先頭が入力bの先頭より先に出力されるべき場合にtrueを返します。
+ * 読み終えた入力は、どの入力よりも後になるように比較します。
+ * 先頭を1つ取り出すたびの比較は、入力の数の対数回です。
+ */
+class LoserTree
+{
+public:
+  LoserTree(const std::size_t size);
+
+public:
+  ~LoserTree(void);
+
+public:
+  std::size_t size(void) const;
+  std::size_t top(void) const;
+
+  template <typename Less>
+  void build(const Less& less);
+
+  template <typename Less>
+  void replay(const Less& less);
+
+private:
+  std::vector<std::size_t> losers;
+
+private:
+  LoserTree(const LoserTree& tree);
+  LoserTree& operator=(const LoserTree& tree);
+};
+
+/**
+ * @brief すべての入力の先頭を比較して、敗者木を構築します。
+ * @param less 入力の先頭を比較する関数オブジェクト
+ */
+template <typename Less>
+void LoserTree::build(const Less& less)
+{
+  const std::size_t count = losers.size();
+
+  // leaves are nodes count..2*count-1, internal nodes are 1..count-1
+  std::vector<std::size_t> winners(count * 2);
+  for (std::size_t i = 0; i < count; i++) {
+    winners[count + i] = i;
+  }
+  for (std::size_t node = count - 1; node >= 1; node--) {
+    const std::size_t left = winners[node * 2];
+    const std::size_t right = winners[node * 2 + 1];
+    if (less(right, left)) {
+      winners[node] = right;
+      losers[node] = left;
+    } else {
+      winners[node] = left;
+      losers[node] = right;
+    }
+  }
+  losers[0] = (count > 1) ? winners[1] : 0;
+}
+
+/**
+ * @brief 先頭だった入力が進んだ後に、その入力から根までを比較し直します。
+ * @param less 入力の先頭を比較する関数オブジェクト
+ */
+template <typename Less>
+void LoserTree::replay(const Less& less)
+{
+  const std::size_t count = losers.size();
+  std::size_t winner = losers[0];
+
+  for (std::size_t node = (count + winner) / 2; node >= 1; node /= 2) {
+    if (less(losers[node], winner)) {
+      std::size_t loser = winner;
+      winner = losers[node];
+      losers[node] = loser;
+    }
+  }
+  losers[0] = winner;
+}
+
+} // namespace csv
+} // namespace csl
+
+#endif // #ifndef CSL_CSV_LOSERTREE_HPP_
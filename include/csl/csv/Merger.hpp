@@ -0,0 +1,69 @@
+/**
+ * @file  Merger.hpp
+ * @brief Mergerクラスヘッダーファイル
+ */
+#ifndef CSL_CSV_MERGER_HPP_
+#define CSL_CSV_MERGER_HPP_
+
+#include <cstddef>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "csl/csv/Config.hpp"
+#include "csl/csv/KeyComparator.hpp"
+
+namespace csl {
+namespace csv {
+
+/**
+ * @brief キーの順に並んだ複数のCSVデータを、並べ替えずに1つに併合します。
+ *
+ * 入力ごとにReaderで読み込み、先頭のCSVレコードを敗者木で比較して、1つのWriterで書き込みます。
+ * 比較の回数は入力の数の対数に比例し、CSVレコードの数に対して線形です。
+ * キーはSorterと同じくKeyComparatorで比較します。キーが等しいCSVレコードは、入力の順、入力の中での順に並べます。
+ */
+class Merger
+{
+public:
+  Merger(void);
+
+public:
+  ~Merger(void);
+
+public:
+  void addKey(const std::size_t column, const KeyComparator::Collation collation);
+  void clearKeys(void);
+  void setUnique(const bool unique);
+  bool getUnique(void) const;
+  void setBufferSize(const std::size_t bufferSize);
+  std::size_t getBufferSize(void) const;
+  std::size_t getRecordCount(void) const;
+  std::size_t getDuplicateCount(void) const;
+
+  void merge(const std::vector<std::istream*>& streams, std::ostream& out);
+  void merge(const std::vector<std::istream*>& streams, const Config& config, std::ostream& out);
+  void merge(const std::vector<std::string>& filepaths, const std::string& outpath);
+  void merge(const std::vector<std::string>& filepaths, const Config& config, const std::string& outpath);
+
+private:
+  KeyComparator comparator;
+  bool unique;
+  std::size_t bufferSize;
+  std::size_t recordCount;
+  std::size_t duplicateCount;
+
+private:
+  Merger(const Merger& merger);
+  Merger& operator=(const Merger& merger);
+};
+
+/**
+ * @brief 入力ファイルと出力ファイルごとのデフォルトのバッファのバイト数です。
+ */
+constexpr std::size_t MERGE_BUFFER_SIZE = 1024 * 1024;
+
+} // namespace csv
+} // namespace csl
+
+#endif // #ifndef CSL_CSV_MERGER_HPP_
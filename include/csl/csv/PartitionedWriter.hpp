@@ -0,0 +1,127 @@
+/**
+ * @file  PartitionedWriter.hpp
+ * @brief PartitionedWriterクラスヘッダーファイル
+ */
+#ifndef CSL_CSV_PARTITIONEDWRITER_HPP_
+#define CSL_CSV_PARTITIONEDWRITER_HPP_
+
+#include <cstddef>
+#include <list>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <vector>
+#include "csl/csv/Config.hpp"
+#include "csl/csv/Dictionary.hpp"
+#include "csl/csv/Writer.hpp"
+
+namespace csl {
+namespace csv {
+
+/**
+ * @brief CSVレコードを、指定された列の値ごとのファイルに振り分けて書き込みます。
+ *
+ * ファイルパスは、接頭辞に列の値(またはハッシュ値で決めた番号)と接尾辞を続けたものです。
+ * 列の値のうち英数字、"-"、"_"、"."(先頭を除く)、0x80以上のバイト以外は"%XX"の形にし、空文字列は"%"にします。
+ * CSVレコードはWriterで整形してファイルごとのバッファにため、バッファの合計がメモリの上限を超えたら大きいバッファから書き出します。
+ * 同時に開くファイルの数は上限を超えないように、最も長く使っていないファイルから閉じます。
+ * 最初に開くときにファイルを切り詰め、その後は追記します。
+ * 列がないCSVレコードは、列の値を空文字列として扱います。
+ */
+class PartitionedWriter
+{
+public:
+  PartitionedWriter(const std::string& prefix, const std::string& suffix, const std::size_t column);
+  PartitionedWriter(const std::string& prefix,
+		    const std::string& suffix,
+		    const std::size_t column,
+		    const Config& config);
+
+public:
+  ~PartitionedWriter(void);
+
+public:
+  void setPartitionCount(const std::size_t partitionCount);
+  std::size_t getPartitionCount(void) const;
+  void setMemoryLimit(const std::size_t memoryLimit);
+  std::size_t getMemoryLimit(void) const;
+  void setMaxOpenFiles(const std::size_t maxOpenFiles);
+  std::size_t getMaxOpenFiles(void) const;
+
+  void write(const std::vector<std::string>& record);
+  void flush(void);
+  void close(void);
+  std::size_t size(void) const;
+  const std::string& getPath(const std::size_t partition) const;
+
+private:
+  /**
+   * @brief 書き込む先の文字列に追加するストリームバッファです。
+   */
+  class AppendBuffer : public std::streambuf
+  {
+  public:
+    AppendBuffer(void);
+    void setTarget(std::string* target);
+
+  protected:
+    virtual int_type overflow(int_type c);
+    virtual std::streamsize xsputn(const char* data, std::streamsize size);
+
+  private:
+    std::string* target;
+  };
+
+  /**
+   * @brief 1つのファイルです。
+   */
+  struct Partition
+  {
+    std::string path;                         ///< ファイルパス
+    std::string buffer;                       ///< 書き出していないCSVレコード
+    int fd;                                   ///< ファイル記述子(開いていない場合は-1)
+    bool created;                             ///< 切り詰めて開いたことがある場合はtrue
+    std::list<std::size_t>::iterator recent;  ///< 開いているファイルの一覧での位置
+  };
+
+private:
+  std::string prefix;
+  std::string suffix;
+  std::size_t column;
+  const Config& config;
+  std::size_t partitionCount;
+  std::size_t memoryLimit;
+  std::size_t maxOpenFiles;
+  Dictionary values;
+  std::vector<Partition> partitions;
+  std::list<std::size_t> openFiles;
+  std::size_t buffered;
+  AppendBuffer appendBuffer;
+  std::ostream stream;
+  Writer writer;
+
+private:
+  std::size_t getPartition(const std::string& value);
+  void spill(void);
+  void drain(const std::size_t partition);
+  void open(const std::size_t partition);
+
+private:
+  PartitionedWriter(const PartitionedWriter& writer);
+  PartitionedWriter& operator=(const PartitionedWriter& writer);
+};
+
+/**
+ * @brief バッファの合計のデフォルトの上限(バイト数)です。
+ */
+constexpr std::size_t PARTITION_MEMORY_LIMIT = 64 * 1024 * 1024;
+
+/**
+ * @brief 同時に開くファイルの数のデフォルトの上限です。
+ */
+constexpr std::size_t PARTITION_OPEN_FILES = 64;
+
+} // namespace csv
+} // namespace csl
+
+#endif // #ifndef CSL_CSV_PARTITIONEDWRITER_HPP_
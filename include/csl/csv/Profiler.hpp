@@ -0,0 +1,67 @@
+/**
+ * @file  Profiler.hpp
+ * @brief Profilerクラスヘッダーファイル
+ */
+#ifndef CSL_CSV_PROFILER_HPP_
+#define CSL_CSV_PROFILER_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <string>
+#include <vector>
+#include "csl/csv/ColumnProfile.hpp"
+#include "csl/csv/Config.hpp"
+#include "csl/csv/LazyRecord.hpp"
+
+namespace csl {
+namespace csv {
+
+/**
+ * @brief CSVデータを読み込みながら、列ごとの統計情報(ColumnProfile)を求めます。
+ *
+ * CSVレコードは保持しないため、メモリ使用量は列の数に比例します。
+ * ファイルを複数のスレッドで読み込む場合は、Splitterで分けた範囲ごとに別々のProfilerで求めてから併合します。
+ * 列がないCSVレコードは、その列を空の値として数えます。フィールドのないCSVレコードは数えません。
+ */
+class Profiler
+{
+public:
+  Profiler(void);
+
+public:
+  ~Profiler(void);
+
+public:
+  void setThreadCount(const std::size_t threadCount);
+  std::size_t getThreadCount(void) const;
+
+  void profile(std::istream& stream);
+  void profile(std::istream& stream, const Config& config);
+  void profile(const std::string& filepath);
+  void profile(const std::string& filepath, const Config& config);
+  void add(const LazyRecord& record);
+  void merge(const Profiler& profiler);
+
+  std::uint64_t getRecordCount(void) const;
+  std::size_t size(void) const;
+  const ColumnProfile& getColumn(const std::size_t column) const;
+  void clear(void);
+
+private:
+  std::size_t threadCount;
+  std::uint64_t recordCount;
+  std::vector<ColumnProfile> columns;
+
+private:
+  void widen(const std::size_t size);
+
+private:
+  Profiler(const Profiler& profiler);
+  Profiler& operator=(const Profiler& profiler);
+};
+
+} // namespace csv
+} // namespace csl
+
+#endif // #ifndef CSL_CSV_PROFILER_HPP_
@@ -0,0 +1,75 @@
+/**
+ * @file  QuantileSketch.hpp
+ * @brief QuantileSketchクラスヘッダーファイル
+ */
+#ifndef CSL_CSV_QUANTILESKETCH_HPP_
+#define CSL_CSV_QUANTILESKETCH_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace csl {
+namespace csv {
+
+/**
+ * @brief 数値の分位数を、相対誤差を保証して近似的に求めます。
+ *
+ * 数値の絶対値を対数の幅が一定のバケットに数え、分位数はそのバケットの代表値で返します。
+ * 返す値と真の分位数の相対誤差は、指定された相対精度以下です。
+ * バケットの数は数値の桁の範囲に比例し、数値の件数には依存しません。
+ * 同じ相対精度のQuantileSketchどうしは併合でき、併合の結果はすべての数値を1つに追加した場合と同じです。
+ */
+class QuantileSketch
+{
+public:
+  QuantileSketch(void);
+  QuantileSketch(const double accuracy);
+
+public:
+  ~QuantileSketch(void);
+
+public:
+  double getAccuracy(void) const;
+  void add(const double value);
+  void merge(const QuantileSketch& sketch);
+  std::uint64_t size(void) const;
+  double quantile(const double q) const;
+  void clear(void);
+
+private:
+  /**
+   * @brief バケットの番号ごとの件数です。
+   */
+  struct Store
+  {
+    std::vector<std::uint64_t> counts;  ///< offset番からの件数
+    int offset;                         ///< counts[0]のバケットの番号
+  };
+
+private:
+  double accuracy;
+  double gamma;
+  double logGamma;
+  Store positive;
+  Store negative;
+  std::uint64_t zeroCount;
+  std::uint64_t count;
+  double minimum;
+  double maximum;
+
+private:
+  int getIndex(const double value) const;
+  double getValue(const int index) const;
+  static void add(Store& store, const int index, const std::uint64_t count);
+};
+
+/**
+ * @brief デフォルトの相対精度です。
+ */
+constexpr double QUANTILE_ACCURACY = 0.01;
+
+} // namespace csv
+} // namespace csl
+
+#endif // #ifndef CSL_CSV_QUANTILESKETCH_HPP_
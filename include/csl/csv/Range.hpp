@@ -0,0 +1,38 @@
+/**
+ * @file  Range.hpp
+ * @brief Rangeクラスヘッダーファイル
+ */
+#ifndef CSL_CSV_RANGE_HPP_
+#define CSL_CSV_RANGE_HPP_
+
+#include <ios>
+
+namespace csl {
+namespace csv {
+
+/**
+ * @brief 入力ストリーム上のバイト位置の範囲[begin, end)を表します。
+ */
+class Range
+{
+public:
+  Range(void);
+  Range(const std::streamoff begin, const std::streamoff end);
+
+public:
+  ~Range(void);
+
+public:
+  std::streamoff getBegin(void) const;
+  std::streamoff getEnd(void) const;
+  std::streamoff getSize(void) const;
+
+private:
+  std::streamoff begin;
+  std::streamoff end;
+};
+
+} // namespace csv
+} // namespace csl
+
+#endif // #ifndef CSL_CSV_RANGE_HPP_
@@ -5,22 +5,38 @@
 #ifndef CSL_CSV_READER_HPP_
 #define CSL_CSV_READER_HPP_
 
+#include <cstddef>
+#include <chrono>
 #include <string>
 #include <vector>
 #include <istream>
+#if __cplusplus >= 201703L
+#include <memory_resource>
+#endif
+#include "csl/csv/Automaton.hpp"
 #include "csl/csv/Config.hpp"
+#include "csl/csv/Filter.hpp"
+#include "csl/csv/LazyRecord.hpp"
+#include "csl/csv/Range.hpp"
+#include "csl/csv/Stats.hpp"
 
 namespace csl {
 namespace csv {
 
 /**
  * @brief CSV形式ファイルを読み込むための入力ストリームです。
+ *
+ * 構築時にConfigオブジェクトからAutomatonの表を作り、1バイトごとに表を引いて解析します。
+ * 構築後にConfigオブジェクトの区切り文字、囲み文字、コメント行の設定を変更しても、読み込みには反映されません。
  */
 class Reader
 {
 public:
   Reader(std::istream& stream);
   Reader(std::istream& stream, const Config& config);
+  Reader(std::istream& stream, const Config& config,
+	 const std::streamoff offset, const std::size_t recordNumber);
+  Reader(std::istream& stream, const Config& config, const Range& range);
 
 public:
   ~Reader(void);
@@ -28,15 +44,40 @@ public:
 public:
   bool hasNext(void);
   void read(std::vector<std::string>& record);
+#if __cplusplus >= 201703L
+  void read(std::pmr::vector<std::pmr::string>& record);
+#endif
+  void read(LazyRecord& record);
+  bool read(LazyRecord& record, const Filter& filter);
+  std::streamoff getOffset(void);
+  std::size_t getRecordNumber(void) const;
+  void setStats(Stats* stats);
 
 private:
   std::istream& stream;
-  const Config& config;
+  Automaton automaton;
   char nextChar;
+  std::streamoff position;
+  std::size_t recordNumber;
+  std::streamoff limit;
+  Stats* stats;
 
 private:
+  template <typename Record>
+  void readRecord(Record& record);
+  bool readLazyRecord(LazyRecord& record, const Filter* filter);
   void readNextChar(void);
   void readCommentLine(void);
+  void skipRecord(void);
+  void addStats(const std::chrono::steady_clock::time_point& begin,
+		const unsigned long long ioTime,
+		const std::streamoff beginOffset,
+		const std::streamoff recordOffset,
+		const std::size_t fields,
+		const std::size_t maxFieldLength,
+		const std::size_t quotedFields,
+		const std::size_t escapedQuotes,
+		const std::size_t commentLines);
 
 private:
   Reader(const Reader& reader);
@@ -0,0 +1,108 @@
+/**
+ * @file  Sampler.hpp
+ * @brief Samplerクラスヘッダーファイル
+ */
+#ifndef CSL_CSV_SAMPLER_HPP_
+#define CSL_CSV_SAMPLER_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <random>
+#include <string>
+#include <vector>
+#include "csl/csv/Config.hpp"
+#include "csl/csv/Dictionary.hpp"
+#include "csl/csv/LazyRecord.hpp"
+#include "csl/csv/Writer.hpp"
+
+namespace csl {
+namespace csv {
+
+/**
+ * @brief CSVデータから、指定された件数のCSVレコードを無作為に抽出します。
+ *
+ * sampleはCSVデータを1回読み込みながら、すべてのCSVレコードが等しい確率で選ばれるように抽出します(リザーバサンプリング)。
+ * 次に選ぶCSVレコードまでの件数を乱数で決めるため(Algorithm L)、選ばれなかったCSVレコードはフィールドを解釈しません。
+ * 層の列を設定した場合は、その列の値ごとに指定された件数ずつ抽出します。
+ *
+ * sampleApproximateはファイルの無作為なバイト位置に移動し、Splitter::alignで次のCSVレコードの境界を求めて読み込みます。
+ * ファイル全体を読み込まずに済みますが、直前のCSVレコードが長いほど選ばれやすくなるため、一様な抽出ではありません。
+ *
+ * 抽出したCSVレコードは、入力に現れた順(層の列を設定した場合は、層の値が最初に現れた順に層ごと)に並びます。
+ */
+class Sampler
+{
+public:
+  Sampler(const std::size_t sampleSize);
+
+public:
+  ~Sampler(void);
+
+public:
+  std::size_t getSampleSize(void) const;
+  void setSeed(const std::uint64_t seed);
+  std::uint64_t getSeed(void) const;
+  void setStratumColumn(const std::size_t column);
+  void clearStratumColumn(void);
+  bool isStratified(void) const;
+
+  void sample(std::istream& stream);
+  void sample(std::istream& stream, const Config& config);
+  void sample(const std::string& filepath);
+  void sample(const std::string& filepath, const Config& config);
+  void sampleApproximate(const std::string& filepath);
+  void sampleApproximate(const std::string& filepath, const Config& config);
+
+  std::uint64_t getRecordCount(void) const;
+  std::size_t size(void) const;
+  void getSample(std::vector<std::vector<std::string> >& csv) const;
+  void write(Writer& writer) const;
+  void clear(void);
+
+private:
+  /**
+   * @brief 抽出したCSVレコードです。
+   */
+  struct Entry
+  {
+    std::uint64_t position;            ///< 入力での順序
+    std::vector<std::string> record;   ///< CSVレコード
+  };
+
+  /**
+   * @brief 1つの層のリザーバです。
+   */
+  struct Reservoir
+  {
+    std::vector<Entry> entries;  ///< 抽出したCSVレコード
+    std::uint64_t seen;          ///< 読み込んだCSVレコードの数
+    std::uint64_t next;          ///< 次に選ぶCSVレコードの番号
+    double weight;               ///< Algorithm LのW
+  };
+
+private:
+  std::size_t sampleSize;
+  std::uint64_t seed;
+  std::mt19937_64 random;
+  bool stratified;
+  std::size_t stratumColumn;
+  std::uint64_t recordCount;
+  Dictionary strata;
+  std::vector<Reservoir> reservoirs;
+
+private:
+  void offer(Reservoir& reservoir, const LazyRecord& record);
+  void skip(Reservoir& reservoir);
+  double uniform(void);
+  void getRecords(std::vector<const Entry*>& entries) const;
+
+private:
+  Sampler(const Sampler& sampler);
+  Sampler& operator=(const Sampler& sampler);
+};
+
+} // namespace csv
+} // namespace csl
+
+#endif // #ifndef CSL_CSV_SAMPLER_HPP_
@@ -0,0 +1,51 @@
+/**
+ * @file  Scanner.hpp
+ * @brief Scannerクラスヘッダーファイル
+ */
+#ifndef CSL_CSV_SCANNER_HPP_
+#define CSL_CSV_SCANNER_HPP_
+
+#include <cstddef>
+#include "csl/csv/Automaton.hpp"
+#include "csl/csv/Config.hpp"
+
+namespace csl {
+namespace csv {
+
+/**
+ * @brief メモリ上のCSVデータからレコードの境界を走査します。
+ *
+ * フィールドの値は組み立てずに、Readerクラスの1回のreadで読み込まれる範囲(先頭のコメント行を含む)の終端だけを求めます。
+ * 構築後にConfigオブジェクトを変更しても、走査には反映されません。
+ */
+class Scanner
+{
+public:
+  Scanner(void);
+  Scanner(const Config& config);
+
+public:
+  ~Scanner(void);
+
+public:
+  std::size_t scan(const char* data, std::size_t begin, std::size_t end) const;
+  std::size_t scan(const char* data, std::size_t begin, std::size_t end, bool& quoteFlag) const;
+
+public:
+  /**
+   * @brief レコードの終端が見つからなかったことを表す値です。
+   */
+  static const std::size_t npos = static_cast<std::size_t>(-1);
+
+private:
+  Automaton automaton;
+
+private:
+  Scanner(const Scanner& scanner);
+  Scanner& operator=(const Scanner& scanner);
+};
+
+} // namespace csv
+} // namespace csl
+
+#endif // #ifndef CSL_CSV_SCANNER_HPP_
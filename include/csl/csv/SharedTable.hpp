@@ -0,0 +1,67 @@
+/**
+ * @file  SharedTable.hpp
+ * @brief SharedTableクラスヘッダーファイル
+ */
+#ifndef CSL_CSV_SHAREDTABLE_HPP_
+#define CSL_CSV_SHAREDTABLE_HPP_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "csl/csv/CachedTable.hpp"
+#include "csl/csv/Config.hpp"
+
+namespace csl {
+namespace csv {
+
+/**
+ * @brief POSIX共有メモリに公開したCSVデータを、複数のプロセスから読み取り専用で参照します。
+ *
+ * CSVデータはCachedTableのキャッシュファイルと同じポインタを含まない形式で、世代ごとの共有メモリセグメントに書き込みます。
+ * 書き込みが終わってから制御用セグメントの現在の世代を切り替えるため、参照するプロセスが書き込み途中のデータを見ることはありません。
+ * 参照するプロセスは構築時の世代をマップし続けます。新しい世代を参照するには、isLatestで確かめてから構築し直します。
+ * 名前は"/"で始まり、それ以外に"/"を含まない文字列です。
+ */
+class SharedTable : public CachedTable
+{
+public:
+  SharedTable(const std::string& name);
+
+public:
+  virtual ~SharedTable(void);
+
+public:
+  std::uint64_t getGeneration(void) const;
+  bool isLatest(void) const;
+
+public:
+  static std::uint64_t publish(const std::string& name,
+			       const std::vector<std::vector<std::string> >& csv);
+  static std::uint64_t publish(const std::string& name,
+			       const Config& config,
+			       const std::vector<std::vector<std::string> >& csv);
+  static std::uint64_t publish(const std::string& name,
+			       const std::string& filepath);
+  static std::uint64_t publish(const std::string& name,
+			       const std::string& filepath,
+			       const Config& config);
+  static void unlink(const std::string& name);
+
+private:
+  void* control;
+  std::uint64_t generation;
+
+private:
+  SharedTable(const SharedTable& table);
+  SharedTable& operator=(const SharedTable& table);
+};
+
+/**
+ * @brief 公開された世代を探し直す回数の上限です。
+ */
+constexpr int SHARED_ATTACH_RETRIES = 16;
+
+} // namespace csv
+} // namespace csl
+
+#endif // #ifndef CSL_CSV_SHAREDTABLE_HPP_
@@ -0,0 +1,115 @@
+/**
+ * @file  Sorter.hpp
+ * @brief Sorterクラスヘッダーファイル
+ */
+#ifndef CSL_CSV_SORTER_HPP_
+#define CSL_CSV_SORTER_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "csl/csv/Config.hpp"
+#include "csl/csv/KeyComparator.hpp"
+#include "csl/csv/TempFiles.hpp"
+#include "csl/csv/ThreadPool.hpp"
+
+namespace csl {
+namespace csv {
+
+/**
+ * @brief メモリに収まらないCSVデータを、指定された列をキーとして並べ替えます。
+ *
+ * 入力をメモリの上限まで読み込むごとに並べ替えて一時ファイルに書き出し、最後に敗者木で併合して出力します。
+ * 入力がメモリの上限に収まる場合は一時ファイルを使いません。
+ * キーが等しいCSVレコードは入力の順序を保ちます。キーの列がないCSVレコードは、その列を空文字列として比較します。
+ */
+class Sorter
+{
+public:
+  /**
+   * @brief キーの比較方法です。
+   */
+  typedef KeyComparator::Collation Collation;
+
+  static constexpr Collation COLLATION_STRING = KeyComparator::COLLATION_STRING;   ///< バイト列として比較する
+  static constexpr Collation COLLATION_NUMERIC = KeyComparator::COLLATION_NUMERIC; ///< 数値として比較する
+
+public:
+  Sorter(void);
+
+public:
+  ~Sorter(void);
+
+public:
+  void addKey(const std::size_t column, const Collation collation);
+  void clearKeys(void);
+  void setMemoryLimit(const std::size_t memoryLimit);
+  std::size_t getMemoryLimit(void) const;
+  void setTempDirectory(const std::string& tempDirectory);
+  const std::string& getTempDirectory(void) const;
+  void setThreadCount(const std::size_t threadCount);
+  std::size_t getThreadCount(void) const;
+  std::size_t getRunCount(void) const;
+
+  void sort(std::istream& in, std::ostream& out);
+  void sort(std::istream& in, const Config& config, std::ostream& out);
+  void sort(const std::string& inpath, const std::string& outpath);
+  void sort(const std::string& inpath, const Config& config, const std::string& outpath);
+
+private:
+  /**
+   * @brief 並べ替えるCSVレコードの、先頭のキーから作った整数と番号です。
+   */
+  struct Entry
+  {
+    std::uint64_t prefix;  ///< 先頭のキーの順序を保つ整数
+    std::uint64_t index;   ///< ランの中でのCSVレコードの番号
+  };
+
+private:
+  KeyComparator comparator;
+  std::size_t memoryLimit;
+  std::string tempDirectory;
+  std::size_t threadCount;
+  std::size_t runCount;
+
+private:
+  int compare(const std::vector<std::string>& a, const std::vector<std::string>& b) const;
+  std::uint64_t getPrefix(const std::vector<std::string>& record) const;
+  void sortRun(const std::vector<std::vector<std::string> >& records,
+	       std::vector<Entry>& entries,
+	       ThreadPool& pool) const;
+  void sortRange(const std::vector<std::vector<std::string> >& records,
+		 Entry* first,
+		 Entry* last) const;
+  void spill(const std::vector<std::vector<std::string> >& records,
+	     const std::vector<Entry>& entries,
+	     const std::uint64_t sequence,
+	     TempFiles& runs);
+  void merge(const std::vector<std::string>& runs,
+	     const Config& config,
+	     std::ostream& out,
+	     const bool final) const;
+
+private:
+  Sorter(const Sorter& sorter);
+  Sorter& operator=(const Sorter& sorter);
+};
+
+/**
+ * @brief デフォルトのメモリの上限(バイト数)です。
+ */
+constexpr std::size_t SORT_MEMORY_LIMIT = 256 * 1024 * 1024;
+
+/**
+ * @brief 1回の併合で開く一時ファイルの数の上限です。
+ */
+constexpr std::size_t SORT_MERGE_WAYS = 64;
+
+} // namespace csv
+} // namespace csl
+
+#endif // #ifndef CSL_CSV_SORTER_HPP_
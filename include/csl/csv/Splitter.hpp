@@ -0,0 +1,66 @@
+/**
+ * @file  Splitter.hpp
+ * @brief Splitterクラスヘッダーファイル
+ */
+#ifndef CSL_CSV_SPLITTER_HPP_
+#define CSL_CSV_SPLITTER_HPP_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <istream>
+#include "csl/csv/Config.hpp"
+#include "csl/csv/Range.hpp"
+
+namespace csl {
+namespace csv {
+
+/**
+ * @brief CSV形式ファイルをCSVレコードの境界で複数の範囲に分割します。
+ *
+ * 分割した範囲はそれぞれReaderクラスで独立して読み込めます。
+ */
+class Splitter
+{
+public:
+  static void plan(std::istream& stream,
+		   const std::size_t count,
+		   std::vector<Range>& ranges);
+  static void plan(std::istream& stream,
+		   const Config& config,
+		   const std::size_t count,
+		   std::vector<Range>& ranges);
+  static void plan(const std::string& filepath,
+		   const std::size_t count,
+		   std::vector<Range>& ranges);
+  static void plan(const std::string& filepath,
+		   const Config& config,
+		   const std::size_t count,
+		   std::vector<Range>& ranges);
+
+  static std::streamoff align(std::istream& stream,
+			      const Config& config,
+			      const std::streamoff origin,
+			      const std::streamoff offset);
+  static std::streamoff align(std::istream& stream,
+			      const Config& config,
+			      const std::streamoff origin,
+			      const std::streamoff offset,
+			      const std::streamoff lookahead);
+
+private:
+  Splitter(void);
+  ~Splitter(void);
+  Splitter(const Splitter& splitter);
+  Splitter& operator=(const Splitter& splitter);
+};
+
+/**
+ * @brief CSVレコードの境界を推測するときに前後を先読みするバイト数です。
+ */
+constexpr std::streamoff SPLIT_LOOKAHEAD = 64 * 1024;
+
+} // namespace csv
+} // namespace csl
+
+#endif // #ifndef CSL_CSV_SPLITTER_HPP_
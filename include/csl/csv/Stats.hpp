@@ -0,0 +1,67 @@
+/**
+ * @file  Stats.hpp
+ * @brief Statsクラスヘッダーファイル
+ */
+#ifndef CSL_CSV_STATS_HPP_
+#define CSL_CSV_STATS_HPP_
+
+#include <cstddef>
+#include <string>
+
+namespace csl {
+namespace csv {
+
+class Reader;
+class Writer;
+
+/**
+ * @brief Reader、Writer、Utilが読み書きしたCSVデータの統計情報です。
+ *
+ * ReaderとWriterはsetStatsで設定された場合だけ値を加算し、設定されていない場合の処理は変わりません。
+ * 時間はナノ秒単位で、入出力の待ち時間と、それ以外の解析(書き込みの場合は整形)の時間に分けて加算します。
+ * 入出力の待ち時間は、Statsオブジェクトを受け取るUtilのload、saveで計測します。
+ */
+class Stats
+{
+public:
+  Stats(void);
+
+public:
+  ~Stats(void);
+
+public:
+  void reset(void);
+  unsigned long long getBytes(void) const;
+  std::size_t getRecords(void) const;
+  std::size_t getFields(void) const;
+  std::size_t getQuotedFields(void) const;
+  std::size_t getEscapedQuotes(void) const;
+  std::size_t getCommentLines(void) const;
+  std::size_t getMaxFieldLength(void) const;
+  std::size_t getMaxRecordLength(void) const;
+  unsigned long long getIoTime(void) const;
+  unsigned long long getParseTime(void) const;
+  void addIoTime(const unsigned long long nanoseconds);
+  std::string toJson(void) const;
+
+private:
+  unsigned long long bytes;
+  std::size_t records;
+  std::size_t fields;
+  std::size_t quotedFields;
+  std::size_t escapedQuotes;
+  std::size_t commentLines;
+  std::size_t maxFieldLength;
+  std::size_t maxRecordLength;
+  unsigned long long ioTime;
+  unsigned long long parseTime;
+
+private:
+  friend class Reader;
+  friend class Writer;
+};
+
+} // namespace csv
+} // namespace csl
+
+#endif // #ifndef CSL_CSV_STATS_HPP_
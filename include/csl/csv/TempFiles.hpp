@@ -0,0 +1,58 @@
+/**
+ * @file  TempFiles.hpp
+ * @brief TempFilesクラスヘッダーファイル
+ */
+#ifndef CSL_CSV_TEMPFILES_HPP_
+#define CSL_CSV_TEMPFILES_HPP_
+
+#include <cstddef>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace csl {
+namespace csv {
+
+/**
+ * @brief メモリに収まらないCSVデータを書き出す一時ファイルの集まりです。
+ *
+ * 作った一時ファイルは、削除しなかったものも含めて破棄するときにすべて削除します。
+ * Writerは囲み文字をエスケープしないため、一時ファイルにはCSV形式ではなく、フィールドの長さを前に置いた形式でCSVレコードを書き込みます。
+ */
+class TempFiles
+{
+public:
+  TempFiles(const std::string& directory);
+
+public:
+  ~TempFiles(void);
+
+public:
+  std::string create(void);
+  void remove(const std::string& path);
+  const std::vector<std::string>& getPaths(void) const;
+
+public:
+  static void write(std::ostream& stream, const std::vector<std::string>& record);
+  static bool read(std::istream& stream, std::vector<std::string>& record);
+  static std::size_t getRecordBytes(const std::vector<std::string>& record);
+
+private:
+  std::string directory;
+  std::vector<std::string> paths;
+
+private:
+  TempFiles(const TempFiles& files);
+  TempFiles& operator=(const TempFiles& files);
+};
+
+/**
+ * @brief 一時ファイルの読み書きに使うバッファのバイト数です。
+ */
+constexpr std::size_t TEMP_BUFFER_SIZE = 64 * 1024;
+
+} // namespace csv
+} // namespace csl
+
+#endif // #ifndef CSL_CSV_TEMPFILES_HPP_
@@ -0,0 +1,76 @@
+/**
+ * @file  ThreadPool.hpp
+ * @brief ThreadPoolクラスヘッダーファイル
+ */
+#ifndef CSL_CSV_THREAD_POOL_HPP_
+#define CSL_CSV_THREAD_POOL_HPP_
+
+#include <cstddef>
+#include <deque>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <exception>
+
+namespace csl {
+namespace csv {
+
+/**
+ * @brief ワークスティーリングでタスクを実行するスレッドプールです。
+ *
+ * スレッドごとにタスクのキューを持ち、自分のキューが空になると他のスレッドのキューからタスクを奪って実行します。
+ */
+class ThreadPool
+{
+public:
+  /**
+   * @brief タスクの型です。
+   */
+  typedef std::function<void (void)> Task;
+
+public:
+  ThreadPool(void);
+  ThreadPool(const std::size_t size);
+
+public:
+  ~ThreadPool(void);
+
+public:
+  void submit(const Task& task);
+  void wait(void);
+  std::size_t getSize(void) const;
+
+private:
+  struct Queue {
+    std::mutex mutex;
+    std::deque<Task> tasks;
+  };
+
+private:
+  std::vector<Queue*> queues;
+  std::vector<std::thread> threads;
+  std::mutex mutex;
+  std::condition_variable taskCondition;
+  std::condition_variable doneCondition;
+  std::size_t queued;
+  std::size_t pending;
+  std::size_t nextQueue;
+  bool stopFlag;
+  std::exception_ptr exception;
+
+private:
+  void start(const std::size_t size);
+  void run(const std::size_t index);
+  bool pop(const std::size_t index, Task& task);
+
+private:
+  ThreadPool(const ThreadPool& threadPool);
+  ThreadPool& operator=(const ThreadPool& threadPool);
+};
+
+} // namespace csv
+} // namespace csl
+
+#endif // #ifndef CSL_CSV_THREAD_POOL_HPP_
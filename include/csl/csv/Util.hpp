@@ -5,30 +5,118 @@
 #ifndef CSL_CSV_UTIL_HPP_
 #define CSL_CSV_UTIL_HPP_
 
+#include <cstddef>
 #include <string>
 #include <vector>
 #include <istream>
 #include <ostream>
+#include <functional>
+#if __cplusplus >= 201703L
+#include <memory_resource>
+#endif
 #include "csl/csv/Config.hpp"
+#include "csl/csv/EncodedTable.hpp"
+#include "csl/csv/Filter.hpp"
+#include "csl/csv/Stats.hpp"
+#include "csl/csv/ThreadPool.hpp"
 
 namespace csl {
 namespace csv {
 
 /**
- * @brief CSV形式ファイルの入出力ユーティリティーを提供します。
+ * @brief CSV形式ファイルの入出力ユーティリティーと、フィールドを解釈する関数を提供します。
  */
 class Util 
 {
 public:
+  /**
+   * @brief loadManyで読み込み終えたファイルごとに呼び出される関数の型です。引数はファイルの番号とCSVデータです。
+   */
+  typedef std::function<void (std::size_t, std::vector<std::vector<std::string> >&)> LoadCallback;
+
+public:
+  static void load(std::istream& stream,
+		   std::vector<std::vector<std::string> >& csv);
+  static void load(std::istream& stream,
+		   const Config& config,
+		   std::vector<std::vector<std::string> >& csv);
+  static void load(const std::string& filepath,
+		   std::vector<std::vector<std::string> >& csv);
+  static void load(const std::string& filepath,
+		   const Config& config,
+		   std::vector<std::vector<std::string> >& csv);
+  static void load(std::istream& stream,
+		   const Config& config,
+		   std::vector<std::vector<std::string> >& csv,
+		   Stats& stats);
+  static void load(const std::string& filepath,
+		   const Config& config,
+		   std::vector<std::vector<std::string> >& csv,
+		   Stats& stats);
+#if __cplusplus >= 201703L
+  static void load(std::istream& stream,
+		   std::pmr::vector<std::pmr::vector<std::pmr::string> >& csv);
+  static void load(std::istream& stream,
+		   const Config& config,
+		   std::pmr::vector<std::pmr::vector<std::pmr::string> >& csv);
+  static void load(const std::string& filepath,
+		   std::pmr::vector<std::pmr::vector<std::pmr::string> >& csv);
+  static void load(const std::string& filepath,
+		   const Config& config,
+		   std::pmr::vector<std::pmr::vector<std::pmr::string> >& csv);
+#endif
+  static void load(std::istream& stream,
+		   EncodedTable& table);
   static void load(std::istream& stream,
+		   const Config& config,
+		   EncodedTable& table);
+  static void load(const std::string& filepath,
+		   EncodedTable& table);
+  static void load(const std::string& filepath,
+		   const Config& config,
+		   EncodedTable& table);
+  static void load(std::istream& stream,
+		   const Filter& filter,
 		   std::vector<std::vector<std::string> >& csv);
   static void load(std::istream& stream,
 		   const Config& config,
+		   const Filter& filter,
 		   std::vector<std::vector<std::string> >& csv);
   static void load(const std::string& filepath,
+		   const Filter& filter,
 		   std::vector<std::vector<std::string> >& csv);
   static void load(const std::string& filepath,
 		   const Config& config,
+		   const Filter& filter,
+		   std::vector<std::vector<std::string> >& csv);
+
+  static void loadMany(const std::vector<std::string>& filepaths,
+		       std::vector<std::vector<std::vector<std::string> > >& csvs);
+  static void loadMany(const std::vector<std::string>& filepaths,
+		       const Config& config,
+		       std::vector<std::vector<std::vector<std::string> > >& csvs);
+  static void loadMany(const std::vector<std::string>& filepaths,
+		       const Config& config,
+		       ThreadPool& pool,
+		       std::vector<std::vector<std::vector<std::string> > >& csvs);
+  static void loadMany(const std::vector<std::string>& filepaths,
+		       const Config& config,
+		       ThreadPool& pool,
+		       const LoadCallback& callback);
+
+  static void tail(std::istream& stream,
+		   const std::size_t count,
+		   std::vector<std::vector<std::string> >& csv);
+  static void tail(std::istream& stream,
+		   const Config& config,
+		   const std::size_t count,
+		   std::vector<std::vector<std::string> >& csv);
+  static void tail(const std::string& filepath,
+		   const std::size_t count,
+		   std::vector<std::vector<std::string> >& csv);
+  static void tail(const std::string& filepath,
+		   const Config& config,
+		   const std::size_t count,
 		   std::vector<std::vector<std::string> >& csv);
 
   static void save(std::ostream& stream,
@@ -41,6 +129,17 @@ public:
   static void save(const std::string& filepath,
 		   const Config& config,
 		   const std::vector<std::vector<std::string> >& csv);
+  static void save(std::ostream& stream,
+		   const Config& config,
+		   const std::vector<std::vector<std::string> >& csv,
+		   Stats& stats);
+  static void save(const std::string& filepath,
+		   const Config& config,
+		   const std::vector<std::vector<std::string> >& csv,
+		   Stats& stats);
+
+public:
+  static bool parseNumber(const char* data, const std::size_t size, double& number);
   
 private:
   Util(void);
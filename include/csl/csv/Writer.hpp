@@ -9,6 +9,7 @@
 #include <vector>
 #include <ostream>
 #include "csl/csv/Config.hpp"
+#include "csl/csv/Stats.hpp"
 
 namespace csl {
 namespace csv {
@@ -27,10 +28,12 @@ public:
   
 public:
   void write(const std::vector<std::string>& record);
+  void setStats(Stats* stats);
 
 private:
   std::ostream& stream;
   const Config& config;
+  Stats* stats;
   
 private:
   Writer(const Writer& writer);
@@ -0,0 +1,427 @@
+/**
+ * @file  Aggregator.cpp
+ * @brief Aggregatorクラス実装ファイル
+ */
+#include "csl/csv/Aggregator.hpp"
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <ios>
+#include <sys/stat.h>
+#include "csl/csv/Reader.hpp"
+#include "csl/csv/Splitter.hpp"
+#include "csl/csv/ThreadPool.hpp"
+#include "csl/csv/Util.hpp"
+
+namespace csl {
+namespace csv {
+
+namespace {
+
+/**
+ * @brief 集計値を文字列にして返します。
+ *
+ * 整数の値は小数点なしで、それ以外は元の値に戻せる最短の桁数で表します。
+ * @param number 集計値
+ * @return 文字列
+ */
+std::string formatNumber(const double number)
+{
+  char buffer[32];
+
+  if (number == 0.0) {
+    return "0";
+  }
+
+  if (std::floor(number) == number && std::fabs(number) < 1e15) {
+    std::snprintf(buffer, sizeof(buffer), "%.0f", number);
+    return buffer;
+  }
+
+  std::snprintf(buffer, sizeof(buffer), "%.15g", number);
+  if (std::strtod(buffer, NULL) != number) {
+    std::snprintf(buffer, sizeof(buffer), "%.17g", number);
+  }
+  return buffer;
+}
+
+} // namespace
+
+/**
+ * @brief グループの列も集計関数もないAggregatorオブジェクトを構築します。
+ *
+ * グループの列がない場合は、すべてのCSVレコードを1つのグループに集計します。スレッド数は1です。
+ */
+Aggregator::Aggregator(void)
+  : threadCount(1)
+{
+}
+
+/**
+ * @brief Aggregatorオブジェクトを破棄します。
+ */
+Aggregator::~Aggregator(void)
+{
+}
+
+/**
+ * @brief グループのキーにする列を追加し、それまでの集計結果を破棄します。
+ * @param column 列の番号
+ */
+void Aggregator::addGroup(const std::size_t column)
+{
+  columns.push_back(column);
+  clear();
+}
+
+/**
+ * @brief 集計関数を追加し、それまでの集計結果を破棄します。
+ *
+ * FUNCTION_COUNTは列に関係なくCSVレコードの数を数えます。
+ * それ以外の集計関数は、数値として解釈できない値と列がないCSVレコードを無視します。
+ * @param function 集計関数
+ * @param column 列の番号
+ */
+void Aggregator::addAggregate(const Function function, const std::size_t column)
+{
+  Aggregate aggregate;
+  aggregate.function = function;
+  aggregate.column = column;
+  aggregates.push_back(aggregate);
+  clear();
+}
+
+/**
+ * @brief ファイルを集計するスレッド数を設定します。
+ *
+ * 入力ストリームは常に1つのスレッドで集計します。
+ * @param threadCount スレッド数(0の場合は1)
+ */
+void Aggregator::setThreadCount(const std::size_t threadCount)
+{
+  this->threadCount = (threadCount > 0) ? threadCount : 1;
+}
+
+/**
+ * @brief ファイルを集計するスレッド数を返します。
+ * @return スレッド数
+ */
+std::size_t Aggregator::getThreadCount(void) const
+{
+  return threadCount;
+}
+
+/**
+ * @brief デフォルトのConfigオブジェクトの設定に従って、入力ストリームのCSVデータを集計します。
+ *
+ * 集計結果はclearを呼び出すまで加算し続けます。
+ * @param stream 入力ストリーム
+ * @exception std::ios_base::failure 入力ストリームにエラーが発生した場合
+ */
+void Aggregator::aggregate(std::istream& stream)
+{
+  aggregate(stream, DEFAULT_CONFIG);
+}
+
+/**
+ * @brief 指定されたConfigオブジェクトの設定に従って、入力ストリームのCSVデータを集計します。
+ *
+ * 集計結果はclearを呼び出すまで加算し続けます。
+ * @param stream 入力ストリーム
+ * @param config Configオブジェクト
+ * @exception std::ios_base::failure 入力ストリームにエラーが発生した場合
+ */
+void Aggregator::aggregate(std::istream& stream, const Config& config)
+{
+  Reader reader(stream, config);
+  LazyRecord record;
+  std::string key;
+
+  while (reader.hasNext()) {
+    reader.read(record);
+    add(table, record, key);
+  }
+}
+
+/**
+ * @brief デフォルトのConfigオブジェクトの設定に従って、ファイルのCSVデータを集計します。
+ * @param filepath ファイルパス
+ * @exception std::ios_base::failure 入力ストリームにエラーが発生した場合
+ */
+void Aggregator::aggregate(const std::string& filepath)
+{
+  aggregate(filepath, DEFAULT_CONFIG);
+}
+
+/**
+ * @brief 指定されたConfigオブジェクトの設定に従って、ファイルのCSVデータを集計します。
+ *
+ * スレッド数が2以上の場合は、ファイルをスレッド数の範囲に分けて並列に集計します。
+ * 集計結果は1つのスレッドで集計した場合と同じです(合計の丸め誤差を除く)。
+ * @param filepath ファイルパス
+ * @param config Configオブジェクト
+ * @exception std::ios_base::failure 入力ストリームにエラーが発生した場合
+ */
+void Aggregator::aggregate(const std::string& filepath, const Config& config)
+{
+  struct stat st;
+  if (stat(filepath.c_str(), &st) != 0 || !S_ISREG(st.st_mode)) {
+    throw std::ios_base::failure("Failed to open file for reading: " + filepath);
+  }
+
+  if (threadCount == 1) {
+    std::ifstream stream(filepath.c_str(), std::ifstream::binary);
+
+    if (!stream.is_open()) {
+      throw std::ios_base::failure("Failed to open file for reading: " + filepath);
+    }
+
+    try {
+      aggregate(stream, config);
+    } catch (...) {
+      stream.close();
+      throw;
+    }
+
+    stream.close();
+    return;
+  }
+
+  std::vector<Range> ranges;
+  Splitter::plan(filepath, config, threadCount, ranges);
+
+  std::vector<Table> partials(ranges.size());
+  ThreadPool pool(threadCount);
+
+  for (std::size_t i = 0; i < ranges.size(); i++) {
+    pool.submit([this, &filepath, &config, &ranges, &partials, i]() {
+	std::ifstream stream(filepath.c_str(), std::ifstream::binary);
+
+	if (!stream.is_open()) {
+	  throw std::ios_base::failure("Failed to open file for reading: " + filepath);
+	}
+
+	Reader reader(stream, config, ranges[i]);
+	LazyRecord record;
+	std::string key;
+
+	while (reader.hasNext()) {
+	  reader.read(record);
+	  add(partials[i], record, key);
+	}
+      });
+  }
+  pool.wait();
+
+  // merge in range order so that groups keep the order of first appearance
+  for (std::size_t i = 0; i < partials.size(); i++) {
+    merge(partials[i]);
+  }
+}
+
+/**
+ * @brief グループの数を返します。
+ * @return グループの数
+ */
+std::size_t Aggregator::size(void) const
+{
+  return table.groups.size();
+}
+
+/**
+ * @brief 集計結果を、グループごとに1つのCSVレコードにして返します。
+ *
+ * CSVレコードはグループのキーの列に続けて、追加した順の集計値を並べます。
+ * 数値がなかったグループの最小値と最大値は空文字列です。
+ * @param csv CSVデータ
+ */
+void Aggregator::getResult(std::vector<std::vector<std::string> >& csv) const
+{
+  csv.resize(table.groups.size());
+  for (std::size_t i = 0; i < csv.size(); i++) {
+    getRecord(i, csv[i]);
+  }
+}
+
+/**
+ * @brief 集計結果を、グループごとに1つのCSVレコードにして書き込みます。
+ * @param writer Writerオブジェクト
+ * @exception std::ios_base::failure 出力ストリームにエラーが発生した場合
+ */
+void Aggregator::write(Writer& writer) const
+{
+  std::vector<std::string> record;
+
+  for (std::size_t i = 0; i < table.groups.size(); i++) {
+    getRecord(i, record);
+    writer.write(record);
+  }
+}
+
+/**
+ * @brief 集計結果を破棄します。グループの列と集計関数は残します。
+ */
+void Aggregator::clear(void)
+{
+  table.groups.clear();
+  table.values.clear();
+}
+
+/**
+ * @brief 1つのCSVレコードを指定されたハッシュ表に集計します。
+ *
+ * 囲み文字のないフィールドは読み込んだままのデータを使い、文字列を作りません。
+ * @param table ハッシュ表
+ * @param record CSVレコード
+ * @param key グループのキーを作るための作業用の文字列
+ */
+void Aggregator::add(Table& table, const LazyRecord& record, std::string& key) const
+{
+  if (record.size() == 0) {
+    return;
+  }
+
+  // each column is stored as a 32-bit length followed by the bytes
+  key.clear();
+  for (std::size_t i = 0; i < columns.size(); i++) {
+    const char* data = "";
+    std::uint32_t size = 0;
+
+    if (columns[i] < record.size()) {
+      if (record.isQuoted(columns[i])) {
+	const std::string& value = record.get(columns[i]);
+	data = value.data();
+	size = static_cast<std::uint32_t>(value.size());
+      } else {
+	data = record.getRawData(columns[i]);
+	size = static_cast<std::uint32_t>(record.getRawSize(columns[i]));
+      }
+    }
+    key.append(reinterpret_cast<const char*>(&size), sizeof(size));
+    key.append(data, size);
+  }
+
+  const std::size_t count = table.groups.size();
+  const std::size_t group = table.groups.intern(key);
+
+  if (group == count) {
+    for (std::size_t i = 0; i < aggregates.size(); i++) {
+      const bool extreme = aggregates[i].function == FUNCTION_MIN || aggregates[i].function == FUNCTION_MAX;
+      table.values.push_back(extreme ? NAN : 0.0);
+    }
+  }
+
+  double* values = table.values.data() + group * aggregates.size();
+  for (std::size_t i = 0; i < aggregates.size(); i++) {
+    const std::size_t column = aggregates[i].column;
+    double number;
+
+    if (aggregates[i].function == FUNCTION_COUNT) {
+      values[i] += 1;
+      continue;
+    }
+
+    if (column >= record.size()) {
+      continue;
+    }
+    if (record.isQuoted(column)) {
+      const std::string& value = record.get(column);
+      if (!Util::parseNumber(value.data(), value.size(), number)) {
+	continue;
+      }
+    } else if (!Util::parseNumber(record.getRawData(column), record.getRawSize(column), number)) {
+      continue;
+    }
+
+    switch (aggregates[i].function) {
+    case FUNCTION_SUM:
+      values[i] += number;
+      break;
+    case FUNCTION_MIN:
+      if (std::isnan(values[i]) || number < values[i]) {
+	values[i] = number;
+      }
+      break;
+    case FUNCTION_MAX:
+      if (std::isnan(values[i]) || number > values[i]) {
+	values[i] = number;
+      }
+      break;
+    default:
+      break;
+    }
+  }
+}
+
+/**
+ * @brief 別のハッシュ表の集計値を併合します。
+ *
+ * 新しいグループは、別のハッシュ表での順に追加します。
+ * @param source 別のハッシュ表
+ */
+void Aggregator::merge(const Table& source)
+{
+  const std::size_t width = aggregates.size();
+
+  for (std::size_t i = 0; i < source.groups.size(); i++) {
+    const std::size_t count = table.groups.size();
+    const std::size_t group = table.groups.intern(source.groups.get(static_cast<std::uint32_t>(i)));
+    const double* from = source.values.data() + i * width;
+
+    if (group == count) {
+      table.values.insert(table.values.end(), from, from + width);
+      continue;
+    }
+
+    double* to = table.values.data() + group * width;
+    for (std::size_t j = 0; j < width; j++) {
+      switch (aggregates[j].function) {
+      case FUNCTION_COUNT:
+      case FUNCTION_SUM:
+	to[j] += from[j];
+	break;
+      case FUNCTION_MIN:
+	if (std::isnan(to[j]) || from[j] < to[j]) {
+	  to[j] = from[j];
+	}
+	break;
+      case FUNCTION_MAX:
+	if (std::isnan(to[j]) || from[j] > to[j]) {
+	  to[j] = from[j];
+	}
+	break;
+      }
+    }
+  }
+}
+
+/**
+ * @brief 指定されたグループの集計結果をCSVレコードにして返します。
+ * @param group グループの番号
+ * @param record CSVレコード
+ */
+void Aggregator::getRecord(const std::size_t group, std::vector<std::string>& record) const
+{
+  const std::string& key = table.groups.get(static_cast<std::uint32_t>(group));
+  const double* values = table.values.data() + group * aggregates.size();
+  std::size_t position = 0;
+
+  record.resize(columns.size() + aggregates.size());
+  for (std::size_t i = 0; i < columns.size(); i++) {
+    std::uint32_t size;
+    std::memcpy(&size, key.data() + position, sizeof(size));
+    position += sizeof(size);
+    record[i].assign(key, position, size);
+    position += size;
+  }
+
+  for (std::size_t i = 0; i < aggregates.size(); i++) {
+    record[columns.size() + i] = std::isnan(values[i]) ? std::string() : formatNumber(values[i]);
+  }
+}
+
+} // namespace csv
+} // namespace csl
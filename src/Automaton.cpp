@@ -0,0 +1,110 @@
+/**
+ * @file  Automaton.cpp
+ * @brief Automatonクラス実装ファイル
+ */
+#include "csl/csv/Automaton.hpp"
+
+namespace csl {
+namespace csv {
+
+namespace {
+
+/**
+ * @brief 状態と文字の種類ごとの遷移です。
+ *
+ * 行は状態、列は文字の種類(その他、区切り文字、囲み文字、CR、LF)の順です。
+ */
+const Automaton::Transition TRANSITIONS[AUTOMATON_STATES][AUTOMATON_CLASSES] = {
+  { // STATE_NORMAL
+    { Automaton::STATE_NORMAL, Automaton::ACTION_APPEND },
+    { Automaton::STATE_NORMAL, Automaton::ACTION_END_FIELD },
+    { Automaton::STATE_QUOTE, Automaton::ACTION_QUOTED },
+    { Automaton::STATE_AFTER_CR, 0 },
+    { Automaton::STATE_NORMAL, Automaton::ACTION_APPEND | Automaton::ACTION_LINE_BREAK },
+  },
+  { // STATE_QUOTE
+    { Automaton::STATE_QUOTE, Automaton::ACTION_APPEND },
+    { Automaton::STATE_QUOTE, Automaton::ACTION_APPEND },
+    { Automaton::STATE_ESCAPE, 0 },
+    { Automaton::STATE_QUOTE, Automaton::ACTION_APPEND | Automaton::ACTION_LINE_BREAK },
+    { Automaton::STATE_QUOTE, Automaton::ACTION_APPEND | Automaton::ACTION_LINE_BREAK },
+  },
+  { // STATE_ESCAPE
+    { Automaton::STATE_NORMAL, Automaton::ACTION_APPEND },
+    { Automaton::STATE_NORMAL, Automaton::ACTION_END_FIELD },
+    { Automaton::STATE_QUOTE, Automaton::ACTION_APPEND | Automaton::ACTION_ESCAPED },
+    { Automaton::STATE_AFTER_CR, 0 },
+    { Automaton::STATE_NORMAL, Automaton::ACTION_APPEND | Automaton::ACTION_LINE_BREAK },
+  },
+  { // STATE_AFTER_CR
+    { Automaton::STATE_NORMAL,
+      Automaton::ACTION_APPEND_CR | Automaton::ACTION_APPEND | Automaton::ACTION_LINE_BREAK },
+    { Automaton::STATE_NORMAL,
+      Automaton::ACTION_APPEND_CR | Automaton::ACTION_END_FIELD | Automaton::ACTION_LINE_BREAK },
+    { Automaton::STATE_QUOTE,
+      Automaton::ACTION_APPEND_CR | Automaton::ACTION_QUOTED | Automaton::ACTION_LINE_BREAK },
+    { Automaton::STATE_AFTER_CR, Automaton::ACTION_APPEND_CR | Automaton::ACTION_LINE_BREAK },
+    { Automaton::STATE_NORMAL, Automaton::ACTION_END_RECORD },
+  },
+};
+
+} // namespace
+
+/**
+ * @brief デフォルトのConfigオブジェクトから表を作って、Automatonオブジェクトを構築します。
+ */
+Automaton::Automaton(void)
+{
+  compile(DEFAULT_CONFIG);
+}
+
+/**
+ * @brief 指定されたConfigオブジェクトから表を作って、Automatonオブジェクトを構築します。
+ * @param config Configオブジェクト
+ */
+Automaton::Automaton(const Config& config)
+{
+  compile(config);
+}
+
+/**
+ * @brief Automatonオブジェクトを破棄します。
+ */
+Automaton::~Automaton(void)
+{
+}
+
+/**
+ * @brief 指定されたConfigオブジェクトから表を作り直します。
+ *
+ * 囲み文字が無効な場合は、囲み文字をその他の文字として扱います。
+ * コメント行は行の先頭でしか意味を持たないため、遷移の表には含めず、コメント文字だけを保持します。
+ * 遷移の表は文字の種類の表で区切り文字などの違いを吸収するため、どのConfigオブジェクトでも同じ内容です。
+ * @param config Configオブジェクト
+ */
+void Automaton::compile(const Config& config)
+{
+  for (std::size_t i = 0; i < sizeof(classes); i++) {
+    classes[i] = CLASS_OTHER;
+  }
+  classes[static_cast<unsigned char>('\r')] = CLASS_CR;
+  classes[static_cast<unsigned char>('\n')] = CLASS_LF;
+  if (config.getQuoteEnabled()) {
+    classes[static_cast<unsigned char>(config.getQuoteMark())] = CLASS_QUOTE;
+  }
+  classes[static_cast<unsigned char>(config.getDelimitMark())] = CLASS_DELIMIT;
+
+  for (std::size_t state = 0; state < AUTOMATON_STATES; state++) {
+    for (std::size_t c = 0; c < AUTOMATON_CLASSES; c++) {
+      transitions[state][c] = TRANSITIONS[state][c];
+    }
+  }
+
+  commentEnabled = config.getCommentEnabled();
+  commentMark = config.getCommentMark();
+  quoteEnabled = config.getQuoteEnabled();
+  quoteMark = config.getQuoteMark();
+}
+
+} // namespace csv
+} // namespace csl
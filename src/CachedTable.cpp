@@ -0,0 +1,920 @@
+/**
+ * @file  CachedTable.cpp
+ * @brief CachedTableクラス実装ファイル
+ */
+#include "csl/csv/CachedTable.hpp"
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <ios>
+#include <stdexcept>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "csl/csv/Hash.hpp"
+#include "csl/csv/Util.hpp"
+
+namespace csl {
+namespace csv {
+
+namespace {
+
+/**
+ * @brief キャッシュファイルの先頭に置く識別子です。
+ */
+const char CACHE_MAGIC[8] = {'C', 'S', 'L', 'C', 'S', 'V', 'C', '\0'};
+
+/**
+ * @brief バイト順を確かめるための値です。
+ */
+const std::uint32_t CACHE_BYTE_ORDER = 0x01020304u;
+
+/**
+ * @brief 文字列の列を表す値です。
+ */
+const std::uint32_t COLUMN_STRING = 0;
+
+/**
+ * @brief 64ビット整数の列を表す値です。
+ */
+const std::uint32_t COLUMN_INTEGER = 1;
+
+/**
+ * @brief 元のファイルのハッシュ値を求めるときに一度に読み込むバイト数です。
+ */
+const std::size_t HASH_BLOCK_SIZE = 64 * 1024;
+
+/**
+ * @brief キャッシュファイルのヘッダーです。
+ */
+struct CacheHeader
+{
+  char magic[8];                ///< 識別子
+  std::uint32_t version;        ///< 形式のバージョン
+  std::uint32_t byteOrder;      ///< バイト順を確かめるための値
+  std::uint64_t sourceSize;     ///< 元のファイルのバイト数
+  std::int64_t sourceMtime;     ///< 元のファイルの更新時刻(秒)
+  std::int64_t sourceMtimeNsec; ///< 元のファイルの更新時刻(ナノ秒)
+  std::uint64_t sourceHash;     ///< 元のファイルのハッシュ値
+  std::uint64_t rowCount;       ///< CSVレコードの数
+  std::uint64_t columnCount;    ///< 列の数
+  char delimitMark;             ///< 区切り文字
+  char quoteEnabled;            ///< 囲み文字を有効にしたかどうか
+  char quoteMark;               ///< 囲み文字
+  char commentEnabled;          ///< コメント行を有効にしたかどうか
+  char commentMark;             ///< コメント文字
+  char reserved[3];             ///< 予約
+};
+
+/**
+ * @brief キャッシュファイルの列の目録です。
+ */
+struct CacheColumn
+{
+  std::uint32_t type;      ///< 列の種類
+  std::uint32_t reserved;  ///< 予約
+  std::uint64_t offset;    ///< ファイルの先頭からの列データの位置
+  std::uint64_t size;      ///< 列データのバイト数
+};
+
+static_assert(sizeof(CacheHeader) == 72, "unexpected cache header layout");
+static_assert(sizeof(CacheColumn) == 24, "unexpected cache column layout");
+
+/**
+ * @brief 指定されたバイト数を8の倍数に切り上げます。
+ * @param size バイト数
+ * @return 切り上げたバイト数
+ */
+std::uint64_t align8(const std::uint64_t size)
+{
+  return (size + 7) & ~static_cast<std::uint64_t>(7);
+}
+
+/**
+ * @brief 指定されたファイルの内容のハッシュ値を返します。
+ * @param filepath ファイルパス
+ * @return ハッシュ値
+ * @exception std::ios_base::failure ファイルが読み込めない場合
+ */
+std::uint64_t hashFile(const std::string& filepath)
+{
+  std::ifstream stream(filepath.c_str(), std::ifstream::binary);
+  if (!stream.is_open()) {
+    throw std::ios_base::failure("Failed to open file for reading: " + filepath);
+  }
+
+  std::vector<char> buffer(HASH_BLOCK_SIZE);
+  std::uint64_t hash = 0;
+
+  while (stream) {
+    stream.read(&buffer[0], buffer.size());
+    if (stream.bad()) {
+      throw std::ios_base::failure("Failed to read: " + filepath);
+    }
+    if (stream.gcount() > 0) {
+      hash = Hash::hash(&buffer[0], static_cast<std::size_t>(stream.gcount()), hash);
+    }
+  }
+
+  return hash;
+}
+
+/**
+ * @brief 指定されたConfigオブジェクトの設定をヘッダーに記録します。
+ * @param config Configオブジェクト
+ * @param header ヘッダー
+ */
+void setConfig(const Config& config, CacheHeader& header)
+{
+  header.delimitMark = config.getDelimitMark();
+  header.quoteEnabled = config.getQuoteEnabled() ? 1 : 0;
+  header.quoteMark = config.getQuoteMark();
+  header.commentEnabled = config.getCommentEnabled() ? 1 : 0;
+  header.commentMark = config.getCommentMark();
+}
+
+/**
+ * @brief 指定された値を、書き戻したときに同じ文字列になる64ビット整数に変換します。
+ * @param value 値
+ * @param integer 変換した整数
+ * @return 変換できた場合はtrue
+ */
+bool parseInteger(const std::string& value, std::int64_t& integer)
+{
+  const std::size_t sign = (!value.empty() && value[0] == '-') ? 1 : 0;
+
+  // only canonical forms, so that the value round-trips exactly
+  if (value.size() == sign || value.size() - sign > 19
+      || (value[sign] == '0' && value.size() > sign + 1) || value == "-0") {
+    return false;
+  }
+  for (std::size_t i = sign; i < value.size(); i++) {
+    if (value[i] < '0' || value[i] > '9') {
+      return false;
+    }
+  }
+
+  errno = 0;
+  const long long parsed = std::strtoll(value.c_str(), NULL, 10);
+  if (errno == ERANGE) {
+    return false;
+  }
+
+  integer = static_cast<std::int64_t>(parsed);
+  return true;
+}
+
+/**
+ * @brief 指定された列のすべての値が64ビット整数に変換できるかどうかを返します。
+ * @param csv CSVデータ
+ * @param column 列の番号
+ * @return すべてのCSVレコードがその列を持ち、すべての値が変換できる場合はtrue
+ */
+bool isIntegerColumn(const std::vector<std::vector<std::string> >& csv,
+		     const std::size_t column)
+{
+  std::int64_t integer;
+
+  if (csv.empty()) {
+    return false;
+  }
+  for (std::size_t i = 0; i < csv.size(); i++) {
+    if (column >= csv[i].size() || !parseInteger(csv[i][column], integer)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief 指定されたバイト列を出力ストリームに書き込みます。
+ * @param stream 出力ストリーム
+ * @param data データ
+ * @param size バイト数
+ */
+void writeBytes(std::ostream& stream, const void* data, const std::size_t size)
+{
+  stream.write(static_cast<const char*>(data), size);
+}
+
+/**
+ * @brief 8の倍数の位置になるまで0を書き込みます。
+ * @param stream 出力ストリーム
+ * @param size これまでに書き込んだバイト数
+ */
+void writePadding(std::ostream& stream, const std::uint64_t size)
+{
+  static const char zeros[8] = {0};
+  writeBytes(stream, zeros, static_cast<std::size_t>(align8(size) - size));
+}
+
+/**
+ * @brief 指定されたCSVデータの列の種類と配置を決めます。
+ * @param csv CSVデータ
+ * @param directory 列の目録
+ * @return キャッシュファイル全体のバイト数
+ */
+std::uint64_t layoutColumns(const std::vector<std::vector<std::string> >& csv,
+			    std::vector<CacheColumn>& directory)
+{
+  std::size_t columnCount = 0;
+  for (std::size_t i = 0; i < csv.size(); i++) {
+    if (csv[i].size() > columnCount) {
+      columnCount = csv[i].size();
+    }
+  }
+
+  // column data follows the header, field counts and directory
+  directory.assign(columnCount, CacheColumn());
+  std::uint64_t offset = sizeof(CacheHeader) + align8(csv.size() * sizeof(std::uint32_t))
+    + columnCount * sizeof(CacheColumn);
+
+  for (std::size_t i = 0; i < columnCount; i++) {
+    CacheColumn& entry = directory[i];
+    entry.type = isIntegerColumn(csv, i) ? COLUMN_INTEGER : COLUMN_STRING;
+    entry.reserved = 0;
+    entry.offset = offset;
+
+    if (entry.type == COLUMN_INTEGER) {
+      entry.size = csv.size() * sizeof(std::int64_t);
+    } else {
+      std::uint64_t bytes = 0;
+      for (std::size_t j = 0; j < csv.size(); j++) {
+	bytes += i < csv[j].size() ? csv[j][i].size() : 0;
+      }
+      entry.size = (csv.size() + 1) * sizeof(std::uint64_t) + bytes;
+    }
+    offset += align8(entry.size);
+  }
+
+  return offset;
+}
+
+} // namespace
+
+/**
+ * @brief 指定されたキャッシュファイルをマップして、CachedTableオブジェクトを構築します。
+ * @param cachepath キャッシュファイルのパス
+ * @exception std::ios_base::failure キャッシュファイルが読み込めない、または形式が正しくない場合
+ */
+CachedTable::CachedTable(const std::string& cachepath)
+  : address(NULL), length(0), rowCount(0), fieldCounts(NULL), rebuilt(false)
+{
+  open(cachepath);
+}
+
+/**
+ * @brief デフォルトのConfigオブジェクトの設定で、指定されたCSV形式ファイルのキャッシュファイルをマップして、CachedTableオブジェクトを構築します。
+ *
+ * キャッシュファイルがない、古い、または壊れている場合は、CSV形式ファイルを読み込んでキャッシュファイルを作り直します。
+ * @param filepath CSV形式ファイルのパス
+ * @param cachepath キャッシュファイルのパス
+ * @exception std::ios_base::failure ファイルの読み書きにエラーが発生した場合
+ */
+CachedTable::CachedTable(const std::string& filepath,
+			 const std::string& cachepath)
+  : address(NULL), length(0), rowCount(0), fieldCounts(NULL), rebuilt(false)
+{
+  load(filepath, DEFAULT_CONFIG, cachepath);
+}
+
+/**
+ * @brief 指定されたConfigオブジェクトの設定で、指定されたCSV形式ファイルのキャッシュファイルをマップして、CachedTableオブジェクトを構築します。
+ *
+ * キャッシュファイルがない、古い、壊れている、または別の設定で作られた場合は、CSV形式ファイルを読み込んでキャッシュファイルを作り直します。
+ * @param filepath CSV形式ファイルのパス
+ * @param config Configオブジェクト
+ * @param cachepath キャッシュファイルのパス
+ * @exception std::ios_base::failure ファイルの読み書きにエラーが発生した場合
+ */
+CachedTable::CachedTable(const std::string& filepath,
+			 const Config& config,
+			 const std::string& cachepath)
+  : address(NULL), length(0), rowCount(0), fieldCounts(NULL), rebuilt(false)
+{
+  load(filepath, config, cachepath);
+}
+
+/**
+ * @brief 何もマップしていないCachedTableオブジェクトを構築します。派生クラスがmapでマップします。
+ */
+CachedTable::CachedTable(void)
+  : address(NULL), length(0), rowCount(0), fieldCounts(NULL), rebuilt(false)
+{
+}
+
+/**
+ * @brief CachedTableオブジェクトを破棄します。
+ */
+CachedTable::~CachedTable(void)
+{
+  close();
+}
+
+/**
+ * @brief 構築時にCSV形式ファイルを読み込んでキャッシュファイルを作り直したかどうかを返します。
+ * @return 作り直した場合はtrue
+ */
+bool CachedTable::isRebuilt(void) const
+{
+  return rebuilt;
+}
+
+/**
+ * @brief CSVレコードの数を返します。
+ * @return CSVレコードの数
+ */
+std::size_t CachedTable::getRowCount(void) const
+{
+  return rowCount;
+}
+
+/**
+ * @brief 列の数(最もフィールドの多いCSVレコードのフィールドの数)を返します。
+ * @return 列の数
+ */
+std::size_t CachedTable::getColumnCount(void) const
+{
+  return columns.size();
+}
+
+/**
+ * @brief 指定されたCSVレコードのフィールドの数を返します。
+ * @param row CSVレコードの番号
+ * @return フィールドの数
+ * @exception std::out_of_range CSVレコードの番号が範囲外の場合
+ */
+std::size_t CachedTable::getFieldCount(const std::size_t row) const
+{
+  if (row >= rowCount) {
+    throw std::out_of_range("Invalid row.");
+  }
+  return fieldCounts[row];
+}
+
+/**
+ * @brief 指定された列を64ビット整数の列として保存しているかどうかを返します。
+ * @param column 列の番号
+ * @return 64ビット整数の列の場合はtrue
+ * @exception std::out_of_range 列の番号が範囲外の場合
+ */
+bool CachedTable::isInteger(const std::size_t column) const
+{
+  if (column >= columns.size()) {
+    throw std::out_of_range("Invalid column.");
+  }
+  return columns[column].integer;
+}
+
+/**
+ * @brief 文字列の列の、指定されたフィールドの値の先頭を返します。値はキャッシュファイルを直接指します。
+ * @param row CSVレコードの番号
+ * @param column 列の番号
+ * @return フィールドの値の先頭(終端文字はありません)
+ * @exception std::out_of_range CSVレコードにそのフィールドがない場合
+ * @exception std::invalid_argument 64ビット整数の列の場合
+ * @exception std::ios_base::failure キャッシュファイルの形式が正しくない場合
+ */
+const char* CachedTable::getData(const std::size_t row, const std::size_t column) const
+{
+  const char* data;
+  std::size_t size;
+  locate(row, column, data, size);
+  return data;
+}
+
+/**
+ * @brief 文字列の列の、指定されたフィールドの値のバイト数を返します。
+ * @param row CSVレコードの番号
+ * @param column 列の番号
+ * @return フィールドの値のバイト数
+ * @exception std::out_of_range CSVレコードにそのフィールドがない場合
+ * @exception std::invalid_argument 64ビット整数の列の場合
+ * @exception std::ios_base::failure キャッシュファイルの形式が正しくない場合
+ */
+std::size_t CachedTable::getSize(const std::size_t row, const std::size_t column) const
+{
+  const char* data;
+  std::size_t size;
+  locate(row, column, data, size);
+  return size;
+}
+
+/**
+ * @brief 64ビット整数の列の、指定されたフィールドの値を返します。
+ * @param row CSVレコードの番号
+ * @param column 列の番号
+ * @return フィールドの値
+ * @exception std::out_of_range CSVレコードにそのフィールドがない場合
+ * @exception std::invalid_argument 64ビット整数の列でない場合
+ */
+std::int64_t CachedTable::getInteger(const std::size_t row, const std::size_t column) const
+{
+  const Column& c = at(row, column);
+  if (!c.integer) {
+    throw std::invalid_argument("Column is not an integer column.");
+  }
+  return c.values[row];
+}
+
+/**
+ * @brief 指定されたフィールドの値を文字列で返します。
+ * @param row CSVレコードの番号
+ * @param column 列の番号
+ * @return フィールドの値
+ * @exception std::out_of_range CSVレコードにそのフィールドがない場合
+ * @exception std::ios_base::failure キャッシュファイルの形式が正しくない場合
+ */
+std::string CachedTable::get(const std::size_t row, const std::size_t column) const
+{
+  const Column& c = at(row, column);
+  if (c.integer) {
+    char buffer[24];
+    const int size = std::snprintf(buffer, sizeof(buffer), "%lld", static_cast<long long>(c.values[row]));
+    return std::string(buffer, size);
+  }
+
+  const char* data;
+  std::size_t size;
+  locate(row, column, data, size);
+  return std::string(data, size);
+}
+
+/**
+ * @brief 指定されたCSVレコードを文字列に戻して返します。
+ * @param row CSVレコードの番号
+ * @param record CSVレコード
+ * @exception std::out_of_range CSVレコードの番号が範囲外の場合
+ */
+void CachedTable::getRecord(const std::size_t row, std::vector<std::string>& record) const
+{
+  const std::size_t size = getFieldCount(row);
+
+  record.clear();
+  for (std::size_t i = 0; i < size; i++) {
+    record.push_back(get(row, i));
+  }
+}
+
+/**
+ * @brief デフォルトのConfigオブジェクトの設定で読み込んだCSVデータを、指定されたキャッシュファイルに保存します。
+ * @param cachepath キャッシュファイルのパス
+ * @param filepath 読み込んだCSV形式ファイルのパス
+ * @param csv CSVデータ
+ * @exception std::ios_base::failure ファイルの読み書きにエラーが発生した場合
+ */
+void CachedTable::save(const std::string& cachepath,
+		       const std::string& filepath,
+		       const std::vector<std::vector<std::string> >& csv)
+{
+  save(cachepath, filepath, DEFAULT_CONFIG, csv);
+}
+
+/**
+ * @brief 指定されたConfigオブジェクトの設定で読み込んだCSVデータを、指定されたキャッシュファイルに保存します。
+ *
+ * 一時ファイルに書き込んでから置き換えるため、読み出し中の他のプロセスが途中の内容を見ることはありません。
+ * @param cachepath キャッシュファイルのパス
+ * @param filepath 読み込んだCSV形式ファイルのパス
+ * @param config Configオブジェクト
+ * @param csv CSVデータ
+ * @exception std::ios_base::failure ファイルの読み書きにエラーが発生した場合
+ */
+void CachedTable::save(const std::string& cachepath,
+		       const std::string& filepath,
+		       const Config& config,
+		       const std::vector<std::vector<std::string> >& csv)
+{
+  Source source;
+  inspect(filepath, source);
+  save(cachepath, source, config, csv);
+}
+
+/**
+ * @brief 指定されたConfigオブジェクトの設定で読み込んだCSVデータを、元のファイルの指定された状態とともにキャッシュファイルに保存します。
+ *
+ * 一時ファイルに書き込んでから置き換えるため、読み出し中の他のプロセスが途中の内容を見ることはありません。
+ * @param cachepath キャッシュファイルのパス
+ * @param source 読み込む前に調べた元のファイルの状態
+ * @param config Configオブジェクト
+ * @param csv CSVデータ
+ * @exception std::ios_base::failure ファイルの書き込みにエラーが発生した場合
+ */
+void CachedTable::save(const std::string& cachepath,
+		       const Source& source,
+		       const Config& config,
+		       const std::vector<std::vector<std::string> >& csv)
+{
+  // a unique name next to the cache file, so concurrent saves never share it and rename stays atomic
+  const std::string pattern = cachepath + ".XXXXXX";
+  std::vector<char> path(pattern.begin(), pattern.end());
+  path.push_back('\0');
+
+  const int fd = mkstemp(&path[0]);
+  if (fd < 0) {
+    throw std::ios_base::failure("Failed to open file for writing: " + cachepath);
+  }
+  fchmod(fd, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH); // mkstemp creates 0600, readers may be other users
+  ::close(fd);
+
+  const std::string temppath(&path[0]);
+  std::ofstream stream(temppath.c_str(), std::ofstream::binary | std::ofstream::trunc);
+
+  if (!stream.is_open()) {
+    std::remove(temppath.c_str());
+    throw std::ios_base::failure("Failed to open file for writing: " + temppath);
+  }
+
+  try {
+    write(stream, &source, config, csv);
+  } catch (...) {
+    stream.close();
+    std::remove(temppath.c_str());
+    throw;
+  }
+
+  stream.close();
+  if (stream.fail() || std::rename(temppath.c_str(), cachepath.c_str()) != 0) {
+    std::remove(temppath.c_str());
+    throw std::ios_base::failure("Failed to write: " + cachepath);
+  }
+}
+
+/**
+ * @brief 指定されたCSV形式ファイルの、キャッシュファイルに記録する状態を調べます。
+ * @param filepath CSV形式ファイルのパス
+ * @param source 元のファイルの状態
+ * @exception std::ios_base::failure ファイルが読み込めない場合
+ */
+void CachedTable::inspect(const std::string& filepath, Source& source)
+{
+  struct stat st;
+  if (stat(filepath.c_str(), &st) != 0 || !S_ISREG(st.st_mode)) {
+    throw std::ios_base::failure("Failed to open file for reading: " + filepath);
+  }
+  source.size = static_cast<std::uint64_t>(st.st_size);
+  source.mtime = static_cast<std::int64_t>(st.st_mtim.tv_sec);
+  source.mtimeNsec = static_cast<std::int64_t>(st.st_mtim.tv_nsec);
+  source.hash = hashFile(filepath);
+}
+
+/**
+ * @brief 指定されたCSVデータをキャッシュファイルの形式で書き込んだときのバイト数を返します。
+ * @param csv CSVデータ
+ * @return バイト数
+ */
+std::uint64_t CachedTable::measure(const std::vector<std::vector<std::string> >& csv)
+{
+  std::vector<CacheColumn> directory;
+  return layoutColumns(csv, directory);
+}
+
+/**
+ * @brief 指定されたCSVデータをキャッシュファイルの形式で出力ストリームに書き込みます。
+ * @param stream 出力ストリーム
+ * @param filepath 読み込んだCSV形式ファイルのパス(空文字列の場合は元のファイルを記録しません)
+ * @param config Configオブジェクト
+ * @param csv CSVデータ
+ * @exception std::ios_base::failure ファイルの読み書きにエラーが発生した場合
+ */
+void CachedTable::write(std::ostream& stream,
+			const std::string& filepath,
+			const Config& config,
+			const std::vector<std::vector<std::string> >& csv)
+{
+  if (filepath.empty()) {
+    write(stream, NULL, config, csv);
+    return;
+  }
+
+  Source source;
+  inspect(filepath, source);
+  write(stream, &source, config, csv);
+}
+
+/**
+ * @brief 指定されたCSVデータを、元のファイルの指定された状態とともにキャッシュファイルの形式で出力ストリームに書き込みます。
+ * @param stream 出力ストリーム
+ * @param source 元のファイルの状態(NULLの場合は元のファイルを記録しません)
+ * @param config Configオブジェクト
+ * @param csv CSVデータ
+ * @exception std::ios_base::failure 出力ストリームにエラーが発生した場合
+ */
+void CachedTable::write(std::ostream& stream,
+			const Source* source,
+			const Config& config,
+			const std::vector<std::vector<std::string> >& csv)
+{
+  CacheHeader header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.magic, CACHE_MAGIC, sizeof(header.magic));
+  header.version = CACHE_VERSION;
+  header.byteOrder = CACHE_BYTE_ORDER;
+  setConfig(config, header);
+
+  if (source != NULL) {
+    header.sourceSize = source->size;
+    header.sourceMtime = source->mtime;
+    header.sourceMtimeNsec = source->mtimeNsec;
+    header.sourceHash = source->hash;
+  }
+
+  std::vector<CacheColumn> directory;
+  layoutColumns(csv, directory);
+  header.rowCount = csv.size();
+  header.columnCount = directory.size();
+
+  writeBytes(stream, &header, sizeof(header));
+
+  for (std::size_t i = 0; i < csv.size(); i++) {
+    const std::uint32_t count = static_cast<std::uint32_t>(csv[i].size());
+    writeBytes(stream, &count, sizeof(count));
+  }
+  writePadding(stream, csv.size() * sizeof(std::uint32_t));
+
+  if (!directory.empty()) {
+    writeBytes(stream, &directory[0], directory.size() * sizeof(CacheColumn));
+  }
+
+  for (std::size_t i = 0; i < directory.size(); i++) {
+    if (directory[i].type == COLUMN_INTEGER) {
+      for (std::size_t j = 0; j < csv.size(); j++) {
+	std::int64_t value = 0;
+	parseInteger(csv[j][i], value);
+	writeBytes(stream, &value, sizeof(value));
+      }
+    } else {
+      std::uint64_t position = 0;
+      writeBytes(stream, &position, sizeof(position));
+      for (std::size_t j = 0; j < csv.size(); j++) {
+	position += i < csv[j].size() ? csv[j][i].size() : 0;
+	writeBytes(stream, &position, sizeof(position));
+      }
+      for (std::size_t j = 0; j < csv.size(); j++) {
+	if (i < csv[j].size()) {
+	  writeBytes(stream, csv[j][i].data(), csv[j][i].size());
+	}
+      }
+    }
+    writePadding(stream, directory[i].size);
+  }
+
+  if (!stream) {
+    throw std::ios_base::failure("Failed to write.");
+  }
+}
+
+/**
+ * @brief 指定されたキャッシュファイルが、指定されたCSV形式ファイルと設定に対して最新かどうかを返します。
+ *
+ * サイズと更新時刻が一致すれば最新とみなします。
+ * 更新時刻だけが異なる場合は、ファイルの内容のハッシュ値を比べます。
+ * @param cachepath キャッシュファイルのパス
+ * @param filepath CSV形式ファイルのパス
+ * @param config Configオブジェクト
+ * @return 最新の場合はtrue、キャッシュファイルがない、古い、または形式が異なる場合はfalse
+ * @exception std::ios_base::failure CSV形式ファイルが読み込めない場合
+ */
+bool CachedTable::isFresh(const std::string& cachepath,
+			  const std::string& filepath,
+			  const Config& config)
+{
+  struct stat st;
+  if (stat(filepath.c_str(), &st) != 0 || !S_ISREG(st.st_mode)) {
+    throw std::ios_base::failure("Failed to open file for reading: " + filepath);
+  }
+
+  std::ifstream stream(cachepath.c_str(), std::ifstream::binary);
+  if (!stream.is_open()) {
+    return false;
+  }
+
+  CacheHeader header;
+  if (!stream.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+    return false;
+  }
+  stream.close();
+
+  CacheHeader expected;
+  std::memset(&expected, 0, sizeof(expected));
+  setConfig(config, expected);
+
+  if (std::memcmp(header.magic, CACHE_MAGIC, sizeof(header.magic)) != 0
+      || header.version != CACHE_VERSION
+      || header.byteOrder != CACHE_BYTE_ORDER
+      || header.delimitMark != expected.delimitMark
+      || header.quoteEnabled != expected.quoteEnabled
+      || header.quoteMark != expected.quoteMark
+      || header.commentEnabled != expected.commentEnabled
+      || header.commentMark != expected.commentMark
+      || header.sourceSize != static_cast<std::uint64_t>(st.st_size)) {
+    return false;
+  }
+
+  if (header.sourceMtime == static_cast<std::int64_t>(st.st_mtim.tv_sec)
+      && header.sourceMtimeNsec == static_cast<std::int64_t>(st.st_mtim.tv_nsec)) {
+    return true;
+  }
+  return header.sourceHash == hashFile(filepath);
+}
+
+/**
+ * @brief 指定されたキャッシュファイルが最新であればマップし、そうでなければCSV形式ファイルを読み込んで作り直してからマップします。
+ * @param filepath CSV形式ファイルのパス
+ * @param config Configオブジェクト
+ * @param cachepath キャッシュファイルのパス
+ * @exception std::ios_base::failure ファイルの読み書きにエラーが発生した場合
+ */
+void CachedTable::load(const std::string& filepath,
+		       const Config& config,
+		       const std::string& cachepath)
+{
+  if (isFresh(cachepath, filepath, config)) {
+    try {
+      open(cachepath);
+      return;
+    } catch (const std::ios_base::failure&) {
+      // fall through and rebuild a corrupted cache
+    }
+  }
+
+  // record the source as it was before parsing, so that a change during parsing leaves the cache stale
+  Source source;
+  inspect(filepath, source);
+  std::vector<std::vector<std::string> > csv;
+  Util::load(filepath, config, csv);
+  save(cachepath, source, config, csv);
+  rebuilt = true;
+  open(cachepath);
+}
+
+/**
+ * @brief 指定されたキャッシュファイルを読み取り専用でマップします。
+ * @param cachepath キャッシュファイルのパス
+ * @exception std::ios_base::failure キャッシュファイルが読み込めない、または形式が正しくない場合
+ */
+void CachedTable::open(const std::string& cachepath)
+{
+  const int fd = ::open(cachepath.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw std::ios_base::failure("Failed to open file for reading: " + cachepath);
+  }
+
+  try {
+    map(fd, cachepath);
+  } catch (...) {
+    ::close(fd);
+    throw;
+  }
+  ::close(fd);
+}
+
+/**
+ * @brief 指定されたファイル記述子のキャッシュファイル形式のデータを読み取り専用でマップします。ファイル記述子は閉じません。
+ * @param fd ファイル記述子
+ * @param cachepath エラーメッセージに使うキャッシュファイルの名前
+ * @exception std::ios_base::failure 読み込めない、または形式が正しくない場合
+ */
+void CachedTable::map(const int fd, const std::string& cachepath)
+{
+  close();
+
+  struct stat st;
+  if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)
+      || static_cast<std::size_t>(st.st_size) < sizeof(CacheHeader)) {
+    throw std::ios_base::failure("Invalid cache file: " + cachepath);
+  }
+
+  length = static_cast<std::size_t>(st.st_size);
+  address = mmap(NULL, length, PROT_READ, MAP_SHARED, fd, 0);
+
+  if (address == MAP_FAILED) {
+    address = NULL;
+    length = 0;
+    throw std::ios_base::failure("Failed to read: " + cachepath);
+  }
+
+  const char* base = static_cast<const char*>(address);
+  const CacheHeader* header = reinterpret_cast<const CacheHeader*>(base);
+
+  // validate every section against the mapped size before trusting it
+  const std::uint64_t directoryOffset = sizeof(CacheHeader) + align8(header->rowCount * sizeof(std::uint32_t));
+  bool valid = std::memcmp(header->magic, CACHE_MAGIC, sizeof(header->magic)) == 0
+    && header->version == CACHE_VERSION
+    && header->byteOrder == CACHE_BYTE_ORDER
+    && header->rowCount <= length / sizeof(std::uint32_t)
+    && header->columnCount <= length / sizeof(CacheColumn)
+    && directoryOffset + header->columnCount * sizeof(CacheColumn) <= length;
+
+  if (valid) {
+    const CacheColumn* directory = reinterpret_cast<const CacheColumn*>(base + directoryOffset);
+
+    rowCount = static_cast<std::size_t>(header->rowCount);
+    fieldCounts = reinterpret_cast<const std::uint32_t*>(base + sizeof(CacheHeader));
+    columns.resize(static_cast<std::size_t>(header->columnCount));
+
+    for (std::size_t row = 0; valid && row < rowCount; row++) {
+      valid = fieldCounts[row] <= columns.size();
+    }
+
+    for (std::size_t i = 0; valid && i < columns.size(); i++) {
+      const CacheColumn& entry = directory[i];
+      Column& c = columns[i];
+
+      valid = entry.offset % 8 == 0 && entry.offset <= length && entry.size <= length - entry.offset;
+      if (!valid) {
+	break;
+      }
+
+      c.integer = entry.type == COLUMN_INTEGER;
+      c.offsets = NULL;
+      c.bytes = NULL;
+      c.size = 0;
+      c.values = NULL;
+
+      if (c.integer) {
+	valid = entry.size == rowCount * sizeof(std::int64_t);
+	c.values = reinterpret_cast<const std::int64_t*>(base + entry.offset);
+      } else {
+	const std::uint64_t table = (static_cast<std::uint64_t>(rowCount) + 1) * sizeof(std::uint64_t);
+	valid = entry.type == COLUMN_STRING && entry.size >= table;
+	if (valid) {
+	  c.offsets = reinterpret_cast<const std::uint64_t*>(base + entry.offset);
+	  c.bytes = base + entry.offset + table;
+	  c.size = static_cast<std::size_t>(entry.size - table);
+	  valid = c.offsets[0] == 0 && c.offsets[rowCount] == c.size;
+	}
+      }
+    }
+  }
+
+  if (!valid) {
+    close();
+    throw std::ios_base::failure("Invalid cache file: " + cachepath);
+  }
+}
+
+/**
+ * @brief マップしたキャッシュファイルを解放します。
+ */
+void CachedTable::close(void)
+{
+  if (address != NULL) {
+    munmap(address, length);
+  }
+  address = NULL;
+  length = 0;
+  rowCount = 0;
+  fieldCounts = NULL;
+  columns.clear();
+}
+
+/**
+ * @brief 指定されたフィールドを含む列を返します。
+ * @param row CSVレコードの番号
+ * @param column 列の番号
+ * @return 列
+ * @exception std::out_of_range CSVレコードにそのフィールドがない場合
+ */
+const CachedTable::Column& CachedTable::at(const std::size_t row, const std::size_t column) const
+{
+  if (column >= getFieldCount(row) || column >= columns.size()) {
+    throw std::out_of_range("Invalid column.");
+  }
+  return columns[column];
+}
+
+/**
+ * @brief 文字列の列の、指定されたフィールドの値の位置を返します。
+ * @param row CSVレコードの番号
+ * @param column 列の番号
+ * @param data フィールドの値の先頭
+ * @param size フィールドの値のバイト数
+ * @exception std::out_of_range CSVレコードにそのフィールドがない場合
+ * @exception std::invalid_argument 64ビット整数の列の場合
+ * @exception std::ios_base::failure キャッシュファイルの形式が正しくない場合
+ */
+void CachedTable::locate(const std::size_t row, const std::size_t column,
+			 const char*& data, std::size_t& size) const
+{
+  const Column& c = at(row, column);
+  if (c.integer) {
+    throw std::invalid_argument("Column is not a string column.");
+  }
+
+  const std::uint64_t begin = c.offsets[row];
+  const std::uint64_t end = c.offsets[row + 1];
+  if (begin > end || end > c.size) {
+    throw std::ios_base::failure("Invalid cache file.");
+  }
+
+  data = c.bytes + begin;
+  size = static_cast<std::size_t>(end - begin);
+}
+
+} // namespace csv
+} // namespace csl
@@ -0,0 +1,179 @@
+/**
+ * @file  ColumnProfile.cpp
+ * @brief ColumnProfileクラス実装ファイル
+ */
+#include "csl/csv/ColumnProfile.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "csl/csv/Util.hpp"
+
+namespace csl {
+namespace csv {
+
+/**
+ * @brief 値のないColumnProfileオブジェクトを構築します。
+ */
+ColumnProfile::ColumnProfile(void)
+  : count(0)
+  , emptyCount(0)
+  , minLength(std::numeric_limits<std::size_t>::max())
+  , maxLength(0)
+  , sum(0.0)
+{
+}
+
+/**
+ * @brief ColumnProfileオブジェクトを破棄します。
+ */
+ColumnProfile::~ColumnProfile(void)
+{
+}
+
+/**
+ * @brief 値を追加します。
+ * @param data 値の先頭(囲み文字とエスケープを解釈したもの)
+ * @param size 値のバイト数
+ */
+void ColumnProfile::add(const char* data, const std::size_t size)
+{
+  count++;
+  minLength = std::min(minLength, size);
+  maxLength = std::max(maxLength, size);
+
+  if (size == 0) {
+    emptyCount++;
+    return;
+  }
+
+  distinct.add(data, size);
+
+  double number;
+  if (Util::parseNumber(data, size, number) && std::isfinite(number)) {
+    sum += number;
+    quantiles.add(number);
+  }
+}
+
+/**
+ * @brief 列がないCSVレコードの数を追加します。空の値として数え、長さには含めません。
+ * @param count CSVレコードの数
+ */
+void ColumnProfile::addMissing(const std::uint64_t count)
+{
+  this->count += count;
+  emptyCount += count;
+}
+
+/**
+ * @brief 別のColumnProfileに追加した値を、このColumnProfileに併合します。
+ * @param profile ColumnProfileオブジェクト
+ */
+void ColumnProfile::merge(const ColumnProfile& profile)
+{
+  count += profile.count;
+  emptyCount += profile.emptyCount;
+  minLength = std::min(minLength, profile.minLength);
+  maxLength = std::max(maxLength, profile.maxLength);
+  sum += profile.sum;
+  distinct.merge(profile.distinct);
+  quantiles.merge(profile.quantiles);
+}
+
+/**
+ * @brief 値の数(列がないCSVレコードを含む)を返します。
+ * @return 値の数
+ */
+std::uint64_t ColumnProfile::getCount(void) const
+{
+  return count;
+}
+
+/**
+ * @brief 空文字列の値と、列がないCSVレコードの数を返します。
+ * @return 空の値の数
+ */
+std::uint64_t ColumnProfile::getEmptyCount(void) const
+{
+  return emptyCount;
+}
+
+/**
+ * @brief 値の長さの最小値を返します。
+ * @return バイト数(値がない場合は0)
+ */
+std::size_t ColumnProfile::getMinLength(void) const
+{
+  return (minLength <= maxLength) ? minLength : 0;
+}
+
+/**
+ * @brief 値の長さの最大値を返します。
+ * @return バイト数
+ */
+std::size_t ColumnProfile::getMaxLength(void) const
+{
+  return maxLength;
+}
+
+/**
+ * @brief 数値として解釈できた値の数を返します。
+ * @return 値の数
+ */
+std::uint64_t ColumnProfile::getNumericCount(void) const
+{
+  return quantiles.size();
+}
+
+/**
+ * @brief 数値の最小値を返します。
+ * @return 最小値(数値がない場合はNaN)
+ */
+double ColumnProfile::getMinimum(void) const
+{
+  return quantiles.quantile(0.0);
+}
+
+/**
+ * @brief 数値の最大値を返します。
+ * @return 最大値(数値がない場合はNaN)
+ */
+double ColumnProfile::getMaximum(void) const
+{
+  return quantiles.quantile(1.0);
+}
+
+/**
+ * @brief 数値の平均を返します。
+ * @return 平均(数値がない場合はNaN)
+ */
+double ColumnProfile::getMean(void) const
+{
+  if (quantiles.size() == 0) {
+    return std::numeric_limits<double>::quiet_NaN();
+  }
+  return sum / static_cast<double>(quantiles.size());
+}
+
+/**
+ * @brief 数値の分位数の近似値を返します。
+ * @param q 分位(0以上1以下、0.5で中央値)
+ * @return 分位数の近似値(数値がない場合はNaN)
+ * @exception std::invalid_argument 分位が範囲外の場合
+ */
+double ColumnProfile::getQuantile(const double q) const
+{
+  return quantiles.quantile(q);
+}
+
+/**
+ * @brief 空でない値の種類の数の近似値を返します。
+ * @return 値の種類の数
+ */
+std::uint64_t ColumnProfile::getDistinctCount(void) const
+{
+  return static_cast<std::uint64_t>(distinct.estimate() + 0.5);
+}
+
+} // namespace csv
+} // namespace csl
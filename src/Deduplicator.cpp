@@ -0,0 +1,233 @@
+/**
+ * @file  Deduplicator.cpp
+ * @brief Deduplicatorクラス実装ファイル
+ */
+#include "csl/csv/Deduplicator.hpp"
+#include <fstream>
+#include <ios>
+#include <sys/stat.h>
+#include "csl/csv/LazyRecord.hpp"
+#include "csl/csv/Reader.hpp"
+#include "csl/csv/Writer.hpp"
+
+namespace csl {
+namespace csv {
+
+namespace {
+
+/**
+ * @brief ハッシュ表の最初のスロット数です(2のべき乗)。
+ */
+const std::size_t INITIAL_SLOTS = 1024;
+
+} // namespace
+
+/**
+ * @brief CSVレコード全体で重複を判定するDeduplicatorオブジェクトを構築します。
+ */
+Deduplicator::Deduplicator(void)
+  : recordCount(0)
+  , duplicateCount(0)
+{
+}
+
+/**
+ * @brief Deduplicatorオブジェクトを破棄します。
+ */
+Deduplicator::~Deduplicator(void)
+{
+}
+
+/**
+ * @brief 重複の判定に使うキーの列を追加します。
+ * @param column 列の番号
+ */
+void Deduplicator::addKey(const std::size_t column)
+{
+  keys.push_back(column);
+}
+
+/**
+ * @brief キーの列をすべて削除し、CSVレコード全体で重複を判定するようにします。
+ */
+void Deduplicator::clearKeys(void)
+{
+  keys.clear();
+}
+
+/**
+ * @brief デフォルトのConfigオブジェクトの設定に従って、入力ストリームのCSVデータから重複を取り除いて出力ストリームに書き込みます。
+ * @param in 入力ストリーム
+ * @param out 出力ストリーム
+ * @exception std::ios_base::failure 入出力ストリームにエラーが発生した場合
+ */
+void Deduplicator::dedup(std::istream& in, std::ostream& out)
+{
+  dedup(in, DEFAULT_CONFIG, out);
+}
+
+/**
+ * @brief 指定されたConfigオブジェクトの設定に従って、入力ストリームのCSVデータから重複を取り除いて出力ストリームに書き込みます。
+ *
+ * 呼び出すたびに、それまでに保持したハッシュ値と件数を破棄します。
+ * @param in 入力ストリーム
+ * @param config Configオブジェクト
+ * @param out 出力ストリーム
+ * @exception std::ios_base::failure 入出力ストリームにエラーが発生した場合
+ */
+void Deduplicator::dedup(std::istream& in, const Config& config, std::ostream& out)
+{
+  Reader reader(in, config);
+  Writer writer(out, config);
+  LazyRecord record;
+  std::vector<std::string> fields;
+
+  slots.assign(INITIAL_SLOTS, Digest());
+  occupied.assign(INITIAL_SLOTS, false);
+  recordCount = 0;
+  duplicateCount = 0;
+
+  while (reader.hasNext()) {
+    reader.read(record);
+    recordCount++;
+
+    const Digest digest = keys.empty() ? Digest(record) : Digest(record, keys);
+    if (!insert(digest)) {
+      duplicateCount++;
+      continue;
+    }
+
+    fields.resize(record.size());
+    for (std::size_t i = 0; i < record.size(); i++) {
+      record.get(i, fields[i]);
+    }
+    writer.write(fields);
+  }
+
+  // release the table, only the counts are kept
+  std::vector<Digest>().swap(slots);
+  std::vector<bool>().swap(occupied);
+}
+
+/**
+ * @brief デフォルトのConfigオブジェクトの設定に従って、入力ファイルのCSVデータから重複を取り除いて出力ファイルに書き込みます。
+ * @param inpath 入力ファイルのパス
+ * @param outpath 出力ファイルのパス
+ * @exception std::ios_base::failure 入出力ファイルにエラーが発生した場合
+ */
+void Deduplicator::dedup(const std::string& inpath, const std::string& outpath)
+{
+  dedup(inpath, DEFAULT_CONFIG, outpath);
+}
+
+/**
+ * @brief 指定されたConfigオブジェクトの設定に従って、入力ファイルのCSVデータから重複を取り除いて出力ファイルに書き込みます。
+ * @param inpath 入力ファイルのパス
+ * @param config Configオブジェクト
+ * @param outpath 出力ファイルのパス
+ * @exception std::ios_base::failure 入出力ファイルにエラーが発生した場合
+ */
+void Deduplicator::dedup(const std::string& inpath, const Config& config, const std::string& outpath)
+{
+  struct stat st;
+  if (stat(inpath.c_str(), &st) != 0 || !S_ISREG(st.st_mode)) {
+    throw std::ios_base::failure("Failed to open file for reading: " + inpath);
+  }
+
+  std::ifstream in(inpath.c_str(), std::ifstream::binary);
+
+  if (!in.is_open()) {
+    throw std::ios_base::failure("Failed to open file for reading: " + inpath);
+  }
+
+  std::ofstream out(outpath.c_str(), std::ofstream::binary);
+
+  if (!out.is_open()) {
+    in.close();
+    throw std::ios_base::failure("Failed to open file for writing: " + outpath);
+  }
+
+  try {
+    dedup(in, config, out);
+  } catch (...) {
+    in.close();
+    out.close();
+    throw;
+  }
+
+  in.close();
+  out.close();
+}
+
+/**
+ * @brief 直前のdedupで読み込んだCSVレコードの数を返します。
+ * @return CSVレコードの数
+ */
+std::size_t Deduplicator::getRecordCount(void) const
+{
+  return recordCount;
+}
+
+/**
+ * @brief 直前のdedupで取り除いたCSVレコードの数を返します。
+ * @return CSVレコードの数
+ */
+std::size_t Deduplicator::getDuplicateCount(void) const
+{
+  return duplicateCount;
+}
+
+/**
+ * @brief ハッシュ値をハッシュ表に追加します。
+ * @param digest ハッシュ値
+ * @return 追加した場合はtrue、すでにあった場合はfalse
+ */
+bool Deduplicator::insert(const Digest& digest)
+{
+  const std::size_t mask = slots.size() - 1;
+  std::size_t slot = static_cast<std::size_t>(digest.getLow()) & mask;
+
+  while (occupied[slot]) {
+    if (slots[slot] == digest) {
+      return false;
+    }
+    slot = (slot + 1) & mask;
+  }
+
+  slots[slot] = digest;
+  occupied[slot] = true;
+
+  // keep the load factor at or below one half
+  if ((recordCount - duplicateCount) * 2 > slots.size()) {
+    grow();
+  }
+  return true;
+}
+
+/**
+ * @brief ハッシュ表のスロット数を2倍にします。
+ */
+void Deduplicator::grow(void)
+{
+  std::vector<Digest> oldSlots(slots.size() * 2);
+  std::vector<bool> oldOccupied(occupied.size() * 2, false);
+  oldSlots.swap(slots);
+  oldOccupied.swap(occupied);
+
+  const std::size_t mask = slots.size() - 1;
+  for (std::size_t i = 0; i < oldSlots.size(); i++) {
+    if (!oldOccupied[i]) {
+      continue;
+    }
+
+    std::size_t slot = static_cast<std::size_t>(oldSlots[i].getLow()) & mask;
+    while (occupied[slot]) {
+      slot = (slot + 1) & mask;
+    }
+    slots[slot] = oldSlots[i];
+    occupied[slot] = true;
+  }
+}
+
+} // namespace csv
+} // namespace csl
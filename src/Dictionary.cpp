@@ -0,0 +1,183 @@
+/**
+ * @file  Dictionary.cpp
+ * @brief Dictionaryクラス実装ファイル
+ */
+#include "csl/csv/Dictionary.hpp"
+#include <cstring>
+#include <stdexcept>
+#include "csl/csv/Hash.hpp"
+
+namespace csl {
+namespace csv {
+
+namespace {
+
+/**
+ * @brief 空きスロットを表す値です。
+ */
+const std::uint32_t EMPTY_SLOT = 0xFFFFFFFFu;
+
+/**
+ * @brief スロット数の初期値です(2のべき乗)。
+ */
+const std::size_t INITIAL_SLOTS = 64;
+
+} // namespace
+
+/**
+ * @brief 空のDictionaryオブジェクトを構築します。
+ */
+Dictionary::Dictionary(void)
+{
+}
+
+/**
+ * @brief Dictionaryオブジェクトを破棄します。
+ */
+Dictionary::~Dictionary(void)
+{
+}
+
+/**
+ * @brief 指定された文字列を登録して、そのコードを返します。登録済みの場合は登録済みのコードを返します。
+ * @param data 文字列の先頭
+ * @param size 文字列のバイト数
+ * @return コード
+ */
+std::uint32_t Dictionary::intern(const char* data, const std::size_t size)
+{
+  if ((values.size() + 1) * 2 > slots.size()) {
+    grow();
+  }
+
+  const std::uint64_t hash = Hash::hash(data, size);
+  const std::size_t slot = lookup(data, size, hash);
+
+  if (slots[slot] == EMPTY_SLOT) {
+    slots[slot] = static_cast<std::uint32_t>(values.size());
+    values.push_back(std::string(data, size));
+    hashes.push_back(hash);
+  }
+
+  return slots[slot];
+}
+
+/**
+ * @brief 指定された文字列を登録して、そのコードを返します。登録済みの場合は登録済みのコードを返します。
+ * @param value 文字列
+ * @return コード
+ */
+std::uint32_t Dictionary::intern(const std::string& value)
+{
+  return intern(value.data(), value.size());
+}
+
+/**
+ * @brief 指定された文字列のコードを探します。
+ * @param data 文字列の先頭
+ * @param size 文字列のバイト数
+ * @param code 見つかった場合のコード
+ * @return 登録済みの場合はtrue
+ */
+bool Dictionary::find(const char* data, const std::size_t size, std::uint32_t& code) const
+{
+  if (slots.empty()) {
+    return false;
+  }
+
+  const std::size_t slot = lookup(data, size, Hash::hash(data, size));
+  if (slots[slot] == EMPTY_SLOT) {
+    return false;
+  }
+
+  code = slots[slot];
+  return true;
+}
+
+/**
+ * @brief 指定された文字列のコードを探します。
+ * @param value 文字列
+ * @param code 見つかった場合のコード
+ * @return 登録済みの場合はtrue
+ */
+bool Dictionary::find(const std::string& value, std::uint32_t& code) const
+{
+  return find(value.data(), value.size(), code);
+}
+
+/**
+ * @brief 指定されたコードの文字列を返します。
+ * @param code コード
+ * @return 文字列
+ * @exception std::out_of_range 登録されていないコードの場合
+ */
+const std::string& Dictionary::get(const std::uint32_t code) const
+{
+  if (code >= values.size()) {
+    throw std::out_of_range("Invalid code.");
+  }
+  return values[code];
+}
+
+/**
+ * @brief 登録されている文字列の数を返します。
+ * @return 登録されている文字列の数
+ */
+std::size_t Dictionary::size(void) const
+{
+  return values.size();
+}
+
+/**
+ * @brief 登録されているすべての文字列を取り除きます。
+ */
+void Dictionary::clear(void)
+{
+  values.clear();
+  hashes.clear();
+  slots.clear();
+}
+
+/**
+ * @brief 指定された文字列が登録されているスロット、または登録すべき空きスロットを返します。
+ * @param data 文字列の先頭
+ * @param size 文字列のバイト数
+ * @param hash 文字列のハッシュ値
+ * @return スロットの位置
+ */
+std::size_t Dictionary::lookup(const char* data, const std::size_t size, const std::uint64_t hash) const
+{
+  const std::size_t mask = slots.size() - 1;
+
+  for (std::size_t slot = static_cast<std::size_t>(hash) & mask;; slot = (slot + 1) & mask) {
+    const std::uint32_t code = slots[slot];
+    if (code == EMPTY_SLOT) {
+      return slot;
+    }
+    if (hashes[code] == hash && values[code].size() == size
+	&& std::memcmp(values[code].data(), data, size) == 0) {
+      return slot;
+    }
+  }
+}
+
+/**
+ * @brief スロット数を2倍にして、登録済みの文字列を配置し直します。
+ */
+void Dictionary::grow(void)
+{
+  const std::size_t size = slots.empty() ? INITIAL_SLOTS : slots.size() * 2;
+  const std::size_t mask = size - 1;
+
+  slots.assign(size, EMPTY_SLOT);
+  for (std::size_t code = 0; code < values.size(); code++) {
+    std::size_t slot = static_cast<std::size_t>(hashes[code]) & mask;
+    while (slots[slot] != EMPTY_SLOT) {
+      slot = (slot + 1) & mask;
+    }
+    slots[slot] = static_cast<std::uint32_t>(code);
+  }
+}
+
+} // namespace csv
+} // namespace csl
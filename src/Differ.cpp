@@ -0,0 +1,311 @@
+/**
+ * @file  Differ.cpp
+ * @brief Differクラス実装ファイル
+ */
+#include "csl/csv/Differ.hpp"
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+#include <sys/stat.h>
+#include "csl/csv/LazyRecord.hpp"
+#include "csl/csv/Reader.hpp"
+#include "csl/csv/Writer.hpp"
+
+namespace csl {
+namespace csv {
+
+namespace {
+
+/**
+ * @brief 削除されたCSVレコードを読み込み直すときに、移動せずに読み飛ばす最大のバイト数です。
+ */
+const std::streamoff SKIP_LIMIT = 64 * 1024;
+
+} // namespace
+
+/**
+ * @brief CSVレコード全体で照合するDifferオブジェクトを構築します。
+ */
+Differ::Differ(void)
+  : addedCount(0)
+  , removedCount(0)
+  , changedCount(0)
+{
+}
+
+/**
+ * @brief Differオブジェクトを破棄します。
+ */
+Differ::~Differ(void)
+{
+}
+
+/**
+ * @brief 照合に使うキーの列を追加します。
+ * @param column 列の番号
+ */
+void Differ::addKey(const std::size_t column)
+{
+  keys.push_back(column);
+}
+
+/**
+ * @brief キーの列をすべて削除し、CSVレコード全体で照合するようにします。
+ */
+void Differ::clearKeys(void)
+{
+  keys.clear();
+}
+
+/**
+ * @brief デフォルトのConfigオブジェクトの設定に従って、2つの入力ストリームのCSVデータの差分を出力ストリームに書き込みます。
+ * @param before 変更前の入力ストリーム(位置を移動できること)
+ * @param after 変更後の入力ストリーム
+ * @param out 出力ストリーム
+ * @exception std::invalid_argument 変更前の入力ストリームの位置を取得できない場合
+ * @exception std::ios_base::failure 入出力ストリームにエラーが発生した場合
+ */
+void Differ::diff(std::istream& before, std::istream& after, std::ostream& out)
+{
+  diff(before, after, DEFAULT_CONFIG, out);
+}
+
+/**
+ * @brief 指定されたConfigオブジェクトの設定に従って、2つの入力ストリームのCSVデータの差分を出力ストリームに書き込みます。
+ * @param before 変更前の入力ストリーム(位置を移動できること)
+ * @param after 変更後の入力ストリーム
+ * @param config Configオブジェクト
+ * @param out 出力ストリーム
+ * @exception std::invalid_argument 変更前の入力ストリームの位置を取得できない場合
+ * @exception std::ios_base::failure 入出力ストリームにエラーが発生した場合
+ */
+void Differ::diff(std::istream& before, std::istream& after, const Config& config, std::ostream& out)
+{
+  // removed records are read again from their offsets, so fail before writing anything
+  const std::streamoff origin = before.tellg();
+  if (origin == -1) {
+    throw std::invalid_argument("Unseekable stream.");
+  }
+
+  std::vector<Entry> entries;
+  LazyRecord record;
+  std::vector<std::string> fields;
+
+  addedCount = 0;
+  removedCount = 0;
+  changedCount = 0;
+
+  {
+    // start from the current position so that the offsets count from the head of the stream
+    Reader reader(before, config, origin, 0);
+
+    while (reader.hasNext()) {
+      Entry entry;
+      entry.offset = reader.getOffset();
+      reader.read(record);
+      entry.row = Digest(record);
+      entry.key = keys.empty() ? entry.row : Digest(record, keys);
+      entry.matched = 0;
+      entries.push_back(entry);
+    }
+  }
+
+  // records with the same key are paired in the order of appearance
+  std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+      return (a.key != b.key) ? (a.key < b.key) : (a.offset < b.offset);
+    });
+
+  Writer writer(out, config);
+  Reader reader(after, config);
+
+  while (reader.hasNext()) {
+    reader.read(record);
+
+    const Digest row(record);
+    const Digest key = keys.empty() ? row : Digest(record, keys);
+    std::vector<Entry>::iterator head = std::lower_bound(entries.begin(), entries.end(), key,
+							 [](const Entry& entry, const Digest& digest) {
+							   return entry.key < digest;
+							 });
+
+    if (head == entries.end() || head->key != key) {
+      addedCount++;
+      emit(writer, DIFF_ADDED_MARK, record, fields);
+      continue;
+    }
+
+    const std::size_t index = static_cast<std::size_t>(head - entries.begin()) + head->matched;
+    if (index >= entries.size() || entries[index].key != key) {
+      addedCount++;
+      emit(writer, DIFF_ADDED_MARK, record, fields);
+      continue;
+    }
+
+    head->matched++;
+    if (entries[index].row != row) {
+      changedCount++;
+      emit(writer, DIFF_CHANGED_MARK, record, fields);
+    }
+  }
+
+  std::vector<std::streamoff> removed;
+  for (std::size_t i = 0; i < entries.size();) {
+    std::size_t end = i + 1;
+    while (end < entries.size() && entries[end].key == entries[i].key) {
+      end++;
+    }
+    for (std::size_t j = i + entries[i].matched; j < end; j++) {
+      removed.push_back(entries[j].offset);
+    }
+    i = end;
+  }
+  std::vector<Entry>().swap(entries);
+  std::sort(removed.begin(), removed.end());
+  removedCount = removed.size();
+
+  // read forward over short gaps instead of seeking for every record
+  before.clear();
+  Reader* source = NULL;
+
+  try {
+    for (std::size_t i = 0; i < removed.size(); i++) {
+      if (source != NULL && source->getOffset() <= removed[i] && removed[i] - source->getOffset() <= SKIP_LIMIT) {
+	while (source->getOffset() < removed[i]) {
+	  source->read(record);
+	}
+      } else {
+	delete source;
+	source = NULL;
+	before.clear();
+	source = new Reader(before, config, removed[i], 0);
+      }
+
+      source->read(record);
+      emit(writer, DIFF_REMOVED_MARK, record, fields);
+    }
+  } catch (...) {
+    delete source;
+    throw;
+  }
+
+  delete source;
+}
+
+/**
+ * @brief デフォルトのConfigオブジェクトの設定に従って、2つの入力ファイルのCSVデータの差分を出力ファイルに書き込みます。
+ * @param beforepath 変更前の入力ファイルのパス
+ * @param afterpath 変更後の入力ファイルのパス
+ * @param outpath 出力ファイルのパス
+ * @exception std::ios_base::failure 入出力ファイルにエラーが発生した場合
+ */
+void Differ::diff(const std::string& beforepath, const std::string& afterpath, const std::string& outpath)
+{
+  diff(beforepath, afterpath, DEFAULT_CONFIG, outpath);
+}
+
+/**
+ * @brief 指定されたConfigオブジェクトの設定に従って、2つの入力ファイルのCSVデータの差分を出力ファイルに書き込みます。
+ * @param beforepath 変更前の入力ファイルのパス
+ * @param afterpath 変更後の入力ファイルのパス
+ * @param config Configオブジェクト
+ * @param outpath 出力ファイルのパス
+ * @exception std::ios_base::failure 入出力ファイルにエラーが発生した場合
+ */
+void Differ::diff(const std::string& beforepath,
+		  const std::string& afterpath,
+		  const Config& config,
+		  const std::string& outpath)
+{
+  struct stat st;
+  if (stat(beforepath.c_str(), &st) != 0 || !S_ISREG(st.st_mode)) {
+    throw std::ios_base::failure("Failed to open file for reading: " + beforepath);
+  }
+  if (stat(afterpath.c_str(), &st) != 0 || !S_ISREG(st.st_mode)) {
+    throw std::ios_base::failure("Failed to open file for reading: " + afterpath);
+  }
+
+  std::ifstream before(beforepath.c_str(), std::ifstream::binary);
+
+  if (!before.is_open()) {
+    throw std::ios_base::failure("Failed to open file for reading: " + beforepath);
+  }
+
+  std::ifstream after(afterpath.c_str(), std::ifstream::binary);
+
+  if (!after.is_open()) {
+    before.close();
+    throw std::ios_base::failure("Failed to open file for reading: " + afterpath);
+  }
+
+  std::ofstream out(outpath.c_str(), std::ofstream::binary);
+
+  if (!out.is_open()) {
+    before.close();
+    after.close();
+    throw std::ios_base::failure("Failed to open file for writing: " + outpath);
+  }
+
+  try {
+    diff(before, after, config, out);
+  } catch (...) {
+    before.close();
+    after.close();
+    out.close();
+    throw;
+  }
+
+  before.close();
+  after.close();
+  out.close();
+}
+
+/**
+ * @brief 直前のdiffで追加されたCSVレコードの数を返します。
+ * @return CSVレコードの数
+ */
+std::size_t Differ::getAddedCount(void) const
+{
+  return addedCount;
+}
+
+/**
+ * @brief 直前のdiffで削除されたCSVレコードの数を返します。
+ * @return CSVレコードの数
+ */
+std::size_t Differ::getRemovedCount(void) const
+{
+  return removedCount;
+}
+
+/**
+ * @brief 直前のdiffで変更されたCSVレコードの数を返します。
+ * @return CSVレコードの数
+ */
+std::size_t Differ::getChangedCount(void) const
+{
+  return changedCount;
+}
+
+/**
+ * @brief 先頭の列に印を付けて、CSVレコードを書き込みます。
+ * @param writer Writerオブジェクト
+ * @param mark 印
+ * @param record CSVレコード
+ * @param fields 作業用のフィールド
+ * @exception std::ios_base::failure 出力ストリームにエラーが発生した場合
+ */
+void Differ::emit(Writer& writer,
+		  const std::string& mark,
+		  const LazyRecord& record,
+		  std::vector<std::string>& fields) const
+{
+  fields.resize(record.size() + 1);
+  fields[0] = mark;
+  for (std::size_t i = 0; i < record.size(); i++) {
+    record.get(i, fields[i + 1]);
+  }
+  writer.write(fields);
+}
+
+} // namespace csv
+} // namespace csl
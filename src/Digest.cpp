@@ -0,0 +1,161 @@
+/**
+ * @file  Digest.cpp
+ * @brief Digestクラス実装ファイル
+ */
+#include "csl/csv/Digest.hpp"
+#include "csl/csv/Hash.hpp"
+#include "csl/csv/LazyRecord.hpp"
+
+namespace csl {
+namespace csv {
+
+namespace {
+
+/**
+ * @brief 上位64ビットの初期値です。
+ */
+const std::uint64_t HIGH_SEED = 0x243F6A8885A308D3ULL;
+
+/**
+ * @brief 下位64ビットの初期値です。
+ */
+const std::uint64_t LOW_SEED = 0x13198A2E03707344ULL;
+
+} // namespace
+
+/**
+ * @brief 値が0のDigestオブジェクトを構築します。
+ */
+Digest::Digest(void)
+  : high(0)
+  , low(0)
+{
+}
+
+/**
+ * @brief CSVレコード全体のハッシュ値を求めます。
+ *
+ * フィールドの数も値に含めるため、末尾に空のフィールドがあるかどうかも区別します。
+ * @param record CSVレコード
+ */
+Digest::Digest(const LazyRecord& record)
+  : high(HIGH_SEED)
+  , low(LOW_SEED)
+{
+  for (std::size_t i = 0; i < record.size(); i++) {
+    add(record, i);
+  }
+  finish(record.size());
+}
+
+/**
+ * @brief CSVレコードの指定された列のハッシュ値を求めます。
+ *
+ * 列がない場合は空文字列として扱います。
+ * @param record CSVレコード
+ * @param columns 列の番号
+ */
+Digest::Digest(const LazyRecord& record, const std::vector<std::size_t>& columns)
+  : high(HIGH_SEED)
+  , low(LOW_SEED)
+{
+  for (std::size_t i = 0; i < columns.size(); i++) {
+    add(record, columns[i]);
+  }
+  finish(columns.size());
+}
+
+/**
+ * @brief Digestオブジェクトを破棄します。
+ */
+Digest::~Digest(void)
+{
+}
+
+/**
+ * @brief ハッシュ値の上位64ビットを返します。
+ * @return 上位64ビット
+ */
+std::uint64_t Digest::getHigh(void) const
+{
+  return high;
+}
+
+/**
+ * @brief ハッシュ値の下位64ビットを返します。
+ * @return 下位64ビット
+ */
+std::uint64_t Digest::getLow(void) const
+{
+  return low;
+}
+
+/**
+ * @brief ハッシュ値が等しいかどうかを返します。
+ * @param digest Digestオブジェクト
+ * @return 等しい場合はtrue
+ */
+bool Digest::operator==(const Digest& digest) const
+{
+  return high == digest.high && low == digest.low;
+}
+
+/**
+ * @brief ハッシュ値が異なるかどうかを返します。
+ * @param digest Digestオブジェクト
+ * @return 異なる場合はtrue
+ */
+bool Digest::operator!=(const Digest& digest) const
+{
+  return !(*this == digest);
+}
+
+/**
+ * @brief ハッシュ値を符号なし128ビット整数として比較します。
+ * @param digest Digestオブジェクト
+ * @return このハッシュ値の方が小さい場合はtrue
+ */
+bool Digest::operator<(const Digest& digest) const
+{
+  return (high != digest.high) ? (high < digest.high) : (low < digest.low);
+}
+
+/**
+ * @brief 1つのフィールドの値をハッシュ値に加えます。
+ * @param record CSVレコード
+ * @param index フィールドの番号
+ */
+void Digest::add(const LazyRecord& record, const std::size_t index)
+{
+  const char* data = "";
+  std::size_t size = 0;
+
+  if (index < record.size()) {
+    if (record.isQuoted(index)) {
+      const std::string& value = record.get(index);
+      data = value.data();
+      size = value.size();
+    } else {
+      data = record.getRawData(index);
+      size = record.getRawSize(index);
+    }
+  }
+
+  // chaining through the seed keeps field boundaries significant
+  high = Hash::hash(data, size, high);
+  low = Hash::hash(data, size, low);
+}
+
+/**
+ * @brief フィールドの数をハッシュ値に加えます。
+ * @param count フィールドの数
+ */
+void Digest::finish(const std::size_t count)
+{
+  const std::uint64_t value = count;
+  high = Hash::hash(reinterpret_cast<const char*>(&value), sizeof(value), high);
+  low = Hash::hash(reinterpret_cast<const char*>(&value), sizeof(value), low);
+}
+
+} // namespace csv
+} // namespace csl
@@ -0,0 +1,286 @@
+/**
+ * @file  EncodedTable.cpp
+ * @brief EncodedTableクラス実装ファイル
+ */
+#include "csl/csv/EncodedTable.hpp"
+#include <stdexcept>
+
+namespace csl {
+namespace csv {
+
+/**
+ * @brief 空のEncodedTableオブジェクトを構築します。
+ */
+EncodedTable::EncodedTable(void)
+  : autoEncodeLimit(ENCODE_AUTO_LIMIT)
+{
+}
+
+/**
+ * @brief EncodedTableオブジェクトを破棄します。
+ */
+EncodedTable::~EncodedTable(void)
+{
+}
+
+/**
+ * @brief 指定された列を常に符号化するかどうかを設定します。
+ *
+ * 設定はこれ以降に作られる列に適用されるため、CSVレコードを追加する前に設定します。
+ * @param column 列の番号
+ * @param encoded 常に符号化する場合はtrue、自動的に判定する場合はfalse
+ */
+void EncodedTable::setEncoded(const std::size_t column, const bool encoded)
+{
+  if (column >= selected.size()) {
+    selected.resize(column + 1, false);
+  }
+  selected[column] = encoded;
+}
+
+/**
+ * @brief setEncodedで指定されていない列を自動的に符号化する、異なる値の数の上限を設定します。
+ * @param limit 異なる値の数の上限(0の場合は自動的に符号化しない)
+ */
+void EncodedTable::setAutoEncodeLimit(const std::size_t limit)
+{
+  autoEncodeLimit = limit;
+}
+
+/**
+ * @brief すべてのCSVレコードを取り除きます。符号化する列の設定は残します。
+ */
+void EncodedTable::clear(void)
+{
+  columns.clear();
+  fieldCounts.clear();
+}
+
+/**
+ * @brief CSVレコードを追加します。
+ * @param record CSVレコード
+ */
+void EncodedTable::add(const std::vector<std::string>& record)
+{
+  for (std::size_t i = 0; i < record.size(); i++) {
+    if (i >= columns.size()) {
+      addColumn();
+    }
+    addField(i, record[i].data(), record[i].size());
+  }
+  for (std::size_t i = record.size(); i < columns.size(); i++) {
+    addField(i, "", 0); // placeholder for a missing field
+  }
+
+  fieldCounts.push_back(static_cast<std::uint32_t>(record.size()));
+}
+
+/**
+ * @brief フィールドを解釈しながらCSVレコードを追加します。
+ * @param record CSVレコード
+ */
+void EncodedTable::add(const LazyRecord& record)
+{
+  for (std::size_t i = 0; i < record.size(); i++) {
+    if (i >= columns.size()) {
+      addColumn();
+    }
+    if (record.isQuoted(i)) {
+      const std::string& field = record.get(i);
+      addField(i, field.data(), field.size());
+    } else {
+      addField(i, record.getRawData(i), record.getRawSize(i));
+    }
+  }
+  for (std::size_t i = record.size(); i < columns.size(); i++) {
+    addField(i, "", 0); // placeholder for a missing field
+  }
+
+  fieldCounts.push_back(static_cast<std::uint32_t>(record.size()));
+}
+
+/**
+ * @brief CSVレコードの数を返します。
+ * @return CSVレコードの数
+ */
+std::size_t EncodedTable::getRowCount(void) const
+{
+  return fieldCounts.size();
+}
+
+/**
+ * @brief 列の数(最もフィールドの多いCSVレコードのフィールドの数)を返します。
+ * @return 列の数
+ */
+std::size_t EncodedTable::getColumnCount(void) const
+{
+  return columns.size();
+}
+
+/**
+ * @brief 指定されたCSVレコードのフィールドの数を返します。
+ * @param row CSVレコードの番号
+ * @return フィールドの数
+ * @exception std::out_of_range CSVレコードの番号が範囲外の場合
+ */
+std::size_t EncodedTable::getFieldCount(const std::size_t row) const
+{
+  if (row >= fieldCounts.size()) {
+    throw std::out_of_range("Invalid row.");
+  }
+  return fieldCounts[row];
+}
+
+/**
+ * @brief 指定された列を符号化しているかどうかを返します。
+ * @param column 列の番号
+ * @return 符号化している場合はtrue
+ * @exception std::out_of_range 列の番号が範囲外の場合
+ */
+bool EncodedTable::isEncoded(const std::size_t column) const
+{
+  if (column >= columns.size()) {
+    throw std::out_of_range("Invalid column.");
+  }
+  return columns[column].encoded;
+}
+
+/**
+ * @brief 指定されたフィールドの値を返します。
+ * @param row CSVレコードの番号
+ * @param column 列の番号
+ * @return フィールドの値
+ * @exception std::out_of_range CSVレコードにそのフィールドがない場合
+ */
+const std::string& EncodedTable::get(const std::size_t row, const std::size_t column) const
+{
+  const Column& c = at(row, column);
+  return c.encoded ? c.dictionary.get(c.codes[row]) : c.values[row];
+}
+
+/**
+ * @brief 符号化した列の、指定されたフィールドのコードを返します。
+ *
+ * 同じ列のフィールドどうしは、コードを比べるだけで等しいかどうかがわかります。
+ * @param row CSVレコードの番号
+ * @param column 列の番号
+ * @return コード
+ * @exception std::out_of_range CSVレコードにそのフィールドがない場合
+ * @exception std::invalid_argument 列を符号化していない場合
+ */
+std::uint32_t EncodedTable::getCode(const std::size_t row, const std::size_t column) const
+{
+  const Column& c = at(row, column);
+  if (!c.encoded) {
+    throw std::invalid_argument("Column is not encoded.");
+  }
+  return c.codes[row];
+}
+
+/**
+ * @brief 指定された列の辞書を返します。符号化していない列の場合は空の辞書です。
+ * @param column 列の番号
+ * @return 辞書
+ * @exception std::out_of_range 列の番号が範囲外の場合
+ */
+const Dictionary& EncodedTable::getDictionary(const std::size_t column) const
+{
+  if (column >= columns.size()) {
+    throw std::out_of_range("Invalid column.");
+  }
+  return columns[column].dictionary;
+}
+
+/**
+ * @brief 指定されたCSVレコードを文字列に戻して返します。
+ * @param row CSVレコードの番号
+ * @param record CSVレコード
+ * @exception std::out_of_range CSVレコードの番号が範囲外の場合
+ */
+void EncodedTable::getRecord(const std::size_t row, std::vector<std::string>& record) const
+{
+  const std::size_t size = getFieldCount(row);
+
+  record.clear();
+  for (std::size_t i = 0; i < size; i++) {
+    record.push_back(get(row, i));
+  }
+}
+
+/**
+ * @brief 指定された列の末尾にフィールドを追加します。
+ *
+ * 自動的に符号化している列の異なる値の数が上限を超えた場合は、文字列の列に戻します。
+ * @param column 列の番号
+ * @param data フィールドの先頭
+ * @param size フィールドのバイト数
+ */
+void EncodedTable::addField(const std::size_t column, const char* data, const std::size_t size)
+{
+  Column& c = columns[column];
+
+  if (!c.encoded) {
+    c.values.push_back(std::string(data, size));
+    return;
+  }
+
+  c.codes.push_back(c.dictionary.intern(data, size));
+
+  const bool fixed = column < selected.size() && selected[column];
+  if (!fixed && c.dictionary.size() > autoEncodeLimit) {
+    decodeColumn(c);
+  }
+}
+
+/**
+ * @brief 列を追加して、これまでのCSVレコードには欠けたフィールドとして空文字列を入れます。
+ */
+void EncodedTable::addColumn(void)
+{
+  const std::size_t index = columns.size();
+  columns.push_back(Column());
+
+  Column& c = columns.back();
+  c.encoded = (index < selected.size() && selected[index]) || autoEncodeLimit > 0;
+  if (c.encoded) {
+    if (!fieldCounts.empty()) {
+      c.codes.assign(fieldCounts.size(), c.dictionary.intern("", 0));
+    }
+  } else {
+    c.values.resize(fieldCounts.size());
+  }
+}
+
+/**
+ * @brief 符号化している列を文字列の列に戻します。
+ * @param column 列
+ */
+void EncodedTable::decodeColumn(Column& column)
+{
+  column.values.reserve(column.codes.size());
+  for (std::size_t i = 0; i < column.codes.size(); i++) {
+    column.values.push_back(column.dictionary.get(column.codes[i]));
+  }
+
+  std::vector<std::uint32_t>().swap(column.codes);
+  column.dictionary = Dictionary();
+  column.encoded = false;
+}
+
+/**
+ * @brief 指定されたフィールドを含む列を返します。
+ * @param row CSVレコードの番号
+ * @param column 列の番号
+ * @return 列
+ * @exception std::out_of_range CSVレコードにそのフィールドがない場合
+ */
+const EncodedTable::Column& EncodedTable::at(const std::size_t row, const std::size_t column) const
+{
+  if (column >= getFieldCount(row)) {
+    throw std::out_of_range("Invalid column.");
+  }
+  return columns[column];
+}
+
+} // namespace csv
+} // namespace csl
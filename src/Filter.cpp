@@ -0,0 +1,222 @@
+/**
+ * @file  Filter.cpp
+ * @brief Filterクラス実装ファイル
+ */
+#include "csl/csv/Filter.hpp"
+#include <cstring>
+#include "csl/csv/Util.hpp"
+
+namespace csl {
+namespace csv {
+
+/**
+ * @brief 条件のないFilterオブジェクトを構築します。すべてのCSVレコードを選びます。
+ */
+Filter::Filter(void)
+{
+}
+
+/**
+ * @brief Filterオブジェクトを破棄します。
+ */
+Filter::~Filter(void)
+{
+}
+
+/**
+ * @brief 指定された列が指定された値に等しいという条件を追加します。
+ * @param column 列の番号
+ * @param value 値
+ */
+void Filter::addEquals(const std::size_t column, const std::string& value)
+{
+  add(column, TYPE_EQUALS).value = value;
+}
+
+/**
+ * @brief 指定された列が指定された値で始まるという条件を追加します。
+ * @param column 列の番号
+ * @param prefix 値の先頭
+ */
+void Filter::addPrefix(const std::size_t column, const std::string& prefix)
+{
+  add(column, TYPE_PREFIX).value = prefix;
+}
+
+/**
+ * @brief 指定された列が指定された値のいずれかに等しいという条件を追加します。
+ * @param column 列の番号
+ * @param values 値
+ */
+void Filter::addIn(const std::size_t column, const std::vector<std::string>& values)
+{
+  Predicate& predicate = add(column, TYPE_IN);
+  for (std::size_t i = 0; i < values.size(); i++) {
+    predicate.values.intern(values[i]);
+  }
+}
+
+/**
+ * @brief 指定された列が数値で、指定された範囲にあるという条件を追加します。
+ *
+ * フィールド全体が数値として解釈できない場合は条件を満たしません。
+ * @param column 列の番号
+ * @param minimum 最小値(この値を含む)
+ * @param maximum 最大値(この値を含む)
+ */
+void Filter::addRange(const std::size_t column, const double minimum, const double maximum)
+{
+  Predicate& predicate = add(column, TYPE_RANGE);
+  predicate.minimum = minimum;
+  predicate.maximum = maximum;
+}
+
+/**
+ * @brief すべての条件を取り除きます。
+ */
+void Filter::clear(void)
+{
+  columns.clear();
+}
+
+/**
+ * @brief 条件がないかどうかを返します。
+ * @return 条件がない場合はtrue
+ */
+bool Filter::empty(void) const
+{
+  return columns.empty();
+}
+
+/**
+ * @brief 指定されたCSVレコードがすべての条件を満たすかどうかを返します。
+ * @param record CSVレコード
+ * @return すべての条件を満たす場合はtrue
+ */
+bool Filter::matches(const std::vector<std::string>& record) const
+{
+  if (record.size() < columns.size()) {
+    return false;
+  }
+  for (std::size_t i = 0; i < columns.size(); i++) {
+    if (!test(i, record[i].data(), record[i].size())) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief 指定されたCSVレコードがすべての条件を満たすかどうかを返します。
+ * @param record CSVレコード
+ * @return すべての条件を満たす場合はtrue
+ */
+bool Filter::matches(const LazyRecord& record) const
+{
+  if (record.size() < columns.size()) {
+    return false;
+  }
+  for (std::size_t i = 0; i < columns.size(); i++) {
+    if (!test(record, i)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief 指定された列に条件を追加して返します。
+ * @param column 列の番号
+ * @param type 条件の種類
+ * @return 追加した条件
+ */
+Filter::Predicate& Filter::add(const std::size_t column, const Type type)
+{
+  if (column >= columns.size()) {
+    columns.resize(column + 1);
+  }
+
+  columns[column].push_back(Predicate());
+  Predicate& predicate = columns[column].back();
+  predicate.type = type;
+  predicate.minimum = 0;
+  predicate.maximum = 0;
+  return predicate;
+}
+
+/**
+ * @brief 指定された列の値が、その列のすべての条件を満たすかどうかを返します。
+ * @param column 列の番号
+ * @param data 値の先頭
+ * @param size 値のバイト数
+ * @return すべての条件を満たす場合、またはその列に条件がない場合はtrue
+ */
+bool Filter::test(const std::size_t column, const char* data, const std::size_t size) const
+{
+  if (column >= columns.size()) {
+    return true;
+  }
+
+  const std::vector<Predicate>& predicates = columns[column];
+  for (std::size_t i = 0; i < predicates.size(); i++) {
+    const Predicate& predicate = predicates[i];
+    std::uint32_t code;
+    double number;
+
+    switch (predicate.type) {
+    case TYPE_EQUALS:
+      if (size != predicate.value.size() || std::memcmp(data, predicate.value.data(), size) != 0) {
+	return false;
+      }
+      break;
+    case TYPE_PREFIX:
+      if (size < predicate.value.size() || std::memcmp(data, predicate.value.data(), predicate.value.size()) != 0) {
+	return false;
+      }
+      break;
+    case TYPE_IN:
+      if (!predicate.values.find(data, size, code)) {
+	return false;
+      }
+      break;
+    case TYPE_RANGE:
+      if (!Util::parseNumber(data, size, number) || number < predicate.minimum || number > predicate.maximum) {
+	return false;
+      }
+      break;
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief 指定されたCSVレコードの指定された列が、その列のすべての条件を満たすかどうかを返します。
+ *
+ * 囲み文字を含まないフィールドは、読み込んだままのデータをそのまま調べます。
+ * @param record CSVレコード
+ * @param column 列の番号
+ * @return すべての条件を満たす場合、またはその列に条件がない場合はtrue
+ */
+bool Filter::test(const LazyRecord& record, const std::size_t column) const
+{
+  if (column >= columns.size() || columns[column].empty()) {
+    return true;
+  }
+  if (record.isQuoted(column)) {
+    const std::string& field = record.get(column);
+    return test(column, field.data(), field.size());
+  }
+  return test(column, record.getRawData(column), record.getRawSize(column));
+}
+
+/**
+ * @brief 条件のある最後の列の次の番号を返します。
+ * @return 条件のある最後の列の次の番号
+ */
+std::size_t Filter::getColumnCount(void) const
+{
+  return columns.size();
+}
+
+} // namespace csv
+} // namespace csl
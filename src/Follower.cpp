@@ -0,0 +1,428 @@
+/**
+ * @file  Follower.cpp
+ * @brief Followerクラス実装ファイル
+ */
+#include "csl/csv/Follower.hpp"
+#include <sstream>
+#include <cerrno>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#ifdef __linux__
+#include <sys/inotify.h>
+#endif
+#include "csl/csv/Reader.hpp"
+
+namespace csl {
+namespace csv {
+
+namespace {
+
+/**
+ * @brief 追記されたデータを一度に読み込むバイト数です。
+ */
+const std::size_t FOLLOW_READ_SIZE = 64 * 1024;
+
+/**
+ * @brief 切り詰めて書き直されていないかを確かめるために保持する、読み込んだデータの末尾のバイト数です。
+ */
+const std::size_t FOLLOW_CHECK_SIZE = 64;
+
+} // namespace
+
+/**
+ * @brief デフォルトのConfigオブジェクトを設定して、指定されたファイルを監視するFollowerオブジェクトを構築します。
+ * @param filepath ファイルパス
+ * @exception std::ios_base::failure ファイルを開けなかった場合
+ */
+Follower::Follower(const std::string& filepath)
+  : filepath(filepath)
+  , config(DEFAULT_CONFIG)
+  , fd(-1)
+  , notifyFd(-1)
+  , watchFd(-1)
+  , device(0)
+  , inode(0)
+  , offset(0)
+  , automaton(DEFAULT_CONFIG)
+  , scanned(0)
+  , complete(0)
+  , scanState(Automaton::STATE_NORMAL)
+  , recordStart(true)
+  , commentFlag(false)
+  , carriageReturnFlag(false)
+{
+  open();
+}
+
+/**
+ * @brief 指定されたConfigオブジェクトを設定して、指定されたファイルを監視するFollowerオブジェクトを構築します。
+ * @param filepath ファイルパス
+ * @param config Configオブジェクト
+ * @exception std::ios_base::failure ファイルを開けなかった場合
+ */
+Follower::Follower(const std::string& filepath, const Config& config)
+  : filepath(filepath)
+  , config(config)
+  , fd(-1)
+  , notifyFd(-1)
+  , watchFd(-1)
+  , device(0)
+  , inode(0)
+  , offset(0)
+  , automaton(config)
+  , scanned(0)
+  , complete(0)
+  , scanState(Automaton::STATE_NORMAL)
+  , recordStart(true)
+  , commentFlag(false)
+  , carriageReturnFlag(false)
+{
+  open();
+}
+
+/**
+ * @brief Followerオブジェクトを破棄します。
+ */
+Follower::~Follower(void)
+{
+  close();
+
+  if (notifyFd >= 0) {
+    ::close(notifyFd);
+  }
+}
+
+/**
+ * @brief 前回の呼び出し以降に追記されたCSVレコードを読み込んで返します。
+ *
+ * 末尾のCRLFがまだ書き込まれていないCSVレコードは読み込まずに保留し、次回以降の呼び出しで読み込みます。
+ * 1回に読み込むのはFOLLOW_READ_LIMITバイトまでで、残りは次回以降の呼び出しで読み込みます。
+ * ファイルが切り詰められた場合(切り詰めた後に前回より大きく書き直された場合を含む)は先頭から読み込みます。
+ * 別のファイルに置き換えられた場合は、元のファイルの残りをすべて読み込んでから新しいファイルの先頭から読み込みます。
+ * 新しいファイルを開けなかった場合は、元のファイルの残りのCSVレコードがあればそれを返し、次回の呼び出しで開き直します。
+ * @param csv CSVデータ
+ * @return 検出したファイルの変化
+ * @exception std::ios_base::failure ファイルの読み込みに失敗した場合
+ */
+Follower::Event Follower::read(std::vector<std::vector<std::string> >& csv)
+{
+  csv.clear();
+
+  Event event = EVENT_NONE;
+  struct stat st;
+
+  if (fd < 0) {
+    open(); // the file could not be reopened after the last rotation
+    event = EVENT_ROTATED;
+  } else if (stat(filepath.c_str(), &st) == 0 && (st.st_dev != device || st.st_ino != inode)) {
+    while (readAppended()) {
+      scan();
+      parse(csv, false);
+    }
+    scan();
+    parse(csv, true);
+    close();
+    try {
+      open();
+    } catch (const std::ios_base::failure&) {
+      if (csv.empty()) {
+	throw;
+      }
+      return EVENT_ROTATED; // reopened on the next call
+    }
+    event = EVENT_ROTATED;
+  } else {
+    if (fstat(fd, &st) != 0) {
+      throw std::ios_base::failure("Failed to read.");
+    }
+    if (isTruncated(st)) {
+      offset = 0;
+      pending.clear();
+      tail.clear();
+      reset();
+      event = EVENT_TRUNCATED;
+    }
+    modified = st.st_mtim;
+  }
+
+  readAppended();
+  scan();
+  parse(csv, false);
+
+  if (event == EVENT_NONE && csv.size() > 0) {
+    event = EVENT_APPENDED;
+  }
+
+  return event;
+}
+
+/**
+ * @brief ファイルが変化するまで待ちます。
+ *
+ * inotifyが使える場合はその通知で、使えない場合はFOLLOW_POLL_INTERVALごとにファイルの状態を確認して待ちます。
+ * @param timeout 待つ時間の上限(ミリ秒)
+ * @return ファイルが変化した場合はtrue、上限までに変化しなかった場合はfalse
+ */
+bool Follower::wait(const int timeout)
+{
+  int remaining = timeout;
+
+  for (;;) {
+    struct stat st;
+    if (stat(filepath.c_str(), &st) == 0
+	&& (st.st_dev != device || st.st_ino != inode
+	    || st.st_size != offset + static_cast<std::streamoff>(pending.size()))) {
+      return true;
+    }
+
+    if (remaining <= 0) {
+      return false;
+    }
+
+    const int interval = (remaining < FOLLOW_POLL_INTERVAL) ? remaining : FOLLOW_POLL_INTERVAL;
+    if (watchFd >= 0) {
+      struct pollfd pfd;
+      pfd.fd = notifyFd;
+      pfd.events = POLLIN;
+      pfd.revents = 0;
+      if (poll(&pfd, 1, interval) > 0) {
+	char events[4096];
+	while (::read(notifyFd, events, sizeof(events)) > 0) {
+	  // discard the events and check the file itself
+	}
+      }
+    } else {
+      poll(NULL, 0, interval);
+    }
+    remaining -= interval;
+  }
+}
+
+/**
+ * @brief 読み込みを終えたCSVレコードの直後の位置を返します。
+ * @return 読み込みを終えたCSVレコードの直後の位置
+ */
+std::streamoff Follower::getOffset(void) const
+{
+  return offset;
+}
+
+/**
+ * @brief ファイルを開いて、先頭から監視を始めます。
+ * @exception std::ios_base::failure ファイルを開けなかった場合
+ */
+void Follower::open(void)
+{
+  struct stat st;
+  fd = ::open(filepath.c_str(), O_RDONLY | O_CLOEXEC);
+
+  if (fd < 0 || fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+    close();
+    throw std::ios_base::failure("Failed to open file for reading: " + filepath);
+  }
+
+  device = st.st_dev;
+  inode = st.st_ino;
+  modified = st.st_mtim;
+  offset = 0;
+  pending.clear();
+  tail.clear();
+  reset();
+  watch();
+}
+
+/**
+ * @brief ファイルを閉じます。
+ */
+void Follower::close(void)
+{
+  if (fd >= 0) {
+    ::close(fd);
+    fd = -1;
+  }
+}
+
+/**
+ * @brief inotifyでファイルの監視を登録します。inotifyが使えない場合は何もしません。
+ */
+void Follower::watch(void)
+{
+#ifdef __linux__
+  if (notifyFd < 0) {
+    notifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  }
+  if (notifyFd < 0) {
+    return; // fall back to polling
+  }
+  if (watchFd >= 0) {
+    inotify_rm_watch(notifyFd, watchFd);
+  }
+  watchFd = inotify_add_watch(notifyFd, filepath.c_str(),
+			      IN_MODIFY | IN_ATTRIB | IN_MOVE_SELF | IN_DELETE_SELF);
+#endif
+}
+
+/**
+ * @brief 保留中のデータの走査の状態を初期化します。
+ */
+void Follower::reset(void)
+{
+  scanned = 0;
+  complete = 0;
+  scanState = Automaton::STATE_NORMAL;
+  recordStart = true;
+  commentFlag = false;
+  carriageReturnFlag = false;
+}
+
+/**
+ * @brief ファイルが切り詰められたかどうかを返します。
+ *
+ * 前回より小さくなった場合のほか、大きさか更新時刻が変わった場合は、読み込んだデータの末尾が変わっていないかを確かめます。
+ * @param st ファイルの状態
+ * @return 切り詰められた場合はtrue
+ * @exception std::ios_base::failure ファイルの読み込みに失敗した場合
+ */
+bool Follower::isTruncated(const struct stat& st)
+{
+  const std::streamoff end = offset + static_cast<std::streamoff>(pending.size());
+
+  if (st.st_size < end) {
+    return true;
+  }
+  if (tail.empty()
+      || (st.st_size == end
+	  && st.st_mtim.tv_sec == modified.tv_sec
+	  && st.st_mtim.tv_nsec == modified.tv_nsec)) {
+    return false;
+  }
+
+  std::string data(tail.size(), '\0');
+  ssize_t size;
+  do {
+    size = pread(fd, &data[0], data.size(), end - static_cast<std::streamoff>(tail.size()));
+  } while (size < 0 && errno == EINTR);
+  if (size < 0) {
+    throw std::ios_base::failure("Failed to read.");
+  }
+
+  return static_cast<std::size_t>(size) != tail.size() || data != tail;
+}
+
+/**
+ * @brief 前回の呼び出し以降に追記されたデータを、FOLLOW_READ_LIMITバイトまで読み込んで保留中のデータの後ろに追加します。
+ * @return 上限まで読み込んだ(まだ残りがあるかもしれない)場合はtrue
+ * @exception std::ios_base::failure ファイルの読み込みに失敗した場合
+ */
+bool Follower::readAppended(void)
+{
+  std::string buffer(FOLLOW_READ_SIZE, '\0');
+  std::size_t total = 0;
+
+  while (total < FOLLOW_READ_LIMIT) {
+    const ssize_t size = pread(fd, &buffer[0], buffer.size(),
+			       offset + static_cast<std::streamoff>(pending.size()));
+    if (size < 0) {
+      if (errno == EINTR) {
+	continue;
+      }
+      throw std::ios_base::failure("Failed to read.");
+    }
+    if (size == 0) {
+      return false;
+    }
+
+    const std::size_t count = static_cast<std::size_t>(size);
+    pending.append(buffer, 0, count);
+    total += count;
+
+    if (count >= FOLLOW_CHECK_SIZE) {
+      tail.assign(buffer, count - FOLLOW_CHECK_SIZE, FOLLOW_CHECK_SIZE);
+    } else {
+      tail.append(buffer, 0, count);
+      if (tail.size() > FOLLOW_CHECK_SIZE) {
+	tail.erase(0, tail.size() - FOLLOW_CHECK_SIZE);
+      }
+    }
+  }
+
+  return true;
+}
+
+/**
+ * @brief 保留中のデータのうち、前回までに走査していない部分を走査して、終端まで書き込まれたCSVレコードの終わりを求めます。
+ *
+ * 走査の状態は呼び出しをまたいで保持するため、ゆっくり書き込まれる長いCSVレコードも各バイトを一度だけ走査します。
+ * CSVレコードの先頭のコメント行は、Scannerクラスと同じく次のCSVレコードと合わせて1つとして扱います。
+ */
+void Follower::scan(void)
+{
+  for (; scanned < pending.size(); scanned++) {
+    const char c = pending[scanned];
+
+    if (commentFlag) {
+      if (carriageReturnFlag && c == '\n') {
+	commentFlag = false;
+      }
+      carriageReturnFlag = (c == '\r');
+      continue;
+    }
+
+    if (recordStart) {
+      recordStart = false;
+      if (automaton.isCommentMark(c)) {
+	commentFlag = true;
+	carriageReturnFlag = false;
+	continue;
+      }
+    }
+
+    const Automaton::Transition transition = automaton.step(scanState, c);
+    if ((transition.actions & Automaton::ACTION_END_RECORD) != 0) {
+      complete = scanned + 1;
+      scanState = Automaton::STATE_NORMAL;
+      recordStart = true;
+    } else {
+      scanState = transition.state;
+    }
+  }
+}
+
+/**
+ * @brief 保留中のデータのうち、終端まで書き込まれたCSVレコードを読み込んで返します。
+ * @param csv CSVデータ
+ * @param flush 終端が書き込まれていないCSVレコードも読み込むかどうか
+ */
+void Follower::parse(std::vector<std::vector<std::string> >& csv, const bool flush)
+{
+  const std::size_t position = flush ? pending.size() : complete;
+
+  if (position == 0) {
+    return;
+  }
+
+  std::istringstream input(pending.substr(0, position));
+  Reader reader(input, config);
+  std::vector<std::string> record;
+
+  while (reader.hasNext()) {
+    reader.read(record);
+    csv.push_back(record);
+    record.clear();
+  }
+
+  pending.erase(0, position);
+  offset += static_cast<std::streamoff>(position);
+
+  if (flush) {
+    reset();
+  } else {
+    scanned -= position;
+    complete = 0;
+  }
+}
+
+} // namespace csv
+} // namespace csl
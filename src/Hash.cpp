@@ -0,0 +1,59 @@
+/**
+ * @file  Hash.cpp
+ * @brief Hashクラス実装ファイル
+ */
+#include "csl/csv/Hash.hpp"
+#include <cstring>
+
+namespace csl {
+namespace csv {
+
+/**
+ * @brief 指定されたバイト列のハッシュ値を返します。
+ * @param data データ
+ * @param size バイト数
+ * @return ハッシュ値
+ */
+std::uint64_t Hash::hash(const char* data, const std::size_t size)
+{
+  return hash(data, size, 0);
+}
+
+/**
+ * @brief 指定された初期値から、指定されたバイト列のハッシュ値を求めて返します。
+ *
+ * 前のブロックのハッシュ値を初期値にすれば、大きなデータをブロックごとにハッシュできます。
+ * @param data データ
+ * @param size バイト数
+ * @param seed 初期値
+ * @return ハッシュ値
+ */
+std::uint64_t Hash::hash(const char* data, const std::size_t size, const std::uint64_t seed)
+{
+  std::uint64_t h = (seed ^ 0x9E3779B97F4A7C15ULL) ^ (size * 0xFF51AFD7ED558CCDULL);
+  std::size_t remaining = size;
+
+  for (; remaining >= 8; data += 8, remaining -= 8) {
+    std::uint64_t k;
+    std::memcpy(&k, data, 8);
+    k *= 0x87C37B91114253D5ULL;
+    k ^= k >> 31;
+    h = (h ^ k) * 0x4CF5AD432745937FULL;
+  }
+
+  std::uint64_t k = 0;
+  for (std::size_t i = 0; i < remaining; i++) {
+    k |= static_cast<std::uint64_t>(static_cast<unsigned char>(data[i])) << (i * 8);
+  }
+  h = (h ^ k) * 0x4CF5AD432745937FULL;
+
+  h ^= h >> 33;
+  h *= 0xFF51AFD7ED558CCDULL;
+  h ^= h >> 33;
+  h *= 0xC4CEB9FE1A85EC53ULL;
+  h ^= h >> 33;
+  return h;
+}
+
+} // namespace csv
+} // namespace csl
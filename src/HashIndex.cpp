@@ -0,0 +1,575 @@
+/**
+ * @file  HashIndex.cpp
+ * @brief HashIndexクラス実装ファイル
+ */
+#include "csl/csv/HashIndex.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <ios>
+#include <vector>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "csl/csv/Hash.hpp"
+
+namespace csl {
+namespace csv {
+
+namespace {
+
+/**
+ * @brief 索引ファイルの先頭に置く識別子です。
+ */
+const char INDEX_MAGIC[8] = {'C', 'S', 'L', 'C', 'S', 'V', 'I', '\0'};
+
+/**
+ * @brief 索引ファイル形式のバージョンです。
+ */
+const std::uint32_t INDEX_VERSION = 1;
+
+/**
+ * @brief バイト順を確かめるための値です。
+ */
+const std::uint32_t INDEX_BYTE_ORDER = 0x01020304u;
+
+/**
+ * @brief 索引ファイルのヘッダーです。
+ */
+struct IndexHeader
+{
+  char magic[8];                ///< 識別子
+  std::uint32_t version;        ///< 形式のバージョン
+  std::uint32_t byteOrder;      ///< バイト順を確かめるための値
+  std::uint64_t sourceSize;     ///< 元のファイルのバイト数
+  std::int64_t sourceMtime;     ///< 元のファイルの更新時刻(秒)
+  std::int64_t sourceMtimeNsec; ///< 元のファイルの更新時刻(ナノ秒)
+  std::uint64_t rowCount;       ///< CSVレコードの数
+  std::uint64_t column;         ///< キーの列の番号
+  std::uint64_t count;          ///< 索引に含めたCSVレコードの数
+  std::uint64_t shardCount;     ///< シャードの数
+  std::uint64_t slotCount;      ///< スロットの数
+};
+
+/**
+ * @brief 指定されたハッシュ値のシャードの番号を返します。
+ * @param hash ハッシュ値
+ * @return シャードの番号
+ */
+std::size_t getShard(const std::uint64_t hash)
+{
+  // shards use high bits so that slots within a shard can use the low bits
+  return static_cast<std::size_t>(hash >> 32) & (INDEX_SHARDS - 1);
+}
+
+/**
+ * @brief 指定されたCSVレコードのキーのハッシュ値を求めて、シャードごとの数を数えます。
+ * @param csv CSVデータ
+ * @param column キーの列の番号
+ * @param begin 最初のCSVレコードの番号
+ * @param end 最後のCSVレコードの次の番号
+ * @param hashes CSVレコードごとのハッシュ値
+ * @param counts シャードごとのCSVレコードの数
+ */
+void hashRows(const std::vector<std::vector<std::string> >& csv,
+	      const std::size_t column,
+	      const std::size_t begin,
+	      const std::size_t end,
+	      std::vector<std::uint64_t>& hashes,
+	      std::vector<std::size_t>& counts)
+{
+  counts.assign(INDEX_SHARDS, 0);
+  for (std::size_t i = begin; i < end; i++) {
+    if (column < csv[i].size()) {
+      const std::string& key = csv[i][column];
+      hashes[i] = Hash::hash(key.data(), key.size());
+      counts[getShard(hashes[i])]++;
+    }
+  }
+}
+
+/**
+ * @brief シャードごとのCSVレコードの数から、シャードごとに並べたCSVレコードの番号での開始位置を求めます。
+ * @param counts シャードごとのCSVレコードの数
+ * @param starts シャードごとの開始位置(最後の要素はCSVレコードの数の合計)
+ */
+void getStarts(const std::vector<std::size_t>& counts, std::vector<std::size_t>& starts)
+{
+  starts.assign(INDEX_SHARDS + 1, 0);
+  for (std::size_t i = 0; i < INDEX_SHARDS; i++) {
+    starts[i + 1] = starts[i] + counts[i];
+  }
+}
+
+/**
+ * @brief 指定されたCSVレコードの番号を、シャードごとにCSVレコードの順に並べます(計数ソート)。
+ * @param csv CSVデータ
+ * @param column キーの列の番号
+ * @param begin 最初のCSVレコードの番号
+ * @param end 最後のCSVレコードの次の番号
+ * @param hashes CSVレコードごとのハッシュ値
+ * @param positions シャードごとの次に書き込む位置
+ * @param rows シャードごとに並べたCSVレコードの番号
+ */
+void sortRows(const std::vector<std::vector<std::string> >& csv,
+	      const std::size_t column,
+	      const std::size_t begin,
+	      const std::size_t end,
+	      const std::vector<std::uint64_t>& hashes,
+	      std::vector<std::size_t>& positions,
+	      std::vector<std::size_t>& rows)
+{
+  for (std::size_t i = begin; i < end; i++) {
+    if (column < csv[i].size()) {
+      rows[positions[getShard(hashes[i])]++] = i;
+    }
+  }
+}
+
+/**
+ * @brief 指定されたファイルの状態をヘッダーに記録します。
+ * @param filepath ファイルパス
+ * @param header ヘッダー
+ * @return ファイルの状態が取得できた場合はtrue
+ */
+bool setSource(const std::string& filepath, IndexHeader& header)
+{
+  struct stat st;
+  if (stat(filepath.c_str(), &st) != 0 || !S_ISREG(st.st_mode)) {
+    return false;
+  }
+
+  header.sourceSize = static_cast<std::uint64_t>(st.st_size);
+  header.sourceMtime = static_cast<std::int64_t>(st.st_mtim.tv_sec);
+  header.sourceMtimeNsec = static_cast<std::int64_t>(st.st_mtim.tv_nsec);
+  return true;
+}
+
+} // namespace
+
+/**
+ * @brief 指定されたCSVデータの指定された列の索引を構築します。
+ * @param csv CSVデータ
+ * @param column キーの列の番号
+ */
+HashIndex::HashIndex(const std::vector<std::vector<std::string> >& csv,
+		     const std::size_t column)
+  : csv(csv), column(column), count(0), loaded(false)
+{
+  build();
+}
+
+/**
+ * @brief 指定されたCSVデータの指定された列の索引を、指定されたThreadPoolオブジェクトで並列に構築します。
+ *
+ * ハッシュ値とシャードごとの並べ替えはCSVレコードを分けて、ハッシュ表への挿入はシャードを分けて並列に求めます。
+ * 構築した索引は並列に構築しない場合と同じです。ThreadPoolオブジェクトのスレッドから呼び出してはいけません。
+ * @param csv CSVデータ
+ * @param column キーの列の番号
+ * @param pool ThreadPoolオブジェクト
+ */
+HashIndex::HashIndex(const std::vector<std::vector<std::string> >& csv,
+		     const std::size_t column,
+		     ThreadPool& pool)
+  : csv(csv), column(column), count(0), loaded(false)
+{
+  const std::size_t tasks = pool.getSize() < INDEX_SHARDS ? pool.getSize() : INDEX_SHARDS;
+  std::vector<std::uint64_t> hashes(csv.size());
+  std::vector<std::vector<std::size_t> > taskCounts(tasks);
+
+  for (std::size_t i = 0; i < tasks; i++) {
+    const std::size_t begin = csv.size() * i / tasks;
+    const std::size_t end = csv.size() * (i + 1) / tasks;
+    std::vector<std::size_t>& counts = taskCounts[i];
+    pool.submit([&csv, column, begin, end, &hashes, &counts]() {
+	hashRows(csv, column, begin, end, hashes, counts);
+      });
+  }
+  pool.wait();
+
+  std::vector<std::size_t> counts(INDEX_SHARDS, 0);
+  for (std::size_t i = 0; i < tasks; i++) {
+    for (std::size_t j = 0; j < INDEX_SHARDS; j++) {
+      counts[j] += taskCounts[i][j];
+    }
+  }
+  allocate(counts);
+
+  // each task places its rows after those of earlier tasks, which keeps the row order within a shard
+  std::vector<std::size_t> starts;
+  std::vector<std::size_t> rows(count);
+  getStarts(counts, starts);
+  std::vector<std::size_t> positions(starts.begin(), starts.end() - 1);
+  for (std::size_t i = 0; i < tasks; i++) {
+    for (std::size_t j = 0; j < INDEX_SHARDS; j++) {
+      const std::size_t position = positions[j];
+      positions[j] += taskCounts[i][j];
+      taskCounts[i][j] = position;
+    }
+  }
+
+  for (std::size_t i = 0; i < tasks; i++) {
+    const std::size_t begin = csv.size() * i / tasks;
+    const std::size_t end = csv.size() * (i + 1) / tasks;
+    std::vector<std::size_t>& taskPositions = taskCounts[i];
+    pool.submit([&csv, column, begin, end, &hashes, &taskPositions, &rows]() {
+	sortRows(csv, column, begin, end, hashes, taskPositions, rows);
+      });
+  }
+  pool.wait();
+
+  for (std::size_t i = 0; i < tasks; i++) {
+    const std::size_t begin = INDEX_SHARDS * i / tasks;
+    const std::size_t end = INDEX_SHARDS * (i + 1) / tasks;
+    pool.submit([this, &hashes, &rows, &starts, begin, end]() {
+	insert(hashes, rows, starts, begin, end);
+      });
+  }
+  pool.wait();
+}
+
+/**
+ * @brief 指定されたCSV形式ファイルから読み込んだCSVデータの指定された列の索引を、索引ファイルから読み込むか、構築して索引ファイルに保存します。
+ *
+ * 索引ファイルが、CSV形式ファイルのサイズと更新時刻、CSVレコードの数、キーの列の番号に一致する場合は読み込みます。
+ * 一致しない場合や読み込めない場合は構築して、索引ファイルを作り直します。
+ * @param csv CSVデータ
+ * @param column キーの列の番号
+ * @param filepath CSVデータを読み込んだCSV形式ファイルのパス
+ * @param indexpath 索引ファイルのパス
+ * @exception std::ios_base::failure 索引ファイルに書き込めない場合
+ */
+HashIndex::HashIndex(const std::vector<std::vector<std::string> >& csv,
+		     const std::size_t column,
+		     const std::string& filepath,
+		     const std::string& indexpath)
+  : csv(csv), column(column), count(0), loaded(false)
+{
+  if (load(indexpath, filepath)) {
+    loaded = true;
+    return;
+  }
+
+  build();
+  save(indexpath, filepath);
+}
+
+/**
+ * @brief HashIndexオブジェクトを破棄します。
+ */
+HashIndex::~HashIndex(void)
+{
+}
+
+/**
+ * @brief キーの列の番号を返します。
+ * @return キーの列の番号
+ */
+std::size_t HashIndex::getColumn(void) const
+{
+  return column;
+}
+
+/**
+ * @brief 索引に含めたCSVレコードの数を返します。
+ * @return 索引に含めたCSVレコードの数
+ */
+std::size_t HashIndex::size(void) const
+{
+  return count;
+}
+
+/**
+ * @brief 構築時に索引ファイルから読み込んだかどうかを返します。
+ * @return 読み込んだ場合はtrue
+ */
+bool HashIndex::isLoaded(void) const
+{
+  return loaded;
+}
+
+/**
+ * @brief 指定されたキーを持つ最初のCSVレコードの番号を探します。
+ * @param key キー
+ * @param row 見つかった場合のCSVレコードの番号
+ * @return 見つかった場合はtrue
+ */
+bool HashIndex::find(const std::string& key, std::size_t& row) const
+{
+  std::size_t position = 0;
+  const Slot* slot = probe(key, Hash::hash(key.data(), key.size()), position);
+
+  if (slot == NULL) {
+    return false;
+  }
+  row = static_cast<std::size_t>(slot->row);
+  return true;
+}
+
+/**
+ * @brief 指定されたキーを持つ最初のCSVレコードを探します。
+ * @param key キー
+ * @return 見つかった場合はCSVレコード、見つからなかった場合はNULL
+ */
+const std::vector<std::string>* HashIndex::find(const std::string& key) const
+{
+  std::size_t row;
+  return find(key, row) ? &csv[row] : NULL;
+}
+
+/**
+ * @brief 指定されたキーを持つすべてのCSVレコードの番号を、CSVレコードの順に返します。
+ * @param key キー
+ * @param rows CSVレコードの番号
+ */
+void HashIndex::findAll(const std::string& key, std::vector<std::size_t>& rows) const
+{
+  const std::uint64_t hash = Hash::hash(key.data(), key.size());
+  std::size_t position = 0;
+
+  rows.clear();
+  for (const Slot* slot = probe(key, hash, position); slot != NULL; slot = probe(key, hash, position)) {
+    rows.push_back(static_cast<std::size_t>(slot->row));
+  }
+}
+
+/**
+ * @brief 索引を指定された索引ファイルに保存します。
+ *
+ * 一時ファイルに書き込んでから置き換えます。
+ * @param indexpath 索引ファイルのパス
+ * @param filepath CSVデータを読み込んだCSV形式ファイルのパス
+ * @exception std::ios_base::failure ファイルの読み書きにエラーが発生した場合
+ */
+void HashIndex::save(const std::string& indexpath, const std::string& filepath) const
+{
+  IndexHeader header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.magic, INDEX_MAGIC, sizeof(header.magic));
+  header.version = INDEX_VERSION;
+  header.byteOrder = INDEX_BYTE_ORDER;
+  if (!setSource(filepath, header)) {
+    throw std::ios_base::failure("Failed to open file for reading: " + filepath);
+  }
+  header.rowCount = csv.size();
+  header.column = column;
+  header.count = count;
+  header.shardCount = shards.size();
+  header.slotCount = slots.size();
+
+  // a unique name next to the index file, so concurrent saves never share it and rename stays atomic
+  const std::string pattern = indexpath + ".XXXXXX";
+  std::vector<char> path(pattern.begin(), pattern.end());
+  path.push_back('\0');
+
+  const int fd = mkstemp(&path[0]);
+  if (fd < 0) {
+    throw std::ios_base::failure("Failed to open file for writing: " + indexpath);
+  }
+  fchmod(fd, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH); // mkstemp creates 0600, readers may be other users
+  ::close(fd);
+
+  const std::string temppath(&path[0]);
+  std::ofstream stream(temppath.c_str(), std::ofstream::binary | std::ofstream::trunc);
+
+  if (!stream.is_open()) {
+    std::remove(temppath.c_str());
+    throw std::ios_base::failure("Failed to open file for writing: " + temppath);
+  }
+
+  stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  stream.write(reinterpret_cast<const char*>(&shards[0]), shards.size() * sizeof(Shard));
+  stream.write(reinterpret_cast<const char*>(&slots[0]), slots.size() * sizeof(Slot));
+  stream.close();
+
+  if (stream.fail() || std::rename(temppath.c_str(), indexpath.c_str()) != 0) {
+    std::remove(temppath.c_str());
+    throw std::ios_base::failure("Failed to write: " + indexpath);
+  }
+}
+
+/**
+ * @brief シャードごとのCSVレコードの数から、シャードごとのスロットを割り当てます。
+ *
+ * 負荷率が1/2以下になる2のべき乗のスロット数にします。
+ * @param counts シャードごとのCSVレコードの数
+ */
+void HashIndex::allocate(const std::vector<std::size_t>& counts)
+{
+  std::uint64_t offset = 0;
+
+  count = 0;
+  shards.resize(INDEX_SHARDS);
+  for (std::size_t i = 0; i < INDEX_SHARDS; i++) {
+    std::uint64_t capacity = 1;
+    while (capacity < counts[i] * 2) {
+      capacity *= 2;
+    }
+    shards[i].offset = offset;
+    shards[i].mask = capacity - 1;
+    offset += capacity;
+    count += counts[i];
+  }
+
+  Slot empty;
+  empty.hash = 0;
+  empty.row = INDEX_EMPTY;
+  slots.assign(static_cast<std::size_t>(offset), empty);
+}
+
+/**
+ * @brief 1つのスレッドで索引を構築します。
+ */
+void HashIndex::build(void)
+{
+  std::vector<std::uint64_t> hashes(csv.size());
+  std::vector<std::size_t> counts;
+
+  hashRows(csv, column, 0, csv.size(), hashes, counts);
+  allocate(counts);
+
+  std::vector<std::size_t> starts;
+  std::vector<std::size_t> rows(count);
+  getStarts(counts, starts);
+  std::vector<std::size_t> positions(starts.begin(), starts.end() - 1);
+  sortRows(csv, column, 0, csv.size(), hashes, positions, rows);
+  insert(hashes, rows, starts, 0, INDEX_SHARDS);
+}
+
+/**
+ * @brief 指定された範囲のシャードに属するCSVレコードを、CSVレコードの順に挿入します。
+ * @param hashes CSVレコードごとのハッシュ値
+ * @param rows シャードごとに並べたCSVレコードの番号
+ * @param starts シャードごとのrowsでの開始位置
+ * @param begin 最初のシャードの番号
+ * @param end 最後のシャードの次の番号
+ */
+void HashIndex::insert(const std::vector<std::uint64_t>& hashes,
+		       const std::vector<std::size_t>& rows,
+		       const std::vector<std::size_t>& starts,
+		       const std::size_t begin,
+		       const std::size_t end)
+{
+  for (std::size_t shard = begin; shard < end; shard++) {
+    Slot* table = &slots[static_cast<std::size_t>(shards[shard].offset)];
+    const std::uint64_t mask = shards[shard].mask;
+
+    for (std::size_t k = starts[shard]; k < starts[shard + 1]; k++) {
+      const std::size_t i = rows[k];
+      std::uint64_t position = hashes[i] & mask;
+
+      while (table[position].row != INDEX_EMPTY) {
+	position = (position + 1) & mask;
+      }
+      table[position].hash = hashes[i];
+      table[position].row = i;
+    }
+  }
+}
+
+/**
+ * @brief 指定された索引ファイルが指定されたCSV形式ファイルとCSVデータに一致する場合に読み込みます。
+ * @param indexpath 索引ファイルのパス
+ * @param filepath CSV形式ファイルのパス
+ * @return 読み込んだ場合はtrue
+ */
+bool HashIndex::load(const std::string& indexpath, const std::string& filepath)
+{
+  std::ifstream stream(indexpath.c_str(), std::ifstream::binary);
+  if (!stream.is_open()) {
+    return false;
+  }
+
+  IndexHeader header;
+  IndexHeader expected;
+  std::memset(&expected, 0, sizeof(expected));
+
+  if (!stream.read(reinterpret_cast<char*>(&header), sizeof(header))
+      || !setSource(filepath, expected)
+      || std::memcmp(header.magic, INDEX_MAGIC, sizeof(header.magic)) != 0
+      || header.version != INDEX_VERSION
+      || header.byteOrder != INDEX_BYTE_ORDER
+      || header.sourceSize != expected.sourceSize
+      || header.sourceMtime != expected.sourceMtime
+      || header.sourceMtimeNsec != expected.sourceMtimeNsec
+      || header.rowCount != csv.size()
+      || header.column != column
+      || header.count > header.rowCount
+      || header.shardCount != INDEX_SHARDS) {
+    return false;
+  }
+
+  shards.resize(INDEX_SHARDS);
+  if (!stream.read(reinterpret_cast<char*>(&shards[0]), shards.size() * sizeof(Shard))) {
+    shards.clear();
+    return false;
+  }
+
+  // shards must be laid out back to back as allocate() does, each under a load factor of 1/2
+  bool valid = true;
+  std::uint64_t offset = 0;
+  for (std::size_t i = 0; valid && i < shards.size(); i++) {
+    valid = ((shards[i].mask + 1) & shards[i].mask) == 0
+      && shards[i].mask < header.count * 4 + 1
+      && shards[i].offset == offset;
+    offset += shards[i].mask + 1;
+  }
+  if (!valid || offset != header.slotCount) {
+    shards.clear();
+    return false;
+  }
+
+  slots.resize(static_cast<std::size_t>(header.slotCount));
+  if (!stream.read(reinterpret_cast<char*>(&slots[0]), slots.size() * sizeof(Slot))) {
+    shards.clear();
+    slots.clear();
+    return false;
+  }
+
+  // every row must lie inside the data
+  for (std::size_t i = 0; valid && i < slots.size(); i++) {
+    valid = slots[i].row == INDEX_EMPTY || slots[i].row < csv.size();
+  }
+  if (!valid) {
+    shards.clear();
+    slots.clear();
+    return false;
+  }
+
+  count = static_cast<std::size_t>(header.count);
+  return true;
+}
+
+/**
+ * @brief 指定されたキーを持つスロットを、指定された位置から探します。
+ *
+ * 次に探す位置を返すため、繰り返し呼び出すと同じキーを持つすべてのスロットを挿入した順に返します。
+ * @param key キー
+ * @param hash キーのハッシュ値
+ * @param position 探し始める位置(最初のスロットからの距離で、最初の呼び出しでは0)と、次に探す位置
+ * @return 見つかった場合はスロット、見つからなかった場合はNULL
+ */
+const HashIndex::Slot* HashIndex::probe(const std::string& key, const std::uint64_t hash, std::size_t& position) const
+{
+  const Shard& shard = shards[getShard(hash)];
+  const Slot* table = &slots[static_cast<std::size_t>(shard.offset)];
+  const std::size_t mask = static_cast<std::size_t>(shard.mask);
+  const std::size_t first = static_cast<std::size_t>(hash) & mask;
+
+  while (position <= mask) {
+    const Slot& slot = table[(first + position) & mask];
+    if (slot.row == INDEX_EMPTY) {
+      return NULL;
+    }
+    position++;
+
+    const std::vector<std::string>& record = csv[static_cast<std::size_t>(slot.row)];
+    if (slot.hash == hash && column < record.size() && record[column] == key) {
+      return &slot;
+    }
+  }
+  return NULL;
+}
+
+} // namespace csv
+} // namespace csl
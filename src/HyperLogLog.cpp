@@ -0,0 +1,137 @@
+/**
+ * @file  HyperLogLog.cpp
+ * @brief HyperLogLogクラス実装ファイル
+ */
+#include "csl/csv/HyperLogLog.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include "csl/csv/Hash.hpp"
+
+namespace csl {
+namespace csv {
+
+/**
+ * @brief デフォルトの精度で、空のHyperLogLogオブジェクトを構築します。
+ */
+HyperLogLog::HyperLogLog(void)
+  : precision(HLL_PRECISION)
+  , registers(static_cast<std::size_t>(1) << HLL_PRECISION, 0)
+{
+}
+
+/**
+ * @brief 指定された精度で、空のHyperLogLogオブジェクトを構築します。
+ * @param precision レジスタの数の2を底とする対数(4から18まで)
+ * @exception std::invalid_argument 精度が範囲外の場合
+ */
+HyperLogLog::HyperLogLog(const std::size_t precision)
+  : precision(precision)
+{
+  if (precision < 4 || precision > 18) {
+    throw std::invalid_argument("Invalid precision.");
+  }
+  registers.assign(static_cast<std::size_t>(1) << precision, 0);
+}
+
+/**
+ * @brief HyperLogLogオブジェクトを破棄します。
+ */
+HyperLogLog::~HyperLogLog(void)
+{
+}
+
+/**
+ * @brief 精度を返します。
+ * @return レジスタの数の2を底とする対数
+ */
+std::size_t HyperLogLog::getPrecision(void) const
+{
+  return precision;
+}
+
+/**
+ * @brief 値を追加します。
+ * @param data 値の先頭
+ * @param size 値のバイト数
+ */
+void HyperLogLog::add(const char* data, const std::size_t size)
+{
+  addHash(Hash::hash(data, size));
+}
+
+/**
+ * @brief 64ビットハッシュ値で表した値を追加します。
+ * @param hash ハッシュ値
+ */
+void HyperLogLog::addHash(const std::uint64_t hash)
+{
+  // the top bits select a register, the rest give the rank of the first set bit
+  const std::size_t index = static_cast<std::size_t>(hash >> (64 - precision));
+  std::uint64_t rest = (hash << precision) | (static_cast<std::uint64_t>(1) << (precision - 1));
+  std::uint8_t rank = 1;
+
+  while ((rest & 0x8000000000000000ULL) == 0) {
+    rest <<= 1;
+    rank++;
+  }
+
+  if (rank > registers[index]) {
+    registers[index] = rank;
+  }
+}
+
+/**
+ * @brief 別のHyperLogLogに追加した値を、このHyperLogLogに併合します。
+ * @param sketch HyperLogLogオブジェクト
+ * @exception std::invalid_argument 精度が異なる場合
+ */
+void HyperLogLog::merge(const HyperLogLog& sketch)
+{
+  if (sketch.precision != precision) {
+    throw std::invalid_argument("Invalid precision.");
+  }
+
+  for (std::size_t i = 0; i < registers.size(); i++) {
+    registers[i] = std::max(registers[i], sketch.registers[i]);
+  }
+}
+
+/**
+ * @brief 追加した値の種類の数の推定値を返します。
+ *
+ * 推定値が小さい場合は、空のレジスタの数から求めます(linear counting)。
+ * @return 値の種類の数の推定値
+ */
+double HyperLogLog::estimate(void) const
+{
+  const double m = static_cast<double>(registers.size());
+  double sum = 0.0;
+  std::size_t zeros = 0;
+
+  for (std::size_t i = 0; i < registers.size(); i++) {
+    sum += std::ldexp(1.0, -static_cast<int>(registers[i]));
+    if (registers[i] == 0) {
+      zeros++;
+    }
+  }
+
+  const double alpha = 0.7213 / (1.0 + 1.079 / m);
+  const double raw = alpha * m * m / sum;
+
+  if (raw <= 2.5 * m && zeros > 0) {
+    return m * std::log(m / static_cast<double>(zeros));
+  }
+  return raw;
+}
+
+/**
+ * @brief 追加した値をすべて破棄します。
+ */
+void HyperLogLog::clear(void)
+{
+  std::fill(registers.begin(), registers.end(), 0);
+}
+
+} // namespace csv
+} // namespace csl
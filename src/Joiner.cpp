@@ -0,0 +1,777 @@
+/**
+ * @file  Joiner.cpp
+ * @brief Joinerクラス実装ファイル
+ */
+#include "csl/csv/Joiner.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <ios>
+#include <stdexcept>
+#include <sys/stat.h>
+#include "csl/csv/Hash.hpp"
+#include "csl/csv/Reader.hpp"
+#include "csl/csv/Splitter.hpp"
+#include "csl/csv/TempFiles.hpp"
+
+namespace csl {
+namespace csv {
+
+namespace {
+
+/**
+ * @brief ビルド側の1つのCSVレコードあたりの索引の推定メモリ使用量です(負荷率1/2のスロット)。
+ */
+const std::size_t INDEX_BYTES = 32;
+
+/**
+ * @brief キーのハッシュ値で分けた一時ファイルの集まりです。
+ */
+struct Partitions
+{
+  std::vector<std::string> paths;          ///< 一時ファイルのパス
+  std::vector<std::vector<char> > buffers; ///< 出力ストリームのバッファ
+  std::vector<std::ofstream*> streams;     ///< 出力ストリーム
+  std::vector<std::size_t> bytes;          ///< 書き込んだCSVレコードを読み込んだときの推定メモリ使用量
+
+  /**
+   * @brief 出力ストリームを破棄します。
+   */
+  ~Partitions(void)
+  {
+    for (std::size_t i = 0; i < streams.size(); i++) {
+      delete streams[i];
+    }
+  }
+};
+
+/**
+ * @brief JOIN_PARTITIONS個の一時ファイルを作って開きます。
+ * @param files 一時ファイルの集まり
+ * @param partitions 開いた一時ファイル
+ * @exception std::ios_base::failure 一時ファイルを作れない場合
+ */
+void openPartitions(TempFiles& files, Partitions& partitions)
+{
+  for (std::size_t i = 0; i < JOIN_PARTITIONS; i++) {
+    partitions.paths.push_back(files.create());
+    partitions.buffers.push_back(std::vector<char>(TEMP_BUFFER_SIZE));
+    partitions.streams.push_back(new std::ofstream());
+    partitions.bytes.push_back(0);
+
+    std::ofstream& stream = *partitions.streams.back();
+    stream.rdbuf()->pubsetbuf(&partitions.buffers.back()[0], TEMP_BUFFER_SIZE);
+    stream.open(partitions.paths.back().c_str(), std::ofstream::binary | std::ofstream::trunc);
+
+    if (!stream.is_open()) {
+      throw std::ios_base::failure("Failed to open file for writing: " + partitions.paths.back());
+    }
+  }
+}
+
+/**
+ * @brief 開いた一時ファイルを閉じます。
+ * @param partitions 開いた一時ファイル
+ * @exception std::ios_base::failure 一時ファイルにエラーが発生した場合
+ */
+void closePartitions(Partitions& partitions)
+{
+  for (std::size_t i = 0; i < partitions.streams.size(); i++) {
+    partitions.streams[i]->close();
+    if (partitions.streams[i]->fail()) {
+      throw std::ios_base::failure("Failed to write: " + partitions.paths[i]);
+    }
+  }
+}
+
+/**
+ * @brief CSVレコードを一時ファイルに書き込み、読み込んだときの推定メモリ使用量を加えます。
+ * @param partitions 開いた一時ファイル
+ * @param partition 一時ファイルの番号
+ * @param record CSVレコード
+ * @exception std::ios_base::failure 一時ファイルにエラーが発生した場合
+ */
+void writePartition(Partitions& partitions, const std::size_t partition, const std::vector<std::string>& record)
+{
+  TempFiles::write(*partitions.streams[partition], record);
+  partitions.bytes[partition] += TempFiles::getRecordBytes(record) + INDEX_BYTES;
+}
+
+/**
+ * @brief キーを書き込む一時ファイルの番号を返します。
+ *
+ * 分け直すたびに、ハッシュ値の上位24ビットのうち異なる部分を使います。
+ * @param key キー
+ * @param depth 分け直した回数
+ * @return 一時ファイルの番号
+ */
+std::size_t getPartition(const std::string& key, const std::size_t depth)
+{
+  // HashIndex uses the low 40 bits for shards and slots
+  std::uint64_t slice = Hash::hash(key.data(), key.size()) >> 40;
+  for (std::size_t i = 0; i < depth; i++) {
+    slice /= JOIN_PARTITIONS;
+  }
+  return static_cast<std::size_t>(slice) & (JOIN_PARTITIONS - 1);
+}
+
+/**
+ * @brief 指定された回数だけ分け直した一時ファイルを、ハッシュ値の上位24ビットの残りでさらに分け直せるかどうかを返します。
+ * @param depth 分け直した回数
+ * @return 分け直せる場合はtrue、それ以外の場合はfalse
+ */
+bool isSplittable(const std::size_t depth)
+{
+  std::uint64_t rest = static_cast<std::uint64_t>(1) << 24;
+  for (std::size_t i = 0; i <= depth + 1; i++) {
+    rest /= JOIN_PARTITIONS;
+  }
+  return rest > 0;
+}
+
+} // namespace
+
+/**
+ * @brief 指定された列どうしで内部結合するJoinerオブジェクトを構築します。
+ *
+ * 出力する列を追加しない場合は、プローブ側のすべての列にビルド側のすべての列を続けて出力します。
+ * メモリの上限はJOIN_MEMORY_LIMIT、一時ファイルのディレクトリは環境変数TMPDIR(ない場合は/tmp)、スレッド数は1です。
+ * @param probeColumn プローブ側のキーの列の番号
+ * @param buildColumn ビルド側のキーの列の番号
+ */
+Joiner::Joiner(const std::size_t probeColumn, const std::size_t buildColumn)
+  : probeColumn(probeColumn)
+  , buildColumn(buildColumn)
+  , type(JOIN_INNER)
+  , memoryLimit(JOIN_MEMORY_LIMIT)
+  , tempDirectory("/tmp")
+  , threadCount(1)
+  , partitioned(false)
+  , buildWidth(0)
+{
+  const char* directory = std::getenv("TMPDIR");
+  if (directory != NULL && *directory != '\0') {
+    tempDirectory = directory;
+  }
+}
+
+/**
+ * @brief Joinerオブジェクトを破棄します。
+ */
+Joiner::~Joiner(void)
+{
+}
+
+/**
+ * @brief 結合の種類を設定します。
+ * @param type 結合の種類
+ */
+void Joiner::setType(const Type type)
+{
+  this->type = type;
+}
+
+/**
+ * @brief 結合の種類を返します。
+ * @return 結合の種類
+ */
+Joiner::Type Joiner::getType(void) const
+{
+  return type;
+}
+
+/**
+ * @brief 出力する列を追加します。
+ *
+ * 追加した順に出力します。CSVレコードにない列は空文字列にします。
+ * @param side 入力
+ * @param column 列の番号
+ */
+void Joiner::addOutput(const Side side, const std::size_t column)
+{
+  Output output;
+  output.side = side;
+  output.column = column;
+  outputs.push_back(output);
+}
+
+/**
+ * @brief 出力する列をすべて削除します。
+ */
+void Joiner::clearOutputs(void)
+{
+  outputs.clear();
+}
+
+/**
+ * @brief ビルド側をメモリに読み込むときのメモリの上限を設定します。
+ *
+ * CSVレコードと索引のメモリ使用量は推定値です。
+ * @param memoryLimit バイト数
+ */
+void Joiner::setMemoryLimit(const std::size_t memoryLimit)
+{
+  this->memoryLimit = memoryLimit;
+}
+
+/**
+ * @brief ビルド側をメモリに読み込むときのメモリの上限を返します。
+ * @return バイト数
+ */
+std::size_t Joiner::getMemoryLimit(void) const
+{
+  return memoryLimit;
+}
+
+/**
+ * @brief 一時ファイルを作るディレクトリを設定します。
+ * @param tempDirectory ディレクトリのパス
+ */
+void Joiner::setTempDirectory(const std::string& tempDirectory)
+{
+  this->tempDirectory = tempDirectory;
+}
+
+/**
+ * @brief 一時ファイルを作るディレクトリを返します。
+ * @return ディレクトリのパス
+ */
+const std::string& Joiner::getTempDirectory(void) const
+{
+  return tempDirectory;
+}
+
+/**
+ * @brief 索引の構築とプローブ側のファイルの読み込みに使うスレッド数を設定します。
+ * @param threadCount スレッド数(0の場合は1)
+ */
+void Joiner::setThreadCount(const std::size_t threadCount)
+{
+  this->threadCount = (threadCount > 0) ? threadCount : 1;
+}
+
+/**
+ * @brief 索引の構築とプローブ側のファイルの読み込みに使うスレッド数を返します。
+ * @return スレッド数
+ */
+std::size_t Joiner::getThreadCount(void) const
+{
+  return threadCount;
+}
+
+/**
+ * @brief 直前の結合で、ビルド側がメモリの上限を超えて入力を一時ファイルに分けたかどうかを返します。
+ * @return 一時ファイルに分けた場合はtrue
+ */
+bool Joiner::isPartitioned(void) const
+{
+  return partitioned;
+}
+
+/**
+ * @brief デフォルトのConfigオブジェクトの設定に従って、2つの入力ストリームのCSVデータを結合して出力ストリームに書き込みます。
+ * @param probe プローブ側の入力ストリーム
+ * @param build ビルド側の入力ストリーム
+ * @param out 出力ストリーム
+ * @exception std::length_error 分け直してもビルド側がメモリの上限に収まらない場合
+ * @exception std::ios_base::failure 入出力ストリームまたは一時ファイルにエラーが発生した場合
+ */
+void Joiner::join(std::istream& probe, std::istream& build, std::ostream& out)
+{
+  join(probe, build, DEFAULT_CONFIG, out);
+}
+
+/**
+ * @brief 指定されたConfigオブジェクトの設定に従って、2つの入力ストリームのCSVデータを結合して出力ストリームに書き込みます。
+ *
+ * プローブ側の入力ストリームは1つのスレッドで読み込みます。
+ * @param probe プローブ側の入力ストリーム
+ * @param build ビルド側の入力ストリーム
+ * @param config Configオブジェクト
+ * @param out 出力ストリーム
+ * @exception std::length_error 分け直してもビルド側がメモリの上限に収まらない場合
+ * @exception std::ios_base::failure 入出力ストリームまたは一時ファイルにエラーが発生した場合
+ */
+void Joiner::join(std::istream& probe, std::istream& build, const Config& config, std::ostream& out)
+{
+  run(probe, build, NULL, config, out);
+}
+
+/**
+ * @brief デフォルトのConfigオブジェクトの設定に従って、2つのファイルのCSVデータを結合して出力ファイルに書き込みます。
+ * @param probepath プローブ側のファイルのパス
+ * @param buildpath ビルド側のファイルのパス
+ * @param outpath 出力ファイルのパス
+ * @exception std::length_error 分け直してもビルド側がメモリの上限に収まらない場合
+ * @exception std::ios_base::failure 入出力ファイルまたは一時ファイルにエラーが発生した場合
+ */
+void Joiner::join(const std::string& probepath, const std::string& buildpath, const std::string& outpath)
+{
+  join(probepath, buildpath, DEFAULT_CONFIG, outpath);
+}
+
+/**
+ * @brief 指定されたConfigオブジェクトの設定に従って、2つのファイルのCSVデータを結合して出力ファイルに書き込みます。
+ *
+ * スレッド数が2以上で一時ファイルに分けない場合は、プローブ側のファイルをスレッド数の範囲に分けて並列に読み込みます。
+ * 出力は1つのスレッドで読み込んだ場合と同じです。
+ * @param probepath プローブ側のファイルのパス
+ * @param buildpath ビルド側のファイルのパス
+ * @param config Configオブジェクト
+ * @param outpath 出力ファイルのパス
+ * @exception std::length_error 分け直してもビルド側がメモリの上限に収まらない場合
+ * @exception std::ios_base::failure 入出力ファイルまたは一時ファイルにエラーが発生した場合
+ */
+void Joiner::join(const std::string& probepath,
+		  const std::string& buildpath,
+		  const Config& config,
+		  const std::string& outpath)
+{
+  struct stat st;
+  if (stat(probepath.c_str(), &st) != 0 || !S_ISREG(st.st_mode)) {
+    throw std::ios_base::failure("Failed to open file for reading: " + probepath);
+  }
+  if (stat(buildpath.c_str(), &st) != 0 || !S_ISREG(st.st_mode)) {
+    throw std::ios_base::failure("Failed to open file for reading: " + buildpath);
+  }
+
+  std::ifstream probe(probepath.c_str(), std::ifstream::binary);
+
+  if (!probe.is_open()) {
+    throw std::ios_base::failure("Failed to open file for reading: " + probepath);
+  }
+
+  std::ifstream build(buildpath.c_str(), std::ifstream::binary);
+
+  if (!build.is_open()) {
+    probe.close();
+    throw std::ios_base::failure("Failed to open file for reading: " + buildpath);
+  }
+
+  std::ofstream out(outpath.c_str(), std::ofstream::binary);
+
+  if (!out.is_open()) {
+    probe.close();
+    build.close();
+    throw std::ios_base::failure("Failed to open file for writing: " + outpath);
+  }
+
+  try {
+    run(probe, build, &probepath, config, out);
+  } catch (...) {
+    probe.close();
+    build.close();
+    out.close();
+    throw;
+  }
+
+  probe.close();
+  build.close();
+  out.close();
+}
+
+/**
+ * @brief ビルド側を読み込んで、メモリに収まれば索引を作ってプローブ側を探し、収まらなければ一時ファイルに分けて結合します。
+ * @param probe プローブ側の入力ストリーム
+ * @param build ビルド側の入力ストリーム
+ * @param probepath プローブ側のファイルのパス(入力ストリームの場合はNULL)
+ * @param config Configオブジェクト
+ * @param out 出力ストリーム
+ * @exception std::length_error 分け直してもビルド側がメモリの上限に収まらない場合
+ * @exception std::ios_base::failure 入出力ストリームまたは一時ファイルにエラーが発生した場合
+ */
+void Joiner::run(std::istream& probe,
+		 std::istream& build,
+		 const std::string* probepath,
+		 const Config& config,
+		 std::ostream& out)
+{
+  Reader buildReader(build, config);
+  std::vector<std::vector<std::string> > table;
+  std::size_t bytes = 0;
+
+  partitioned = false;
+  buildWidth = 0;
+  while (buildReader.hasNext()) {
+    table.emplace_back();
+    buildReader.read(table.back());
+    buildWidth = std::max(buildWidth, table.back().size());
+    bytes += TempFiles::getRecordBytes(table.back()) + INDEX_BYTES;
+
+    if (bytes >= memoryLimit) {
+      partitioned = true;
+      break;
+    }
+  }
+
+  if (partitioned) {
+    Reader probeReader(probe, config);
+    joinPartitioned(probeReader, buildReader, table, config, out);
+    return;
+  }
+
+  if (threadCount == 1) {
+    HashIndex index(table, buildColumn);
+    Reader probeReader(probe, config);
+    Writer writer(out, config);
+    probeAll(probeReader, table, index, writer);
+    return;
+  }
+
+  ThreadPool pool(threadCount);
+  HashIndex index(table, buildColumn, pool);
+
+  if (probepath != NULL) {
+    probeParallel(*probepath, config, table, index, pool, out);
+  } else {
+    Reader probeReader(probe, config);
+    Writer writer(out, config);
+    probeAll(probeReader, table, index, writer);
+  }
+}
+
+/**
+ * @brief プローブ側のCSVレコードをすべて読み込んで、索引で探して書き込みます。
+ * @param reader プローブ側のReaderオブジェクト
+ * @param table ビルド側のCSVデータ
+ * @param index ビルド側の索引
+ * @param writer Writerオブジェクト
+ * @exception std::ios_base::failure 入出力ストリームにエラーが発生した場合
+ */
+void Joiner::probeAll(Reader& reader,
+		      const std::vector<std::vector<std::string> >& table,
+		      const HashIndex& index,
+		      Writer& writer) const
+{
+  std::vector<std::string> record;
+  std::vector<std::string> output;
+  std::vector<std::size_t> rows;
+
+  while (reader.hasNext()) {
+    record.clear();
+    reader.read(record);
+    match(record, table, index, writer, rows, output);
+  }
+}
+
+/**
+ * @brief プローブ側のファイルを範囲に分けて、範囲ごとに並列に探して一時ファイルに書き込み、範囲の順に出力ストリームへ書き写します。
+ * @param probepath プローブ側のファイルのパス
+ * @param config Configオブジェクト
+ * @param table ビルド側のCSVデータ
+ * @param index ビルド側の索引
+ * @param pool ThreadPoolオブジェクト
+ * @param out 出力ストリーム
+ * @exception std::ios_base::failure 入出力ストリームまたは一時ファイルにエラーが発生した場合
+ */
+void Joiner::probeParallel(const std::string& probepath,
+			   const Config& config,
+			   const std::vector<std::vector<std::string> >& table,
+			   const HashIndex& index,
+			   ThreadPool& pool,
+			   std::ostream& out) const
+{
+  std::vector<Range> ranges;
+  Splitter::plan(probepath, config, pool.getSize(), ranges);
+
+  TempFiles files(tempDirectory);
+  std::vector<std::string> paths;
+  for (std::size_t i = 0; i < ranges.size(); i++) {
+    paths.push_back(files.create());
+  }
+
+  for (std::size_t i = 0; i < ranges.size(); i++) {
+    pool.submit([this, &probepath, &config, &table, &index, &ranges, &paths, i]() {
+	std::ifstream in(probepath.c_str(), std::ifstream::binary);
+
+	if (!in.is_open()) {
+	  throw std::ios_base::failure("Failed to open file for reading: " + probepath);
+	}
+
+	std::vector<char> buffer(TEMP_BUFFER_SIZE);
+	std::ofstream stream;
+	stream.rdbuf()->pubsetbuf(&buffer[0], buffer.size());
+	stream.open(paths[i].c_str(), std::ofstream::binary | std::ofstream::trunc);
+
+	if (!stream.is_open()) {
+	  throw std::ios_base::failure("Failed to open file for writing: " + paths[i]);
+	}
+
+	Reader reader(in, config, ranges[i]);
+	Writer writer(stream, config);
+	probeAll(reader, table, index, writer);
+	stream.close();
+
+	if (stream.fail()) {
+	  throw std::ios_base::failure("Failed to write: " + paths[i]);
+	}
+      });
+  }
+  pool.wait();
+
+  std::vector<char> buffer(TEMP_BUFFER_SIZE);
+  for (std::size_t i = 0; i < paths.size(); i++) {
+    std::ifstream in(paths[i].c_str(), std::ifstream::binary);
+
+    if (!in.is_open()) {
+      throw std::ios_base::failure("Failed to open file for reading: " + paths[i]);
+    }
+
+    while (in.read(&buffer[0], buffer.size()) || in.gcount() > 0) {
+      out.write(&buffer[0], in.gcount());
+    }
+
+    if (out.fail() || out.bad()) {
+      throw std::ios_base::failure("Failed to write.");
+    }
+    files.remove(paths[i]);
+  }
+}
+
+/**
+ * @brief 両方の入力をキーのハッシュ値で一時ファイルに分けてから、分けたものごとに索引を作って結合します。
+ *
+ * キーの列がないプローブ側のCSVレコードは、左外部結合の場合だけ分ける前に書き込みます。
+ * @param probe プローブ側のReaderオブジェクト
+ * @param build ビルド側のReaderオブジェクト(メモリの上限を超えたところまで読み込み済み)
+ * @param table ビルド側の読み込み済みのCSVデータ
+ * @param config Configオブジェクト
+ * @param out 出力ストリーム
+ * @exception std::length_error 分け直してもビルド側がメモリの上限に収まらない場合
+ * @exception std::ios_base::failure 入出力ストリームまたは一時ファイルにエラーが発生した場合
+ */
+void Joiner::joinPartitioned(Reader& probe,
+			     Reader& build,
+			     std::vector<std::vector<std::string> >& table,
+			     const Config& config,
+			     std::ostream& out)
+{
+  TempFiles files(tempDirectory);
+  Writer writer(out, config);
+  std::vector<std::string> record;
+  std::vector<std::string> output;
+
+  Partitions builds;
+  openPartitions(files, builds);
+  for (std::size_t i = 0; i < table.size(); i++) {
+    if (buildColumn < table[i].size()) {
+      writePartition(builds, getPartition(table[i][buildColumn], 0), table[i]);
+    }
+  }
+  table.clear();
+  while (build.hasNext()) {
+    record.clear();
+    build.read(record);
+    buildWidth = std::max(buildWidth, record.size());
+    if (buildColumn < record.size()) {
+      writePartition(builds, getPartition(record[buildColumn], 0), record);
+    }
+  }
+  closePartitions(builds);
+
+  Partitions probes;
+  openPartitions(files, probes);
+  while (probe.hasNext()) {
+    record.clear();
+    probe.read(record);
+    if (record.empty()) {
+      continue;
+    }
+    if (probeColumn < record.size()) {
+      writePartition(probes, getPartition(record[probeColumn], 0), record);
+    } else if (type == JOIN_LEFT) {
+      emit(writer, record, NULL, output);
+    }
+  }
+  closePartitions(probes);
+
+  for (std::size_t i = 0; i < JOIN_PARTITIONS; i++) {
+    joinPartition(files, builds.paths[i], probes.paths[i], builds.bytes[i], 0, table, writer);
+  }
+}
+
+/**
+ * @brief キーのハッシュ値で分けた1組の一時ファイルを結合します。
+ *
+ * ビルド側がメモリの上限を超える場合は、ハッシュ値の別の部分で両方をさらにJOIN_PARTITIONS個に分け直して、分け直したものごとに結合します。
+ * @param files 一時ファイルの集まり
+ * @param buildpath ビルド側の一時ファイルのパス
+ * @param probepath プローブ側の一時ファイルのパス
+ * @param bytes ビルド側を読み込んだときの推定メモリ使用量
+ * @param depth 分け直した回数
+ * @param table ビルド側のCSVデータを読み込むための作業用の配列
+ * @param writer Writerオブジェクト
+ * @exception std::length_error 1つのキーのCSVレコードだけでメモリの上限を超えるなど、分け直してもメモリの上限に収まらない場合
+ * @exception std::ios_base::failure 出力ストリームまたは一時ファイルにエラーが発生した場合
+ */
+void Joiner::joinPartition(TempFiles& files,
+			   const std::string& buildpath,
+			   const std::string& probepath,
+			   const std::size_t bytes,
+			   const std::size_t depth,
+			   std::vector<std::vector<std::string> >& table,
+			   Writer& writer)
+{
+  std::vector<std::string> record;
+
+  if (bytes >= memoryLimit) {
+    if (!isSplittable(depth)) {
+      throw std::length_error("Too many records with colliding keys to join within the memory limit.");
+    }
+
+    std::ifstream buildStream(buildpath.c_str(), std::ifstream::binary);
+    if (!buildStream.is_open()) {
+      throw std::ios_base::failure("Failed to open file for reading: " + buildpath);
+    }
+
+    Partitions builds;
+    openPartitions(files, builds);
+    std::string key;
+    bool first = true;
+    bool distinct = false;
+    while (TempFiles::read(buildStream, record)) {
+      if (first) {
+	key = record[buildColumn];
+	first = false;
+      } else if (!distinct && record[buildColumn] != key) {
+	distinct = true;
+      }
+      writePartition(builds, getPartition(record[buildColumn], depth + 1), record);
+    }
+    buildStream.close();
+    closePartitions(builds);
+    files.remove(buildpath);
+
+    // records with one key always land in the same file, so splitting again cannot help
+    if (!distinct) {
+      throw std::length_error("Too many records with the same key to join within the memory limit.");
+    }
+
+    std::ifstream probeStream(probepath.c_str(), std::ifstream::binary);
+    if (!probeStream.is_open()) {
+      throw std::ios_base::failure("Failed to open file for reading: " + probepath);
+    }
+
+    Partitions probes;
+    openPartitions(files, probes);
+    while (TempFiles::read(probeStream, record)) {
+      writePartition(probes, getPartition(record[probeColumn], depth + 1), record);
+    }
+    probeStream.close();
+    closePartitions(probes);
+    files.remove(probepath);
+
+    for (std::size_t i = 0; i < JOIN_PARTITIONS; i++) {
+      joinPartition(files, builds.paths[i], probes.paths[i], builds.bytes[i], depth + 1, table, writer);
+    }
+    return;
+  }
+
+  std::ifstream buildStream(buildpath.c_str(), std::ifstream::binary);
+  if (!buildStream.is_open()) {
+    throw std::ios_base::failure("Failed to open file for reading: " + buildpath);
+  }
+
+  table.clear();
+  table.emplace_back();
+  while (TempFiles::read(buildStream, table.back())) {
+    table.emplace_back();
+  }
+  table.pop_back();
+  buildStream.close();
+  files.remove(buildpath);
+
+  HashIndex index(table, buildColumn);
+  std::ifstream probeStream(probepath.c_str(), std::ifstream::binary);
+  if (!probeStream.is_open()) {
+    throw std::ios_base::failure("Failed to open file for reading: " + probepath);
+  }
+
+  std::vector<std::string> output;
+  std::vector<std::size_t> rows;
+  while (TempFiles::read(probeStream, record)) {
+    match(record, table, index, writer, rows, output);
+  }
+  probeStream.close();
+  files.remove(probepath);
+}
+
+/**
+ * @brief プローブ側の1つのCSVレコードを索引で探し、一致したビルド側のCSVレコードと結合して書き込みます。
+ *
+ * フィールドのないCSVレコードは書き込みません。
+ * @param record プローブ側のCSVレコード
+ * @param table ビルド側のCSVデータ
+ * @param index ビルド側の索引
+ * @param writer Writerオブジェクト
+ * @param rows 一致したCSVレコードの番号を返すための作業用の配列
+ * @param output 出力するCSVレコードを作るための作業用の配列
+ * @exception std::ios_base::failure 出力ストリームにエラーが発生した場合
+ */
+void Joiner::match(const std::vector<std::string>& record,
+		   const std::vector<std::vector<std::string> >& table,
+		   const HashIndex& index,
+		   Writer& writer,
+		   std::vector<std::size_t>& rows,
+		   std::vector<std::string>& output) const
+{
+  if (record.empty()) {
+    return;
+  }
+
+  rows.clear();
+  if (probeColumn < record.size()) {
+    index.findAll(record[probeColumn], rows);
+  }
+
+  if (rows.empty()) {
+    if (type == JOIN_LEFT) {
+      emit(writer, record, NULL, output);
+    }
+    return;
+  }
+
+  for (std::size_t i = 0; i < rows.size(); i++) {
+    emit(writer, record, &table[rows[i]], output);
+  }
+}
+
+/**
+ * @brief 結合したCSVレコードを書き込みます。
+ * @param writer Writerオブジェクト
+ * @param probe プローブ側のCSVレコード
+ * @param build ビルド側のCSVレコード(一致しなかった場合はNULL)
+ * @param output 出力するCSVレコードを作るための作業用の配列
+ * @exception std::ios_base::failure 出力ストリームにエラーが発生した場合
+ */
+void Joiner::emit(Writer& writer,
+		  const std::vector<std::string>& probe,
+		  const std::vector<std::string>* build,
+		  std::vector<std::string>& output) const
+{
+  if (outputs.empty()) {
+    output = probe;
+    if (build != NULL) {
+      output.insert(output.end(), build->begin(), build->end());
+    } else {
+      output.resize(output.size() + buildWidth);
+    }
+    writer.write(output);
+    return;
+  }
+
+  output.resize(outputs.size());
+  for (std::size_t i = 0; i < outputs.size(); i++) {
+    const std::vector<std::string>* source = (outputs[i].side == SIDE_PROBE) ? &probe : build;
+    if (source != NULL && outputs[i].column < source->size()) {
+      output[i] = (*source)[outputs[i].column];
+    } else {
+      output[i].clear();
+    }
+  }
+  writer.write(output);
+}
+
+} // namespace csv
+} // namespace csl
@@ -0,0 +1,147 @@
+/**
+ * @file  KeyComparator.cpp
+ * @brief KeyComparatorクラス実装ファイル
+ */
+#include "csl/csv/KeyComparator.hpp"
+#include "csl/csv/Util.hpp"
+
+namespace csl {
+namespace csv {
+
+namespace {
+
+/**
+ * @brief キーの列がない場合に比較する値です。
+ */
+const std::string EMPTY_VALUE;
+
+} // namespace
+
+/**
+ * @brief キーのないKeyComparatorオブジェクトを構築します。
+ */
+KeyComparator::KeyComparator(void)
+{
+}
+
+/**
+ * @brief KeyComparatorオブジェクトを破棄します。
+ */
+KeyComparator::~KeyComparator(void)
+{
+}
+
+/**
+ * @brief キーを追加します。
+ *
+ * 追加した順に比較し、先のキーが等しい場合に次のキーを比較します。
+ * @param column 列の番号
+ * @param collation 比較方法
+ */
+void KeyComparator::addKey(const std::size_t column, const Collation collation)
+{
+  Key key;
+  key.column = column;
+  key.collation = collation;
+  keys.push_back(key);
+}
+
+/**
+ * @brief すべてのキーを削除します。
+ */
+void KeyComparator::clearKeys(void)
+{
+  keys.clear();
+}
+
+/**
+ * @brief キーの数を返します。
+ * @return キーの数
+ */
+std::size_t KeyComparator::getKeyCount(void) const
+{
+  return keys.size();
+}
+
+/**
+ * @brief 指定されたキーの列の番号を返します。
+ * @param key キーの番号
+ * @return 列の番号
+ */
+std::size_t KeyComparator::getColumn(const std::size_t key) const
+{
+  return keys[key].column;
+}
+
+/**
+ * @brief 指定されたキーの比較方法を返します。
+ * @param key キーの番号
+ * @return 比較方法
+ */
+KeyComparator::Collation KeyComparator::getCollation(const std::size_t key) const
+{
+  return keys[key].collation;
+}
+
+/**
+ * @brief 2つのCSVレコードのキーを比較します。
+ *
+ * 並べ替えた出力では、比較結果が負になるCSVレコードが先に並びます。
+ * @param a CSVレコード
+ * @param b CSVレコード
+ * @return aが先の場合は負、bが先の場合は正、キーが等しい場合は0
+ */
+int KeyComparator::compare(const std::vector<std::string>& a, const std::vector<std::string>& b) const
+{
+  for (std::size_t i = 0; i < keys.size(); i++) {
+    const std::size_t column = keys[i].column;
+    const std::string& x = (column < a.size()) ? a[column] : EMPTY_VALUE;
+    const std::string& y = (column < b.size()) ? b[column] : EMPTY_VALUE;
+
+    if (keys[i].collation == COLLATION_NUMERIC) {
+      double p, q;
+      const bool xNumber = parseNumber(x, p);
+      const bool yNumber = parseNumber(y, q);
+
+      if (xNumber && yNumber) {
+	if (p != q) {
+	  return (p < q) ? -1 : 1;
+	}
+	continue;
+      }
+      if (xNumber != yNumber) {
+	return xNumber ? -1 : 1;
+      }
+    }
+
+    const int result = x.compare(y);
+    if (result != 0) {
+      return (result < 0) ? -1 : 1;
+    }
+  }
+
+  return 0;
+}
+
+/**
+ * @brief 数値として比較するキーの文字列全体を数値として解釈します。-0は0にします。
+ * @param value 文字列
+ * @param number 数値
+ * @return 数値の場合はtrue、それ以外の場合はfalse
+ */
+bool KeyComparator::parseNumber(const std::string& value, double& number)
+{
+  if (!Util::parseNumber(value.data(), value.size(), number)) {
+    return false;
+  }
+
+  if (number == 0.0) {
+    // -0 equals 0
+    number = 0.0;
+  }
+
+  return true;
+}
+
+} // namespace csv
+} // namespace csl
@@ -0,0 +1,173 @@
+/**
+ * @file  LazyRecord.cpp
+ * @brief LazyRecordクラス実装ファイル
+ */
+#include "csl/csv/LazyRecord.hpp"
+#include <stdexcept>
+
+namespace csl {
+namespace csv {
+
+/**
+ * @brief フィールドを持たないLazyRecordオブジェクトを構築します。
+ */
+LazyRecord::LazyRecord(void)
+  : quoteEnabled(true)
+  , quoteMark('"')
+{
+}
+
+/**
+ * @brief LazyRecordオブジェクトを破棄します。
+ */
+LazyRecord::~LazyRecord(void)
+{
+}
+
+/**
+ * @brief すべてのフィールドを取り除きます。確保済みのメモリは再利用します。
+ */
+void LazyRecord::clear(void)
+{
+  data.clear();
+  fields.clear();
+}
+
+/**
+ * @brief フィールドの数を返します。
+ * @return フィールドの数
+ */
+std::size_t LazyRecord::size(void) const
+{
+  return fields.size();
+}
+
+/**
+ * @brief 指定されたフィールドの、読み込んだままのデータの先頭を返します。
+ * @param index フィールドの番号
+ * @return 読み込んだままのデータの先頭
+ * @exception std::out_of_range フィールドの番号が範囲外の場合
+ */
+const char* LazyRecord::getRawData(const std::size_t index) const
+{
+  return data.data() + at(index).begin;
+}
+
+/**
+ * @brief 指定されたフィールドの、読み込んだままのデータのバイト数を返します。
+ * @param index フィールドの番号
+ * @return 読み込んだままのデータのバイト数
+ * @exception std::out_of_range フィールドの番号が範囲外の場合
+ */
+std::size_t LazyRecord::getRawSize(const std::size_t index) const
+{
+  return at(index).size;
+}
+
+/**
+ * @brief 指定されたフィールドが囲み文字を含むかどうかを返します。
+ * @param index フィールドの番号
+ * @return 囲み文字を含む場合はtrue
+ * @exception std::out_of_range フィールドの番号が範囲外の場合
+ */
+bool LazyRecord::isQuoted(const std::size_t index) const
+{
+  return (at(index).flags & FLAG_QUOTED) != 0;
+}
+
+/**
+ * @brief 指定されたフィールドがエスケープされた囲み文字を含むかどうかを返します。
+ * @param index フィールドの番号
+ * @return エスケープされた囲み文字を含む場合はtrue
+ * @exception std::out_of_range フィールドの番号が範囲外の場合
+ */
+bool LazyRecord::hasEscapedQuotes(const std::size_t index) const
+{
+  return (at(index).flags & FLAG_ESCAPED) != 0;
+}
+
+/**
+ * @brief 指定されたフィールドがCRまたはLFを含むかどうかを返します。
+ * @param index フィールドの番号
+ * @return CRまたはLFを含む場合はtrue
+ * @exception std::out_of_range フィールドの番号が範囲外の場合
+ */
+bool LazyRecord::hasLineBreaks(const std::size_t index) const
+{
+  return (at(index).flags & FLAG_LINE_BREAK) != 0;
+}
+
+/**
+ * @brief 指定されたフィールドを解釈して返します。
+ *
+ * 返す文字列はLazyRecordオブジェクトが持つ作業用のバッファで、次にgetを呼び出すまで有効です。
+ * @param index フィールドの番号
+ * @return フィールド
+ * @exception std::out_of_range フィールドの番号が範囲外の場合
+ */
+const std::string& LazyRecord::get(const std::size_t index) const
+{
+  decode(at(index), scratch);
+  return scratch;
+}
+
+/**
+ * @brief 指定されたフィールドを解釈して返します。
+ * @param index フィールドの番号
+ * @param field フィールド
+ * @exception std::out_of_range フィールドの番号が範囲外の場合
+ */
+void LazyRecord::get(const std::size_t index, std::string& field) const
+{
+  decode(at(index), field);
+}
+
+/**
+ * @brief 指定された番号のフィールドを返します。
+ * @param index フィールドの番号
+ * @return フィールドの位置と性質
+ * @exception std::out_of_range フィールドの番号が範囲外の場合
+ */
+const LazyRecord::Field& LazyRecord::at(const std::size_t index) const
+{
+  if (index >= fields.size()) {
+    throw std::out_of_range("Invalid index.");
+  }
+  return fields[index];
+}
+
+/**
+ * @brief 読み込んだままのフィールドから囲み文字を取り除き、エスケープを戻します。
+ *
+ * Reader::read(std::vector<std::string>&)と同じ結果になるように解釈します。
+ * @param field フィールドの位置と性質
+ * @param value 解釈したフィールド
+ */
+void LazyRecord::decode(const Field& field, std::string& value) const
+{
+  const char* raw = data.data() + field.begin;
+
+  if (!quoteEnabled || (field.flags & FLAG_QUOTED) == 0) {
+    value.assign(raw, field.size);
+    return;
+  }
+
+  value.clear();
+  bool quoteFlag = false;
+
+  for (std::size_t i = 0; i < field.size; i++) {
+    if (raw[i] != quoteMark) {
+      value.push_back(raw[i]);
+    } else if (!quoteFlag) {
+      quoteFlag = true;
+    } else if (i + 1 < field.size && raw[i + 1] == quoteMark) {
+      value.push_back(quoteMark); // escaped quote
+      i++;
+    } else {
+      quoteFlag = false;
+    }
+  }
+}
+
+} // namespace csv
+} // namespace csl
@@ -0,0 +1,52 @@
+/**
+ * @file  LoserTree.cpp
+ * @brief LoserTreeクラス実装ファイル
+ */
+#include "csl/csv/LoserTree.hpp"
+#include <stdexcept>
+
+namespace csl {
+namespace csv {
+
+/**
+ * @brief 指定された数の入力を併合する敗者木を構築します。
+ *
+ * 比較はbuildを呼び出すまで行いません。
+ * @param size 入力の数
+ * @exception std::invalid_argument 入力の数が0の場合
+ */
+LoserTree::LoserTree(const std::size_t size)
+  : losers(size)
+{
+  if (size == 0) {
+    throw std::invalid_argument("Invalid size.");
+  }
+}
+
+/**
+ * @brief 敗者木を破棄します。
+ */
+LoserTree::~LoserTree(void)
+{
+}
+
+/**
+ * @brief 入力の数を返します。
+ * @return 入力の数
+ */
+std::size_t LoserTree::size(void) const
+{
+  return losers.size();
+}
+
+/**
+ * @brief 次に出力すべき先頭を持つ入力の番号を返します。
+ * @return 入力の番号
+ */
+std::size_t LoserTree::top(void) const
+{
+  return losers[0];
+}
+
+} // namespace csv
+} // namespace csl
@@ -0,0 +1,311 @@
+/**
+ * @file  Merger.cpp
+ * @brief Mergerクラス実装ファイル
+ */
+#include "csl/csv/Merger.hpp"
+#include <fstream>
+#include <ios>
+#include <stdexcept>
+#include <sys/stat.h>
+#include "csl/csv/LoserTree.hpp"
+#include "csl/csv/Reader.hpp"
+#include "csl/csv/Writer.hpp"
+
+namespace csl {
+namespace csv {
+
+namespace {
+
+/**
+ * @brief 併合する1つの入力です。
+ */
+struct Input
+{
+  Reader* reader;                    ///< Readerオブジェクト
+  std::vector<std::string> record;   ///< 先頭のCSVレコード
+  std::vector<std::string> previous; ///< 直前のCSVレコード
+  bool done;                         ///< 読み終えた場合はtrue
+};
+
+/**
+ * @brief 入力ファイルを、指定されたバイト数のバッファで開きます。
+ * @param filepath ファイルパス
+ * @param buffer バッファ
+ * @param stream 入力ストリーム
+ * @exception std::ios_base::failure ファイルを開けない場合
+ */
+void openInput(const std::string& filepath, std::vector<char>& buffer, std::ifstream& stream)
+{
+  struct stat st;
+  if (stat(filepath.c_str(), &st) != 0 || !S_ISREG(st.st_mode)) {
+    throw std::ios_base::failure("Failed to open file for reading: " + filepath);
+  }
+
+  stream.rdbuf()->pubsetbuf(&buffer[0], buffer.size());
+  stream.open(filepath.c_str(), std::ifstream::binary);
+
+  if (!stream.is_open()) {
+    throw std::ios_base::failure("Failed to open file for reading: " + filepath);
+  }
+}
+
+} // namespace
+
+/**
+ * @brief キーのないMergerオブジェクトを構築します。
+ *
+ * 重複を除かず、バッファのバイト数はMERGE_BUFFER_SIZEです。
+ */
+Merger::Merger(void)
+  : unique(false)
+  , bufferSize(MERGE_BUFFER_SIZE)
+  , recordCount(0)
+  , duplicateCount(0)
+{
+}
+
+/**
+ * @brief Mergerオブジェクトを破棄します。
+ */
+Merger::~Merger(void)
+{
+}
+
+/**
+ * @brief キーを追加します。
+ *
+ * 追加した順に比較し、先のキーが等しい場合に次のキーを比較します。
+ * @param column 列の番号
+ * @param collation 比較方法
+ */
+void Merger::addKey(const std::size_t column, const KeyComparator::Collation collation)
+{
+  comparator.addKey(column, collation);
+}
+
+/**
+ * @brief すべてのキーを削除します。
+ */
+void Merger::clearKeys(void)
+{
+  comparator.clearKeys();
+}
+
+/**
+ * @brief キーが等しいCSVレコードを、最初の1件だけにするかどうかを設定します。
+ * @param unique 最初の1件だけにする場合はtrue
+ */
+void Merger::setUnique(const bool unique)
+{
+  this->unique = unique;
+}
+
+/**
+ * @brief キーが等しいCSVレコードを、最初の1件だけにするかどうかを返します。
+ * @return 最初の1件だけにする場合はtrue
+ */
+bool Merger::getUnique(void) const
+{
+  return unique;
+}
+
+/**
+ * @brief 入力ファイルと出力ファイルごとのバッファのバイト数を設定します。
+ *
+ * 入力ストリームと出力ストリームのバッファは変更しません。
+ * @param bufferSize バイト数(0の場合は1)
+ */
+void Merger::setBufferSize(const std::size_t bufferSize)
+{
+  this->bufferSize = (bufferSize > 0) ? bufferSize : 1;
+}
+
+/**
+ * @brief 入力ファイルと出力ファイルごとのバッファのバイト数を返します。
+ * @return バイト数
+ */
+std::size_t Merger::getBufferSize(void) const
+{
+  return bufferSize;
+}
+
+/**
+ * @brief 直前の併合で書き込んだCSVレコードの数を返します。
+ * @return CSVレコードの数
+ */
+std::size_t Merger::getRecordCount(void) const
+{
+  return recordCount;
+}
+
+/**
+ * @brief 直前の併合で、キーが重複していたため書き込まなかったCSVレコードの数を返します。
+ * @return CSVレコードの数
+ */
+std::size_t Merger::getDuplicateCount(void) const
+{
+  return duplicateCount;
+}
+
+/**
+ * @brief デフォルトのConfigオブジェクトの設定に従って、複数の入力ストリームのCSVデータを併合して出力ストリームに書き込みます。
+ * @param streams 入力ストリーム
+ * @param out 出力ストリーム
+ * @exception std::invalid_argument キーがない場合、または入力がキーの順に並んでいない場合
+ * @exception std::ios_base::failure 入出力ストリームにエラーが発生した場合
+ */
+void Merger::merge(const std::vector<std::istream*>& streams, std::ostream& out)
+{
+  merge(streams, DEFAULT_CONFIG, out);
+}
+
+/**
+ * @brief 指定されたConfigオブジェクトの設定に従って、複数の入力ストリームのCSVデータを併合して出力ストリームに書き込みます。
+ *
+ * 入力ごとに、直前のCSVレコードより前に並ぶべきCSVレコードを見つけた時点で例外を送出します。
+ * @param streams 入力ストリーム
+ * @param config Configオブジェクト
+ * @param out 出力ストリーム
+ * @exception std::invalid_argument キーがない場合、または入力がキーの順に並んでいない場合
+ * @exception std::ios_base::failure 入出力ストリームにエラーが発生した場合
+ */
+void Merger::merge(const std::vector<std::istream*>& streams, const Config& config, std::ostream& out)
+{
+  if (comparator.getKeyCount() == 0) {
+    throw std::invalid_argument("No keys.");
+  }
+
+  recordCount = 0;
+  duplicateCount = 0;
+  if (streams.empty()) {
+    return;
+  }
+
+  std::vector<Input> inputs(streams.size());
+  for (std::size_t i = 0; i < inputs.size(); i++) {
+    inputs[i].reader = NULL;
+  }
+
+  try {
+    for (std::size_t i = 0; i < inputs.size(); i++) {
+      inputs[i].reader = new Reader(*streams[i], config);
+      inputs[i].done = !inputs[i].reader->hasNext();
+      if (!inputs[i].done) {
+	inputs[i].reader->read(inputs[i].record);
+      }
+    }
+
+    const auto less = [this, &inputs](const std::size_t a, const std::size_t b) {
+      if (inputs[a].done || inputs[b].done) {
+	return !inputs[a].done;
+      }
+      const int result = comparator.compare(inputs[a].record, inputs[b].record);
+      return (result != 0) ? (result < 0) : (a < b);
+    };
+
+    Writer writer(out, config);
+    LoserTree tree(inputs.size());
+    std::vector<std::string> last;
+    bool written = false;
+    tree.build(less);
+
+    while (!inputs[tree.top()].done) {
+      Input& input = inputs[tree.top()];
+
+      if (unique && written && comparator.compare(last, input.record) == 0) {
+	duplicateCount++;
+      } else {
+	writer.write(input.record);
+	recordCount++;
+	if (unique) {
+	  last = input.record;
+	  written = true;
+	}
+      }
+
+      input.previous.swap(input.record);
+      input.done = !input.reader->hasNext();
+      if (!input.done) {
+	input.record.clear();
+	input.reader->read(input.record);
+	if (comparator.compare(input.previous, input.record) > 0) {
+	  throw std::invalid_argument("Unsorted input.");
+	}
+      }
+      tree.replay(less);
+    }
+  } catch (...) {
+    for (std::size_t i = 0; i < inputs.size(); i++) {
+      delete inputs[i].reader;
+    }
+    throw;
+  }
+
+  for (std::size_t i = 0; i < inputs.size(); i++) {
+    delete inputs[i].reader;
+  }
+}
+
+/**
+ * @brief デフォルトのConfigオブジェクトの設定に従って、複数のファイルのCSVデータを併合して出力ファイルに書き込みます。
+ * @param filepaths 入力ファイルのパス
+ * @param outpath 出力ファイルのパス
+ * @exception std::invalid_argument キーがない場合、または入力がキーの順に並んでいない場合
+ * @exception std::ios_base::failure 入出力ファイルにエラーが発生した場合
+ */
+void Merger::merge(const std::vector<std::string>& filepaths, const std::string& outpath)
+{
+  merge(filepaths, DEFAULT_CONFIG, outpath);
+}
+
+/**
+ * @brief 指定されたConfigオブジェクトの設定に従って、複数のファイルのCSVデータを併合して出力ファイルに書き込みます。
+ *
+ * 入力ファイルと出力ファイルは、それぞれバッファのバイト数のバッファで読み書きします。
+ * @param filepaths 入力ファイルのパス
+ * @param config Configオブジェクト
+ * @param outpath 出力ファイルのパス
+ * @exception std::invalid_argument キーがない場合、または入力がキーの順に並んでいない場合
+ * @exception std::ios_base::failure 入出力ファイルにエラーが発生した場合
+ */
+void Merger::merge(const std::vector<std::string>& filepaths, const Config& config, const std::string& outpath)
+{
+  std::vector<std::vector<char> > buffers(filepaths.size() + 1, std::vector<char>(bufferSize));
+  std::vector<std::ifstream*> files;
+  std::vector<std::istream*> streams;
+  std::ofstream out;
+
+  try {
+    for (std::size_t i = 0; i < filepaths.size(); i++) {
+      files.push_back(new std::ifstream());
+      openInput(filepaths[i], buffers[i], *files.back());
+      streams.push_back(files.back());
+    }
+
+    out.rdbuf()->pubsetbuf(&buffers.back()[0], bufferSize);
+    out.open(outpath.c_str(), std::ofstream::binary);
+
+    if (!out.is_open()) {
+      throw std::ios_base::failure("Failed to open file for writing: " + outpath);
+    }
+
+    merge(streams, config, out);
+    out.close();
+
+    if (out.fail()) {
+      throw std::ios_base::failure("Failed to write: " + outpath);
+    }
+  } catch (...) {
+    for (std::size_t i = 0; i < files.size(); i++) {
+      delete files[i];
+    }
+    throw;
+  }
+
+  for (std::size_t i = 0; i < files.size(); i++) {
+    delete files[i];
+  }
+}
+
+} // namespace csv
+} // namespace csl
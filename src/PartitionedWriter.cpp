@@ -0,0 +1,432 @@
+/**
+ * @file  PartitionedWriter.cpp
+ * @brief PartitionedWriterクラス実装ファイル
+ */
+#include "csl/csv/PartitionedWriter.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <ios>
+#include <fcntl.h>
+#include <unistd.h>
+#include "csl/csv/Hash.hpp"
+
+namespace csl {
+namespace csv {
+
+namespace {
+
+/**
+ * @brief ファイル名に使う16進数の数字です。
+ */
+const char HEX_DIGITS[] = "0123456789ABCDEF";
+
+/**
+ * @brief 列の値を、ファイル名に使える文字列にして返します。
+ * @param value 列の値
+ * @return ファイル名に使える文字列
+ */
+std::string encodeName(const std::string& value)
+{
+  std::string name;
+
+  if (value.empty()) {
+    return "%";
+  }
+
+  for (std::size_t i = 0; i < value.size(); i++) {
+    const unsigned char c = static_cast<unsigned char>(value[i]);
+    const bool safe = (c >= 0x80) || (c >= '0' && c <= '9') || (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z')
+      || c == '-' || c == '_' || (c == '.' && i > 0);
+
+    if (safe) {
+      name += static_cast<char>(c);
+    } else {
+      name += '%';
+      name += HEX_DIGITS[c >> 4];
+      name += HEX_DIGITS[c & 0x0f];
+    }
+  }
+
+  return name;
+}
+
+/**
+ * @brief ファイル記述子にすべてのデータを書き込みます。
+ * @param fd ファイル記述子
+ * @param data データ
+ * @param size バイト数
+ * @return 書き込めた場合はtrue、エラーが発生した場合はfalse
+ */
+bool writeAll(const int fd, const char* data, std::size_t size)
+{
+  while (size > 0) {
+    const ssize_t written = ::write(fd, data, size);
+    if (written < 0) {
+      if (errno == EINTR) {
+	continue;
+      }
+      return false;
+    }
+    data += written;
+    size -= static_cast<std::size_t>(written);
+  }
+  return true;
+}
+
+} // namespace
+
+/**
+ * @brief 書き込む先のないストリームバッファを構築します。
+ */
+PartitionedWriter::AppendBuffer::AppendBuffer(void)
+  : target(NULL)
+{
+}
+
+/**
+ * @brief 書き込む先の文字列を設定します。
+ * @param target 文字列
+ */
+void PartitionedWriter::AppendBuffer::setTarget(std::string* target)
+{
+  this->target = target;
+}
+
+/**
+ * @brief 1文字を書き込む先の文字列に追加します。
+ * @param c 文字
+ * @return 文字(EOFの場合はEOF以外の値)
+ */
+PartitionedWriter::AppendBuffer::int_type PartitionedWriter::AppendBuffer::overflow(int_type c)
+{
+  if (!traits_type::eq_int_type(c, traits_type::eof())) {
+    target->push_back(traits_type::to_char_type(c));
+  }
+  return traits_type::not_eof(c);
+}
+
+/**
+ * @brief 文字列を書き込む先の文字列に追加します。
+ * @param data 文字列
+ * @param size バイト数
+ * @return 追加したバイト数
+ */
+std::streamsize PartitionedWriter::AppendBuffer::xsputn(const char* data, std::streamsize size)
+{
+  target->append(data, static_cast<std::size_t>(size));
+  return size;
+}
+
+/**
+ * @brief デフォルトのConfigオブジェクトを設定して、列の値ごとのファイルに書き込むPartitionedWriterオブジェクトを構築します。
+ * @param prefix ファイルパスの接頭辞
+ * @param suffix ファイルパスの接尾辞
+ * @param column 振り分けに使う列の番号
+ */
+PartitionedWriter::PartitionedWriter(const std::string& prefix,
+				     const std::string& suffix,
+				     const std::size_t column)
+  : prefix(prefix)
+  , suffix(suffix)
+  , column(column)
+  , config(DEFAULT_CONFIG)
+  , partitionCount(0)
+  , memoryLimit(PARTITION_MEMORY_LIMIT)
+  , maxOpenFiles(PARTITION_OPEN_FILES)
+  , buffered(0)
+  , stream(&appendBuffer)
+  , writer(stream, config)
+{
+}
+
+/**
+ * @brief 指定されたConfigオブジェクトを設定して、列の値ごとのファイルに書き込むPartitionedWriterオブジェクトを構築します。
+ * @param prefix ファイルパスの接頭辞
+ * @param suffix ファイルパスの接尾辞
+ * @param column 振り分けに使う列の番号
+ * @param config Configオブジェクト
+ */
+PartitionedWriter::PartitionedWriter(const std::string& prefix,
+				     const std::string& suffix,
+				     const std::size_t column,
+				     const Config& config)
+  : prefix(prefix)
+  , suffix(suffix)
+  , column(column)
+  , config(config)
+  , partitionCount(0)
+  , memoryLimit(PARTITION_MEMORY_LIMIT)
+  , maxOpenFiles(PARTITION_OPEN_FILES)
+  , buffered(0)
+  , stream(&appendBuffer)
+  , writer(stream, config)
+{
+}
+
+/**
+ * @brief 残っているバッファを書き出してファイルを閉じ、PartitionedWriterオブジェクトを破棄します。
+ *
+ * 書き出しのエラーを知るには、破棄する前にcloseを呼び出します。
+ */
+PartitionedWriter::~PartitionedWriter(void)
+{
+  try {
+    close();
+  } catch (...) {
+    // errors are reported by an explicit close
+  }
+}
+
+/**
+ * @brief 列の値のハッシュ値で振り分けるファイルの数を設定します。
+ *
+ * 0の場合(デフォルト)は列の値ごとのファイルに振り分けます。
+ * 1以上の場合はファイルパスの接頭辞と接尾辞の間に0からファイルの数-1までの番号を入れます。最初に書き込む前に設定します。
+ * @param partitionCount ファイルの数
+ */
+void PartitionedWriter::setPartitionCount(const std::size_t partitionCount)
+{
+  this->partitionCount = partitionCount;
+}
+
+/**
+ * @brief 列の値のハッシュ値で振り分けるファイルの数を返します。
+ * @return ファイルの数(列の値ごとのファイルに振り分ける場合は0)
+ */
+std::size_t PartitionedWriter::getPartitionCount(void) const
+{
+  return partitionCount;
+}
+
+/**
+ * @brief バッファの合計の上限を設定します。
+ *
+ * 上限を超えた場合は、合計が上限の半分以下になるまで大きいバッファから書き出します。
+ * @param memoryLimit バイト数
+ */
+void PartitionedWriter::setMemoryLimit(const std::size_t memoryLimit)
+{
+  this->memoryLimit = memoryLimit;
+}
+
+/**
+ * @brief バッファの合計の上限を返します。
+ * @return バイト数
+ */
+std::size_t PartitionedWriter::getMemoryLimit(void) const
+{
+  return memoryLimit;
+}
+
+/**
+ * @brief 同時に開くファイルの数の上限を設定します。
+ * @param maxOpenFiles ファイルの数(0の場合は1)
+ */
+void PartitionedWriter::setMaxOpenFiles(const std::size_t maxOpenFiles)
+{
+  this->maxOpenFiles = (maxOpenFiles > 0) ? maxOpenFiles : 1;
+}
+
+/**
+ * @brief 同時に開くファイルの数の上限を返します。
+ * @return ファイルの数
+ */
+std::size_t PartitionedWriter::getMaxOpenFiles(void) const
+{
+  return maxOpenFiles;
+}
+
+/**
+ * @brief CSVレコードを、列の値で決まるファイルのバッファに書き込みます。
+ * @param record CSVレコード
+ * @exception std::ios_base::failure ファイルへの書き出しにエラーが発生した場合
+ */
+void PartitionedWriter::write(const std::vector<std::string>& record)
+{
+  static const std::string empty;
+  const std::size_t index = getPartition((column < record.size()) ? record[column] : empty);
+  std::string& buffer = partitions[index].buffer;
+  const std::size_t before = buffer.size();
+
+  appendBuffer.setTarget(&buffer);
+  writer.write(record);
+  buffered += buffer.size() - before;
+
+  if (buffered > memoryLimit) {
+    spill();
+  }
+}
+
+/**
+ * @brief すべてのバッファをファイルに書き出します。
+ * @exception std::ios_base::failure ファイルへの書き出しにエラーが発生した場合
+ */
+void PartitionedWriter::flush(void)
+{
+  for (std::size_t i = 0; i < partitions.size(); i++) {
+    drain(i);
+  }
+}
+
+/**
+ * @brief すべてのバッファをファイルに書き出して、開いているファイルを閉じます。
+ *
+ * 閉じた後に書き込んだCSVレコードは、ファイルに追記します。
+ * @exception std::ios_base::failure ファイルへの書き出しにエラーが発生した場合
+ */
+void PartitionedWriter::close(void)
+{
+  flush();
+
+  while (!openFiles.empty()) {
+    Partition& partition = partitions[openFiles.back()];
+    openFiles.pop_back();
+
+    const int result = ::close(partition.fd);
+    partition.fd = -1;
+    if (result != 0) {
+      throw std::ios_base::failure("Failed to write: " + partition.path);
+    }
+  }
+}
+
+/**
+ * @brief 書き込んだことのあるファイルの数を返します。
+ *
+ * ハッシュ値で振り分ける場合は、設定したファイルの数です。
+ * @return ファイルの数
+ */
+std::size_t PartitionedWriter::size(void) const
+{
+  return partitions.size();
+}
+
+/**
+ * @brief 指定された番号のファイルのパスを返します。
+ *
+ * 列の値ごとに振り分ける場合、番号は列の値が最初に現れた順です。
+ * @param partition ファイルの番号
+ * @return ファイルパス
+ * @exception std::out_of_range ファイルの番号が範囲外の場合
+ */
+const std::string& PartitionedWriter::getPath(const std::size_t partition) const
+{
+  if (partition >= partitions.size()) {
+    throw std::out_of_range("Invalid partition.");
+  }
+  return partitions[partition].path;
+}
+
+/**
+ * @brief 列の値を書き込むファイルの番号を返します。初めての値の場合はファイルを追加します。
+ * @param value 列の値
+ * @return ファイルの番号
+ */
+std::size_t PartitionedWriter::getPartition(const std::string& value)
+{
+  Partition partition;
+  partition.fd = -1;
+  partition.created = false;
+
+  if (partitionCount > 0) {
+    while (partitions.size() < partitionCount) {
+      partition.path = prefix + std::to_string(partitions.size()) + suffix;
+      partitions.push_back(partition);
+    }
+    return static_cast<std::size_t>(Hash::hash(value.data(), value.size()) % partitionCount);
+  }
+
+  const std::size_t count = values.size();
+  const std::size_t index = values.intern(value);
+
+  if (index == count) {
+    partition.path = prefix + encodeName(value) + suffix;
+    partitions.push_back(partition);
+  }
+  return index;
+}
+
+/**
+ * @brief バッファの合計が上限の半分以下になるまで、大きいバッファから書き出します。
+ * @exception std::ios_base::failure ファイルへの書き出しにエラーが発生した場合
+ */
+void PartitionedWriter::spill(void)
+{
+  std::vector<std::size_t> order;
+  for (std::size_t i = 0; i < partitions.size(); i++) {
+    if (!partitions[i].buffer.empty()) {
+      order.push_back(i);
+    }
+  }
+
+  std::sort(order.begin(), order.end(), [this](const std::size_t a, const std::size_t b) {
+      return partitions[a].buffer.size() > partitions[b].buffer.size();
+    });
+
+  for (std::size_t i = 0; i < order.size() && buffered > memoryLimit / 2; i++) {
+    drain(order[i]);
+  }
+}
+
+/**
+ * @brief 指定されたファイルのバッファを書き出して、バッファのメモリを解放します。
+ * @param partition ファイルの番号
+ * @exception std::ios_base::failure ファイルへの書き出しにエラーが発生した場合
+ */
+void PartitionedWriter::drain(const std::size_t partition)
+{
+  Partition& target = partitions[partition];
+
+  if (target.buffer.empty()) {
+    return;
+  }
+
+  open(partition);
+  if (!writeAll(target.fd, target.buffer.data(), target.buffer.size())) {
+    throw std::ios_base::failure("Failed to write: " + target.path);
+  }
+
+  buffered -= target.buffer.size();
+  std::string().swap(target.buffer);
+}
+
+/**
+ * @brief 指定されたファイルを開いて、最近使ったファイルにします。
+ *
+ * 開いているファイルの数が上限に達している場合は、最も長く使っていないファイルを閉じます。
+ * @param partition ファイルの番号
+ * @exception std::ios_base::failure ファイルを開けない場合、または閉じるときにエラーが発生した場合
+ */
+void PartitionedWriter::open(const std::size_t partition)
+{
+  Partition& target = partitions[partition];
+
+  if (target.fd >= 0) {
+    openFiles.splice(openFiles.begin(), openFiles, target.recent);
+    return;
+  }
+
+  while (openFiles.size() >= maxOpenFiles) {
+    Partition& victim = partitions[openFiles.back()];
+    openFiles.pop_back();
+
+    const int result = ::close(victim.fd);
+    victim.fd = -1;
+    if (result != 0) {
+      throw std::ios_base::failure("Failed to write: " + victim.path);
+    }
+  }
+
+  const int flags = O_WRONLY | O_CREAT | (target.created ? O_APPEND : O_TRUNC);
+  target.fd = ::open(target.path.c_str(), flags, 0666);
+  if (target.fd < 0) {
+    throw std::ios_base::failure("Failed to open file for writing: " + target.path);
+  }
+
+  target.created = true;
+  openFiles.push_front(partition);
+  target.recent = openFiles.begin();
+}
+
+} // namespace csv
+} // namespace csl
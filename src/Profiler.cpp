@@ -0,0 +1,258 @@
+/**
+ * @file  Profiler.cpp
+ * @brief Profilerクラス実装ファイル
+ */
+#include "csl/csv/Profiler.hpp"
+#include <fstream>
+#include <ios>
+#include <stdexcept>
+#include <sys/stat.h>
+#include "csl/csv/Reader.hpp"
+#include "csl/csv/Splitter.hpp"
+#include "csl/csv/ThreadPool.hpp"
+
+namespace csl {
+namespace csv {
+
+/**
+ * @brief 1つのスレッドで読み込む、空のProfilerオブジェクトを構築します。
+ */
+Profiler::Profiler(void)
+  : threadCount(1)
+  , recordCount(0)
+{
+}
+
+/**
+ * @brief Profilerオブジェクトを破棄します。
+ */
+Profiler::~Profiler(void)
+{
+}
+
+/**
+ * @brief ファイルを読み込むスレッド数を設定します。
+ *
+ * 入力ストリームは常に1つのスレッドで読み込みます。
+ * @param threadCount スレッド数(0の場合は1)
+ */
+void Profiler::setThreadCount(const std::size_t threadCount)
+{
+  this->threadCount = (threadCount > 0) ? threadCount : 1;
+}
+
+/**
+ * @brief ファイルを読み込むスレッド数を返します。
+ * @return スレッド数
+ */
+std::size_t Profiler::getThreadCount(void) const
+{
+  return threadCount;
+}
+
+/**
+ * @brief デフォルトのConfigオブジェクトの設定に従って、入力ストリームのCSVデータの統計情報を求めます。
+ *
+ * 統計情報はclearを呼び出すまで加算し続けます。
+ * @param stream 入力ストリーム
+ * @exception std::ios_base::failure 入力ストリームにエラーが発生した場合
+ */
+void Profiler::profile(std::istream& stream)
+{
+  profile(stream, DEFAULT_CONFIG);
+}
+
+/**
+ * @brief 指定されたConfigオブジェクトの設定に従って、入力ストリームのCSVデータの統計情報を求めます。
+ *
+ * 統計情報はclearを呼び出すまで加算し続けます。
+ * @param stream 入力ストリーム
+ * @param config Configオブジェクト
+ * @exception std::ios_base::failure 入力ストリームにエラーが発生した場合
+ */
+void Profiler::profile(std::istream& stream, const Config& config)
+{
+  Reader reader(stream, config);
+  LazyRecord record;
+
+  while (reader.hasNext()) {
+    reader.read(record);
+    add(record);
+  }
+}
+
+/**
+ * @brief デフォルトのConfigオブジェクトの設定に従って、ファイルのCSVデータの統計情報を求めます。
+ * @param filepath ファイルパス
+ * @exception std::ios_base::failure 入力ストリームにエラーが発生した場合
+ */
+void Profiler::profile(const std::string& filepath)
+{
+  profile(filepath, DEFAULT_CONFIG);
+}
+
+/**
+ * @brief 指定されたConfigオブジェクトの設定に従って、ファイルのCSVデータの統計情報を求めます。
+ *
+ * スレッド数が2以上の場合は、ファイルをスレッド数の範囲に分けて並列に読み込み、範囲ごとの統計情報を併合します。
+ * @param filepath ファイルパス
+ * @param config Configオブジェクト
+ * @exception std::ios_base::failure 入力ストリームにエラーが発生した場合
+ */
+void Profiler::profile(const std::string& filepath, const Config& config)
+{
+  struct stat st;
+  if (stat(filepath.c_str(), &st) != 0 || !S_ISREG(st.st_mode)) {
+    throw std::ios_base::failure("Failed to open file for reading: " + filepath);
+  }
+
+  if (threadCount == 1) {
+    std::ifstream stream(filepath.c_str(), std::ifstream::binary);
+
+    if (!stream.is_open()) {
+      throw std::ios_base::failure("Failed to open file for reading: " + filepath);
+    }
+
+    try {
+      profile(stream, config);
+    } catch (...) {
+      stream.close();
+      throw;
+    }
+
+    stream.close();
+    return;
+  }
+
+  std::vector<Range> ranges;
+  Splitter::plan(filepath, config, threadCount, ranges);
+
+  std::vector<Profiler> partials(ranges.size());
+  ThreadPool pool(threadCount);
+
+  for (std::size_t i = 0; i < ranges.size(); i++) {
+    pool.submit([&filepath, &config, &ranges, &partials, i]() {
+	std::ifstream stream(filepath.c_str(), std::ifstream::binary);
+
+	if (!stream.is_open()) {
+	  throw std::ios_base::failure("Failed to open file for reading: " + filepath);
+	}
+
+	Reader reader(stream, config, ranges[i]);
+	LazyRecord record;
+
+	while (reader.hasNext()) {
+	  reader.read(record);
+	  partials[i].add(record);
+	}
+      });
+  }
+  pool.wait();
+
+  for (std::size_t i = 0; i < partials.size(); i++) {
+    merge(partials[i]);
+  }
+}
+
+/**
+ * @brief 1件のCSVレコードを統計情報に加えます。
+ *
+ * Reader::read(LazyRecord&)で読み込みながら、呼び出し側で統計情報を求める場合に使います。
+ * @param record CSVレコード
+ */
+void Profiler::add(const LazyRecord& record)
+{
+  if (record.size() == 0) {
+    return;
+  }
+
+  widen(record.size());
+  recordCount++;
+
+  for (std::size_t i = 0; i < columns.size(); i++) {
+    if (i >= record.size()) {
+      columns[i].addMissing(1);
+    } else if (record.isQuoted(i)) {
+      const std::string& value = record.get(i);
+      columns[i].add(value.data(), value.size());
+    } else {
+      columns[i].add(record.getRawData(i), record.getRawSize(i));
+    }
+  }
+}
+
+/**
+ * @brief 別のProfilerの統計情報を、このProfilerに併合します。
+ *
+ * 別のスレッドで同じCSVデータの別の部分を読み込んだProfilerを併合すると、1つで読み込んだ場合と同じ統計情報になります(合計の丸め誤差を除く)。
+ * @param profiler Profilerオブジェクト
+ */
+void Profiler::merge(const Profiler& profiler)
+{
+  widen(profiler.columns.size());
+
+  for (std::size_t i = 0; i < columns.size(); i++) {
+    if (i < profiler.columns.size()) {
+      columns[i].merge(profiler.columns[i]);
+    } else {
+      columns[i].addMissing(profiler.recordCount);
+    }
+  }
+  recordCount += profiler.recordCount;
+}
+
+/**
+ * @brief 統計情報に加えたCSVレコードの数を返します。
+ * @return CSVレコードの数
+ */
+std::uint64_t Profiler::getRecordCount(void) const
+{
+  return recordCount;
+}
+
+/**
+ * @brief 列の数(最もフィールドの多いCSVレコードのフィールドの数)を返します。
+ * @return 列の数
+ */
+std::size_t Profiler::size(void) const
+{
+  return columns.size();
+}
+
+/**
+ * @brief 指定された列の統計情報を返します。
+ * @param column 列の番号
+ * @return 統計情報
+ * @exception std::out_of_range 列の番号が範囲外の場合
+ */
+const ColumnProfile& Profiler::getColumn(const std::size_t column) const
+{
+  if (column >= columns.size()) {
+    throw std::out_of_range("Invalid column.");
+  }
+  return columns[column];
+}
+
+/**
+ * @brief 統計情報を破棄します。
+ */
+void Profiler::clear(void)
+{
+  recordCount = 0;
+  columns.clear();
+}
+
+/**
+ * @brief 列の数を増やします。増やした列では、それまでのCSVレコードを列がないものとして数えます。
+ * @param size 列の数
+ */
+void Profiler::widen(const std::size_t size)
+{
+  while (columns.size() < size) {
+    columns.push_back(ColumnProfile());
+    columns.back().addMissing(recordCount);
+  }
+}
+
+} // namespace csv
+} // namespace csl
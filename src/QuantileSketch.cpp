@@ -0,0 +1,252 @@
+/**
+ * @file  QuantileSketch.cpp
+ * @brief QuantileSketchクラス実装ファイル
+ */
+#include "csl/csv/QuantileSketch.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace csl {
+namespace csv {
+
+namespace {
+
+/**
+ * @brief 0とみなす絶対値の上限です。
+ */
+const double ZERO_THRESHOLD = 1e-300;
+
+} // namespace
+
+/**
+ * @brief デフォルトの相対精度で、空のQuantileSketchオブジェクトを構築します。
+ */
+QuantileSketch::QuantileSketch(void)
+  : accuracy(QUANTILE_ACCURACY)
+  , gamma((1.0 + QUANTILE_ACCURACY) / (1.0 - QUANTILE_ACCURACY))
+  , logGamma(std::log(gamma))
+  , zeroCount(0)
+  , count(0)
+  , minimum(std::numeric_limits<double>::infinity())
+  , maximum(-std::numeric_limits<double>::infinity())
+{
+  positive.offset = 0;
+  negative.offset = 0;
+}
+
+/**
+ * @brief 指定された相対精度で、空のQuantileSketchオブジェクトを構築します。
+ * @param accuracy 相対精度(0より大きく1未満)
+ * @exception std::invalid_argument 相対精度が範囲外の場合
+ */
+QuantileSketch::QuantileSketch(const double accuracy)
+  : accuracy(accuracy)
+  , gamma((1.0 + accuracy) / (1.0 - accuracy))
+  , logGamma(std::log(gamma))
+  , zeroCount(0)
+  , count(0)
+  , minimum(std::numeric_limits<double>::infinity())
+  , maximum(-std::numeric_limits<double>::infinity())
+{
+  if (!(accuracy > 0.0 && accuracy < 1.0)) {
+    throw std::invalid_argument("Invalid accuracy.");
+  }
+  positive.offset = 0;
+  negative.offset = 0;
+}
+
+/**
+ * @brief QuantileSketchオブジェクトを破棄します。
+ */
+QuantileSketch::~QuantileSketch(void)
+{
+}
+
+/**
+ * @brief 相対精度を返します。
+ * @return 相対精度
+ */
+double QuantileSketch::getAccuracy(void) const
+{
+  return accuracy;
+}
+
+/**
+ * @brief 数値を追加します。NaNと無限大は無視します。
+ * @param value 数値
+ */
+void QuantileSketch::add(const double value)
+{
+  if (!std::isfinite(value)) {
+    return;
+  }
+
+  if (value > ZERO_THRESHOLD) {
+    add(positive, getIndex(value), 1);
+  } else if (value < -ZERO_THRESHOLD) {
+    add(negative, getIndex(-value), 1);
+  } else {
+    zeroCount++;
+  }
+
+  count++;
+  minimum = std::min(minimum, value);
+  maximum = std::max(maximum, value);
+}
+
+/**
+ * @brief 別のQuantileSketchに追加した数値を、このQuantileSketchに併合します。
+ * @param sketch QuantileSketchオブジェクト
+ * @exception std::invalid_argument 相対精度が異なる場合
+ */
+void QuantileSketch::merge(const QuantileSketch& sketch)
+{
+  if (sketch.accuracy != accuracy) {
+    throw std::invalid_argument("Invalid accuracy.");
+  }
+
+  for (std::size_t i = 0; i < sketch.positive.counts.size(); i++) {
+    if (sketch.positive.counts[i] > 0) {
+      add(positive, sketch.positive.offset + static_cast<int>(i), sketch.positive.counts[i]);
+    }
+  }
+  for (std::size_t i = 0; i < sketch.negative.counts.size(); i++) {
+    if (sketch.negative.counts[i] > 0) {
+      add(negative, sketch.negative.offset + static_cast<int>(i), sketch.negative.counts[i]);
+    }
+  }
+
+  zeroCount += sketch.zeroCount;
+  count += sketch.count;
+  minimum = std::min(minimum, sketch.minimum);
+  maximum = std::max(maximum, sketch.maximum);
+}
+
+/**
+ * @brief 追加した数値の件数を返します。
+ * @return 件数
+ */
+std::uint64_t QuantileSketch::size(void) const
+{
+  return count;
+}
+
+/**
+ * @brief 分位数の近似値を返します。
+ *
+ * 0の場合は最小値、1の場合は最大値を返します。
+ * @param q 分位(0以上1以下)
+ * @return 分位数の近似値(数値がない場合はNaN)
+ * @exception std::invalid_argument 分位が範囲外の場合
+ */
+double QuantileSketch::quantile(const double q) const
+{
+  if (!(q >= 0.0 && q <= 1.0)) {
+    throw std::invalid_argument("Invalid quantile.");
+  }
+
+  if (count == 0) {
+    return std::numeric_limits<double>::quiet_NaN();
+  }
+  if (q == 0.0) {
+    return minimum;
+  }
+  if (q == 1.0) {
+    return maximum;
+  }
+
+  // rank of the requested value among the sorted values, counted from 0
+  const std::uint64_t rank = static_cast<std::uint64_t>(q * static_cast<double>(count - 1));
+  std::uint64_t seen = 0;
+  double value = maximum;
+  bool found = false;
+
+  for (std::size_t i = negative.counts.size(); i > 0 && !found; i--) {
+    seen += negative.counts[i - 1];
+    if (seen > rank) {
+      value = -getValue(negative.offset + static_cast<int>(i - 1));
+      found = true;
+    }
+  }
+
+  if (!found) {
+    seen += zeroCount;
+    if (seen > rank) {
+      value = 0.0;
+      found = true;
+    }
+  }
+
+  for (std::size_t i = 0; i < positive.counts.size() && !found; i++) {
+    seen += positive.counts[i];
+    if (seen > rank) {
+      value = getValue(positive.offset + static_cast<int>(i));
+      found = true;
+    }
+  }
+
+  return std::min(std::max(value, minimum), maximum);
+}
+
+/**
+ * @brief 追加した数値をすべて破棄します。
+ */
+void QuantileSketch::clear(void)
+{
+  positive.counts.clear();
+  positive.offset = 0;
+  negative.counts.clear();
+  negative.offset = 0;
+  zeroCount = 0;
+  count = 0;
+  minimum = std::numeric_limits<double>::infinity();
+  maximum = -std::numeric_limits<double>::infinity();
+}
+
+/**
+ * @brief 正の数値が入るバケットの番号を返します。
+ * @param value 正の数値
+ * @return バケットの番号
+ */
+int QuantileSketch::getIndex(const double value) const
+{
+  return static_cast<int>(std::ceil(std::log(value) / logGamma));
+}
+
+/**
+ * @brief バケットの代表値を返します。
+ *
+ * バケット(gamma^(index-1), gamma^index]のどの値に対しても、相対誤差が相対精度以下になる値です。
+ * @param index バケットの番号
+ * @return 代表値
+ */
+double QuantileSketch::getValue(const int index) const
+{
+  return 2.0 * std::pow(gamma, index) / (gamma + 1.0);
+}
+
+/**
+ * @brief バケットの件数を加えます。必要に応じてcountsを前後に広げます。
+ * @param store バケットの件数
+ * @param index バケットの番号
+ * @param count 加える件数
+ */
+void QuantileSketch::add(Store& store, const int index, const std::uint64_t count)
+{
+  if (store.counts.empty()) {
+    store.offset = index;
+    store.counts.push_back(0);
+  } else if (index < store.offset) {
+    store.counts.insert(store.counts.begin(), static_cast<std::size_t>(store.offset - index), 0);
+    store.offset = index;
+  } else if (index >= store.offset + static_cast<int>(store.counts.size())) {
+    store.counts.resize(static_cast<std::size_t>(index - store.offset) + 1, 0);
+  }
+
+  store.counts[static_cast<std::size_t>(index - store.offset)] += count;
+}
+
+} // namespace csv
+} // namespace csl
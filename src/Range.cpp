@@ -0,0 +1,70 @@
+/**
+ * @file  Range.cpp
+ * @brief Rangeクラス実装ファイル
+ */
+#include "csl/csv/Range.hpp"
+#include <stdexcept>
+
+namespace csl {
+namespace csv {
+
+/**
+ * @brief 空のRangeオブジェクトを構築します。
+ */
+Range::Range(void)
+  : begin(0)
+  , end(0)
+{
+}
+
+/**
+ * @brief 指定された範囲を表すRangeオブジェクトを構築します。
+ * @param begin 範囲の開始位置
+ * @param end   範囲の終了位置(この位置を含みません)
+ * @exception std::invalid_argument 開始位置が負の場合、または、終了位置が開始位置より前の場合
+ */
+Range::Range(const std::streamoff begin, const std::streamoff end)
+  : begin(begin)
+  , end(end)
+{
+  if (begin < 0 || end < begin) {
+    throw std::invalid_argument("Invalid range.");
+  }
+}
+
+/**
+ * @brief Rangeオブジェクトを破棄します。
+ */
+Range::~Range(void)
+{
+}
+
+/**
+ * @brief 範囲の開始位置を返します。
+ * @return 範囲の開始位置
+ */
+std::streamoff Range::getBegin(void) const
+{
+  return begin;
+}
+
+/**
+ * @brief 範囲の終了位置を返します。
+ * @return 範囲の終了位置(この位置を含みません)
+ */
+std::streamoff Range::getEnd(void) const
+{
+  return end;
+}
+
+/**
+ * @brief 範囲のバイト数を返します。
+ * @return 範囲のバイト数
+ */
+std::streamoff Range::getSize(void) const
+{
+  return end - begin;
+}
+
+} // namespace csv
+} // namespace csl
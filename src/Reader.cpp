@@ -3,6 +3,8 @@
  * @brief Readerクラス実装ファイル
  */
 #include "csl/csv/Reader.hpp"
+#include <chrono>
+#include <limits>
 
 namespace csl {
 namespace csv {
@@ -13,7 +15,11 @@ namespace csv {
  */
 Reader::Reader(std::istream& stream)
   : stream(stream)
-  , config(DEFAULT_CONFIG)
+  , automaton(DEFAULT_CONFIG)
+  , position(0)
+  , recordNumber(0)
+  , limit(std::numeric_limits<std::streamoff>::max())
+  , stats(NULL)
 {
   readNextChar();
 }
@@ -25,11 +31,66 @@ Reader::Reader(std::istream& stream)
  */
 Reader::Reader(std::istream& stream, const Config& config)
   : stream(stream)
-  , config(config)
+  , automaton(config)
+  , position(0)
+  , recordNumber(0)
+  , limit(std::numeric_limits<std::streamoff>::max())
+  , stats(NULL)
 {
   readNextChar();
 }
 
+/**
+ * @brief 指定されたConfigオブジェクトを設定して、getOffsetとgetRecordNumberで保存しておいた位置から読み込みを再開するReaderオブジェクトを構築します。
+ * @param stream 入力ストリーム
+ * @param config Configオブジェクト
+ * @param offset 読み込みを再開するバイト位置
+ * @param recordNumber 読み込みを再開する位置までに読み込んだCSVレコードの数
+ * @exception std::ios_base::failure 入力ストリームを指定された位置に移動できなかった場合
+ */
+Reader::Reader(std::istream& stream, const Config& config,
+	       const std::streamoff offset, const std::size_t recordNumber)
+  : stream(stream)
+  , automaton(config)
+  , position(offset)
+  , recordNumber(recordNumber)
+  , limit(std::numeric_limits<std::streamoff>::max())
+  , stats(NULL)
+{
+  stream.seekg(offset);
+  if (stream.fail() || stream.bad()) {
+    throw std::ios_base::failure("Failed to seek.");
+  }
+
+  readNextChar();
+}
+
+/**
+ * @brief 指定されたConfigオブジェクトを設定して、入力ストリームの指定された範囲だけを読み込むReaderオブジェクトを構築します。
+ *
+ * 範囲はSplitterクラスなどでCSVレコードの境界に合わせておく必要があります。
+ * 読み込んだCSVレコードの数(getRecordNumber)は範囲の先頭から数えます。
+ * @param stream 入力ストリーム
+ * @param config Configオブジェクト
+ * @param range 読み込む範囲
+ * @exception std::ios_base::failure 入力ストリームを範囲の先頭に移動できなかった場合
+ */
+Reader::Reader(std::istream& stream, const Config& config, const Range& range)
+  : stream(stream)
+  , automaton(config)
+  , position(range.getBegin())
+  , recordNumber(0)
+  , limit(range.getEnd())
+  , stats(NULL)
+{
+  stream.seekg(range.getBegin());
+  if (stream.fail() || stream.bad()) {
+    throw std::ios_base::failure("Failed to seek.");
+  }
+
+  readNextChar();
+}
+
 /**
  * @brief Readerオブジェクトを破棄します。
  */
@@ -43,7 +104,7 @@ Reader::~Reader(void)
  */
 bool Reader::hasNext(void)
 {
-  return !stream.eof();
+  return !stream.eof() && position <= limit;
 }
 
 /**
@@ -53,18 +114,52 @@ bool Reader::hasNext(void)
  */
 void Reader::read(std::vector<std::string>& record)
 {
-  typedef enum {
-    STATE_NORMAL,
-    STATE_QUOTE,
-    STATE_ESCAPE,
-    STATE_AFTER_CR,
-  } STATE;
+  readRecord(record);
+}
+
+#if __cplusplus >= 201703L
+/**
+ * @brief 入力ストリームからCSVレコードを読み込んで、CSVレコードのメモリリソースから割り当てたフィールドで返します。
+ *
+ * monotonic_buffer_resourceなどを使用すれば、読み込んだCSVデータをまとめて解放できます。
+ * @param record CSVレコード
+ * @exception std::ios_base::failure 入力ストリームにエラーが発生した場合
+ */
+void Reader::read(std::pmr::vector<std::pmr::string>& record)
+{
+  readRecord(record);
+}
+#endif
 
+/**
+ * @brief 入力ストリームからCSVレコードを読み込んで返します。
+ *
+ * 各フィールドはCSVレコードのアロケータで構築します。
+ * @param record CSVレコード
+ * @exception std::ios_base::failure 入力ストリームにエラーが発生した場合
+ */
+template <typename Record>
+void Reader::readRecord(Record& record)
+{
   record.clear();
 
   std::string field;
-  STATE state = STATE_NORMAL;
+  unsigned char state = Automaton::STATE_NORMAL;
   bool firstCharFlag = true;
+  std::size_t quotedFields = 0;
+  std::size_t escapedQuotes = 0;
+  std::size_t commentLines = 0;
+  std::chrono::steady_clock::time_point begin;
+  unsigned long long ioTime = 0;
+  std::streamoff beginOffset = 0;
+  std::streamoff recordOffset = 0;
+
+  if (stats != NULL) {
+    begin = std::chrono::steady_clock::now();
+    ioTime = stats->ioTime;
+    beginOffset = getOffset();
+    recordOffset = beginOffset;
+  }
   
   while (hasNext()) {
     if (stream.fail() || stream.bad()) {
@@ -73,81 +168,293 @@ void Reader::read(std::vector<std::string>& record)
 
     if (firstCharFlag) {
       firstCharFlag = false;
-      if (config.getCommentEnabled() && nextChar == config.getCommentMark()) {
+      if (automaton.isCommentMark(nextChar)) {
 	readCommentLine();
+	commentLines++;
+	if (stats != NULL) {
+	  recordOffset = getOffset();
+	}
 	if (!hasNext()) {
 	  break; // end of file
 	}
       }
     }
 
-    if (state == STATE_NORMAL) {
-      if (nextChar == config.getDelimitMark()) {
-	record.push_back(field);
-	field.clear();
-	state = STATE_NORMAL;
-      } else if (nextChar == '\r') {
-	state = STATE_AFTER_CR;
-      } else if (config.getQuoteEnabled() && nextChar == config.getQuoteMark()) {
-	state = STATE_QUOTE;
-      } else {
-	field.push_back(nextChar);
-	state = STATE_NORMAL;
+    const Automaton::Transition transition = automaton.step(state, nextChar);
+    const unsigned char actions = transition.actions;
+    state = transition.state;
+
+    if ((actions & Automaton::ACTION_END_RECORD) != 0) {
+      readNextChar();
+      break; // end of record
+    }
+    if ((actions & Automaton::ACTION_APPEND_CR) != 0) {
+      field.push_back('\r');
+    }
+    if ((actions & Automaton::ACTION_APPEND) != 0) {
+      field.push_back(nextChar);
+    }
+    if ((actions & Automaton::ACTION_END_FIELD) != 0) {
+      record.emplace_back(field.data(), field.size());
+      field.clear();
+    }
+    quotedFields += ((actions & Automaton::ACTION_QUOTED) != 0);
+    escapedQuotes += ((actions & Automaton::ACTION_ESCAPED) != 0);
+
+    readNextChar();
+  }
+
+  if (state == Automaton::STATE_AFTER_CR) {
+    field.push_back('\r');
+  }
+
+  if (field.size() > 0) {
+    record.emplace_back(field.data(), field.size());
+  }
+
+  recordNumber++;
+
+  if (stats != NULL) {
+    std::size_t maxFieldLength = 0;
+    for (std::size_t i = 0; i < record.size(); i++) {
+      if (record[i].size() > maxFieldLength) {
+	maxFieldLength = record[i].size();
+      }
+    }
+    addStats(begin, ioTime, beginOffset, recordOffset,
+	     record.size(), maxFieldLength, quotedFields, escapedQuotes, commentLines);
+  }
+}
+
+/**
+ * @brief 入力ストリームからCSVレコードを読み込んで、フィールドを解釈せずに返します。
+ *
+ * フィールドの境界を求めるだけで、囲み文字の除去やエスケープの解釈はフィールドにアクセスしたときに行います。
+ * 読み込まれるフィールドはread(std::vector<std::string>&)と同じです。
+ * @param record CSVレコード
+ * @exception std::ios_base::failure 入力ストリームにエラーが発生した場合
+ */
+void Reader::read(LazyRecord& record)
+{
+  readLazyRecord(record, NULL);
+}
+
+/**
+ * @brief 入力ストリームからCSVレコードを読み込んで、指定されたFilterオブジェクトの条件を満たす場合だけフィールドを解釈せずに返します。
+ *
+ * 条件のある列のフィールドは、読み込んだ時点で調べます。
+ * 条件を満たさなかった場合は、残りのフィールドを保持せずにCSVレコードの終わりまで読み飛ばします。
+ * 条件を満たさなかったCSVレコードも、読み込んだCSVレコードの数(getRecordNumber)に数えます。
+ * @param record CSVレコード(条件を満たさなかった場合は空)
+ * @param filter Filterオブジェクト
+ * @return 条件を満たした場合はtrue
+ * @exception std::ios_base::failure 入力ストリームにエラーが発生した場合
+ */
+bool Reader::read(LazyRecord& record, const Filter& filter)
+{
+  return readLazyRecord(record, &filter);
+}
+
+/**
+ * @brief 入力ストリームからCSVレコードを読み込んで、フィールドを解釈せずに返します。
+ * @param record CSVレコード
+ * @param filter Filterオブジェクト、またはNULL
+ * @return 条件を満たした場合(NULLの場合は常に)true
+ * @exception std::ios_base::failure 入力ストリームにエラーが発生した場合
+ */
+bool Reader::readLazyRecord(LazyRecord& record, const Filter* filter)
+{
+  record.clear();
+  record.quoteEnabled = automaton.getQuoteEnabled();
+  record.quoteMark = automaton.getQuoteMark();
+
+  std::string& data = record.data;
+  LazyRecord::Field field = {0, 0, 0};
+  unsigned char state = Automaton::STATE_NORMAL;
+  bool firstCharFlag = true;
+  bool matched = true;
+  std::size_t quotedFields = 0;
+  std::size_t escapedQuotes = 0;
+  std::size_t commentLines = 0;
+  std::chrono::steady_clock::time_point begin;
+  unsigned long long ioTime = 0;
+  std::streamoff beginOffset = 0;
+  std::streamoff recordOffset = 0;
+
+  if (stats != NULL) {
+    begin = std::chrono::steady_clock::now();
+    ioTime = stats->ioTime;
+    beginOffset = getOffset();
+    recordOffset = beginOffset;
+  }
+
+  while (hasNext()) {
+    if (stream.fail() || stream.bad()) {
+      throw std::ios_base::failure("Failed to read.");
+    }
+
+    if (firstCharFlag) {
+      firstCharFlag = false;
+      if (automaton.isCommentMark(nextChar)) {
+	readCommentLine();
+	commentLines++;
+	if (stats != NULL) {
+	  recordOffset = getOffset();
+	}
+	if (!hasNext()) {
+	  break; // end of file
+	}
       }
-    } else if (state == STATE_AFTER_CR) {
-      if (nextChar == config.getDelimitMark()) {
-	field.push_back('\r');
-	record.push_back(field);
-	field.clear();
-	state = STATE_NORMAL;
-      } else if (nextChar == '\r') {
-	field.push_back('\r');
-	state = STATE_AFTER_CR;
-      } else if (nextChar == '\n') {
-	state = STATE_NORMAL;
+    }
+
+    const Automaton::Transition transition = automaton.step(state, nextChar);
+    const unsigned char actions = transition.actions;
+    state = transition.state;
+
+    if ((actions & Automaton::ACTION_END_RECORD) != 0) {
+      data.erase(data.size() - 1); // the CR belongs to the record terminator
+      readNextChar();
+      break; // end of record
+    }
+    if ((actions & Automaton::ACTION_LINE_BREAK) != 0) {
+      field.flags |= LazyRecord::FLAG_LINE_BREAK;
+    }
+    if ((actions & Automaton::ACTION_QUOTED) != 0) {
+      field.flags |= LazyRecord::FLAG_QUOTED;
+      quotedFields++;
+    }
+    if ((actions & Automaton::ACTION_ESCAPED) != 0) {
+      field.flags |= LazyRecord::FLAG_ESCAPED;
+      escapedQuotes++;
+    }
+
+    // the raw data keeps everything but delimiters and record terminators
+    if ((actions & Automaton::ACTION_END_FIELD) == 0) {
+      data.push_back(nextChar);
+    } else {
+      field.size = data.size() - field.begin;
+      record.fields.push_back(field);
+      field.begin = data.size();
+      field.flags = 0;
+      if (filter != NULL && !filter->test(record, record.fields.size() - 1)) {
+	matched = false;
 	readNextChar();
+	skipRecord();
 	break; // end of record
-      } else if (config.getQuoteEnabled() && nextChar == config.getQuoteMark()) {
-	field.push_back('\r');
-	state = STATE_QUOTE;
-      } else {
-	field.push_back('\r');
-	field.push_back(nextChar);
-	state = STATE_NORMAL;
-      }
-    } else if (state == STATE_QUOTE) {
-      if (config.getQuoteEnabled() && nextChar == config.getQuoteMark()) {
-	state = STATE_ESCAPE;
-      } else {
-	field.push_back(nextChar);
-	state = STATE_QUOTE;
-      }
-    } else if (state == STATE_ESCAPE) {
-      if (nextChar == config.getDelimitMark()) {
-	record.push_back(field);
-	field.clear();
-	state = STATE_NORMAL;
-      } else if (nextChar == '\r') {
-	state = STATE_AFTER_CR;
-      } else if (config.getQuoteEnabled() && nextChar == config.getQuoteMark()) {
-	field.push_back(nextChar);
-	state = STATE_QUOTE;
-      } else {
-	field.push_back(nextChar);
-	state = STATE_NORMAL;
       }
     }
 
     readNextChar();
   }
 
-  if (state == STATE_AFTER_CR) {
-    field.push_back('\r');
+  if (state == Automaton::STATE_AFTER_CR) {
+    field.flags |= LazyRecord::FLAG_LINE_BREAK;
   }
 
-  if (field.size() > 0) {
-    record.push_back(field);
+  // an empty last field is dropped, as read(std::vector<std::string>&) does
+  field.size = data.size() - field.begin;
+  if (matched && field.size > 0) {
+    record.fields.push_back(field);
+    if ((field.flags & LazyRecord::FLAG_QUOTED) != 0 && record.get(record.fields.size() - 1).empty()) {
+      record.fields.pop_back();
+    } else if (filter != NULL) {
+      matched = filter->test(record, record.fields.size() - 1);
+    }
   }
+  if (filter != NULL && record.fields.size() < filter->getColumnCount()) {
+    matched = false;
+  }
+
+  recordNumber++;
+
+  if (stats != NULL) {
+    std::size_t maxFieldLength = 0;
+    for (std::size_t i = 0; i < record.fields.size(); i++) {
+      if (record.fields[i].size > maxFieldLength) {
+	maxFieldLength = record.fields[i].size;
+      }
+    }
+    addStats(begin, ioTime, beginOffset, recordOffset,
+	     record.fields.size(), maxFieldLength, quotedFields, escapedQuotes, commentLines);
+  }
+
+  if (!matched) {
+    record.clear();
+  }
+  return matched;
+}
+
+/**
+ * @brief 次のCSVレコードの先頭のバイト位置を返します。
+ *
+ * 位置を指定するコンストラクタで構築した場合は入力ストリームの先頭から、それ以外の場合は読み込みを始めた位置からのバイト数です。
+ * @return 次のCSVレコードの先頭のバイト位置
+ */
+std::streamoff Reader::getOffset(void)
+{
+  return stream.eof() ? position : position - 1;
+}
+
+/**
+ * @brief これまでに読み込んだCSVレコードの数を返します。
+ * @return これまでに読み込んだCSVレコードの数
+ */
+std::size_t Reader::getRecordNumber(void) const
+{
+  return recordNumber;
+}
+
+/**
+ * @brief 読み込んだCSVデータの統計情報を加算するStatsオブジェクトを設定します。
+ *
+ * 設定しない場合(NULLの場合)は統計情報を集計しません。
+ * @param stats Statsオブジェクト、またはNULL
+ */
+void Reader::setStats(Stats* stats)
+{
+  this->stats = stats;
+}
+
+/**
+ * @brief 読み込んだCSVレコードの統計情報をStatsオブジェクトに加算します。
+ * @param begin 読み込みを始めた時刻
+ * @param ioTime 読み込みを始めたときの入出力の待ち時間
+ * @param beginOffset 読み込みを始めた位置
+ * @param recordOffset コメント行を除いたCSVレコードの先頭の位置
+ * @param fields フィールドの数
+ * @param maxFieldLength 最も長いフィールドのバイト数
+ * @param quotedFields 囲み文字で囲まれたフィールドの数
+ * @param escapedQuotes エスケープされた囲み文字の数
+ * @param commentLines コメント行の数
+ */
+void Reader::addStats(const std::chrono::steady_clock::time_point& begin,
+		      const unsigned long long ioTime,
+		      const std::streamoff beginOffset,
+		      const std::streamoff recordOffset,
+		      const std::size_t fields,
+		      const std::size_t maxFieldLength,
+		      const std::size_t quotedFields,
+		      const std::size_t escapedQuotes,
+		      const std::size_t commentLines)
+{
+  const std::streamoff endOffset = getOffset();
+  const unsigned long long elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>
+    (std::chrono::steady_clock::now() - begin).count();
+  const unsigned long long waited = stats->ioTime - ioTime;
+
+  stats->bytes += static_cast<unsigned long long>(endOffset - beginOffset);
+  stats->records++;
+  stats->fields += fields;
+  stats->quotedFields += quotedFields;
+  stats->escapedQuotes += escapedQuotes;
+  stats->commentLines += commentLines;
+  if (maxFieldLength > stats->maxFieldLength) {
+    stats->maxFieldLength = maxFieldLength;
+  }
+  if (static_cast<std::size_t>(endOffset - recordOffset) > stats->maxRecordLength) {
+    stats->maxRecordLength = static_cast<std::size_t>(endOffset - recordOffset);
+  }
+  stats->parseTime += (elapsed > waited) ? elapsed - waited : 0;
 }
 
 /**
@@ -156,6 +463,7 @@ void Reader::read(std::vector<std::string>& record)
 void Reader::readNextChar(void)
 {
   nextChar = stream.get();
+  position += stream.gcount();
 }
 
 /**
@@ -181,5 +489,38 @@ void Reader::readCommentLine(void)
   }
 }
 
+/**
+ * @brief 現在のCSVレコードの残りを、フィールドを保持せずに読み飛ばします。
+ *
+ * フィールドの区切りの直後から呼び出します。囲み文字の中のCR/LFはCSVレコードの終わりとみなしません。
+ * @exception std::ios_base::failure 入力ストリームにエラーが発生した場合
+ */
+void Reader::skipRecord(void)
+{
+  bool quoted = false;
+  bool afterCr = false;
+
+  while (hasNext()) {
+    if (stream.fail() || stream.bad()) {
+      throw std::ios_base::failure("Failed to read.");
+    }
+
+    if (afterCr && nextChar == '\n') {
+      readNextChar();
+      return; // end of record
+    }
+
+    // an escaped quote toggles twice, which keeps the boundary intact
+    afterCr = false;
+    if (automaton.classify(nextChar) == Automaton::CLASS_QUOTE) {
+      quoted = !quoted;
+    } else if (!quoted && nextChar == '\r') {
+      afterCr = true;
+    }
+
+    readNextChar();
+  }
+}
+
 } // namespace csv
 } // namespace csl
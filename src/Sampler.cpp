@@ -0,0 +1,464 @@
+/**
+ * @file  Sampler.cpp
+ * @brief Samplerクラス実装ファイル
+ */
+#include "csl/csv/Sampler.hpp"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <ios>
+#include <limits>
+#include <set>
+#include <stdexcept>
+#include <sys/stat.h>
+#include "csl/csv/Reader.hpp"
+#include "csl/csv/Splitter.hpp"
+
+namespace csl {
+namespace csv {
+
+namespace {
+
+/**
+ * @brief sampleApproximateで境界を推測するときに前後を先読みするバイト数です。
+ */
+const std::streamoff SAMPLE_LOOKAHEAD = 4 * 1024;
+
+/**
+ * @brief sampleApproximateで、重複した位置を引き直す回数の上限です。
+ */
+const std::size_t SAMPLE_ROUNDS = 8;
+
+/**
+ * @brief 抽出したCSVレコードを入力での順序で比較します。
+ */
+struct PositionLess
+{
+  template <typename T>
+  bool operator()(const T* a, const T* b) const
+  {
+    return a->position < b->position;
+  }
+};
+
+} // namespace
+
+/**
+ * @brief 指定された件数を抽出するSamplerオブジェクトを構築します。乱数の種は無作為に決めます。
+ * @param sampleSize 抽出する件数(層の列を設定した場合は層ごとの件数)
+ */
+Sampler::Sampler(const std::size_t sampleSize)
+  : sampleSize(sampleSize)
+  , seed(std::random_device()())
+  , random(seed)
+  , stratified(false)
+  , stratumColumn(0)
+  , recordCount(0)
+{
+}
+
+/**
+ * @brief Samplerオブジェクトを破棄します。
+ */
+Sampler::~Sampler(void)
+{
+}
+
+/**
+ * @brief 抽出する件数を返します。
+ * @return 件数
+ */
+std::size_t Sampler::getSampleSize(void) const
+{
+  return sampleSize;
+}
+
+/**
+ * @brief 乱数の種を設定します。同じ種と入力からは同じCSVレコードを抽出します。
+ * @param seed 乱数の種
+ */
+void Sampler::setSeed(const std::uint64_t seed)
+{
+  this->seed = seed;
+  random.seed(seed);
+}
+
+/**
+ * @brief 乱数の種を返します。
+ * @return 乱数の種
+ */
+std::uint64_t Sampler::getSeed(void) const
+{
+  return seed;
+}
+
+/**
+ * @brief 層の列を設定し、それまでの抽出結果を破棄します。
+ *
+ * 列がないCSVレコードは、その列を空文字列として扱います。
+ * @param column 列の番号
+ */
+void Sampler::setStratumColumn(const std::size_t column)
+{
+  stratified = true;
+  stratumColumn = column;
+  clear();
+}
+
+/**
+ * @brief 層の列を削除し、それまでの抽出結果を破棄します。
+ */
+void Sampler::clearStratumColumn(void)
+{
+  stratified = false;
+  clear();
+}
+
+/**
+ * @brief 層の列が設定されているかどうかを返します。
+ * @return 設定されている場合はtrue
+ */
+bool Sampler::isStratified(void) const
+{
+  return stratified;
+}
+
+/**
+ * @brief デフォルトのConfigオブジェクトの設定に従って、入力ストリームのCSVデータから抽出します。
+ * @param stream 入力ストリーム
+ * @exception std::ios_base::failure 入力ストリームにエラーが発生した場合
+ */
+void Sampler::sample(std::istream& stream)
+{
+  sample(stream, DEFAULT_CONFIG);
+}
+
+/**
+ * @brief 指定されたConfigオブジェクトの設定に従って、入力ストリームのCSVデータから抽出します。
+ *
+ * clearを呼び出すまでは、続けて呼び出した入力すべてから抽出します。フィールドのないCSVレコードは抽出しません。
+ * @param stream 入力ストリーム
+ * @param config Configオブジェクト
+ * @exception std::ios_base::failure 入力ストリームにエラーが発生した場合
+ */
+void Sampler::sample(std::istream& stream, const Config& config)
+{
+  Reader reader(stream, config);
+  LazyRecord record;
+
+  while (reader.hasNext()) {
+    reader.read(record);
+    if (record.size() == 0) {
+      continue;
+    }
+
+    std::size_t index = 0;
+    if (stratified) {
+      const char* data = "";
+      std::size_t size = 0;
+
+      if (stratumColumn < record.size()) {
+	if (record.isQuoted(stratumColumn)) {
+	  const std::string& value = record.get(stratumColumn);
+	  data = value.data();
+	  size = value.size();
+	} else {
+	  data = record.getRawData(stratumColumn);
+	  size = record.getRawSize(stratumColumn);
+	}
+      }
+      index = strata.intern(data, size);
+    }
+
+    if (index == reservoirs.size()) {
+      reservoirs.push_back(Reservoir());
+      reservoirs.back().seen = 0;
+      reservoirs.back().next = 0;
+      reservoirs.back().weight = 0.0;
+    }
+
+    offer(reservoirs[index], record);
+    recordCount++;
+  }
+}
+
+/**
+ * @brief デフォルトのConfigオブジェクトの設定に従って、ファイルのCSVデータから抽出します。
+ * @param filepath ファイルパス
+ * @exception std::ios_base::failure 入力ストリームにエラーが発生した場合
+ */
+void Sampler::sample(const std::string& filepath)
+{
+  sample(filepath, DEFAULT_CONFIG);
+}
+
+/**
+ * @brief 指定されたConfigオブジェクトの設定に従って、ファイルのCSVデータから抽出します。
+ * @param filepath ファイルパス
+ * @param config Configオブジェクト
+ * @exception std::ios_base::failure 入力ストリームにエラーが発生した場合
+ */
+void Sampler::sample(const std::string& filepath, const Config& config)
+{
+  struct stat st;
+  if (stat(filepath.c_str(), &st) != 0 || !S_ISREG(st.st_mode)) {
+    throw std::ios_base::failure("Failed to open file for reading: " + filepath);
+  }
+
+  std::ifstream stream(filepath.c_str(), std::ifstream::binary);
+
+  if (!stream.is_open()) {
+    throw std::ios_base::failure("Failed to open file for reading: " + filepath);
+  }
+
+  try {
+    sample(stream, config);
+  } catch (...) {
+    stream.close();
+    throw;
+  }
+
+  stream.close();
+}
+
+/**
+ * @brief デフォルトのConfigオブジェクトの設定に従って、ファイルの無作為な位置からCSVレコードを抽出します。
+ * @param filepath ファイルパス
+ * @exception std::invalid_argument 層の列が設定されている場合
+ * @exception std::ios_base::failure 入力ストリームにエラーが発生した場合
+ */
+void Sampler::sampleApproximate(const std::string& filepath)
+{
+  sampleApproximate(filepath, DEFAULT_CONFIG);
+}
+
+/**
+ * @brief 指定されたConfigオブジェクトの設定に従って、ファイルの無作為な位置からCSVレコードを抽出します。
+ *
+ * それまでの抽出結果を破棄します。同じCSVレコードを2回抽出しないように、重複した位置は引き直します。
+ * CSVレコードが抽出する件数より少ない場合は、抽出できた件数で終わります。
+ * @param filepath ファイルパス
+ * @param config Configオブジェクト
+ * @exception std::invalid_argument 層の列が設定されている場合
+ * @exception std::ios_base::failure 入力ストリームにエラーが発生した場合
+ */
+void Sampler::sampleApproximate(const std::string& filepath, const Config& config)
+{
+  if (stratified) {
+    throw std::invalid_argument("Stratified sampling is not supported.");
+  }
+
+  struct stat st;
+  if (stat(filepath.c_str(), &st) != 0 || !S_ISREG(st.st_mode)) {
+    throw std::ios_base::failure("Failed to open file for reading: " + filepath);
+  }
+
+  std::ifstream stream(filepath.c_str(), std::ifstream::binary);
+
+  if (!stream.is_open()) {
+    throw std::ios_base::failure("Failed to open file for reading: " + filepath);
+  }
+
+  clear();
+  reservoirs.push_back(Reservoir());
+  reservoirs.back().seen = 0;
+  reservoirs.back().next = 0;
+  reservoirs.back().weight = 0.0;
+
+  const std::streamoff size = static_cast<std::streamoff>(st.st_size);
+  std::vector<Entry>& entries = reservoirs.back().entries;
+  std::set<std::streamoff> taken;
+
+  try {
+    for (std::size_t round = 0; round < SAMPLE_ROUNDS && size > 0 && taken.size() < sampleSize; round++) {
+      std::vector<std::streamoff> offsets(sampleSize - taken.size());
+      for (std::size_t i = 0; i < offsets.size(); i++) {
+	offsets[i] = static_cast<std::streamoff>(random() % static_cast<std::uint64_t>(size));
+      }
+
+      // visit the offsets in file order so that the nearest known boundary can be the origin
+      std::sort(offsets.begin(), offsets.end());
+
+      const std::size_t before = taken.size();
+      for (std::size_t i = 0; i < offsets.size(); i++) {
+	std::set<std::streamoff>::iterator next = taken.upper_bound(offsets[i]);
+	const std::streamoff origin = (next == taken.begin()) ? 0 : *(--next);
+
+	stream.clear();
+	const std::streamoff boundary = Splitter::align(stream, config, origin, offsets[i], SAMPLE_LOOKAHEAD);
+	if (boundary >= size || taken.count(boundary) > 0) {
+	  continue;
+	}
+
+	stream.clear();
+	Reader reader(stream, config, boundary, 0);
+	if (!reader.hasNext()) {
+	  continue;
+	}
+
+	Entry entry;
+	entry.position = static_cast<std::uint64_t>(boundary);
+	reader.read(entry.record);
+	taken.insert(boundary);
+	if (entry.record.empty()) {
+	  continue;
+	}
+	entries.push_back(entry);
+      }
+
+      if (taken.size() == before) {
+	break;
+      }
+    }
+  } catch (...) {
+    stream.close();
+    throw;
+  }
+
+  stream.close();
+  recordCount = entries.size();
+  reservoirs.back().seen = entries.size();
+}
+
+/**
+ * @brief 読み込んだCSVレコードの数を返します。
+ *
+ * sampleApproximateの場合は、読み込んで抽出したCSVレコードの数です。
+ * @return CSVレコードの数
+ */
+std::uint64_t Sampler::getRecordCount(void) const
+{
+  return recordCount;
+}
+
+/**
+ * @brief 抽出したCSVレコードの数を返します。
+ * @return CSVレコードの数
+ */
+std::size_t Sampler::size(void) const
+{
+  std::size_t count = 0;
+  for (std::size_t i = 0; i < reservoirs.size(); i++) {
+    count += reservoirs[i].entries.size();
+  }
+  return count;
+}
+
+/**
+ * @brief 抽出したCSVレコードを返します。
+ * @param csv CSVデータ
+ */
+void Sampler::getSample(std::vector<std::vector<std::string> >& csv) const
+{
+  std::vector<const Entry*> entries;
+  getRecords(entries);
+
+  csv.resize(entries.size());
+  for (std::size_t i = 0; i < entries.size(); i++) {
+    csv[i] = entries[i]->record;
+  }
+}
+
+/**
+ * @brief 抽出したCSVレコードを書き込みます。
+ * @param writer Writerオブジェクト
+ * @exception std::ios_base::failure 出力ストリームにエラーが発生した場合
+ */
+void Sampler::write(Writer& writer) const
+{
+  std::vector<const Entry*> entries;
+  getRecords(entries);
+
+  for (std::size_t i = 0; i < entries.size(); i++) {
+    writer.write(entries[i]->record);
+  }
+}
+
+/**
+ * @brief 抽出結果を破棄します。件数、乱数の種、層の列は残します。
+ */
+void Sampler::clear(void)
+{
+  recordCount = 0;
+  strata.clear();
+  reservoirs.clear();
+}
+
+/**
+ * @brief 1件のCSVレコードをリザーバに渡し、選ばれた場合はフィールドを解釈して保持します。
+ * @param reservoir リザーバ
+ * @param record CSVレコード
+ */
+void Sampler::offer(Reservoir& reservoir, const LazyRecord& record)
+{
+  const std::uint64_t index = reservoir.seen++;
+  Entry* entry = NULL;
+
+  if (sampleSize == 0) {
+    return;
+  }
+
+  if (index < sampleSize) {
+    reservoir.entries.push_back(Entry());
+    entry = &reservoir.entries.back();
+    if (reservoir.entries.size() == sampleSize) {
+      reservoir.weight = std::exp(std::log(uniform()) / static_cast<double>(sampleSize));
+      skip(reservoir);
+    }
+  } else if (index == reservoir.next) {
+    std::uniform_int_distribution<std::size_t> slot(0, sampleSize - 1);
+    entry = &reservoir.entries[slot(random)];
+    reservoir.weight *= std::exp(std::log(uniform()) / static_cast<double>(sampleSize));
+    skip(reservoir);
+  } else {
+    return;
+  }
+
+  entry->position = recordCount;
+  entry->record.resize(record.size());
+  for (std::size_t i = 0; i < record.size(); i++) {
+    record.get(i, entry->record[i]);
+  }
+}
+
+/**
+ * @brief 次に選ぶCSVレコードの番号を決めます。
+ * @param reservoir リザーバ
+ */
+void Sampler::skip(Reservoir& reservoir)
+{
+  // the number of records to pass over follows a geometric distribution
+  const double gap = std::floor(std::log(uniform()) / std::log1p(-reservoir.weight));
+  const double limit = static_cast<double>(std::numeric_limits<std::uint64_t>::max() - reservoir.seen);
+
+  reservoir.next = (gap < limit) ? reservoir.seen + static_cast<std::uint64_t>(gap)
+    : std::numeric_limits<std::uint64_t>::max();
+}
+
+/**
+ * @brief 0より大きく1未満の一様乱数を返します。
+ * @return 乱数
+ */
+double Sampler::uniform(void)
+{
+  return (static_cast<double>(random() >> 11) + 0.5) * (1.0 / 9007199254740992.0);
+}
+
+/**
+ * @brief 抽出したCSVレコードを、層ごとに入力での順序に並べて返します。
+ * @param entries 抽出したCSVレコード
+ */
+void Sampler::getRecords(std::vector<const Entry*>& entries) const
+{
+  entries.clear();
+  for (std::size_t i = 0; i < reservoirs.size(); i++) {
+    const std::size_t begin = entries.size();
+    for (std::size_t j = 0; j < reservoirs[i].entries.size(); j++) {
+      entries.push_back(&reservoirs[i].entries[j]);
+    }
+    std::sort(entries.begin() + begin, entries.end(), PositionLess());
+  }
+}
+
+} // namespace csv
+} // namespace csl
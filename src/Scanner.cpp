@@ -0,0 +1,94 @@
+/**
+ * @file  Scanner.cpp
+ * @brief Scannerクラス実装ファイル
+ */
+#include "csl/csv/Scanner.hpp"
+
+namespace csl {
+namespace csv {
+
+const std::size_t Scanner::npos;
+
+/**
+ * @brief デフォルトのConfigオブジェクトを設定したScannerオブジェクトを構築します。
+ */
+Scanner::Scanner(void)
+  : automaton(DEFAULT_CONFIG)
+{
+}
+
+/**
+ * @brief 指定されたConfigオブジェクトを設定したScannerオブジェクトを構築します。
+ * @param config Configオブジェクト
+ */
+Scanner::Scanner(const Config& config)
+  : automaton(config)
+{
+}
+
+/**
+ * @brief Scannerオブジェクトを破棄します。
+ */
+Scanner::~Scanner(void)
+{
+}
+
+/**
+ * @brief 指定された位置から始まるCSVレコードの終端を返します。
+ *
+ * 囲み文字の外にある改行コード(CRLF)の直後を終端とします。
+ * 先頭がコメント文字の場合は、Readerクラスと同様にコメント行とそれに続くレコードをまとめて1つの範囲とします。
+ * @param data  CSVデータ
+ * @param begin 走査を開始する位置
+ * @param end   走査を終了する位置
+ * @return CSVレコードの終端の位置、終端が見つからない場合はScanner::npos
+ */
+std::size_t Scanner::scan(const char* data, std::size_t begin, std::size_t end) const
+{
+  bool quoteFlag;
+  return scan(data, begin, end, quoteFlag);
+}
+
+/**
+ * @brief 指定された位置から始まるCSVレコードの終端と、走査を終えた時点で囲み文字の中にいるかどうかを返します。
+ * @param data      CSVデータ
+ * @param begin     走査を開始する位置
+ * @param end       走査を終了する位置
+ * @param quoteFlag 走査を終えた時点で囲み文字の中にいるかどうか
+ * @return CSVレコードの終端の位置、終端が見つからない場合はScanner::npos
+ */
+std::size_t Scanner::scan(const char* data, std::size_t begin, std::size_t end, bool& quoteFlag) const
+{
+  std::size_t i = begin;
+  quoteFlag = false;
+
+  if (i < end && automaton.isCommentMark(data[i])) {
+    bool carriageReturnFlag = false;
+    for (; i < end; i++) {
+      if (carriageReturnFlag && data[i] == '\n') {
+	break;
+      }
+      carriageReturnFlag = (data[i] == '\r');
+    }
+    if (i == end) {
+      return npos;
+    }
+    i++;
+  }
+
+  unsigned char state = Automaton::STATE_NORMAL;
+
+  for (; i < end; i++) {
+    const Automaton::Transition transition = automaton.step(state, data[i]);
+    if ((transition.actions & Automaton::ACTION_END_RECORD) != 0) {
+      return i + 1;
+    }
+    state = transition.state;
+  }
+
+  quoteFlag = (state == Automaton::STATE_QUOTE);
+  return npos;
+}
+
+} // namespace csv
+} // namespace csl
@@ -0,0 +1,355 @@
+/**
+ * @file  SharedTable.cpp
+ * @brief SharedTableクラス実装ファイル
+ */
+#include "csl/csv/SharedTable.hpp"
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <ios>
+#include <stdexcept>
+#include <streambuf>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "csl/csv/Util.hpp"
+
+namespace csl {
+namespace csv {
+
+namespace {
+
+/**
+ * @brief 制御用セグメントの先頭に置く識別子です。
+ */
+const char CONTROL_MAGIC[8] = {'C', 'S', 'L', 'C', 'S', 'V', 'S', '\0'};
+
+/**
+ * @brief 制御用セグメントです。
+ *
+ * ロックを使わないアトミック変数は、プロセス間で共有したメモリ上でもそのまま使えます。
+ */
+struct SharedControl
+{
+  char magic[8];                       ///< 識別子
+  std::atomic<std::uint64_t> current;  ///< 現在の世代(0の場合は未公開)
+  std::atomic<std::uint64_t> next;     ///< 最後に割り当てた世代
+};
+
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2, "shared generations need lock-free 64-bit atomics");
+
+/**
+ * @brief マップしたメモリに書き込む出力ストリームバッファです。溢れた場合は書き込みに失敗します。
+ */
+class MemoryOutputBuffer : public std::streambuf
+{
+public:
+  MemoryOutputBuffer(char* data, const std::size_t size)
+  {
+    setp(data, data + size);
+  }
+};
+
+/**
+ * @brief 指定された名前を確かめます。
+ * @param name 名前
+ * @exception std::invalid_argument 共有メモリの名前として使えない場合
+ */
+void checkName(const std::string& name)
+{
+  if (name.size() < 2 || name[0] != '/' || name.find('/', 1) != std::string::npos) {
+    throw std::invalid_argument("Invalid name.");
+  }
+}
+
+/**
+ * @brief 指定された世代のデータ用セグメントの名前を返します。
+ * @param name 名前
+ * @param generation 世代
+ * @return セグメントの名前
+ */
+std::string getSegmentName(const std::string& name, const std::uint64_t generation)
+{
+  return name + "." + std::to_string(generation);
+}
+
+/**
+ * @brief 制御用セグメントをマップします。
+ * @param name 名前
+ * @param writable 書き込む場合はtrue(存在しなければ作成します)
+ * @return マップした制御用セグメント、書き込まない場合に存在しなければNULL
+ * @exception std::ios_base::failure マップできない場合
+ */
+SharedControl* mapControl(const std::string& name, const bool writable)
+{
+  const int fd = writable ? shm_open(name.c_str(), O_RDWR | O_CREAT, 0644) : shm_open(name.c_str(), O_RDONLY, 0);
+  if (fd < 0) {
+    if (!writable && errno == ENOENT) {
+      return NULL;
+    }
+    throw std::ios_base::failure("Failed to open shared memory: " + name);
+  }
+
+  // a fresh segment is zero-filled, which is an unpublished control
+  struct stat st;
+  bool valid = fstat(fd, &st) == 0;
+  if (valid && writable && st.st_size == 0) {
+    valid = ftruncate(fd, sizeof(SharedControl)) == 0;
+    st.st_size = sizeof(SharedControl);
+  }
+  valid = valid && static_cast<std::size_t>(st.st_size) >= sizeof(SharedControl);
+
+  void* address = valid ? mmap(NULL, sizeof(SharedControl), writable ? PROT_READ | PROT_WRITE : PROT_READ,
+			       MAP_SHARED, fd, 0) : MAP_FAILED;
+  close(fd);
+
+  if (address == MAP_FAILED) {
+    throw std::ios_base::failure("Failed to open shared memory: " + name);
+  }
+
+  SharedControl* control = static_cast<SharedControl*>(address);
+  if (writable && control->magic[0] == '\0') {
+    std::memcpy(control->magic, CONTROL_MAGIC, sizeof(control->magic));
+  }
+  if (control->magic[0] != '\0' && std::memcmp(control->magic, CONTROL_MAGIC, sizeof(control->magic)) != 0) {
+    munmap(address, sizeof(SharedControl));
+    throw std::ios_base::failure("Invalid shared memory: " + name);
+  }
+  return control;
+}
+
+} // namespace
+
+/**
+ * @brief 指定された名前で公開されている現在の世代のCSVデータをマップして、SharedTableオブジェクトを構築します。
+ *
+ * データを解釈しないため、CSVデータの大きさによらず短い時間で構築できます。
+ * @param name 名前
+ * @exception std::invalid_argument 名前が正しくない場合
+ * @exception std::ios_base::failure 公開されていない、またはマップできない場合
+ */
+SharedTable::SharedTable(const std::string& name)
+  : control(NULL), generation(0)
+{
+  checkName(name);
+
+  SharedControl* shared = mapControl(name, false);
+  if (shared == NULL) {
+    throw std::ios_base::failure("Failed to open shared memory for reading: " + name);
+  }
+  control = shared;
+
+  try {
+    // the publisher may unlink the segment we are about to open, so retry
+    for (int i = 0; i < SHARED_ATTACH_RETRIES; i++) {
+      const std::uint64_t current = shared->current.load(std::memory_order_acquire);
+      if (current == 0) {
+	break;
+      }
+
+      const std::string segment = getSegmentName(name, current);
+      const int fd = shm_open(segment.c_str(), O_RDONLY, 0);
+      if (fd < 0) {
+	if (errno == ENOENT) {
+	  continue;
+	}
+	throw std::ios_base::failure("Failed to open shared memory for reading: " + segment);
+      }
+
+      try {
+	map(fd, segment);
+      } catch (...) {
+	::close(fd);
+	throw;
+      }
+      ::close(fd);
+
+      generation = current;
+      return;
+    }
+    throw std::ios_base::failure("No table is published: " + name);
+  } catch (...) {
+    munmap(control, sizeof(SharedControl));
+    throw;
+  }
+}
+
+/**
+ * @brief SharedTableオブジェクトを破棄します。
+ */
+SharedTable::~SharedTable(void)
+{
+  munmap(control, sizeof(SharedControl));
+}
+
+/**
+ * @brief マップしている世代を返します。
+ * @return 世代
+ */
+std::uint64_t SharedTable::getGeneration(void) const
+{
+  return generation;
+}
+
+/**
+ * @brief マップしている世代が現在公開されている世代かどうかを返します。
+ * @return 現在の世代の場合はtrue
+ */
+bool SharedTable::isLatest(void) const
+{
+  return static_cast<const SharedControl*>(control)->current.load(std::memory_order_acquire) == generation;
+}
+
+/**
+ * @brief デフォルトのConfigオブジェクトの設定で読み込んだCSVデータを、指定された名前で新しい世代として公開します。
+ * @param name 名前
+ * @param csv CSVデータ
+ * @return 公開した世代
+ * @exception std::invalid_argument 名前が正しくない場合
+ * @exception std::ios_base::failure 共有メモリに書き込めない場合
+ */
+std::uint64_t SharedTable::publish(const std::string& name,
+				   const std::vector<std::vector<std::string> >& csv)
+{
+  return publish(name, DEFAULT_CONFIG, csv);
+}
+
+/**
+ * @brief 指定されたConfigオブジェクトの設定で読み込んだCSVデータを、指定された名前で新しい世代として公開します。
+ *
+ * 新しい世代のセグメントに書き込み終えてから現在の世代を切り替え、前の世代のセグメントの名前を削除します。
+ * 前の世代をマップしているプロセスは、破棄するまでそのまま参照できます。
+ * 後から割り当てられた世代が先に公開された場合は、現在の世代を戻さずに自分のセグメントを削除します。
+ * @param name 名前
+ * @param config Configオブジェクト
+ * @param csv CSVデータ
+ * @return 公開した世代(後の世代が先に公開されていた場合はその世代)
+ * @exception std::invalid_argument 名前が正しくない場合
+ * @exception std::ios_base::failure 共有メモリに書き込めない場合
+ */
+std::uint64_t SharedTable::publish(const std::string& name,
+				   const Config& config,
+				   const std::vector<std::vector<std::string> >& csv)
+{
+  checkName(name);
+
+  SharedControl* shared = mapControl(name, true);
+  const std::uint64_t current = shared->next.fetch_add(1, std::memory_order_relaxed) + 1;
+  const std::string segment = getSegmentName(name, current);
+
+  const int fd = shm_open(segment.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+  if (fd < 0) {
+    munmap(shared, sizeof(SharedControl));
+    throw std::ios_base::failure("Failed to open shared memory for writing: " + segment);
+  }
+
+  // reserve the pages up front, a full /dev/shm would otherwise raise SIGBUS while writing
+  const std::size_t size = static_cast<std::size_t>(measure(csv));
+  void* address = posix_fallocate(fd, 0, static_cast<off_t>(size)) == 0
+    ? mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) : MAP_FAILED;
+  ::close(fd);
+
+  try {
+    if (address == MAP_FAILED) {
+      throw std::ios_base::failure("Failed to write: " + segment);
+    }
+
+    MemoryOutputBuffer buffer(static_cast<char*>(address), size);
+    std::ostream stream(&buffer);
+    try {
+      write(stream, "", config, csv);
+    } catch (...) {
+      munmap(address, size);
+      throw;
+    }
+    munmap(address, size);
+  } catch (...) {
+    shm_unlink(segment.c_str());
+    munmap(shared, sizeof(SharedControl));
+    throw;
+  }
+
+  // only move forward, a publisher that allocated a later generation may have finished first
+  std::uint64_t previous = shared->current.load(std::memory_order_acquire);
+  while (previous < current
+	 && !shared->current.compare_exchange_weak(previous, current, std::memory_order_acq_rel,
+						   std::memory_order_acquire)) {
+  }
+
+  std::uint64_t published = current;
+  if (previous > current) {
+    shm_unlink(segment.c_str());
+    published = previous;
+  } else if (previous != 0) {
+    shm_unlink(getSegmentName(name, previous).c_str());
+  }
+
+  munmap(shared, sizeof(SharedControl));
+  return published;
+}
+
+/**
+ * @brief デフォルトのConfigオブジェクトの設定で指定されたファイルを読み込んで、指定された名前で新しい世代として公開します。
+ * @param name 名前
+ * @param filepath ファイルパス
+ * @return 公開した世代
+ * @exception std::invalid_argument 名前が正しくない場合
+ * @exception std::ios_base::failure ファイルの読み込み、または共有メモリへの書き込みにエラーが発生した場合
+ */
+std::uint64_t SharedTable::publish(const std::string& name,
+				   const std::string& filepath)
+{
+  return publish(name, filepath, DEFAULT_CONFIG);
+}
+
+/**
+ * @brief 指定されたConfigオブジェクトの設定で指定されたファイルを読み込んで、指定された名前で新しい世代として公開します。
+ * @param name 名前
+ * @param filepath ファイルパス
+ * @param config Configオブジェクト
+ * @return 公開した世代
+ * @exception std::invalid_argument 名前が正しくない場合
+ * @exception std::ios_base::failure ファイルの読み込み、または共有メモリへの書き込みにエラーが発生した場合
+ */
+std::uint64_t SharedTable::publish(const std::string& name,
+				   const std::string& filepath,
+				   const Config& config)
+{
+  checkName(name);
+
+  std::vector<std::vector<std::string> > csv;
+  Util::load(filepath, config, csv);
+  return publish(name, config, csv);
+}
+
+/**
+ * @brief 指定された名前の公開をやめて、共有メモリセグメントの名前を削除します。
+ *
+ * マップしているプロセスは、破棄するまでそのまま参照できます。
+ * @param name 名前
+ * @exception std::invalid_argument 名前が正しくない場合
+ */
+void SharedTable::unlink(const std::string& name)
+{
+  checkName(name);
+
+  SharedControl* shared = NULL;
+  try {
+    shared = mapControl(name, false);
+  } catch (const std::ios_base::failure&) {
+    // remove the name below even if the control is unreadable
+  }
+
+  if (shared != NULL) {
+    const std::uint64_t current = shared->current.load(std::memory_order_acquire);
+    if (current != 0) {
+      shm_unlink(getSegmentName(name, current).c_str());
+    }
+    munmap(shared, sizeof(SharedControl));
+  }
+  shm_unlink(name.c_str());
+}
+
+} // namespace csv
+} // namespace csl
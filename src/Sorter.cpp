@@ -0,0 +1,651 @@
+/**
+ * @file  Sorter.cpp
+ * @brief Sorterクラス実装ファイル
+ */
+#include "csl/csv/Sorter.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <ios>
+#include <stdexcept>
+#include <sys/stat.h>
+#include "csl/csv/LoserTree.hpp"
+#include "csl/csv/Reader.hpp"
+#include "csl/csv/TempFiles.hpp"
+#include "csl/csv/Writer.hpp"
+
+namespace csl {
+namespace csv {
+
+namespace {
+
+/**
+ * @brief ランを分けて並列に並べ替えるCSVレコードの数の下限です。
+ */
+const std::size_t PARALLEL_MINIMUM = 4096;
+
+/**
+ * @brief キーの列がない場合に比較する値です。
+ */
+const std::string EMPTY_VALUE;
+
+/**
+ * @brief 併合する一時ファイルの1つです。
+ */
+struct Source
+{
+  std::vector<char> buffer;          ///< 入力ストリームのバッファ
+  std::ifstream stream;              ///< 入力ストリーム
+  std::vector<std::string> record;   ///< 先頭のCSVレコード
+  std::uint64_t sequence;            ///< 先頭のCSVレコードの入力での番号
+  bool done;                         ///< 読み終えた場合はtrue
+};
+
+/**
+ * @brief 文字列の先頭8バイトを、バイト列の順序を保つ整数にして返します。
+ * @param value 文字列
+ * @return 整数
+ */
+std::uint64_t getStringPrefix(const std::string& value)
+{
+  std::uint64_t prefix = 0;
+
+  for (std::size_t i = 0; i < 8; i++) {
+    prefix <<= 8;
+    if (i < value.size()) {
+      prefix |= static_cast<unsigned char>(value[i]);
+    }
+  }
+
+  return prefix;
+}
+
+/**
+ * @brief 数値を、大小の順序を保つ整数にして返します。
+ * @param number 数値
+ * @return 整数
+ */
+std::uint64_t getNumberPrefix(const double number)
+{
+  std::uint64_t bits;
+  std::memcpy(&bits, &number, sizeof(bits));
+
+  const std::uint64_t sign = static_cast<std::uint64_t>(1) << 63;
+  return (bits & sign) ? ~bits : (bits | sign);
+}
+
+/**
+ * @brief 一時ファイルに1つのCSVレコードを、入力での番号を前に置いて書き込みます。
+ * @param stream 出力ストリーム
+ * @param record CSVレコード
+ * @param sequence CSVレコードの入力での番号
+ */
+void writeRun(std::ostream& stream,
+	      const std::vector<std::string>& record,
+	      const std::uint64_t sequence)
+{
+  stream.write(reinterpret_cast<const char*>(&sequence), sizeof(sequence));
+  TempFiles::write(stream, record);
+}
+
+/**
+ * @brief 一時ファイルから1つのCSVレコードと入力での番号を読み込みます。
+ * @param stream 入力ストリーム
+ * @param record CSVレコード
+ * @param sequence CSVレコードの入力での番号
+ * @return 読み込んだ場合はtrue、終わりに達した場合はfalse
+ * @exception std::ios_base::failure 一時ファイルが途中で終わっている場合
+ */
+bool readRun(std::istream& stream,
+	     std::vector<std::string>& record,
+	     std::uint64_t& sequence)
+{
+  stream.read(reinterpret_cast<char*>(&sequence), sizeof(sequence));
+  if (stream.gcount() == 0 && stream.eof()) {
+    return false;
+  }
+
+  if (stream.fail() || !TempFiles::read(stream, record)) {
+    throw std::ios_base::failure("Failed to read.");
+  }
+
+  return true;
+}
+
+/**
+ * @brief 併合する一時ファイルの次のCSVレコードに進みます。
+ * @param source 一時ファイル
+ */
+void advance(Source& source)
+{
+  source.done = !readRun(source.stream, source.record, source.sequence);
+}
+
+} // namespace
+
+constexpr Sorter::Collation Sorter::COLLATION_STRING;
+constexpr Sorter::Collation Sorter::COLLATION_NUMERIC;
+
+/**
+ * @brief キーのないSorterオブジェクトを構築します。
+ *
+ * メモリの上限はSORT_MEMORY_LIMIT、一時ファイルのディレクトリは環境変数TMPDIR(ない場合は/tmp)、スレッド数は1です。
+ */
+Sorter::Sorter(void)
+  : memoryLimit(SORT_MEMORY_LIMIT)
+  , tempDirectory("/tmp")
+  , threadCount(1)
+  , runCount(0)
+{
+  const char* directory = std::getenv("TMPDIR");
+  if (directory != NULL && *directory != '\0') {
+    tempDirectory = directory;
+  }
+}
+
+/**
+ * @brief Sorterオブジェクトを破棄します。
+ */
+Sorter::~Sorter(void)
+{
+}
+
+/**
+ * @brief キーを追加します。
+ *
+ * 追加した順に比較し、先のキーが等しい場合に次のキーを比較します。
+ * @param column 列の番号
+ * @param collation 比較方法
+ */
+void Sorter::addKey(const std::size_t column, const Collation collation)
+{
+  comparator.addKey(column, collation);
+}
+
+/**
+ * @brief すべてのキーを削除します。
+ */
+void Sorter::clearKeys(void)
+{
+  comparator.clearKeys();
+}
+
+/**
+ * @brief 1つのランに読み込むCSVレコードのメモリの上限を設定します。
+ *
+ * CSVレコードのメモリ使用量は推定値です。
+ * @param memoryLimit バイト数
+ */
+void Sorter::setMemoryLimit(const std::size_t memoryLimit)
+{
+  this->memoryLimit = memoryLimit;
+}
+
+/**
+ * @brief 1つのランに読み込むCSVレコードのメモリの上限を返します。
+ * @return バイト数
+ */
+std::size_t Sorter::getMemoryLimit(void) const
+{
+  return memoryLimit;
+}
+
+/**
+ * @brief 一時ファイルを作るディレクトリを設定します。
+ * @param tempDirectory ディレクトリのパス
+ */
+void Sorter::setTempDirectory(const std::string& tempDirectory)
+{
+  this->tempDirectory = tempDirectory;
+}
+
+/**
+ * @brief 一時ファイルを作るディレクトリを返します。
+ * @return ディレクトリのパス
+ */
+const std::string& Sorter::getTempDirectory(void) const
+{
+  return tempDirectory;
+}
+
+/**
+ * @brief ランを並べ替えるスレッド数を設定します。
+ * @param threadCount スレッド数(0の場合は1)
+ */
+void Sorter::setThreadCount(const std::size_t threadCount)
+{
+  this->threadCount = (threadCount > 0) ? threadCount : 1;
+}
+
+/**
+ * @brief ランを並べ替えるスレッド数を返します。
+ * @return スレッド数
+ */
+std::size_t Sorter::getThreadCount(void) const
+{
+  return threadCount;
+}
+
+/**
+ * @brief 直前の並べ替えで一時ファイルに書き出したランの数を返します。
+ *
+ * 入力がメモリの上限に収まった場合は0です。
+ * @return ランの数
+ */
+std::size_t Sorter::getRunCount(void) const
+{
+  return runCount;
+}
+
+/**
+ * @brief デフォルトのConfigオブジェクトの設定に従って、入力ストリームのCSVデータを並べ替えて出力ストリームに書き込みます。
+ * @param in 入力ストリーム
+ * @param out 出力ストリーム
+ * @exception std::invalid_argument キーがない場合
+ * @exception std::ios_base::failure 入出力ストリームまたは一時ファイルにエラーが発生した場合
+ */
+void Sorter::sort(std::istream& in, std::ostream& out)
+{
+  sort(in, DEFAULT_CONFIG, out);
+}
+
+/**
+ * @brief 指定されたConfigオブジェクトの設定に従って、入力ストリームのCSVデータを並べ替えて出力ストリームに書き込みます。
+ * @param in 入力ストリーム
+ * @param config Configオブジェクト
+ * @param out 出力ストリーム
+ * @exception std::invalid_argument キーがない場合
+ * @exception std::ios_base::failure 入出力ストリームまたは一時ファイルにエラーが発生した場合
+ */
+void Sorter::sort(std::istream& in, const Config& config, std::ostream& out)
+{
+  if (comparator.getKeyCount() == 0) {
+    throw std::invalid_argument("No keys.");
+  }
+
+  ThreadPool pool(threadCount);
+  Reader reader(in, config);
+  TempFiles runs(tempDirectory);
+  std::vector<std::vector<std::string> > records;
+  std::vector<Entry> entries;
+  std::uint64_t sequence = 0;
+  std::size_t bytes = 0;
+
+  runCount = 0;
+  while (reader.hasNext()) {
+    records.emplace_back();
+    reader.read(records.back());
+    bytes += TempFiles::getRecordBytes(records.back()) + sizeof(Entry);
+
+    if (bytes >= memoryLimit) {
+      sortRun(records, entries, pool);
+      spill(records, entries, sequence, runs);
+      sequence += records.size();
+      records.clear();
+      bytes = 0;
+    }
+  }
+
+  sortRun(records, entries, pool);
+
+  if (runs.getPaths().empty()) {
+    Writer writer(out, config);
+    for (std::size_t i = 0; i < entries.size(); i++) {
+      writer.write(records[static_cast<std::size_t>(entries[i].index)]);
+    }
+    return;
+  }
+
+  if (!records.empty()) {
+    spill(records, entries, sequence, runs);
+  }
+  records.clear();
+  entries.clear();
+
+  while (runs.getPaths().size() > SORT_MERGE_WAYS) {
+    // merge the oldest runs into a new one until a single pass is enough
+    const std::vector<std::string> group(runs.getPaths().begin(), runs.getPaths().begin() + SORT_MERGE_WAYS);
+    const std::string path = runs.create();
+    std::vector<char> buffer(TEMP_BUFFER_SIZE);
+    std::ofstream stream;
+    stream.rdbuf()->pubsetbuf(&buffer[0], buffer.size());
+    stream.open(path.c_str(), std::ofstream::binary | std::ofstream::trunc);
+
+    if (!stream.is_open()) {
+      throw std::ios_base::failure("Failed to open file for writing: " + path);
+    }
+
+    merge(group, config, stream, false);
+    stream.close();
+
+    if (stream.fail()) {
+      throw std::ios_base::failure("Failed to write: " + path);
+    }
+
+    for (std::size_t i = 0; i < group.size(); i++) {
+      runs.remove(group[i]);
+    }
+  }
+
+  merge(runs.getPaths(), config, out, true);
+}
+
+/**
+ * @brief デフォルトのConfigオブジェクトの設定に従って、入力ファイルのCSVデータを並べ替えて出力ファイルに書き込みます。
+ * @param inpath 入力ファイルのパス
+ * @param outpath 出力ファイルのパス
+ * @exception std::invalid_argument キーがない場合
+ * @exception std::ios_base::failure 入出力ファイルまたは一時ファイルにエラーが発生した場合
+ */
+void Sorter::sort(const std::string& inpath, const std::string& outpath)
+{
+  sort(inpath, DEFAULT_CONFIG, outpath);
+}
+
+/**
+ * @brief 指定されたConfigオブジェクトの設定に従って、入力ファイルのCSVデータを並べ替えて出力ファイルに書き込みます。
+ * @param inpath 入力ファイルのパス
+ * @param config Configオブジェクト
+ * @param outpath 出力ファイルのパス
+ * @exception std::invalid_argument キーがない場合
+ * @exception std::ios_base::failure 入出力ファイルまたは一時ファイルにエラーが発生した場合
+ */
+void Sorter::sort(const std::string& inpath, const Config& config, const std::string& outpath)
+{
+  struct stat st;
+  if (stat(inpath.c_str(), &st) != 0 || !S_ISREG(st.st_mode)) {
+    throw std::ios_base::failure("Failed to open file for reading: " + inpath);
+  }
+
+  std::ifstream in(inpath.c_str(), std::ifstream::binary);
+
+  if (!in.is_open()) {
+    throw std::ios_base::failure("Failed to open file for reading: " + inpath);
+  }
+
+  std::ofstream out(outpath.c_str(), std::ofstream::binary);
+
+  if (!out.is_open()) {
+    in.close();
+    throw std::ios_base::failure("Failed to open file for writing: " + outpath);
+  }
+
+  try {
+    sort(in, config, out);
+  } catch (...) {
+    in.close();
+    out.close();
+    throw;
+  }
+
+  in.close();
+  out.close();
+}
+
+/**
+ * @brief 2つのCSVレコードのキーを比較します。
+ *
+ * 並べ替えた出力では、比較結果が負になるCSVレコードが先に並びます。
+ * @param a CSVレコード
+ * @param b CSVレコード
+ * @return aが先の場合は負、bが先の場合は正、キーが等しい場合は0
+ */
+int Sorter::compare(const std::vector<std::string>& a, const std::vector<std::string>& b) const
+{
+  return comparator.compare(a, b);
+}
+
+/**
+ * @brief CSVレコードの先頭のキーを、順序を保つ整数にして返します。
+ *
+ * 整数が異なればキーの順序は整数の順序と同じです。整数が等しい場合はcompareで比較します。
+ * 数値として比較するキーでは、数値を上位半分に、数値でないものを下位半分に置きます。
+ * @param record CSVレコード
+ * @return 整数
+ */
+std::uint64_t Sorter::getPrefix(const std::vector<std::string>& record) const
+{
+  const std::size_t column = comparator.getColumn(0);
+  const std::string& value = (column < record.size()) ? record[column] : EMPTY_VALUE;
+
+  if (comparator.getCollation(0) == COLLATION_NUMERIC) {
+    double number;
+    if (KeyComparator::parseNumber(value, number)) {
+      return getNumberPrefix(number) >> 1;
+    }
+    return (static_cast<std::uint64_t>(1) << 63) | (getStringPrefix(value) >> 1);
+  }
+
+  return getStringPrefix(value);
+}
+
+/**
+ * @brief 1つのランのCSVレコードを並べ替えます。
+ *
+ * スレッドが複数ある場合は、ランを分けて並列に並べ替えてから、隣り合う部分を並列に併合します。
+ * @param records CSVレコード
+ * @param entries 並べ替えた順のCSVレコードの番号
+ * @param pool ThreadPoolオブジェクト
+ */
+void Sorter::sortRun(const std::vector<std::vector<std::string> >& records,
+		     std::vector<Entry>& entries,
+		     ThreadPool& pool) const
+{
+  const std::size_t size = records.size();
+  const std::size_t chunks = (size >= PARALLEL_MINIMUM) ? pool.getSize() : 1;
+  const std::size_t chunk = (size + chunks - 1) / chunks;
+
+  entries.resize(size);
+  for (std::size_t i = 0; i < size; i++) {
+    entries[i].index = i;
+  }
+
+  if (chunks == 1) {
+    sortRange(records, entries.data(), entries.data() + size);
+    return;
+  }
+
+  for (std::size_t begin = 0; begin < size; begin += chunk) {
+    Entry* first = entries.data() + begin;
+    Entry* last = entries.data() + std::min(begin + chunk, size);
+    pool.submit([this, &records, first, last]() {
+	sortRange(records, first, last);
+      });
+  }
+  pool.wait();
+
+  const auto less = [this, &records](const Entry& a, const Entry& b) {
+    if (a.prefix != b.prefix) {
+      return a.prefix < b.prefix;
+    }
+    const int result = compare(records[static_cast<std::size_t>(a.index)],
+			       records[static_cast<std::size_t>(b.index)]);
+    return (result != 0) ? (result < 0) : (a.index < b.index);
+  };
+
+  for (std::size_t width = chunk; width < size; width *= 2) {
+    for (std::size_t begin = 0; begin + width < size; begin += width * 2) {
+      Entry* first = entries.data() + begin;
+      Entry* middle = first + width;
+      Entry* last = entries.data() + std::min(begin + width * 2, size);
+      pool.submit([first, middle, last, less]() {
+	  std::inplace_merge(first, middle, last, less);
+	});
+    }
+    pool.wait();
+  }
+}
+
+/**
+ * @brief ランの一部のCSVレコードを並べ替えます。
+ *
+ * 各CSVレコードの番号は設定済みです。先頭のキーから作った整数で基数ソートしてから、整数が等しい部分だけをcompareで並べ替えます。
+ * キーが等しいCSVレコードは番号の順にします。
+ * @param records CSVレコード
+ * @param first 並べ替える範囲の先頭
+ * @param last 並べ替える範囲の終わり
+ */
+void Sorter::sortRange(const std::vector<std::vector<std::string> >& records,
+		       Entry* first,
+		       Entry* last) const
+{
+  const std::size_t size = last - first;
+  std::vector<std::size_t> counts(8 * 256, 0);
+
+  for (std::size_t i = 0; i < size; i++) {
+    first[i].prefix = getPrefix(records[static_cast<std::size_t>(first[i].index)]);
+    for (std::size_t pass = 0; pass < 8; pass++) {
+      counts[pass * 256 + ((first[i].prefix >> (pass * 8)) & 0xff)]++;
+    }
+  }
+
+  // least significant byte first, which keeps equal prefixes in index order
+  std::vector<Entry> buffer(size);
+  Entry* source = first;
+  Entry* target = buffer.data();
+
+  for (std::size_t pass = 0; pass < 8 && size > 0; pass++) {
+    std::size_t* count = &counts[pass * 256];
+    if (count[(source[0].prefix >> (pass * 8)) & 0xff] == size) {
+      continue;
+    }
+
+    std::size_t offset = 0;
+    for (std::size_t i = 0; i < 256; i++) {
+      const std::size_t n = count[i];
+      count[i] = offset;
+      offset += n;
+    }
+    for (std::size_t i = 0; i < size; i++) {
+      target[count[(source[i].prefix >> (pass * 8)) & 0xff]++] = source[i];
+    }
+    std::swap(source, target);
+  }
+
+  if (source != first) {
+    std::copy(source, source + size, first);
+  }
+
+  const auto less = [this, &records](const Entry& a, const Entry& b) {
+    const int result = compare(records[static_cast<std::size_t>(a.index)],
+			       records[static_cast<std::size_t>(b.index)]);
+    return (result != 0) ? (result < 0) : (a.index < b.index);
+  };
+
+  for (Entry* begin = first; begin != last; ) {
+    Entry* end = begin + 1;
+    while (end != last && end->prefix == begin->prefix) {
+      end++;
+    }
+    if (end - begin > 1) {
+      std::sort(begin, end, less);
+    }
+    begin = end;
+  }
+}
+
+/**
+ * @brief 並べ替えたランを一時ファイルに書き出します。
+ * @param records CSVレコード
+ * @param entries 並べ替えた順のCSVレコードの番号
+ * @param sequence ランの先頭のCSVレコードの入力での番号
+ * @param runs 一時ファイルの集まり
+ * @exception std::ios_base::failure 一時ファイルにエラーが発生した場合
+ */
+void Sorter::spill(const std::vector<std::vector<std::string> >& records,
+		   const std::vector<Entry>& entries,
+		   const std::uint64_t sequence,
+		   TempFiles& runs)
+{
+  const std::string path = runs.create();
+  std::vector<char> buffer(TEMP_BUFFER_SIZE);
+  std::ofstream stream;
+  stream.rdbuf()->pubsetbuf(&buffer[0], buffer.size());
+  stream.open(path.c_str(), std::ofstream::binary | std::ofstream::trunc);
+
+  if (!stream.is_open()) {
+    throw std::ios_base::failure("Failed to open file for writing: " + path);
+  }
+
+  for (std::size_t i = 0; i < entries.size(); i++) {
+    writeRun(stream, records[static_cast<std::size_t>(entries[i].index)], sequence + entries[i].index);
+  }
+  stream.close();
+
+  if (stream.fail()) {
+    throw std::ios_base::failure("Failed to write: " + path);
+  }
+
+  runCount++;
+}
+
+/**
+ * @brief 一時ファイルのランを敗者木で併合して書き込みます。
+ * @param runs 一時ファイルのパス
+ * @param config Configオブジェクト
+ * @param out 出力ストリーム
+ * @param final CSV形式で書き込む場合はtrue、一時ファイルの形式で書き込む場合はfalse
+ * @exception std::ios_base::failure 出力ストリームまたは一時ファイルにエラーが発生した場合
+ */
+void Sorter::merge(const std::vector<std::string>& runs,
+		   const Config& config,
+		   std::ostream& out,
+		   const bool final) const
+{
+  std::vector<Source*> sources;
+
+  try {
+    for (std::size_t i = 0; i < runs.size(); i++) {
+      sources.push_back(new Source());
+      Source& source = *sources.back();
+      source.buffer.resize(TEMP_BUFFER_SIZE);
+      source.stream.rdbuf()->pubsetbuf(&source.buffer[0], source.buffer.size());
+      source.stream.open(runs[i].c_str(), std::ifstream::binary);
+
+      if (!source.stream.is_open()) {
+	throw std::ios_base::failure("Failed to open file for reading: " + runs[i]);
+      }
+      advance(source);
+    }
+
+    const auto less = [this, &sources](const std::size_t a, const std::size_t b) {
+      const Source& x = *sources[a];
+      const Source& y = *sources[b];
+      if (x.done || y.done) {
+	return !x.done;
+      }
+      const int result = compare(x.record, y.record);
+      return (result != 0) ? (result < 0) : (x.sequence < y.sequence);
+    };
+
+    Writer writer(out, config);
+    LoserTree tree(sources.size());
+    tree.build(less);
+
+    while (!sources[tree.top()]->done) {
+      Source& source = *sources[tree.top()];
+      if (final) {
+	writer.write(source.record);
+      } else {
+	writeRun(out, source.record, source.sequence);
+      }
+      advance(source);
+      tree.replay(less);
+    }
+  } catch (...) {
+    for (std::size_t i = 0; i < sources.size(); i++) {
+      delete sources[i];
+    }
+    throw;
+  }
+
+  for (std::size_t i = 0; i < sources.size(); i++) {
+    delete sources[i];
+  }
+}
+
+} // namespace csv
+} // namespace csl
@@ -0,0 +1,418 @@
+/**
+ * @file  Splitter.cpp
+ * @brief Splitterクラス実装ファイル
+ */
+#include "csl/csv/Splitter.hpp"
+#include <cstring>
+#include <fstream>
+#include <sys/stat.h>
+#include "csl/csv/Automaton.hpp"
+#include "csl/csv/Scanner.hpp"
+
+namespace csl {
+namespace csv {
+
+namespace {
+
+/**
+ * @brief 入力ストリームのバイト数を返します。
+ * @param stream 入力ストリーム
+ * @return 入力ストリームのバイト数
+ * @exception std::ios_base::failure 入力ストリームをシークできなかった場合
+ */
+std::streamoff sizeOf(std::istream& stream)
+{
+  stream.clear();
+  stream.seekg(0, std::ios_base::end);
+  const std::streamoff size = stream.tellg();
+  if (stream.fail() || stream.bad() || size < 0) {
+    throw std::ios_base::failure("Failed to seek.");
+  }
+  return size;
+}
+
+/**
+ * @brief 入力ストリームの指定された範囲を読み込みます。
+ * @param stream 入力ストリーム
+ * @param begin  範囲の開始位置
+ * @param end    範囲の終了位置
+ * @param buffer 読み込んだデータを追加するバッファ
+ * @exception std::ios_base::failure 入力ストリームの読み込みに失敗した場合
+ */
+void readRange(std::istream& stream, std::streamoff begin, std::streamoff end, std::string& buffer)
+{
+  const std::size_t size = buffer.size();
+  buffer.resize(size + static_cast<std::size_t>(end - begin));
+  stream.clear();
+  stream.seekg(begin);
+  stream.read(&buffer[size], end - begin);
+  if (stream.gcount() != end - begin) {
+    throw std::ios_base::failure("Failed to read.");
+  }
+}
+
+/**
+ * @brief speculateの結果です。
+ */
+enum Speculation {
+  SPECULATION_FOUND,     ///< 矛盾がなく、境界が見つかった
+  SPECULATION_NOT_FOUND, ///< 矛盾はないが、境界が見つからなかった
+  SPECULATION_REJECTED,  ///< 矛盾が見つかった
+};
+
+/**
+ * @brief 走査を始める位置が囲み文字の中か外かを仮定して先読みし、その仮定が妥当かどうかを調べます。
+ *
+ * 閉じる囲み文字の後ろが区切り文字、囲み文字、CR以外の場合や、開く囲み文字の前が区切り文字、囲み文字、LF以外の場合は矛盾とみなします。
+ * Readerはこれらの規則を強制しない(フィールドの途中の囲み文字も受け付ける)ため、矛盾は正しい仮定でも起こり得ます。
+ * @param window      先読みしたデータ
+ * @param start       走査を始める位置
+ * @param lower       境界として認める最小の位置
+ * @param quoteFlag   走査を始める位置が囲み文字の中かどうか
+ * @param lineFlag    走査を始める位置が行頭かどうか
+ * @param commentFlag 走査を始める位置がコメント行の中かどうか
+ * @param endFlag     先読みしたデータが入力ストリームの末尾までかどうか(末尾までの場合は、末尾を境界とみなす)
+ * @param config      Configオブジェクト
+ * @param boundary    最初に見つかったCSVレコードの境界
+ * @return 結果
+ */
+Speculation speculate(const std::string& window, std::size_t start, std::size_t lower,
+	       bool quoteFlag, bool lineFlag, bool commentFlag, bool endFlag,
+	       const Config& config, std::size_t& boundary)
+{
+  const char delimitMark = config.getDelimitMark();
+  const bool quoteEnabled = config.getQuoteEnabled();
+  const char quoteMark = config.getQuoteMark();
+  const bool commentEnabled = config.getCommentEnabled();
+  const char commentMark = config.getCommentMark();
+  const std::size_t size = window.size();
+  bool carriageReturnFlag = false;
+
+  boundary = Scanner::npos;
+
+  for (std::size_t i = start; i < size; i++) {
+    const char c = window[i];
+
+    if (!quoteFlag && (commentFlag || (lineFlag && commentEnabled && c == commentMark))) {
+      // skip the comment line; the record after it belongs to the same read
+      for (; i < size; i++) {
+	if (carriageReturnFlag && window[i] == '\n') {
+	  break;
+	}
+	carriageReturnFlag = (window[i] == '\r');
+      }
+      carriageReturnFlag = false;
+      commentFlag = false;
+      lineFlag = false;
+      continue;
+    }
+    lineFlag = false;
+
+    if (quoteFlag) {
+      if (c == quoteMark) {
+	quoteFlag = false;
+	if (i + 1 < size && window[i + 1] != delimitMark && window[i + 1] != quoteMark && window[i + 1] != '\r') {
+	  return SPECULATION_REJECTED;
+	}
+      }
+    } else if (carriageReturnFlag && c == '\n') {
+      if (boundary == Scanner::npos && i + 1 >= lower) {
+	boundary = i + 1;
+      }
+      carriageReturnFlag = false;
+      lineFlag = true;
+    } else {
+      carriageReturnFlag = (c == '\r');
+      if (quoteEnabled && c == quoteMark) {
+	if (i > 0 && window[i - 1] != delimitMark && window[i - 1] != quoteMark && window[i - 1] != '\n') {
+	  return SPECULATION_REJECTED;
+	}
+	quoteFlag = true;
+      }
+    }
+  }
+
+  if (boundary == Scanner::npos && endFlag && size >= lower) {
+    boundary = size; // the last record ends at the end of the stream
+  }
+  return (boundary != Scanner::npos) ? SPECULATION_FOUND : SPECULATION_NOT_FOUND;
+}
+
+/**
+ * @brief 既知のCSVレコードの境界から順に走査して、指定された位置以降で最初の境界を返します。
+ * @param stream 入力ストリーム
+ * @param config Configオブジェクト
+ * @param origin 既知のCSVレコードの境界
+ * @param offset 位置
+ * @param size   入力ストリームのバイト数
+ * @return 指定された位置以降で最初のCSVレコードの境界
+ */
+std::streamoff scanExactly(std::istream& stream, const Config& config,
+			   std::streamoff origin, std::streamoff offset, std::streamoff size)
+{
+  Scanner scanner(config);
+  std::string buffer;
+  std::streamoff base = origin;
+  std::size_t position = 0;
+
+  for (;;) {
+    const std::size_t end = scanner.scan(buffer.data(), position, buffer.size());
+    if (end != Scanner::npos) {
+      if (base + static_cast<std::streamoff>(end) >= offset) {
+	return base + static_cast<std::streamoff>(end);
+      }
+      position = end;
+      continue;
+    }
+
+    const std::streamoff next = base + static_cast<std::streamoff>(buffer.size());
+    if (next >= size) {
+      return size;
+    }
+    buffer.erase(0, position);
+    base += static_cast<std::streamoff>(position);
+    position = 0;
+    readRange(stream, next, (size - next > SPLIT_LOOKAHEAD) ? next + SPLIT_LOOKAHEAD : size, buffer);
+  }
+}
+
+/**
+ * @brief 既知のCSVレコードの境界から囲み文字の数を数えて、指定された位置以降で最初の境界を返します。
+ *
+ * Readerはフィールドの途中の囲み文字でも囲みを開閉するため、コメント行が無効な場合は、囲み文字の中かどうかが既知の境界からの囲み文字の数の偶奇で決まります。
+ * 指定された位置の直前までは囲み文字を数えるだけで済むため、scanExactlyと同じ境界をより速く求められます。
+ * @param stream 入力ストリーム
+ * @param config Configオブジェクト(コメント行が無効で、囲み文字が有効であること)
+ * @param origin 既知のCSVレコードの境界
+ * @param offset 位置
+ * @param size   入力ストリームのバイト数
+ * @return 指定された位置以降で最初のCSVレコードの境界
+ */
+std::streamoff scanByParity(std::istream& stream, const Config& config,
+			    std::streamoff origin, std::streamoff offset, std::streamoff size)
+{
+  const char quoteMark = config.getQuoteMark();
+  // stop counting two bytes early so that a CRLF just before the offset is seen
+  const std::streamoff start = (offset - origin > 2) ? offset - 2 : origin;
+  std::string buffer;
+  bool quoteFlag = false;
+
+  for (std::streamoff base = origin; base < start; base += static_cast<std::streamoff>(buffer.size())) {
+    buffer.clear();
+    readRange(stream, base, (start - base > SPLIT_LOOKAHEAD) ? base + SPLIT_LOOKAHEAD : start, buffer);
+    const char* data = buffer.data();
+    const char* end = data + buffer.size();
+    while ((data = static_cast<const char*>(std::memchr(data, quoteMark, end - data))) != NULL) {
+      quoteFlag = !quoteFlag;
+      data++;
+    }
+  }
+
+  // the states outside quotes differ only in how a following LF ends a record, which cannot end before the offset
+  const Automaton automaton(config);
+  unsigned char state = quoteFlag ? Automaton::STATE_QUOTE : Automaton::STATE_NORMAL;
+
+  for (std::streamoff base = start; base < size; base += static_cast<std::streamoff>(buffer.size())) {
+    buffer.clear();
+    readRange(stream, base, (size - base > SPLIT_LOOKAHEAD) ? base + SPLIT_LOOKAHEAD : size, buffer);
+    for (std::size_t i = 0; i < buffer.size(); i++) {
+      const Automaton::Transition transition = automaton.step(state, buffer[i]);
+      if ((transition.actions & Automaton::ACTION_END_RECORD) != 0
+	  && base + static_cast<std::streamoff>(i + 1) >= offset) {
+	return base + static_cast<std::streamoff>(i + 1);
+      }
+      state = transition.state;
+    }
+  }
+  return size;
+}
+
+} // namespace
+
+/**
+ * @brief デフォルトのConfigオブジェクトの設定に従って、指定された入力ストリームをCSVレコードの境界で指定された数の範囲に分割します。
+ * @param stream 入力ストリーム
+ * @param count 範囲の数
+ * @param ranges 範囲
+ * @exception std::ios_base::failure 入力ストリームにエラーが発生した場合
+ */
+void Splitter::plan(std::istream& stream,
+		    const std::size_t count,
+		    std::vector<Range>& ranges)
+{
+  plan(stream, DEFAULT_CONFIG, count, ranges);
+}
+
+/**
+ * @brief 指定されたConfigオブジェクトの設定に従って、指定された入力ストリームをCSVレコードの境界で指定された数の範囲に分割します。
+ *
+ * 入力ストリームをバイト数で等分した位置ごとに、alignで直後のCSVレコードの境界に合わせます。
+ * データが少ない場合は空の範囲が含まれることがあります。
+ * @param stream 入力ストリーム
+ * @param config Configオブジェクト
+ * @param count 範囲の数
+ * @param ranges 範囲
+ * @exception std::ios_base::failure 入力ストリームにエラーが発生した場合
+ */
+void Splitter::plan(std::istream& stream,
+		    const Config& config,
+		    const std::size_t count,
+		    std::vector<Range>& ranges)
+{
+  ranges.clear();
+
+  const std::streamoff size = sizeOf(stream);
+  std::streamoff begin = 0;
+
+  for (std::size_t i = 1; i <= count; i++) {
+    std::streamoff end = size;
+    if (i < count) {
+      end = align(stream, config, begin, size / static_cast<std::streamoff>(count) * static_cast<std::streamoff>(i));
+    }
+    ranges.push_back(Range(begin, end));
+    begin = end;
+  }
+}
+
+/**
+ * @brief デフォルトのConfigオブジェクトの設定に従って、指定されたファイルをCSVレコードの境界で指定された数の範囲に分割します。
+ * @param filepath ファイルパス
+ * @param count 範囲の数
+ * @param ranges 範囲
+ * @exception std::ios_base::failure 入力ストリームにエラーが発生した場合
+ */
+void Splitter::plan(const std::string& filepath,
+		    const std::size_t count,
+		    std::vector<Range>& ranges)
+{
+  plan(filepath, DEFAULT_CONFIG, count, ranges);
+}
+
+/**
+ * @brief 指定されたConfigオブジェクトの設定に従って、指定されたファイルをCSVレコードの境界で指定された数の範囲に分割します。
+ * @param filepath ファイルパス
+ * @param config Configオブジェクト
+ * @param count 範囲の数
+ * @param ranges 範囲
+ * @exception std::ios_base::failure 入力ストリームにエラーが発生した場合
+ */
+void Splitter::plan(const std::string& filepath,
+		    const Config& config,
+		    const std::size_t count,
+		    std::vector<Range>& ranges)
+{
+  struct stat st;
+  if (stat(filepath.c_str(), &st) != 0 || !S_ISREG(st.st_mode)) {
+    throw std::ios_base::failure("Failed to open file for reading: " + filepath);
+  }
+
+  std::ifstream stream(filepath.c_str(), std::ifstream::binary);
+
+  if (!stream.is_open()) {
+    throw std::ios_base::failure("Failed to open file for reading: " + filepath);
+  }
+
+  try {
+    plan(stream, config, count, ranges);
+  } catch (...) {
+    stream.close();
+    throw;
+  }
+
+  stream.close();
+}
+
+/**
+ * @brief 指定された位置以降で最初のCSVレコードの境界を返します。
+ *
+ * 前後SPLIT_LOOKAHEADバイトを先読みし、指定された位置が囲み文字の中か外かを両方仮定して、両方に矛盾がなく境界が一致した場合に採用します。
+ * 一方でしか境界が見つからない場合は先読みより長い囲み文字の中にいる可能性があるため、矛盾が見つかった場合と同様に、既知の境界から順に走査して正確な境界を求めます。
+ * @param stream 入力ストリーム
+ * @param config Configオブジェクト
+ * @param origin 指定された位置より前にある既知のCSVレコードの境界
+ * @param offset 位置
+ * @return 指定された位置以降で最初のCSVレコードの境界、見つからない場合は入力ストリームの末尾
+ * @exception std::ios_base::failure 入力ストリームにエラーが発生した場合
+ */
+std::streamoff Splitter::align(std::istream& stream,
+			       const Config& config,
+			       const std::streamoff origin,
+			       const std::streamoff offset)
+{
+  return align(stream, config, origin, offset, SPLIT_LOOKAHEAD);
+}
+
+/**
+ * @brief 指定された位置以降で最初のCSVレコードの境界を、指定されたバイト数の先読みで返します。
+ *
+ * 多くの位置を調べる場合に先読みを小さくすると、読み込むバイト数を減らせます。
+ * 先読みの範囲で決められない場合は、既知の境界から順に走査します。
+ * @param stream 入力ストリーム
+ * @param config Configオブジェクト
+ * @param origin 指定された位置より前にある既知のCSVレコードの境界
+ * @param offset 位置
+ * @param lookahead 前後を先読みするバイト数
+ * @return 指定された位置以降で最初のCSVレコードの境界、見つからない場合は入力ストリームの末尾
+ * @exception std::ios_base::failure 入力ストリームにエラーが発生した場合
+ */
+std::streamoff Splitter::align(std::istream& stream,
+			       const Config& config,
+			       const std::streamoff origin,
+			       const std::streamoff offset,
+			       const std::streamoff lookahead)
+{
+  const std::streamoff size = sizeOf(stream);
+
+  if (offset <= origin) {
+    return origin;
+  }
+  if (offset >= size) {
+    return size;
+  }
+
+  const std::streamoff windowBegin = (offset - origin > lookahead) ? offset - lookahead : origin;
+  const std::streamoff windowEnd = (size - offset > lookahead) ? offset + lookahead : size;
+  std::string window;
+  readRange(stream, windowBegin, windowEnd, window);
+
+  // start two bytes early so that a CRLF just before the offset is seen
+  const std::size_t lower = static_cast<std::size_t>(offset - windowBegin);
+  const std::size_t start = (lower >= 2) ? lower - 2 : 0;
+
+  // find out whether the start lies in a comment line, assuming it is outside quotes
+  std::size_t lineBegin = Scanner::npos;
+  for (std::size_t i = start; i >= 2; i--) {
+    if (window[i - 2] == '\r' && window[i - 1] == '\n') {
+      lineBegin = i;
+      break;
+    }
+  }
+  if (lineBegin == Scanner::npos && windowBegin == origin) {
+    lineBegin = 0;
+  }
+  const bool lineFlag = (lineBegin == start);
+  const bool commentFlag = (!lineFlag && lineBegin != Scanner::npos
+			    && config.getCommentEnabled() && window[lineBegin] == config.getCommentMark());
+
+  std::size_t outside;
+  std::size_t inside;
+  const Speculation outsideResult = speculate(window, start, lower, false, lineFlag, commentFlag, windowEnd == size, config, outside);
+  const Speculation insideResult = config.getQuoteEnabled()
+    ? speculate(window, start, lower, true, false, false, windowEnd == size, config, inside)
+    : SPECULATION_NOT_FOUND;
+
+  // a guess without a boundary may be a quoted field longer than the window, and a rejection may come
+  // from lenient input that Reader accepts, so only two agreeing boundaries settle the position
+  if (outsideResult == SPECULATION_FOUND
+      && (!config.getQuoteEnabled() || (insideResult == SPECULATION_FOUND && inside == outside))) {
+    return windowBegin + static_cast<std::streamoff>(outside);
+  }
+
+  if (config.getQuoteEnabled() && !config.getCommentEnabled()) {
+    return scanByParity(stream, config, origin, offset, size);
+  }
+  return scanExactly(stream, config, origin, offset, size);
+}
+
+} // namespace csv
+} // namespace csl
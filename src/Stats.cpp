@@ -0,0 +1,169 @@
+/**
+ * @file  Stats.cpp
+ * @brief Statsクラス実装ファイル
+ */
+#include "csl/csv/Stats.hpp"
+#include <sstream>
+
+namespace csl {
+namespace csv {
+
+/**
+ * @brief すべての値が0のStatsオブジェクトを構築します。
+ */
+Stats::Stats(void)
+{
+  reset();
+}
+
+/**
+ * @brief Statsオブジェクトを破棄します。
+ */
+Stats::~Stats(void)
+{
+}
+
+/**
+ * @brief すべての値を0に戻します。
+ */
+void Stats::reset(void)
+{
+  bytes = 0;
+  records = 0;
+  fields = 0;
+  quotedFields = 0;
+  escapedQuotes = 0;
+  commentLines = 0;
+  maxFieldLength = 0;
+  maxRecordLength = 0;
+  ioTime = 0;
+  parseTime = 0;
+}
+
+/**
+ * @brief 読み書きしたバイト数を返します。
+ * @return 読み書きしたバイト数
+ */
+unsigned long long Stats::getBytes(void) const
+{
+  return bytes;
+}
+
+/**
+ * @brief 読み書きしたCSVレコードの数を返します。
+ * @return 読み書きしたCSVレコードの数
+ */
+std::size_t Stats::getRecords(void) const
+{
+  return records;
+}
+
+/**
+ * @brief 読み書きしたフィールドの数を返します。
+ * @return 読み書きしたフィールドの数
+ */
+std::size_t Stats::getFields(void) const
+{
+  return fields;
+}
+
+/**
+ * @brief 囲み文字で囲まれたフィールドの数を返します。
+ * @return 囲み文字で囲まれたフィールドの数
+ */
+std::size_t Stats::getQuotedFields(void) const
+{
+  return quotedFields;
+}
+
+/**
+ * @brief エスケープされた囲み文字の数を返します。
+ * @return エスケープされた囲み文字の数
+ */
+std::size_t Stats::getEscapedQuotes(void) const
+{
+  return escapedQuotes;
+}
+
+/**
+ * @brief 読み飛ばしたコメント行の数を返します。
+ * @return 読み飛ばしたコメント行の数
+ */
+std::size_t Stats::getCommentLines(void) const
+{
+  return commentLines;
+}
+
+/**
+ * @brief 最も長いフィールドのバイト数を返します。
+ * @return 最も長いフィールドのバイト数
+ */
+std::size_t Stats::getMaxFieldLength(void) const
+{
+  return maxFieldLength;
+}
+
+/**
+ * @brief 最も長いCSVレコードのバイト数(コメント行を除き、CRLFを含む)を返します。
+ * @return 最も長いCSVレコードのバイト数
+ */
+std::size_t Stats::getMaxRecordLength(void) const
+{
+  return maxRecordLength;
+}
+
+/**
+ * @brief 入出力の待ち時間を返します。
+ * @return 入出力の待ち時間(ナノ秒)
+ */
+unsigned long long Stats::getIoTime(void) const
+{
+  return ioTime;
+}
+
+/**
+ * @brief 解析(書き込みの場合は整形)の時間を返します。
+ * @return 解析の時間(ナノ秒)
+ */
+unsigned long long Stats::getParseTime(void) const
+{
+  return parseTime;
+}
+
+/**
+ * @brief 入出力の待ち時間を加算します。
+ *
+ * ReaderやWriterが使用するストリームバッファで入出力の時間を計測した場合に呼び出します。
+ * ReaderとWriterは、処理中に加算された待ち時間を解析の時間から差し引きます。
+ * @param nanoseconds 入出力の待ち時間(ナノ秒)
+ */
+void Stats::addIoTime(const unsigned long long nanoseconds)
+{
+  ioTime += nanoseconds;
+}
+
+/**
+ * @brief すべての値をJSON形式の文字列で返します。
+ * @return JSON形式の文字列
+ */
+std::string Stats::toJson(void) const
+{
+  std::ostringstream json;
+
+  json << "{\"bytes\":" << bytes
+       << ",\"records\":" << records
+       << ",\"fields\":" << fields
+       << ",\"quoted_fields\":" << quotedFields
+       << ",\"escaped_quotes\":" << escapedQuotes
+       << ",\"comment_lines\":" << commentLines
+       << ",\"max_field_length\":" << maxFieldLength
+       << ",\"max_record_length\":" << maxRecordLength
+       << ",\"io_time_ns\":" << ioTime
+       << ",\"parse_time_ns\":" << parseTime
+       << "}";
+
+  return json.str();
+}
+
+} // namespace csv
+} // namespace csl
@@ -0,0 +1,158 @@
+/**
+ * @file  TempFiles.cpp
+ * @brief TempFilesクラス実装ファイル
+ */
+#include "csl/csv/TempFiles.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <ios>
+#include <stdlib.h>
+#include <unistd.h>
+
+namespace csl {
+namespace csv {
+
+/**
+ * @brief 指定されたディレクトリに一時ファイルを作るTempFilesオブジェクトを構築します。
+ * @param directory ディレクトリのパス
+ */
+TempFiles::TempFiles(const std::string& directory)
+  : directory(directory)
+{
+}
+
+/**
+ * @brief 残っている一時ファイルを削除して、TempFilesオブジェクトを破棄します。
+ */
+TempFiles::~TempFiles(void)
+{
+  for (std::size_t i = 0; i < paths.size(); i++) {
+    std::remove(paths[i].c_str());
+  }
+}
+
+/**
+ * @brief 空の一時ファイルを作ります。
+ * @return 一時ファイルのパス
+ * @exception std::ios_base::failure 一時ファイルを作れない場合
+ */
+std::string TempFiles::create(void)
+{
+  const std::string pattern = directory + "/cslcsv-XXXXXX";
+  std::vector<char> path(pattern.begin(), pattern.end());
+  path.push_back('\0');
+
+  const int fd = mkstemp(&path[0]);
+  if (fd < 0) {
+    throw std::ios_base::failure("Failed to open file for writing: " + directory);
+  }
+  ::close(fd);
+
+  paths.push_back(&path[0]);
+  return paths.back();
+}
+
+/**
+ * @brief 作った一時ファイルを削除します。
+ * @param path 一時ファイルのパス
+ */
+void TempFiles::remove(const std::string& path)
+{
+  std::vector<std::string>::iterator it = std::find(paths.begin(), paths.end(), path);
+
+  if (it != paths.end()) {
+    std::remove(path.c_str());
+    paths.erase(it);
+  }
+}
+
+/**
+ * @brief 残っている一時ファイルのパスを、作った順に返します。
+ * @return 一時ファイルのパス
+ */
+const std::vector<std::string>& TempFiles::getPaths(void) const
+{
+  return paths;
+}
+
+/**
+ * @brief 一時ファイルに1つのCSVレコードを書き込みます。
+ *
+ * 出力ストリームのエラーは、呼び出し側で閉じるときに確かめます。
+ * @param stream 出力ストリーム
+ * @param record CSVレコード
+ */
+void TempFiles::write(std::ostream& stream, const std::vector<std::string>& record)
+{
+  const std::uint64_t count = record.size();
+  stream.write(reinterpret_cast<const char*>(&count), sizeof(count));
+
+  for (std::size_t i = 0; i < record.size(); i++) {
+    const std::uint64_t size = record[i].size();
+    stream.write(reinterpret_cast<const char*>(&size), sizeof(size));
+    stream.write(record[i].data(), record[i].size());
+  }
+}
+
+/**
+ * @brief 一時ファイルから1つのCSVレコードを読み込みます。
+ * @param stream 入力ストリーム
+ * @param record CSVレコード
+ * @return 読み込んだ場合はtrue、終わりに達した場合はfalse
+ * @exception std::ios_base::failure 一時ファイルが途中で終わっている場合
+ */
+bool TempFiles::read(std::istream& stream, std::vector<std::string>& record)
+{
+  std::uint64_t count;
+
+  stream.read(reinterpret_cast<char*>(&count), sizeof(count));
+  if (stream.gcount() == 0 && stream.eof()) {
+    return false;
+  }
+  if (stream.fail()) {
+    throw std::ios_base::failure("Failed to read.");
+  }
+
+  record.resize(static_cast<std::size_t>(count));
+  for (std::size_t i = 0; i < record.size(); i++) {
+    std::uint64_t size;
+    stream.read(reinterpret_cast<char*>(&size), sizeof(size));
+    if (stream.fail()) {
+      throw std::ios_base::failure("Failed to read.");
+    }
+    record[i].resize(static_cast<std::size_t>(size));
+    if (size > 0) {
+      stream.read(&record[i][0], static_cast<std::streamsize>(size));
+    }
+  }
+
+  if (stream.fail()) {
+    throw std::ios_base::failure("Failed to read.");
+  }
+
+  return true;
+}
+
+/**
+ * @brief メモリに保持したCSVレコードの推定メモリ使用量を返します。
+ * @param record CSVレコード
+ * @return バイト数
+ */
+std::size_t TempFiles::getRecordBytes(const std::vector<std::string>& record)
+{
+  std::size_t bytes = sizeof(std::vector<std::string>);
+
+  for (std::size_t i = 0; i < record.size(); i++) {
+    bytes += sizeof(std::string);
+    if (record[i].size() >= sizeof(std::string) / 2) {
+      // not stored inline
+      bytes += record[i].capacity() + 1;
+    }
+  }
+
+  return bytes;
+}
+
+} // namespace csv
+} // namespace csl
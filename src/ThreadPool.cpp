@@ -0,0 +1,208 @@
+/**
+ * @file  ThreadPool.cpp
+ * @brief ThreadPoolクラス実装ファイル
+ */
+#include "csl/csv/ThreadPool.hpp"
+#include <utility>
+
+namespace csl {
+namespace csv {
+
+namespace {
+
+/**
+ * @brief 現在のスレッドを実行しているThreadPoolオブジェクトです。
+ */
+thread_local const ThreadPool* currentPool = 0;
+
+/**
+ * @brief 現在のスレッドのThreadPoolオブジェクト内での番号です。
+ */
+thread_local std::size_t currentIndex = 0;
+
+} // namespace
+
+/**
+ * @brief ハードウェアが同時に実行できるスレッド数のThreadPoolオブジェクトを構築します。
+ */
+ThreadPool::ThreadPool(void)
+  : queued(0)
+  , pending(0)
+  , nextQueue(0)
+  , stopFlag(false)
+{
+  const std::size_t size = std::thread::hardware_concurrency();
+  start(size > 0 ? size : 1);
+}
+
+/**
+ * @brief 指定されたスレッド数のThreadPoolオブジェクトを構築します。
+ * @param size スレッド数(0の場合は1)
+ */
+ThreadPool::ThreadPool(const std::size_t size)
+  : queued(0)
+  , pending(0)
+  , nextQueue(0)
+  , stopFlag(false)
+{
+  start(size > 0 ? size : 1);
+}
+
+/**
+ * @brief 投入済みのタスクがすべて終わるのを待ってから、ThreadPoolオブジェクトを破棄します。
+ */
+ThreadPool::~ThreadPool(void)
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopFlag = true;
+  }
+  taskCondition.notify_all();
+
+  for (std::size_t i = 0; i < threads.size(); i++) {
+    threads[i].join();
+  }
+  for (std::size_t i = 0; i < queues.size(); i++) {
+    delete queues[i];
+  }
+}
+
+/**
+ * @brief タスクを投入します。
+ *
+ * プール内のスレッドから投入した場合はそのスレッドのキューに、それ以外の場合は各スレッドのキューに順に投入します。
+ * @param task タスク
+ */
+void ThreadPool::submit(const Task& task)
+{
+  std::size_t index;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    index = (currentPool == this) ? currentIndex : nextQueue++ % queues.size();
+    queued++;
+    pending++;
+  }
+  {
+    std::lock_guard<std::mutex> lock(queues[index]->mutex);
+    queues[index]->tasks.push_back(task);
+  }
+  taskCondition.notify_one();
+}
+
+/**
+ * @brief 投入済みのタスクがすべて終わるまで待ちます。
+ *
+ * プール内のスレッドから呼び出してはいけません。
+ * @exception タスクが例外を送出した場合は、最初に送出された例外
+ */
+void ThreadPool::wait(void)
+{
+  std::unique_lock<std::mutex> lock(mutex);
+  while (pending > 0) {
+    doneCondition.wait(lock);
+  }
+
+  if (exception) {
+    std::exception_ptr e = exception;
+    exception = std::exception_ptr();
+    std::rethrow_exception(e);
+  }
+}
+
+/**
+ * @brief スレッド数を返します。
+ * @return スレッド数
+ */
+std::size_t ThreadPool::getSize(void) const
+{
+  return threads.size();
+}
+
+/**
+ * @brief 指定された数のスレッドを起動します。
+ * @param size スレッド数
+ */
+void ThreadPool::start(const std::size_t size)
+{
+  for (std::size_t i = 0; i < size; i++) {
+    queues.push_back(new Queue());
+  }
+  for (std::size_t i = 0; i < size; i++) {
+    threads.push_back(std::thread(&ThreadPool::run, this, i));
+  }
+}
+
+/**
+ * @brief スレッドでタスクを取り出して実行し続けます。
+ * @param index スレッドの番号
+ */
+void ThreadPool::run(const std::size_t index)
+{
+  currentPool = this;
+  currentIndex = index;
+
+  for (;;) {
+    Task task;
+    if (pop(index, task)) {
+      try {
+	task();
+      } catch (...) {
+	std::lock_guard<std::mutex> lock(mutex);
+	if (!exception) {
+	  exception = std::current_exception();
+	}
+      }
+
+      std::lock_guard<std::mutex> lock(mutex);
+      if (--pending == 0) {
+	doneCondition.notify_all();
+      }
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!stopFlag && queued == 0) {
+      taskCondition.wait(lock);
+    }
+    if (stopFlag && queued == 0) {
+      break;
+    }
+  }
+}
+
+/**
+ * @brief 自分のキューの末尾から、空の場合は他のスレッドのキューの先頭からタスクを取り出します。
+ * @param index スレッドの番号
+ * @param task 取り出したタスク
+ * @return タスクを取り出せた場合はtrue
+ */
+bool ThreadPool::pop(const std::size_t index, Task& task)
+{
+  bool found = false;
+
+  for (std::size_t i = 0; i < queues.size() && !found; i++) {
+    Queue& queue = *queues[(index + i) % queues.size()];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty()) {
+      continue;
+    }
+    if (i == 0) {
+      task = std::move(queue.tasks.back());
+      queue.tasks.pop_back();
+    } else {
+      task = std::move(queue.tasks.front()); // steal the oldest task
+      queue.tasks.pop_front();
+    }
+    found = true;
+  }
+
+  if (found) {
+    std::lock_guard<std::mutex> lock(mutex);
+    queued--;
+  }
+
+  return found;
+}
+
+} // namespace csv
+} // namespace csl
@@ -3,14 +3,285 @@
  * @brief Utilクラス実装ファイル
  */
 #include "csl/csv/Util.hpp"
+#include <chrono>
 #include <fstream>
+#include <map>
+#include <sstream>
+#include <streambuf>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <cerrno>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
 #include <sys/stat.h>
 #include "csl/csv/Reader.hpp"
 #include "csl/csv/Writer.hpp"
+#include "csl/csv/Scanner.hpp"
 
 namespace csl {
 namespace csv {
 
+namespace {
+
+/**
+ * @brief 末尾からCSVレコードを探すときに最初に読み込むバイト数です。
+ */
+const std::streamoff TAIL_BLOCK_SIZE = 64 * 1024;
+
+/**
+ * @brief 数値として解釈するときに、ヒープを使わずに複写するフィールドのバイト数の上限です。
+ */
+const std::size_t NUMBER_BUFFER_SIZE = 64;
+
+/**
+ * @brief バッファ上の指定された範囲がコメント行かどうかを返します。
+ * @param buffer バッファ
+ * @param base   バッファの先頭の位置
+ * @param begin  範囲の開始位置
+ * @param end    範囲の終了位置
+ * @param config Configオブジェクト
+ * @return 範囲がコメント文字で始まり、最初のCRLFで終わる場合はtrue
+ */
+bool isCommentLine(const std::string& buffer, std::streamoff base,
+		   std::streamoff begin, std::streamoff end, const Config& config)
+{
+  if (!config.getCommentEnabled() || buffer[begin - base] != config.getCommentMark()) {
+    return false;
+  }
+
+  for (std::streamoff i = begin + 1; i < end; i++) {
+    if (buffer[i - 1 - base] == '\r' && buffer[i - base] == '\n') {
+      return i + 1 == end;
+    }
+  }
+
+  return false;
+}
+
+/**
+ * @brief メモリ上のデータを読み込む入力ストリームバッファです。
+ */
+class MemoryBuffer : public std::streambuf
+{
+public:
+  MemoryBuffer(char* data, std::size_t size)
+  {
+    setg(data, data, data + size);
+  }
+};
+
+/**
+ * @brief loadFileで読み込み後もスレッドごとに保持しておくバッファの容量の上限(バイト数)です。
+ */
+const std::size_t LOAD_BUFFER_RETAIN = 16 * 1024 * 1024;
+
+/**
+ * @brief 指定されたファイルを指定されたバッファに読み込みます。
+ * @param filepath ファイルパス
+ * @param buffer バッファ
+ * @exception std::ios_base::failure ファイルの読み込みに失敗した場合
+ */
+void readFile(const std::string& filepath, std::string& buffer)
+{
+  struct stat st;
+  const int fd = open(filepath.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0 || fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+    if (fd >= 0) {
+      close(fd);
+    }
+    throw std::ios_base::failure("Failed to open file for reading: " + filepath);
+  }
+
+  buffer.resize(static_cast<std::size_t>(st.st_size));
+  std::size_t size = 0;
+  while (size < buffer.size()) {
+    const ssize_t n = read(fd, &buffer[size], buffer.size() - size);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      break;
+    }
+    size += static_cast<std::size_t>(n);
+  }
+  close(fd);
+
+  if (size != buffer.size()) {
+    throw std::ios_base::failure("Failed to read: " + filepath);
+  }
+}
+
+/**
+ * @brief 指定されたファイルを現在のスレッドのバッファに読み込んでから、CSVデータを読み込んで返します。
+ *
+ * ファイルはopen、fstat、read、closeの各1回のシステムコールで読み込み、バッファはスレッドごとに再利用します。
+ * 容量がLOAD_BUFFER_RETAINを超えたバッファは、読み込みの後に解放します。
+ * @param filepath ファイルパス
+ * @param config Configオブジェクト
+ * @param csv CSVデータ
+ * @exception std::ios_base::failure ファイルの読み込みに失敗した場合
+ */
+void loadFile(const std::string& filepath,
+	      const Config& config,
+	      std::vector<std::vector<std::string> >& csv)
+{
+  thread_local std::string buffer;
+
+  try {
+    readFile(filepath, buffer);
+    MemoryBuffer memory(&buffer[0], buffer.size());
+    std::istream stream(&memory);
+    Util::load(stream, config, csv);
+  } catch (...) {
+    if (buffer.capacity() > LOAD_BUFFER_RETAIN) {
+      std::string().swap(buffer);
+    }
+    throw;
+  }
+
+  // a pool thread lives long; do not keep a multi-gigabyte buffer for it
+  if (buffer.capacity() > LOAD_BUFFER_RETAIN) {
+    std::string().swap(buffer);
+  }
+}
+
+/**
+ * @brief 入出力の待ち時間を計測するストリームバッファで、一度に読み書きするバイト数です。
+ */
+const std::size_t TIMED_BUFFER_SIZE = 64 * 1024;
+
+/**
+ * @brief 元のストリームバッファからの読み込みにかかった時間をStatsオブジェクトに加算する入力ストリームバッファです。
+ */
+class TimedInputBuffer : public std::streambuf
+{
+public:
+  TimedInputBuffer(std::streambuf* source, Stats& stats)
+    : source(source)
+    , stats(stats)
+    , buffer(TIMED_BUFFER_SIZE)
+  {
+  }
+
+protected:
+  virtual int_type underflow(void)
+  {
+    const std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    const std::streamsize size = source->sgetn(&buffer[0], static_cast<std::streamsize>(buffer.size()));
+    stats.addIoTime(std::chrono::duration_cast<std::chrono::nanoseconds>
+		    (std::chrono::steady_clock::now() - begin).count());
+
+    if (size <= 0) {
+      return traits_type::eof();
+    }
+    setg(&buffer[0], &buffer[0], &buffer[0] + size);
+    return traits_type::to_int_type(buffer[0]);
+  }
+
+private:
+  std::streambuf* source;
+  Stats& stats;
+  std::vector<char> buffer;
+};
+
+/**
+ * @brief 元のストリームバッファへの書き込みにかかった時間をStatsオブジェクトに加算する出力ストリームバッファです。
+ */
+class TimedOutputBuffer : public std::streambuf
+{
+public:
+  TimedOutputBuffer(std::streambuf* source, Stats& stats)
+    : source(source)
+    , stats(stats)
+    , buffer(TIMED_BUFFER_SIZE)
+  {
+    setp(&buffer[0], &buffer[0] + buffer.size());
+  }
+
+protected:
+  virtual int_type overflow(int_type c)
+  {
+    if (!flush()) {
+      return traits_type::eof();
+    }
+    if (!traits_type::eq_int_type(c, traits_type::eof())) {
+      *pptr() = traits_type::to_char_type(c);
+      pbump(1);
+    }
+    return traits_type::not_eof(c);
+  }
+
+  virtual int sync(void)
+  {
+    if (!flush()) {
+      return -1;
+    }
+
+    const std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    const int result = source->pubsync();
+    stats.addIoTime(std::chrono::duration_cast<std::chrono::nanoseconds>
+		    (std::chrono::steady_clock::now() - begin).count());
+    return result;
+  }
+
+private:
+  std::streambuf* source;
+  Stats& stats;
+  std::vector<char> buffer;
+
+  bool flush(void)
+  {
+    const std::streamsize size = pptr() - pbase();
+    const std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    const std::streamsize written = source->sputn(pbase(), size);
+    stats.addIoTime(std::chrono::duration_cast<std::chrono::nanoseconds>
+		    (std::chrono::steady_clock::now() - begin).count());
+
+    setp(&buffer[0], &buffer[0] + buffer.size());
+    return written == size;
+  }
+};
+
+/**
+ * @brief loadManyで投入したタスクがすべて終わるのを待つためのカウンタです。
+ */
+class Latch
+{
+public:
+  Latch(std::size_t count)
+    : count(count)
+  {
+  }
+
+  void countDown(void)
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (--count == 0) {
+      condition.notify_all();
+    }
+  }
+
+  void wait(void)
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (count > 0) {
+      condition.wait(lock);
+    }
+  }
+
+private:
+  std::size_t count;
+  std::mutex mutex;
+  std::condition_variable condition;
+};
+
+} // namespace
+
 /**
  * @brief デフォルトのConfigオブジェクトの設定に従って、指定された入力ストリームからCSVデータを読み込んで返します。
  * @param stream 入力ストリーム
@@ -90,6 +361,629 @@ void Util::load(const std::string& filepath,
   stream.close();
 }
 
+/**
+ * @brief 指定されたConfigオブジェクトの設定に従って、指定された入力ストリームからCSVデータを読み込んで返し、統計情報を加算します。
+ *
+ * 入力ストリームからの読み込みにかかった時間を入出力の待ち時間として、それ以外を解析の時間として加算します。
+ * 読み込みに失敗した場合は、入力ストリームにもfailbitまたはbadbitを設定します。
+ * @param stream 入力ストリーム
+ * @param config Configオブジェクト
+ * @param csv CSVデータ
+ * @param stats Statsオブジェクト
+ * @exception std::ios_base::failure 入力ストリームにエラーが発生した場合
+ */
+void Util::load(std::istream& stream,
+		const Config& config,
+		std::vector<std::vector<std::string> >& csv,
+		Stats& stats)
+{
+  csv.clear();
+
+  if (stream.fail() || stream.bad()) {
+    throw std::ios_base::failure("Failed to read.");
+  }
+
+  TimedInputBuffer buffer(stream.rdbuf(), stats);
+  std::istream timed(&buffer);
+
+  try {
+    Reader reader(timed, config);
+    std::vector<std::string> record;
+
+    reader.setStats(&stats);
+    while (reader.hasNext()) {
+      reader.read(record);
+      csv.push_back(record);
+      record.clear();
+    }
+  } catch (...) {
+    stream.setstate(timed.bad() ? std::ios_base::badbit : std::ios_base::failbit);
+    throw;
+  }
+
+  if (timed.bad()) {
+    stream.setstate(std::ios_base::badbit);
+    throw std::ios_base::failure("Failed to read.");
+  }
+  stream.setstate(timed.rdstate()); // reached the end like the reader on the stream itself
+}
+
+/**
+ * @brief 指定されたConfigオブジェクトの設定に従って、指定されたファイルからCSVデータを読み込んで返し、統計情報を加算します。
+ * @param filepath ファイルパス
+ * @param config Configオブジェクト
+ * @param csv CSVデータ
+ * @param stats Statsオブジェクト
+ * @exception std::ios_base::failure 入力ストリームにエラーが発生した場合
+ */
+void Util::load(const std::string& filepath,
+		const Config& config,
+		std::vector<std::vector<std::string> >& csv,
+		Stats& stats)
+{
+  struct stat st;
+  if (stat(filepath.c_str(), &st) != 0 || !S_ISREG(st.st_mode)) {
+    throw std::ios_base::failure("Failed to open file for reading: " + filepath);
+  }
+
+  std::ifstream stream(filepath.c_str(), std::ifstream::binary);
+
+  if (!stream.is_open()) {
+    throw std::ios_base::failure("Failed to open file for reading: " + filepath);
+  }
+
+  try {
+    load(stream, config, csv, stats);
+  } catch (...) {
+    stream.close();
+    throw;
+  }
+
+  stream.close();
+}
+
+#if __cplusplus >= 201703L
+/**
+ * @brief デフォルトのConfigオブジェクトの設定に従って、指定された入力ストリームからCSVデータを読み込んで、CSVデータのメモリリソースに割り当てて返します。
+ * @param stream 入力ストリーム
+ * @param csv CSVデータ
+ * @exception std::ios_base::failure 入力ストリームにエラーが発生した場合
+ */
+void Util::load(std::istream& stream,
+		std::pmr::vector<std::pmr::vector<std::pmr::string> >& csv)
+{
+  load(stream, DEFAULT_CONFIG, csv);
+}
+
+/**
+ * @brief 指定されたConfigオブジェクトの設定に従って、指定された入力ストリームからCSVデータを読み込んで、CSVデータのメモリリソースに割り当てて返します。
+ *
+ * CSVレコードとフィールドはすべてCSVデータのメモリリソースから割り当てるため、
+ * monotonic_buffer_resourceを使用すればメモリリソースの解放でCSVデータをまとめて解放できます。
+ * @param stream 入力ストリーム
+ * @param config Configオブジェクト
+ * @param csv CSVデータ
+ * @exception std::ios_base::failure 入力ストリームにエラーが発生した場合
+ */
+void Util::load(std::istream& stream,
+		const Config& config,
+		std::pmr::vector<std::pmr::vector<std::pmr::string> >& csv)
+{
+  csv.clear();
+
+  Reader reader(stream, config);
+
+  while (reader.hasNext()) {
+    csv.emplace_back(); // constructed with the allocator of csv
+    reader.read(csv.back());
+  }
+}
+
+/**
+ * @brief デフォルトのConfigオブジェクトの設定に従って、指定されたファイルからCSVデータを読み込んで、CSVデータのメモリリソースに割り当てて返します。
+ * @param filepath ファイルパス
+ * @param csv CSVデータ
+ * @exception std::ios_base::failure 入力ストリームにエラーが発生した場合
+ */
+void Util::load(const std::string& filepath,
+		std::pmr::vector<std::pmr::vector<std::pmr::string> >& csv)
+{
+  load(filepath, DEFAULT_CONFIG, csv);
+}
+
+/**
+ * @brief 指定されたConfigオブジェクトの設定に従って、指定されたファイルからCSVデータを読み込んで、CSVデータのメモリリソースに割り当てて返します。
+ * @param filepath ファイルパス
+ * @param config Configオブジェクト
+ * @param csv CSVデータ
+ * @exception std::ios_base::failure 入力ストリームにエラーが発生した場合
+ */
+void Util::load(const std::string& filepath,
+		const Config& config,
+		std::pmr::vector<std::pmr::vector<std::pmr::string> >& csv)
+{
+  struct stat st;
+  if (stat(filepath.c_str(), &st) != 0 || !S_ISREG(st.st_mode)) {
+    throw std::ios_base::failure("Failed to open file for reading: " + filepath);
+  }
+
+  std::ifstream stream(filepath.c_str(), std::ifstream::binary);
+
+  if (!stream.is_open()) {
+    throw std::ios_base::failure("Failed to open file for reading: " + filepath);
+  }
+
+  try {
+    load(stream, config, csv);
+  } catch (...) {
+    stream.close();
+    throw;
+  }
+
+  stream.close();
+}
+#endif
+
+/**
+ * @brief デフォルトのConfigオブジェクトの設定に従って、指定された入力ストリームからCSVデータを読み込んで、EncodedTableオブジェクトに追加します。
+ * @param stream 入力ストリーム
+ * @param table EncodedTableオブジェクト
+ * @exception std::ios_base::failure 入力ストリームにエラーが発生した場合
+ */
+void Util::load(std::istream& stream,
+		EncodedTable& table)
+{
+  load(stream, DEFAULT_CONFIG, table);
+}
+
+/**
+ * @brief 指定されたConfigオブジェクトの設定に従って、指定された入力ストリームからCSVデータを読み込んで、EncodedTableオブジェクトに追加します。
+ *
+ * 読み込む前にEncodedTableオブジェクトのCSVレコードを取り除きます。符号化する列の設定はEncodedTableオブジェクトに設定しておきます。
+ * @param stream 入力ストリーム
+ * @param config Configオブジェクト
+ * @param table EncodedTableオブジェクト
+ * @exception std::ios_base::failure 入力ストリームにエラーが発生した場合
+ */
+void Util::load(std::istream& stream,
+		const Config& config,
+		EncodedTable& table)
+{
+  table.clear();
+
+  Reader reader(stream, config);
+  LazyRecord record;
+
+  while (reader.hasNext()) {
+    reader.read(record);
+    table.add(record);
+  }
+}
+
+/**
+ * @brief デフォルトのConfigオブジェクトの設定に従って、指定されたファイルからCSVデータを読み込んで、EncodedTableオブジェクトに追加します。
+ * @param filepath ファイルパス
+ * @param table EncodedTableオブジェクト
+ * @exception std::ios_base::failure 入力ストリームにエラーが発生した場合
+ */
+void Util::load(const std::string& filepath,
+		EncodedTable& table)
+{
+  load(filepath, DEFAULT_CONFIG, table);
+}
+
+/**
+ * @brief 指定されたConfigオブジェクトの設定に従って、指定されたファイルからCSVデータを読み込んで、EncodedTableオブジェクトに追加します。
+ * @param filepath ファイルパス
+ * @param config Configオブジェクト
+ * @param table EncodedTableオブジェクト
+ * @exception std::ios_base::failure 入力ストリームにエラーが発生した場合
+ */
+void Util::load(const std::string& filepath,
+		const Config& config,
+		EncodedTable& table)
+{
+  struct stat st;
+  if (stat(filepath.c_str(), &st) != 0 || !S_ISREG(st.st_mode)) {
+    throw std::ios_base::failure("Failed to open file for reading: " + filepath);
+  }
+
+  std::ifstream stream(filepath.c_str(), std::ifstream::binary);
+
+  if (!stream.is_open()) {
+    throw std::ios_base::failure("Failed to open file for reading: " + filepath);
+  }
+
+  try {
+    load(stream, config, table);
+  } catch (...) {
+    stream.close();
+    throw;
+  }
+
+  stream.close();
+}
+
+/**
+ * @brief デフォルトのConfigオブジェクトの設定に従って、指定された入力ストリームから指定されたFilterオブジェクトの条件を満たすCSVレコードだけを読み込んで返します。
+ * @param stream 入力ストリーム
+ * @param filter Filterオブジェクト
+ * @param csv CSVデータ
+ * @exception std::ios_base::failure 入力ストリームにエラーが発生した場合
+ */
+void Util::load(std::istream& stream,
+		const Filter& filter,
+		std::vector<std::vector<std::string> >& csv)
+{
+  load(stream, DEFAULT_CONFIG, filter, csv);
+}
+
+/**
+ * @brief 指定されたConfigオブジェクトの設定に従って、指定された入力ストリームから指定されたFilterオブジェクトの条件を満たすCSVレコードだけを読み込んで返します。
+ *
+ * 条件を満たさないCSVレコードは、条件の列を読み込んだ時点で読み飛ばし、フィールドを解釈しません。
+ * @param stream 入力ストリーム
+ * @param config Configオブジェクト
+ * @param filter Filterオブジェクト
+ * @param csv CSVデータ
+ * @exception std::ios_base::failure 入力ストリームにエラーが発生した場合
+ */
+void Util::load(std::istream& stream,
+		const Config& config,
+		const Filter& filter,
+		std::vector<std::vector<std::string> >& csv)
+{
+  csv.clear();
+
+  Reader reader(stream, config);
+  LazyRecord record;
+
+  while (reader.hasNext()) {
+    if (!reader.read(record, filter)) {
+      continue;
+    }
+
+    csv.emplace_back(record.size());
+    std::vector<std::string>& fields = csv.back();
+    for (std::size_t i = 0; i < record.size(); i++) {
+      record.get(i, fields[i]);
+    }
+  }
+}
+
+/**
+ * @brief デフォルトのConfigオブジェクトの設定に従って、指定されたファイルから指定されたFilterオブジェクトの条件を満たすCSVレコードだけを読み込んで返します。
+ * @param filepath ファイルパス
+ * @param filter Filterオブジェクト
+ * @param csv CSVデータ
+ * @exception std::ios_base::failure 入力ストリームにエラーが発生した場合
+ */
+void Util::load(const std::string& filepath,
+		const Filter& filter,
+		std::vector<std::vector<std::string> >& csv)
+{
+  load(filepath, DEFAULT_CONFIG, filter, csv);
+}
+
+/**
+ * @brief 指定されたConfigオブジェクトの設定に従って、指定されたファイルから指定されたFilterオブジェクトの条件を満たすCSVレコードだけを読み込んで返します。
+ * @param filepath ファイルパス
+ * @param config Configオブジェクト
+ * @param filter Filterオブジェクト
+ * @param csv CSVデータ
+ * @exception std::ios_base::failure 入力ストリームにエラーが発生した場合
+ */
+void Util::load(const std::string& filepath,
+		const Config& config,
+		const Filter& filter,
+		std::vector<std::vector<std::string> >& csv)
+{
+  struct stat st;
+  if (stat(filepath.c_str(), &st) != 0 || !S_ISREG(st.st_mode)) {
+    throw std::ios_base::failure("Failed to open file for reading: " + filepath);
+  }
+
+  std::ifstream stream(filepath.c_str(), std::ifstream::binary);
+
+  if (!stream.is_open()) {
+    throw std::ios_base::failure("Failed to open file for reading: " + filepath);
+  }
+
+  try {
+    load(stream, config, filter, csv);
+  } catch (...) {
+    stream.close();
+    throw;
+  }
+
+  stream.close();
+}
+
+/**
+ * @brief デフォルトのConfigオブジェクトの設定に従って、指定された複数のファイルからCSVデータを並列に読み込んで、ファイルの順に返します。
+ * @param filepaths ファイルパス
+ * @param csvs ファイルごとのCSVデータ
+ * @exception std::ios_base::failure 入力ストリームにエラーが発生した場合
+ */
+void Util::loadMany(const std::vector<std::string>& filepaths,
+		    std::vector<std::vector<std::vector<std::string> > >& csvs)
+{
+  loadMany(filepaths, DEFAULT_CONFIG, csvs);
+}
+
+/**
+ * @brief 指定されたConfigオブジェクトの設定に従って、指定された複数のファイルからCSVデータを並列に読み込んで、ファイルの順に返します。
+ *
+ * ハードウェアが同時に実行できる数のスレッドを持つThreadPoolオブジェクトを一時的に構築して読み込みます。
+ * @param filepaths ファイルパス
+ * @param config Configオブジェクト
+ * @param csvs ファイルごとのCSVデータ
+ * @exception std::ios_base::failure 入力ストリームにエラーが発生した場合
+ */
+void Util::loadMany(const std::vector<std::string>& filepaths,
+		    const Config& config,
+		    std::vector<std::vector<std::vector<std::string> > >& csvs)
+{
+  ThreadPool pool;
+  loadMany(filepaths, config, pool, csvs);
+}
+
+/**
+ * @brief 指定されたConfigオブジェクトの設定に従って、指定された複数のファイルからCSVデータを指定されたThreadPoolオブジェクトで並列に読み込んで、ファイルの順に返します。
+ *
+ * ThreadPoolオブジェクトのスレッドから呼び出してはいけません。
+ * @param filepaths ファイルパス
+ * @param config Configオブジェクト
+ * @param pool ThreadPoolオブジェクト
+ * @param csvs ファイルごとのCSVデータ
+ * @exception std::ios_base::failure 入力ストリームにエラーが発生した場合(複数ある場合は先頭に近いファイルのもの)
+ */
+void Util::loadMany(const std::vector<std::string>& filepaths,
+		    const Config& config,
+		    ThreadPool& pool,
+		    std::vector<std::vector<std::vector<std::string> > >& csvs)
+{
+  csvs.clear();
+  csvs.resize(filepaths.size());
+
+  std::vector<std::exception_ptr> exceptions(filepaths.size());
+  Latch latch(filepaths.size());
+
+  for (std::size_t i = 0; i < filepaths.size(); i++) {
+    pool.submit([&, i]() {
+	try {
+	  loadFile(filepaths[i], config, csvs[i]);
+	} catch (...) {
+	  exceptions[i] = std::current_exception();
+	}
+	latch.countDown();
+      });
+  }
+  latch.wait();
+
+  for (std::size_t i = 0; i < exceptions.size(); i++) {
+    if (exceptions[i]) {
+      std::rethrow_exception(exceptions[i]);
+    }
+  }
+}
+
+/**
+ * @brief 指定されたConfigオブジェクトの設定に従って、指定された複数のファイルからCSVデータを指定されたThreadPoolオブジェクトで並列に読み込んで、読み込み終えた順に指定された関数に渡します。
+ *
+ * 関数は同時に複数のスレッドから呼び出されることはありません。
+ * ThreadPoolオブジェクトのスレッドから呼び出してはいけません。
+ * @param filepaths ファイルパス
+ * @param config Configオブジェクト
+ * @param pool ThreadPoolオブジェクト
+ * @param callback ファイルの番号とCSVデータを受け取る関数
+ * @exception std::ios_base::failure 入力ストリームにエラーが発生した場合(複数ある場合は先頭に近いファイルのもの)
+ */
+void Util::loadMany(const std::vector<std::string>& filepaths,
+		    const Config& config,
+		    ThreadPool& pool,
+		    const LoadCallback& callback)
+{
+  std::vector<std::exception_ptr> exceptions(filepaths.size());
+  std::mutex callbackMutex;
+  Latch latch(filepaths.size());
+
+  for (std::size_t i = 0; i < filepaths.size(); i++) {
+    pool.submit([&, i]() {
+	try {
+	  std::vector<std::vector<std::string> > csv;
+	  loadFile(filepaths[i], config, csv);
+	  std::lock_guard<std::mutex> lock(callbackMutex);
+	  callback(i, csv);
+	} catch (...) {
+	  exceptions[i] = std::current_exception();
+	}
+	latch.countDown();
+      });
+  }
+  latch.wait();
+
+  for (std::size_t i = 0; i < exceptions.size(); i++) {
+    if (exceptions[i]) {
+      std::rethrow_exception(exceptions[i]);
+    }
+  }
+}
+
+/**
+ * @brief デフォルトのConfigオブジェクトの設定に従って、指定された入力ストリームの末尾から指定された数のCSVレコードを読み込んで返します。
+ * @param stream 入力ストリーム
+ * @param count CSVレコードの数
+ * @param csv CSVデータ
+ * @exception std::ios_base::failure 入力ストリームにエラーが発生した場合
+ */
+void Util::tail(std::istream& stream,
+		const std::size_t count,
+		std::vector<std::vector<std::string> >& csv)
+{
+  tail(stream, DEFAULT_CONFIG, count, csv);
+}
+
+/**
+ * @brief 指定されたConfigオブジェクトの設定に従って、指定された入力ストリームの末尾から指定された数のCSVレコードを読み込んで返します。
+ *
+ * 入力ストリームを末尾からブロック単位で遡ってCRLFを探し、その直後から次のレコード境界まで前向きに走査して本当にレコード境界かどうかを確認します。
+ * 指定された数のレコード境界が見つかった位置から、Readerクラスで前向きに読み込みます。
+ * 入力ストリームはシーク可能で、その末尾が囲み文字の外で終わっている必要があります。
+ * @param stream 入力ストリーム
+ * @param config Configオブジェクト
+ * @param count CSVレコードの数
+ * @param csv CSVデータ
+ * @exception std::ios_base::failure 入力ストリームにエラーが発生した場合
+ */
+void Util::tail(std::istream& stream,
+		const Config& config,
+		const std::size_t count,
+		std::vector<std::vector<std::string> >& csv)
+{
+  csv.clear();
+
+  if (count == 0) {
+    return;
+  }
+
+  stream.seekg(0, std::ios_base::end);
+  const std::streamoff size = stream.tellg();
+  if (stream.fail() || stream.bad() || size < 0) {
+    throw std::ios_base::failure("Failed to seek.");
+  }
+
+  Scanner scanner(config);
+  std::string buffer;                 // [base, size) of the stream
+  std::streamoff base = size;
+  std::streamoff blockSize = TAIL_BLOCK_SIZE;
+  std::streamoff candidate = size;
+  std::map<std::streamoff, std::size_t> boundaries; // verified record boundary -> records after it
+  boundaries[size] = 0;
+
+  while (boundaries.begin()->second < count && candidate > 0) {
+    const std::streamoff next = candidate - 1;
+    if (next >= 2 && next - 2 < base) {
+      const std::streamoff begin = (base > blockSize) ? base - blockSize : 0;
+      std::string block(static_cast<std::size_t>(base - begin), '\0');
+      stream.clear();
+      stream.seekg(begin);
+      stream.read(&block[0], block.size());
+      if (stream.gcount() != static_cast<std::streamsize>(block.size())) {
+	throw std::ios_base::failure("Failed to read.");
+      }
+      buffer.insert(0, block);
+      base = begin;
+      blockSize *= 2;
+      continue;
+    }
+
+    candidate = next;
+    if (candidate > 0
+	&& (candidate < 2
+	    || buffer[candidate - 2 - base] != '\r'
+	    || buffer[candidate - 1 - base] != '\n')) {
+      continue;
+    }
+
+    // verify the candidate by parsing forward until a verified boundary is reached
+    std::streamoff position = candidate;
+    std::size_t records = 0;
+    bool valid = true;
+    while (valid && boundaries.find(position) == boundaries.end()) {
+      bool quoteFlag;
+      const std::size_t end = scanner.scan(buffer.data(),
+					      static_cast<std::size_t>(position - base),
+					      static_cast<std::size_t>(size - base),
+					      quoteFlag);
+      if (end == Scanner::npos && quoteFlag) {
+	valid = false; // a quoted field never ends at end of file
+	break;
+      }
+
+      const std::streamoff last = (end == Scanner::npos) ? size : base + static_cast<std::streamoff>(end);
+      typedef std::map<std::streamoff, std::size_t>::const_iterator iterator;
+      for (iterator i = boundaries.upper_bound(position); i != boundaries.end() && i->first < last; i++) {
+	// only the end of a leading comment line may lie inside a record
+	if (!isCommentLine(buffer, base, position, i->first, config)) {
+	  valid = false;
+	  break;
+	}
+      }
+      position = last;
+      records++;
+    }
+
+    if (valid) {
+      boundaries.erase(boundaries.begin(), boundaries.find(position));
+      boundaries[candidate] = records + boundaries[position];
+    }
+  }
+
+  const std::streamoff start = boundaries.begin()->first;
+  std::istringstream input(buffer.substr(static_cast<std::size_t>(start - base)));
+  Reader reader(input, config);
+  std::vector<std::string> record;
+
+  while (reader.hasNext()) {
+    reader.read(record);
+    csv.push_back(record);
+    record.clear();
+  }
+
+  if (csv.size() > count) {
+    csv.erase(csv.begin(), csv.end() - count);
+  }
+}
+
+/**
+ * @brief デフォルトのConfigオブジェクトの設定に従って、指定されたファイルの末尾から指定された数のCSVレコードを読み込んで返します。
+ * @param filepath ファイルパス
+ * @param count CSVレコードの数
+ * @param csv CSVデータ
+ * @exception std::ios_base::failure 入力ストリームにエラーが発生した場合
+ */
+void Util::tail(const std::string& filepath,
+		const std::size_t count,
+		std::vector<std::vector<std::string> >& csv)
+{
+  tail(filepath, DEFAULT_CONFIG, count, csv);
+}
+
+/**
+ * @brief 指定されたConfigオブジェクトの設定に従って、指定されたファイルの末尾から指定された数のCSVレコードを読み込んで返します。
+ * @param filepath ファイルパス
+ * @param config Configオブジェクト
+ * @param count CSVレコードの数
+ * @param csv CSVデータ
+ * @exception std::ios_base::failure 入力ストリームにエラーが発生した場合
+ */
+void Util::tail(const std::string& filepath,
+		const Config& config,
+		const std::size_t count,
+		std::vector<std::vector<std::string> >& csv)
+{
+  struct stat st;
+  if (stat(filepath.c_str(), &st) != 0 || !S_ISREG(st.st_mode)) {
+    throw std::ios_base::failure("Failed to open file for reading: " + filepath);
+  }
+
+  std::ifstream stream(filepath.c_str(), std::ifstream::binary);
+
+  if (!stream.is_open()) {
+    throw std::ios_base::failure("Failed to open file for reading: " + filepath);
+  }
+
+  try {
+    tail(stream, config, count, csv);
+  } catch (...) {
+    stream.close();
+    throw;
+  }
+
+  stream.close();
+}
+
 /**
  * @brief デフォルトのConfigオブジェクトの設定に従って、指定された出力ストリームにCSVデータを書き込みます。
  * @param stream 出力ストリーム
@@ -160,5 +1054,98 @@ void Util::save(const std::string& filepath,
   stream.close();
 }
 
+/**
+ * @brief 指定されたConfigオブジェクトの設定に従って、指定された出力ストリームにCSVデータを書き込み、統計情報を加算します。
+ *
+ * 出力ストリームへの書き込みにかかった時間を入出力の待ち時間として、それ以外を解析(整形)の時間として加算します。
+ * @param stream 出力ストリーム
+ * @param config Configオブジェクト
+ * @param csv CSVデータ
+ * @param stats Statsオブジェクト
+ * @exception std::ios_base::failure 出力ストリームにエラーが発生した場合
+ */
+void Util::save(std::ostream& stream,
+		const Config& config,
+		const std::vector<std::vector<std::string> >& csv,
+		Stats& stats)
+{
+  TimedOutputBuffer buffer(stream.rdbuf(), stats);
+  std::ostream timed(&buffer);
+  Writer writer(timed, config);
+
+  writer.setStats(&stats);
+  typedef std::vector<std::vector<std::string> >::const_iterator iterator;
+  for (iterator i = csv.begin(); i != csv.end(); i++) {
+    writer.write(*i);
+  }
+
+  timed.flush();
+  if (timed.fail() || timed.bad()) {
+    stream.setstate(std::ios_base::badbit);
+    throw std::ios_base::failure("Failed to write.");
+  }
+}
+
+/**
+ * @brief 指定されたConfigオブジェクトの設定に従って、指定されたファイルにCSVデータを書き込み、統計情報を加算します。
+ * @param filepath ファイルパス
+ * @param config Configオブジェクト
+ * @param csv CSVデータ
+ * @param stats Statsオブジェクト
+ * @exception std::ios_base::failure 出力ストリームにエラーが発生した場合
+ */
+void Util::save(const std::string& filepath,
+		const Config& config,
+		const std::vector<std::vector<std::string> >& csv,
+		Stats& stats)
+{
+  std::ofstream stream(filepath.c_str(), std::ofstream::binary);
+
+  if (!stream.is_open()) {
+    throw std::ios_base::failure("Failed to open file for writing: " + filepath);
+  }
+
+  try {
+    save(stream, config, csv, stats);
+  } catch (...) {
+    stream.close();
+    throw;
+  }
+
+  stream.close();
+}
+
+/**
+ * @brief フィールド全体を数値として解釈します。
+ *
+ * strtodの形式(無限大を含む)を受け付けます。空のフィールド、先頭の空白、NaN、数値の後に続く文字は数値として扱いません。
+ * @param data フィールドの先頭
+ * @param size フィールドのバイト数
+ * @param number 数値
+ * @return 数値の場合はtrue、それ以外の場合はfalse
+ */
+bool Util::parseNumber(const char* data, const std::size_t size, double& number)
+{
+  if (size == 0 || std::isspace(static_cast<unsigned char>(data[0]))) {
+    return false;
+  }
+
+  // strtod needs a terminated copy, short fields stay on the stack
+  char buffer[NUMBER_BUFFER_SIZE];
+  std::string copy;
+  const char* text = buffer;
+  if (size < NUMBER_BUFFER_SIZE) {
+    std::memcpy(buffer, data, size);
+    buffer[size] = '\0';
+  } else {
+    copy.assign(data, size);
+    text = copy.c_str();
+  }
+
+  char* end = NULL;
+  number = std::strtod(text, &end);
+  return end == text + size && !std::isnan(number);
+}
+
 } // namespace csv
 } // namespace csl
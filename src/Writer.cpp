@@ -3,6 +3,7 @@
  * @brief Writerクラス実装ファイル
  */
 #include "csl/csv/Writer.hpp"
+#include <chrono>
 
 namespace csl {
 namespace csv {
@@ -14,6 +15,7 @@ namespace csv {
 Writer::Writer(std::ostream& stream)
   : stream(stream)
   , config(DEFAULT_CONFIG)
+  , stats(NULL)
 {
 }
 
@@ -25,6 +27,7 @@ Writer::Writer(std::ostream& stream)
 Writer::Writer(std::ostream& stream, const Config& config)
   : stream(stream)
   , config(config)
+  , stats(NULL)
 {
 }
 
@@ -37,18 +40,42 @@ Writer::~Writer(void)
 
 /**
  * @brief 出力ストリームにCSVレコードを書き込みます。
+ *
+ * 囲み文字が有効な場合は、フィールドの中の囲み文字を2つ重ねてエスケープします。
  * @param record CSVレコード
  * @exception std::ios_base::failure 出力ストリームにエラーが発生した場合
  */
 void Writer::write(const std::vector<std::string>& record)
 {
+  std::chrono::steady_clock::time_point begin;
+  unsigned long long ioTime = 0;
+  std::size_t escapedQuotes = 0;
+
+  if (stats != NULL) {
+    begin = std::chrono::steady_clock::now();
+    ioTime = stats->ioTime;
+  }
+
   for (int i = 0; i < (int)record.size(); i++) {
     if (i > 0) {
       stream << config.getDelimitMark();
     }
 
     if (config.getQuoteEnabled()) {
-      stream << config.getQuoteMark() << record[i] << config.getQuoteMark();
+      const char quoteMark = config.getQuoteMark();
+      const std::string& field = record[i];
+      std::size_t from = 0;
+      std::size_t quote;
+
+      stream << quoteMark;
+      while ((quote = field.find(quoteMark, from)) != std::string::npos) {
+	stream.write(field.data() + from, quote + 1 - from);
+	stream << quoteMark;
+	escapedQuotes++;
+	from = quote + 1;
+      }
+      stream.write(field.data() + from, field.size() - from);
+      stream << quoteMark;
     } else {
       stream << record[i];
     }
@@ -59,6 +86,42 @@ void Writer::write(const std::vector<std::string>& record)
   if (stream.fail() || stream.bad()) {
     throw std::ios_base::failure("Failed to write.");
   }
+
+  if (stats != NULL) {
+    const unsigned long long elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>
+      (std::chrono::steady_clock::now() - begin).count();
+    const unsigned long long waited = stats->ioTime - ioTime;
+    std::size_t length = 2 + escapedQuotes; // CRLF
+
+    for (std::size_t i = 0; i < record.size(); i++) {
+      length += record[i].size() + (i > 0 ? 1 : 0) + (config.getQuoteEnabled() ? 2 : 0);
+      if (record[i].size() > stats->maxFieldLength) {
+	stats->maxFieldLength = record[i].size();
+      }
+    }
+
+    stats->bytes += length;
+    stats->records++;
+    stats->fields += record.size();
+    stats->quotedFields += config.getQuoteEnabled() ? record.size() : 0;
+    stats->escapedQuotes += escapedQuotes;
+    if (length > stats->maxRecordLength) {
+      stats->maxRecordLength = length;
+    }
+    stats->parseTime += (elapsed > waited) ? elapsed - waited : 0;
+  }
+}
+
+/**
+ * @brief 書き込んだCSVデータの統計情報を加算するStatsオブジェクトを設定します。
+ *
+ * 設定しない場合(NULLの場合)は統計情報を集計しません。
+ * 解析の時間には、CSVレコードの整形にかかった時間を加算します。
+ * @param stats Statsオブジェクト、またはNULL
+ */
+void Writer::setStats(Stats* stats)
+{
+  this->stats = stats;
 }
 
 } // namespace csv
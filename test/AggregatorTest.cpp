@@ -0,0 +1,214 @@
+#include <cppunit/extensions/HelperMacros.h>
+#include "csl/csv/Aggregator.hpp"
+#include "csl/csv/Util.hpp"
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace csl {
+namespace csv {
+
+class AggregatorTest : public CPPUNIT_NS::TestFixture
+{
+  CPPUNIT_TEST_SUITE(AggregatorTest);
+  CPPUNIT_TEST(testAggregate);
+  CPPUNIT_TEST(testAggregateWithoutGroup);
+  CPPUNIT_TEST(testAggregateGroups);
+  CPPUNIT_TEST(testAggregateFile);
+  CPPUNIT_TEST(testAggregateFileThrowFailure);
+  CPPUNIT_TEST(testWrite);
+  CPPUNIT_TEST(testClear);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  virtual void setUp(void);
+  virtual void tearDown(void);
+
+private:
+  void testAggregate(void);
+  void testAggregateWithoutGroup(void);
+  void testAggregateGroups(void);
+  void testAggregateFile(void);
+  void testAggregateFileThrowFailure(void);
+  void testWrite(void);
+  void testClear(void);
+
+private:
+  std::vector<std::string> makeRecord(const std::string& a, const std::string& b);
+  void addAggregates(Aggregator& aggregator);
+
+private:
+  std::string filepath;
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(AggregatorTest);
+
+void AggregatorTest::setUp(void)
+{
+  filepath = "./test/aggregate.csv";
+}
+
+void AggregatorTest::tearDown(void)
+{
+  std::remove(filepath.c_str());
+}
+
+std::vector<std::string> AggregatorTest::makeRecord(const std::string& a, const std::string& b)
+{
+  std::vector<std::string> record;
+  record.push_back(a);
+  record.push_back(b);
+  return record;
+}
+
+void AggregatorTest::addAggregates(Aggregator& aggregator)
+{
+  aggregator.addAggregate(Aggregator::FUNCTION_COUNT, 0);
+  aggregator.addAggregate(Aggregator::FUNCTION_SUM, 1);
+  aggregator.addAggregate(Aggregator::FUNCTION_MIN, 1);
+  aggregator.addAggregate(Aggregator::FUNCTION_MAX, 1);
+}
+
+void AggregatorTest::testAggregate(void)
+{
+  Aggregator aggregator;
+  aggregator.addGroup(0);
+  addAggregates(aggregator);
+
+  std::istringstream stream("Tokyo,10\r\nOsaka,5\r\nTokyo,x\r\n\r\nTokyo,2.5\r\nOsaka,\"7\"\r\nNagoya\r\n");
+  aggregator.aggregate(stream);
+  CPPUNIT_ASSERT_EQUAL((std::size_t)3, aggregator.size());
+
+  std::vector<std::vector<std::string> > csv;
+  aggregator.getResult(csv);
+  CPPUNIT_ASSERT_EQUAL((std::size_t)3, csv.size());
+
+  const char* tokyo[] = {"Tokyo", "3", "12.5", "2.5", "10"};
+  const char* osaka[] = {"Osaka", "2", "12", "5", "7"};
+  const char* nagoya[] = {"Nagoya", "1", "0", "", ""};
+  CPPUNIT_ASSERT(csv[0] == std::vector<std::string>(tokyo, tokyo + 5));
+  CPPUNIT_ASSERT(csv[1] == std::vector<std::string>(osaka, osaka + 5));
+  CPPUNIT_ASSERT(csv[2] == std::vector<std::string>(nagoya, nagoya + 5));
+}
+
+void AggregatorTest::testAggregateWithoutGroup(void)
+{
+  Aggregator aggregator;
+  addAggregates(aggregator);
+
+  std::istringstream stream("a,-1\r\nb,0.1\r\nc,0.2\r\n");
+  aggregator.aggregate(stream);
+
+  std::vector<std::vector<std::string> > csv;
+  aggregator.getResult(csv);
+  CPPUNIT_ASSERT_EQUAL((std::size_t)1, csv.size());
+
+  const char* total[] = {"3", "-0.7", "-1", "0.2"};
+  CPPUNIT_ASSERT(csv[0] == std::vector<std::string>(total, total + 4));
+}
+
+void AggregatorTest::testAggregateGroups(void)
+{
+  Aggregator aggregator;
+  aggregator.addGroup(1);
+  aggregator.addGroup(0);
+  aggregator.addAggregate(Aggregator::FUNCTION_COUNT, 0);
+
+  std::istringstream stream("\"a,b\",x\r\na,\"b,x\"\r\n\"a,b\",x\r\nc\r\n");
+  aggregator.aggregate(stream);
+
+  std::vector<std::vector<std::string> > csv;
+  aggregator.getResult(csv);
+  CPPUNIT_ASSERT_EQUAL((std::size_t)3, csv.size());
+
+  const char* first[] = {"x", "a,b", "2"};
+  const char* second[] = {"b,x", "a", "1"};
+  const char* third[] = {"", "c", "1"};
+  CPPUNIT_ASSERT(csv[0] == std::vector<std::string>(first, first + 3));
+  CPPUNIT_ASSERT(csv[1] == std::vector<std::string>(second, second + 3));
+  CPPUNIT_ASSERT(csv[2] == std::vector<std::string>(third, third + 3));
+}
+
+void AggregatorTest::testAggregateFile(void)
+{
+  std::vector<std::vector<std::string> > csv;
+  for (int i = 0; i < 20000; i++) {
+    std::ostringstream group;
+    std::ostringstream value;
+    group << "g" << (i * 7) % 101;
+    value << (i % 13) - 6;
+    csv.push_back(makeRecord(group.str(), value.str()));
+  }
+  Util::save(filepath, csv);
+
+  Aggregator serial;
+  serial.addGroup(0);
+  addAggregates(serial);
+  serial.aggregate(filepath);
+
+  Aggregator parallel;
+  parallel.addGroup(0);
+  addAggregates(parallel);
+  parallel.setThreadCount(4);
+  parallel.aggregate(filepath);
+
+  std::vector<std::vector<std::string> > expected;
+  std::vector<std::vector<std::string> > result;
+  serial.getResult(expected);
+  parallel.getResult(result);
+  CPPUNIT_ASSERT_EQUAL((std::size_t)101, result.size());
+  CPPUNIT_ASSERT(result == expected);
+  CPPUNIT_ASSERT_EQUAL(std::string("g0"), result[0][0]);
+  CPPUNIT_ASSERT_EQUAL(std::string("g7"), result[1][0]);
+}
+
+void AggregatorTest::testAggregateFileThrowFailure(void)
+{
+  Aggregator aggregator;
+
+  try {
+    aggregator.aggregate("./");
+    CPPUNIT_FAIL("std::ios_base::failure must be throw.");
+  } catch (std::ios_base::failure&) {
+    CPPUNIT_ASSERT(true);
+  }
+}
+
+void AggregatorTest::testWrite(void)
+{
+  Aggregator aggregator;
+  aggregator.addGroup(0);
+  aggregator.addAggregate(Aggregator::FUNCTION_SUM, 1);
+
+  std::istringstream in("a,1\r\nb,2\r\na,3\r\n");
+  aggregator.aggregate(in);
+
+  std::ostringstream out;
+  Writer writer(out);
+  aggregator.write(writer);
+  CPPUNIT_ASSERT_EQUAL(std::string("\"a\",\"4\"\r\n\"b\",\"2\"\r\n"), out.str());
+}
+
+void AggregatorTest::testClear(void)
+{
+  Aggregator aggregator;
+  aggregator.addGroup(0);
+
+  std::istringstream first("a\r\nb\r\n");
+  aggregator.aggregate(first);
+  std::istringstream second("c\r\na\r\n");
+  aggregator.aggregate(second);
+  CPPUNIT_ASSERT_EQUAL((std::size_t)3, aggregator.size());
+
+  aggregator.clear();
+  CPPUNIT_ASSERT_EQUAL((std::size_t)0, aggregator.size());
+
+  aggregator.addAggregate(Aggregator::FUNCTION_COUNT, 0);
+  std::istringstream third("a\r\n");
+  aggregator.aggregate(third);
+  CPPUNIT_ASSERT_EQUAL((std::size_t)1, aggregator.size());
+}
+
+} // namespace csv
+} // namespace csl
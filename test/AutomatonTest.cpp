@@ -0,0 +1,153 @@
+#include <cppunit/extensions/HelperMacros.h>
+#include "csl/csv/Automaton.hpp"
+#include <string>
+#include "csl/csv/Config.hpp"
+
+namespace csl {
+namespace csv {
+
+class AutomatonTest : public CPPUNIT_NS::TestFixture
+{
+  CPPUNIT_TEST_SUITE(AutomatonTest);
+  CPPUNIT_TEST(testAutomaton);
+  CPPUNIT_TEST(testAutomatonConfig);
+  CPPUNIT_TEST(testClassify);
+  CPPUNIT_TEST(testClassifyQuoteDisabled);
+  CPPUNIT_TEST(testCompile);
+  CPPUNIT_TEST(testStep);
+  CPPUNIT_TEST(testStepAfterCr);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  virtual void setUp(void);
+  virtual void tearDown(void);
+
+private:
+  void testAutomaton(void);
+  void testAutomatonConfig(void);
+  void testClassify(void);
+  void testClassifyQuoteDisabled(void);
+  void testCompile(void);
+  void testStep(void);
+  void testStepAfterCr(void);
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(AutomatonTest);
+
+void AutomatonTest::setUp(void)
+{
+}
+
+void AutomatonTest::tearDown(void)
+{
+}
+
+void AutomatonTest::testAutomaton(void)
+{
+  Automaton automaton;
+
+  CPPUNIT_ASSERT_EQUAL((unsigned char)Automaton::CLASS_DELIMIT, automaton.classify(','));
+}
+
+void AutomatonTest::testAutomatonConfig(void)
+{
+  Config config('\t');
+  Automaton automaton(config);
+
+  CPPUNIT_ASSERT_EQUAL((unsigned char)Automaton::CLASS_DELIMIT, automaton.classify('\t'));
+  CPPUNIT_ASSERT_EQUAL((unsigned char)Automaton::CLASS_OTHER, automaton.classify(','));
+}
+
+void AutomatonTest::testClassify(void)
+{
+  Automaton automaton;
+
+  CPPUNIT_ASSERT_EQUAL((unsigned char)Automaton::CLASS_OTHER, automaton.classify('a'));
+  CPPUNIT_ASSERT_EQUAL((unsigned char)Automaton::CLASS_OTHER, automaton.classify('\0'));
+  CPPUNIT_ASSERT_EQUAL((unsigned char)Automaton::CLASS_OTHER, automaton.classify('\xff'));
+  CPPUNIT_ASSERT_EQUAL((unsigned char)Automaton::CLASS_OTHER, automaton.classify('#'));
+  CPPUNIT_ASSERT_EQUAL((unsigned char)Automaton::CLASS_DELIMIT, automaton.classify(','));
+  CPPUNIT_ASSERT_EQUAL((unsigned char)Automaton::CLASS_QUOTE, automaton.classify('"'));
+  CPPUNIT_ASSERT_EQUAL((unsigned char)Automaton::CLASS_CR, automaton.classify('\r'));
+  CPPUNIT_ASSERT_EQUAL((unsigned char)Automaton::CLASS_LF, automaton.classify('\n'));
+}
+
+void AutomatonTest::testClassifyQuoteDisabled(void)
+{
+  Config config;
+  config.setQuoteEnabled(false);
+  Automaton automaton(config);
+
+  CPPUNIT_ASSERT_EQUAL((unsigned char)Automaton::CLASS_OTHER, automaton.classify('"'));
+  CPPUNIT_ASSERT_EQUAL((unsigned char)Automaton::CLASS_DELIMIT, automaton.classify(','));
+}
+
+void AutomatonTest::testCompile(void)
+{
+  Config config;
+  config.setDelimitMark(';');
+  config.setQuoteMark('\'');
+  Automaton automaton;
+  automaton.compile(config);
+
+  CPPUNIT_ASSERT_EQUAL((unsigned char)Automaton::CLASS_DELIMIT, automaton.classify(';'));
+  CPPUNIT_ASSERT_EQUAL((unsigned char)Automaton::CLASS_QUOTE, automaton.classify('\''));
+  CPPUNIT_ASSERT_EQUAL((unsigned char)Automaton::CLASS_OTHER, automaton.classify(','));
+  CPPUNIT_ASSERT_EQUAL((unsigned char)Automaton::CLASS_OTHER, automaton.classify('"'));
+}
+
+void AutomatonTest::testStep(void)
+{
+  // a,"b""c"\r\n
+  const std::string data("a,\"b\"\"c\"\r\n");
+  const unsigned char states[] = {
+    Automaton::STATE_NORMAL, Automaton::STATE_NORMAL, Automaton::STATE_QUOTE, Automaton::STATE_QUOTE,
+    Automaton::STATE_ESCAPE, Automaton::STATE_QUOTE, Automaton::STATE_QUOTE, Automaton::STATE_ESCAPE,
+    Automaton::STATE_AFTER_CR, Automaton::STATE_NORMAL,
+  };
+  const unsigned char actions[] = {
+    Automaton::ACTION_APPEND, Automaton::ACTION_END_FIELD, Automaton::ACTION_QUOTED, Automaton::ACTION_APPEND,
+    0, Automaton::ACTION_APPEND | Automaton::ACTION_ESCAPED, Automaton::ACTION_APPEND, 0,
+    0, Automaton::ACTION_END_RECORD,
+  };
+  Automaton automaton;
+  unsigned char state = Automaton::STATE_NORMAL;
+
+  for (std::size_t i = 0; i < data.size(); i++) {
+    const Automaton::Transition transition = automaton.step(state, data[i]);
+    CPPUNIT_ASSERT_EQUAL(states[i], transition.state);
+    CPPUNIT_ASSERT_EQUAL(actions[i], transition.actions);
+    state = transition.state;
+  }
+}
+
+void AutomatonTest::testStepAfterCr(void)
+{
+  Automaton automaton;
+  Automaton::Transition transition;
+
+  transition = automaton.step(Automaton::STATE_AFTER_CR, 'a');
+  CPPUNIT_ASSERT_EQUAL((unsigned char)Automaton::STATE_NORMAL, transition.state);
+  CPPUNIT_ASSERT_EQUAL((unsigned char)(Automaton::ACTION_APPEND_CR
+				       | Automaton::ACTION_APPEND
+				       | Automaton::ACTION_LINE_BREAK),
+		       transition.actions);
+
+  transition = automaton.step(Automaton::STATE_AFTER_CR, ',');
+  CPPUNIT_ASSERT_EQUAL((unsigned char)Automaton::STATE_NORMAL, transition.state);
+  CPPUNIT_ASSERT_EQUAL((unsigned char)(Automaton::ACTION_APPEND_CR
+				       | Automaton::ACTION_END_FIELD
+				       | Automaton::ACTION_LINE_BREAK),
+		       transition.actions);
+
+  transition = automaton.step(Automaton::STATE_AFTER_CR, '\r');
+  CPPUNIT_ASSERT_EQUAL((unsigned char)Automaton::STATE_AFTER_CR, transition.state);
+
+  transition = automaton.step(Automaton::STATE_QUOTE, '\r');
+  CPPUNIT_ASSERT_EQUAL((unsigned char)Automaton::STATE_QUOTE, transition.state);
+  CPPUNIT_ASSERT_EQUAL((unsigned char)(Automaton::ACTION_APPEND | Automaton::ACTION_LINE_BREAK),
+		       transition.actions);
+}
+
+} // namespace csv
+} // namespace csl
@@ -0,0 +1,342 @@
+#include <cppunit/extensions/HelperMacros.h>
+#include "csl/csv/CachedTable.hpp"
+#include "csl/csv/Util.hpp"
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/stat.h>
+
+namespace csl {
+namespace csv {
+
+class CachedTableTest : public CPPUNIT_NS::TestFixture
+{
+  CPPUNIT_TEST_SUITE(CachedTableTest);
+  CPPUNIT_TEST(testSave);
+  CPPUNIT_TEST(testSaveRagged);
+  CPPUNIT_TEST(testSaveEmpty);
+  CPPUNIT_TEST(testIntegerColumn);
+  CPPUNIT_TEST(testGetThrowOutOfRange);
+  CPPUNIT_TEST(testGetThrowInvalidArgument);
+  CPPUNIT_TEST(testIsFresh);
+  CPPUNIT_TEST(testIsFreshConfig);
+  CPPUNIT_TEST(testRebuild);
+  CPPUNIT_TEST(testRebuildCorrupted);
+  CPPUNIT_TEST(testCorruptedFieldCount);
+  CPPUNIT_TEST(testCachedTableThrowIosBaseFailure);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  virtual void setUp(void);
+  virtual void tearDown(void);
+
+private:
+  void testSave(void);
+  void testSaveRagged(void);
+  void testSaveEmpty(void);
+  void testIntegerColumn(void);
+  void testGetThrowOutOfRange(void);
+  void testGetThrowInvalidArgument(void);
+  void testIsFresh(void);
+  void testIsFreshConfig(void);
+  void testRebuild(void);
+  void testRebuildCorrupted(void);
+  void testCorruptedFieldCount(void);
+  void testCachedTableThrowIosBaseFailure(void);
+
+private:
+  void writeFile(const std::string& filepath, const std::string& data);
+  void touchFile(const std::string& filepath, const time_t mtime);
+
+private:
+  std::string filepath;
+  std::string cachepath;
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(CachedTableTest);
+
+void CachedTableTest::setUp(void)
+{
+  filepath = "./test/cache.csv";
+  cachepath = "./test/cache.bin";
+  writeFile(filepath, "1,Tokyo,\"a,b\"\r\n2,Osaka,\"c\"\"d\"\r\n3,Tokyo,e\r\n");
+  std::remove(cachepath.c_str());
+}
+
+void CachedTableTest::tearDown(void)
+{
+  std::remove(filepath.c_str());
+  std::remove(cachepath.c_str());
+}
+
+void CachedTableTest::writeFile(const std::string& filepath, const std::string& data)
+{
+  std::ofstream stream(filepath.c_str(), std::ofstream::binary | std::ofstream::trunc);
+  stream << data;
+  stream.close();
+}
+
+void CachedTableTest::touchFile(const std::string& filepath, const time_t mtime)
+{
+  struct timespec times[2];
+  times[0].tv_sec = mtime;
+  times[0].tv_nsec = 0;
+  times[1] = times[0];
+  utimensat(AT_FDCWD, filepath.c_str(), times, 0);
+}
+
+void CachedTableTest::testSave(void)
+{
+  std::vector<std::vector<std::string> > csv;
+  Util::load(filepath, csv);
+  CachedTable::save(cachepath, filepath, csv);
+
+  CachedTable table(cachepath);
+  CPPUNIT_ASSERT(!table.isRebuilt());
+  CPPUNIT_ASSERT_EQUAL((std::size_t)3, table.getRowCount());
+  CPPUNIT_ASSERT_EQUAL((std::size_t)3, table.getColumnCount());
+  CPPUNIT_ASSERT_EQUAL((std::size_t)3, table.getFieldCount(1));
+
+  CPPUNIT_ASSERT(table.isInteger(0));
+  CPPUNIT_ASSERT(!table.isInteger(1));
+  CPPUNIT_ASSERT_EQUAL((std::int64_t)2, table.getInteger(1, 0));
+  CPPUNIT_ASSERT_EQUAL(std::string("2"), table.get(1, 0));
+  CPPUNIT_ASSERT_EQUAL(std::string("Osaka"), table.get(1, 1));
+  CPPUNIT_ASSERT_EQUAL(std::string("a,b"), table.get(0, 2));
+  CPPUNIT_ASSERT_EQUAL(std::string("c\"d"), table.get(1, 2));
+  CPPUNIT_ASSERT_EQUAL(std::string("Tokyo"), std::string(table.getData(2, 1), table.getSize(2, 1)));
+
+  std::vector<std::string> record;
+  for (std::size_t i = 0; i < csv.size(); i++) {
+    table.getRecord(i, record);
+    CPPUNIT_ASSERT(record == csv[i]);
+  }
+}
+
+void CachedTableTest::testSaveRagged(void)
+{
+  std::vector<std::vector<std::string> > csv;
+  std::vector<std::string> record;
+  record.push_back("1");
+  csv.push_back(record);
+  record.push_back("x");
+  record.push_back("");
+  csv.push_back(record);
+  CachedTable::save(cachepath, filepath, csv);
+
+  CachedTable table(cachepath);
+  CPPUNIT_ASSERT_EQUAL((std::size_t)2, table.getRowCount());
+  CPPUNIT_ASSERT_EQUAL((std::size_t)3, table.getColumnCount());
+  CPPUNIT_ASSERT_EQUAL((std::size_t)1, table.getFieldCount(0));
+  CPPUNIT_ASSERT_EQUAL((std::size_t)3, table.getFieldCount(1));
+  CPPUNIT_ASSERT(!table.isInteger(1));
+  CPPUNIT_ASSERT_EQUAL(std::string("x"), table.get(1, 1));
+  CPPUNIT_ASSERT_EQUAL(std::string(""), table.get(1, 2));
+
+  table.getRecord(0, record);
+  CPPUNIT_ASSERT(record == csv[0]);
+}
+
+void CachedTableTest::testSaveEmpty(void)
+{
+  std::vector<std::vector<std::string> > csv;
+  CachedTable::save(cachepath, filepath, csv);
+
+  CachedTable table(cachepath);
+  CPPUNIT_ASSERT_EQUAL((std::size_t)0, table.getRowCount());
+  CPPUNIT_ASSERT_EQUAL((std::size_t)0, table.getColumnCount());
+}
+
+void CachedTableTest::testIntegerColumn(void)
+{
+  const char* values[] = {"-9223372036854775808", "9223372036854775807", "007", "-0", "+1", "1e3", "", "9223372036854775808"};
+  const bool integers[] = {true, true, false, false, false, false, false, false};
+
+  for (std::size_t i = 0; i < sizeof(values) / sizeof(values[0]); i++) {
+    std::vector<std::vector<std::string> > csv;
+    std::vector<std::string> record;
+    record.push_back("0");
+    csv.push_back(record);
+    record[0] = values[i];
+    csv.push_back(record);
+    CachedTable::save(cachepath, filepath, csv);
+
+    CachedTable table(cachepath);
+    CPPUNIT_ASSERT_EQUAL(integers[i], table.isInteger(0));
+    CPPUNIT_ASSERT_EQUAL(std::string(values[i]), table.get(1, 0));
+  }
+}
+
+void CachedTableTest::testGetThrowOutOfRange(void)
+{
+  std::vector<std::vector<std::string> > csv;
+  Util::load(filepath, csv);
+  CachedTable::save(cachepath, filepath, csv);
+  CachedTable table(cachepath);
+
+  try {
+    table.get(3, 0);
+    CPPUNIT_FAIL("std::out_of_range must be throw.");
+  } catch (std::out_of_range&) {
+    CPPUNIT_ASSERT(true);
+  }
+
+  try {
+    table.get(0, 3);
+    CPPUNIT_FAIL("std::out_of_range must be throw.");
+  } catch (std::out_of_range&) {
+    CPPUNIT_ASSERT(true);
+  }
+}
+
+void CachedTableTest::testGetThrowInvalidArgument(void)
+{
+  std::vector<std::vector<std::string> > csv;
+  Util::load(filepath, csv);
+  CachedTable::save(cachepath, filepath, csv);
+  CachedTable table(cachepath);
+
+  try {
+    table.getData(0, 0);
+    CPPUNIT_FAIL("std::invalid_argument must be throw.");
+  } catch (std::invalid_argument&) {
+    CPPUNIT_ASSERT(true);
+  }
+
+  try {
+    table.getInteger(0, 1);
+    CPPUNIT_FAIL("std::invalid_argument must be throw.");
+  } catch (std::invalid_argument&) {
+    CPPUNIT_ASSERT(true);
+  }
+}
+
+void CachedTableTest::testIsFresh(void)
+{
+  Config config;
+  CPPUNIT_ASSERT(!CachedTable::isFresh(cachepath, filepath, config));
+
+  std::vector<std::vector<std::string> > csv;
+  Util::load(filepath, csv);
+  CachedTable::save(cachepath, filepath, csv);
+  CPPUNIT_ASSERT(CachedTable::isFresh(cachepath, filepath, config));
+
+  // same size, different contents
+  writeFile(filepath, "1,Tokyo,\"a,b\"\r\n2,Osaka,\"c\"\"d\"\r\n4,Tokyo,e\r\n");
+  touchFile(filepath, 1000000000);
+  CPPUNIT_ASSERT(!CachedTable::isFresh(cachepath, filepath, config));
+
+  // same contents, touched
+  writeFile(filepath, "1,Tokyo,\"a,b\"\r\n2,Osaka,\"c\"\"d\"\r\n3,Tokyo,e\r\n");
+  touchFile(filepath, 1000000001);
+  CPPUNIT_ASSERT(CachedTable::isFresh(cachepath, filepath, config));
+}
+
+void CachedTableTest::testIsFreshConfig(void)
+{
+  std::vector<std::vector<std::string> > csv;
+  Util::load(filepath, csv);
+  CachedTable::save(cachepath, filepath, csv);
+
+  Config config;
+  config.setQuoteEnabled(false);
+  CPPUNIT_ASSERT(!CachedTable::isFresh(cachepath, filepath, config));
+}
+
+void CachedTableTest::testRebuild(void)
+{
+  {
+    CachedTable table(filepath, cachepath);
+    CPPUNIT_ASSERT(table.isRebuilt());
+    CPPUNIT_ASSERT_EQUAL(std::string("Osaka"), table.get(1, 1));
+  }
+  {
+    CachedTable table(filepath, cachepath);
+    CPPUNIT_ASSERT(!table.isRebuilt());
+    CPPUNIT_ASSERT_EQUAL(std::string("Osaka"), table.get(1, 1));
+  }
+
+  writeFile(filepath, "1,Nagoya\r\n");
+  {
+    CachedTable table(filepath, cachepath);
+    CPPUNIT_ASSERT(table.isRebuilt());
+    CPPUNIT_ASSERT_EQUAL((std::size_t)1, table.getRowCount());
+    CPPUNIT_ASSERT_EQUAL(std::string("Nagoya"), table.get(0, 1));
+  }
+
+  Config config;
+  config.setQuoteEnabled(false);
+  {
+    CachedTable table(filepath, config, cachepath);
+    CPPUNIT_ASSERT(table.isRebuilt());
+  }
+}
+
+void CachedTableTest::testRebuildCorrupted(void)
+{
+  std::vector<std::vector<std::string> > csv;
+  Util::load(filepath, csv);
+  CachedTable::save(cachepath, filepath, csv);
+
+  // keep the header intact so that the cache still looks fresh
+  std::ifstream in(cachepath.c_str(), std::ifstream::binary);
+  std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+  in.close();
+  writeFile(cachepath, data.substr(0, 80));
+
+  try {
+    CachedTable table(cachepath);
+    CPPUNIT_FAIL("std::ios_base::failure must be throw.");
+  } catch (std::ios_base::failure&) {
+    CPPUNIT_ASSERT(true);
+  }
+
+  CachedTable table(filepath, cachepath);
+  CPPUNIT_ASSERT(table.isRebuilt());
+  CPPUNIT_ASSERT_EQUAL(std::string("Osaka"), table.get(1, 1));
+}
+
+void CachedTableTest::testCorruptedFieldCount(void)
+{
+  std::vector<std::vector<std::string> > csv;
+  Util::load(filepath, csv);
+  CachedTable::save(cachepath, filepath, csv);
+
+  // the field count of the first record follows the 72-byte header
+  std::ifstream in(cachepath.c_str(), std::ifstream::binary);
+  std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+  in.close();
+  data.replace(72, 4, "\xff\xff\xff\x7f");
+  writeFile(cachepath, data);
+
+  try {
+    CachedTable table(cachepath);
+    CPPUNIT_FAIL("std::ios_base::failure must be throw.");
+  } catch (std::ios_base::failure&) {
+    CPPUNIT_ASSERT(true);
+  }
+}
+
+void CachedTableTest::testCachedTableThrowIosBaseFailure(void)
+{
+  try {
+    CachedTable table("./");
+    CPPUNIT_FAIL("std::ios_base::failure must be throw.");
+  } catch (std::ios_base::failure&) {
+    CPPUNIT_ASSERT(true);
+  }
+
+  try {
+    CachedTable table("./", cachepath);
+    CPPUNIT_FAIL("std::ios_base::failure must be throw.");
+  } catch (std::ios_base::failure&) {
+    CPPUNIT_ASSERT(true);
+  }
+}
+
+} // namespace csv
+} // namespace csl
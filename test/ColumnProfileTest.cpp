@@ -0,0 +1,95 @@
+#include <cppunit/extensions/HelperMacros.h>
+#include "csl/csv/ColumnProfile.hpp"
+#include <cmath>
+#include <cstring>
+#include <string>
+
+namespace csl {
+namespace csv {
+
+class ColumnProfileTest : public CPPUNIT_NS::TestFixture
+{
+  CPPUNIT_TEST_SUITE(ColumnProfileTest);
+  CPPUNIT_TEST(testAdd);
+  CPPUNIT_TEST(testAddText);
+  CPPUNIT_TEST(testMerge);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  void testAdd(void);
+  void testAddText(void);
+  void testMerge(void);
+
+private:
+  void add(ColumnProfile& profile, const char* value);
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(ColumnProfileTest);
+
+void ColumnProfileTest::add(ColumnProfile& profile, const char* value)
+{
+  profile.add(value, std::strlen(value));
+}
+
+void ColumnProfileTest::testAdd(void)
+{
+  ColumnProfile profile;
+  CPPUNIT_ASSERT_EQUAL((std::size_t)0, profile.getMinLength());
+  CPPUNIT_ASSERT(std::isnan(profile.getMean()));
+
+  add(profile, "10");
+  add(profile, "2.5");
+  add(profile, "");
+  add(profile, "-4");
+  add(profile, "10");
+  add(profile, "n/a");
+  add(profile, " 1");
+  add(profile, "inf");
+  profile.addMissing(2);
+
+  CPPUNIT_ASSERT_EQUAL((std::uint64_t)10, profile.getCount());
+  CPPUNIT_ASSERT_EQUAL((std::uint64_t)3, profile.getEmptyCount());
+  CPPUNIT_ASSERT_EQUAL((std::size_t)0, profile.getMinLength());
+  CPPUNIT_ASSERT_EQUAL((std::size_t)3, profile.getMaxLength());
+  CPPUNIT_ASSERT_EQUAL((std::uint64_t)4, profile.getNumericCount());
+  CPPUNIT_ASSERT_EQUAL(-4.0, profile.getMinimum());
+  CPPUNIT_ASSERT_EQUAL(10.0, profile.getMaximum());
+  CPPUNIT_ASSERT_DOUBLES_EQUAL(4.625, profile.getMean(), 1e-12);
+  CPPUNIT_ASSERT_EQUAL((std::uint64_t)6, profile.getDistinctCount());
+}
+
+void ColumnProfileTest::testAddText(void)
+{
+  ColumnProfile profile;
+  add(profile, "apple");
+  add(profile, "kiwi");
+
+  CPPUNIT_ASSERT_EQUAL((std::uint64_t)2, profile.getCount());
+  CPPUNIT_ASSERT_EQUAL((std::uint64_t)0, profile.getEmptyCount());
+  CPPUNIT_ASSERT_EQUAL((std::size_t)4, profile.getMinLength());
+  CPPUNIT_ASSERT_EQUAL((std::size_t)5, profile.getMaxLength());
+  CPPUNIT_ASSERT_EQUAL((std::uint64_t)0, profile.getNumericCount());
+  CPPUNIT_ASSERT(std::isnan(profile.getMinimum()));
+  CPPUNIT_ASSERT(std::isnan(profile.getQuantile(0.5)));
+}
+
+void ColumnProfileTest::testMerge(void)
+{
+  ColumnProfile a;
+  ColumnProfile b;
+  add(a, "1");
+  add(a, "x");
+  add(b, "3");
+  add(b, "x");
+  b.addMissing(1);
+  a.merge(b);
+
+  CPPUNIT_ASSERT_EQUAL((std::uint64_t)5, a.getCount());
+  CPPUNIT_ASSERT_EQUAL((std::uint64_t)1, a.getEmptyCount());
+  CPPUNIT_ASSERT_EQUAL((std::uint64_t)2, a.getNumericCount());
+  CPPUNIT_ASSERT_EQUAL(2.0, a.getMean());
+  CPPUNIT_ASSERT_EQUAL((std::uint64_t)3, a.getDistinctCount());
+}
+
+} // namespace csv
+} // namespace csl
@@ -0,0 +1,140 @@
+#include <cppunit/extensions/HelperMacros.h>
+#include "csl/csv/Deduplicator.hpp"
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <stdexcept>
+
+namespace csl {
+namespace csv {
+
+class DeduplicatorTest : public CPPUNIT_NS::TestFixture
+{
+  CPPUNIT_TEST_SUITE(DeduplicatorTest);
+  CPPUNIT_TEST(testDedup);
+  CPPUNIT_TEST(testDedupKeys);
+  CPPUNIT_TEST(testDedupLarge);
+  CPPUNIT_TEST(testDedupFile);
+  CPPUNIT_TEST(testDedupFileThrowFailure);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  virtual void setUp(void);
+  virtual void tearDown(void);
+
+private:
+  void testDedup(void);
+  void testDedupKeys(void);
+  void testDedupLarge(void);
+  void testDedupFile(void);
+  void testDedupFileThrowFailure(void);
+
+private:
+  std::string dedup(Deduplicator& deduplicator, const std::string& data);
+
+private:
+  std::string inpath;
+  std::string outpath;
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(DeduplicatorTest);
+
+void DeduplicatorTest::setUp(void)
+{
+  inpath = "./test/dedup_in.csv";
+  outpath = "./test/dedup_out.csv";
+}
+
+void DeduplicatorTest::tearDown(void)
+{
+  std::remove(inpath.c_str());
+  std::remove(outpath.c_str());
+}
+
+std::string DeduplicatorTest::dedup(Deduplicator& deduplicator, const std::string& data)
+{
+  std::istringstream in(data);
+  std::ostringstream out;
+  deduplicator.dedup(in, out);
+  return out.str();
+}
+
+void DeduplicatorTest::testDedup(void)
+{
+  Deduplicator deduplicator;
+
+  CPPUNIT_ASSERT_EQUAL(std::string("\"a\",\"1\"\r\n\"b\",\"2\"\r\n\"a\",\"2\"\r\n"),
+		       dedup(deduplicator, "a,1\r\nb,2\r\n\"a\",1\r\na,2\r\nb,2\r\n"));
+  CPPUNIT_ASSERT_EQUAL((std::size_t)5, deduplicator.getRecordCount());
+  CPPUNIT_ASSERT_EQUAL((std::size_t)2, deduplicator.getDuplicateCount());
+
+  CPPUNIT_ASSERT_EQUAL(std::string(""), dedup(deduplicator, ""));
+  CPPUNIT_ASSERT_EQUAL((std::size_t)0, deduplicator.getRecordCount());
+  CPPUNIT_ASSERT_EQUAL((std::size_t)0, deduplicator.getDuplicateCount());
+}
+
+void DeduplicatorTest::testDedupKeys(void)
+{
+  Deduplicator deduplicator;
+  deduplicator.addKey(1);
+
+  CPPUNIT_ASSERT_EQUAL(std::string("\"a\",\"1\"\r\n\"b\",\"2\"\r\n\"c\"\r\n"),
+		       dedup(deduplicator, "a,1\r\nb,2\r\nc,1\r\nc\r\nd\r\n"));
+  CPPUNIT_ASSERT_EQUAL((std::size_t)2, deduplicator.getDuplicateCount());
+
+  deduplicator.clearKeys();
+  CPPUNIT_ASSERT_EQUAL(std::string("\"a\",\"1\"\r\n\"c\",\"1\"\r\n"), dedup(deduplicator, "a,1\r\nc,1\r\n"));
+  CPPUNIT_ASSERT_EQUAL((std::size_t)0, deduplicator.getDuplicateCount());
+}
+
+void DeduplicatorTest::testDedupLarge(void)
+{
+  std::ostringstream data;
+  for (std::size_t i = 0; i < 20000; i++) {
+    data << (i * 7919 % 5000) << "," << (i % 3 == 0 ? "x" : "y") << "\r\n";
+  }
+
+  Deduplicator deduplicator;
+  deduplicator.addKey(0);
+  const std::string result = dedup(deduplicator, data.str());
+  CPPUNIT_ASSERT_EQUAL((std::size_t)20000, deduplicator.getRecordCount());
+  CPPUNIT_ASSERT_EQUAL((std::size_t)15000, deduplicator.getDuplicateCount());
+
+  std::size_t lines = 0;
+  for (std::size_t pos = result.find("\r\n"); pos != std::string::npos; pos = result.find("\r\n", pos + 2)) {
+    lines++;
+  }
+  CPPUNIT_ASSERT_EQUAL((std::size_t)5000, lines);
+}
+
+void DeduplicatorTest::testDedupFile(void)
+{
+  {
+    std::ofstream stream(inpath.c_str(), std::ofstream::binary);
+    stream << "x,y\r\nx,y\r\nx,z\r\n";
+  }
+
+  Deduplicator deduplicator;
+  deduplicator.dedup(inpath, outpath);
+
+  std::ifstream stream(outpath.c_str(), std::ifstream::binary);
+  const std::string result((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+  CPPUNIT_ASSERT_EQUAL(std::string("\"x\",\"y\"\r\n\"x\",\"z\"\r\n"), result);
+  CPPUNIT_ASSERT_EQUAL((std::size_t)1, deduplicator.getDuplicateCount());
+}
+
+void DeduplicatorTest::testDedupFileThrowFailure(void)
+{
+  Deduplicator deduplicator;
+
+  try {
+    deduplicator.dedup("./", outpath);
+    CPPUNIT_FAIL("std::ios_base::failure must be throw.");
+  } catch (std::ios_base::failure& e) {
+  }
+}
+
+} // namespace csv
+} // namespace csl
@@ -0,0 +1,115 @@
+#include <cppunit/extensions/HelperMacros.h>
+#include "csl/csv/Dictionary.hpp"
+#include <string>
+#include <stdexcept>
+
+namespace csl {
+namespace csv {
+
+class DictionaryTest : public CPPUNIT_NS::TestFixture
+{
+  CPPUNIT_TEST_SUITE(DictionaryTest);
+  CPPUNIT_TEST(testDictionary);
+  CPPUNIT_TEST(testIntern);
+  CPPUNIT_TEST(testInternMany);
+  CPPUNIT_TEST(testFind);
+  CPPUNIT_TEST(testGetThrowOutOfRange);
+  CPPUNIT_TEST(testClear);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  virtual void setUp(void);
+  virtual void tearDown(void);
+
+private:
+  void testDictionary(void);
+  void testIntern(void);
+  void testInternMany(void);
+  void testFind(void);
+  void testGetThrowOutOfRange(void);
+  void testClear(void);
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(DictionaryTest);
+
+void DictionaryTest::setUp(void)
+{
+}
+
+void DictionaryTest::tearDown(void)
+{
+}
+
+void DictionaryTest::testDictionary(void)
+{
+  Dictionary dictionary;
+  CPPUNIT_ASSERT_EQUAL((std::size_t)0, dictionary.size());
+}
+
+void DictionaryTest::testIntern(void)
+{
+  Dictionary dictionary;
+  CPPUNIT_ASSERT_EQUAL((std::uint32_t)0, dictionary.intern("aaa"));
+  CPPUNIT_ASSERT_EQUAL((std::uint32_t)1, dictionary.intern("bbb"));
+  CPPUNIT_ASSERT_EQUAL((std::uint32_t)0, dictionary.intern("aaa"));
+  CPPUNIT_ASSERT_EQUAL((std::uint32_t)2, dictionary.intern(""));
+  CPPUNIT_ASSERT_EQUAL((std::uint32_t)3, dictionary.intern(std::string("a\0b", 3)));
+  CPPUNIT_ASSERT_EQUAL((std::uint32_t)4, dictionary.intern(std::string("a\0c", 3)));
+  CPPUNIT_ASSERT_EQUAL((std::size_t)5, dictionary.size());
+
+  CPPUNIT_ASSERT(dictionary.get(0) == "aaa");
+  CPPUNIT_ASSERT(dictionary.get(1) == "bbb");
+  CPPUNIT_ASSERT(dictionary.get(2) == "");
+}
+
+void DictionaryTest::testInternMany(void)
+{
+  Dictionary dictionary;
+  for (int i = 0; i < 10000; i++) {
+    CPPUNIT_ASSERT_EQUAL((std::uint32_t)i, dictionary.intern("value" + std::to_string(i)));
+  }
+  for (int i = 0; i < 10000; i++) {
+    CPPUNIT_ASSERT_EQUAL((std::uint32_t)i, dictionary.intern("value" + std::to_string(i)));
+    CPPUNIT_ASSERT(dictionary.get(i) == "value" + std::to_string(i));
+  }
+  CPPUNIT_ASSERT_EQUAL((std::size_t)10000, dictionary.size());
+}
+
+void DictionaryTest::testFind(void)
+{
+  Dictionary dictionary;
+  std::uint32_t code = 99;
+  CPPUNIT_ASSERT(!dictionary.find("aaa", code));
+
+  dictionary.intern("aaa");
+  dictionary.intern("bbb");
+  CPPUNIT_ASSERT(dictionary.find("bbb", code));
+  CPPUNIT_ASSERT_EQUAL((std::uint32_t)1, code);
+  CPPUNIT_ASSERT(!dictionary.find("ccc", code));
+  CPPUNIT_ASSERT_EQUAL((std::size_t)2, dictionary.size());
+}
+
+void DictionaryTest::testGetThrowOutOfRange(void)
+{
+  Dictionary dictionary;
+  dictionary.intern("aaa");
+
+  try {
+    dictionary.get(1);
+    CPPUNIT_FAIL("std::out_of_range must be throw.");
+  } catch (std::out_of_range&) {
+    CPPUNIT_ASSERT(true);
+  }
+}
+
+void DictionaryTest::testClear(void)
+{
+  Dictionary dictionary;
+  dictionary.intern("aaa");
+  dictionary.clear();
+  CPPUNIT_ASSERT_EQUAL((std::size_t)0, dictionary.size());
+  CPPUNIT_ASSERT_EQUAL((std::uint32_t)0, dictionary.intern("bbb"));
+}
+
+} // namespace csv
+} // namespace csl
@@ -0,0 +1,250 @@
+#include <cppunit/extensions/HelperMacros.h>
+#include "csl/csv/Differ.hpp"
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <stdexcept>
+
+namespace csl {
+namespace csv {
+
+namespace {
+
+/**
+ * @brief 位置を移動できない入力ストリームバッファです(パイプの代わり)。
+ */
+class UnseekableBuffer : public std::streambuf
+{
+public:
+  UnseekableBuffer(std::string& data)
+  {
+    setg(&data[0], &data[0], &data[0] + data.size());
+  }
+};
+
+} // namespace
+
+class DifferTest : public CPPUNIT_NS::TestFixture
+{
+  CPPUNIT_TEST_SUITE(DifferTest);
+  CPPUNIT_TEST(testDiff);
+  CPPUNIT_TEST(testDiffKeys);
+  CPPUNIT_TEST(testDiffDuplicates);
+  CPPUNIT_TEST(testDiffSkippedHeader);
+  CPPUNIT_TEST(testDiffLarge);
+  CPPUNIT_TEST(testDiffFile);
+  CPPUNIT_TEST(testDiffFileThrowFailure);
+  CPPUNIT_TEST(testDiffThrowInvalidArgument);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  virtual void setUp(void);
+  virtual void tearDown(void);
+
+private:
+  void testDiff(void);
+  void testDiffKeys(void);
+  void testDiffDuplicates(void);
+  void testDiffSkippedHeader(void);
+  void testDiffLarge(void);
+  void testDiffFile(void);
+  void testDiffFileThrowFailure(void);
+  void testDiffThrowInvalidArgument(void);
+
+private:
+  std::string diff(Differ& differ, const std::string& before, const std::string& after);
+  void writeFile(const std::string& filepath, const std::string& data);
+
+private:
+  std::string beforepath;
+  std::string afterpath;
+  std::string outpath;
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(DifferTest);
+
+void DifferTest::setUp(void)
+{
+  beforepath = "./test/diff_before.csv";
+  afterpath = "./test/diff_after.csv";
+  outpath = "./test/diff_out.csv";
+}
+
+void DifferTest::tearDown(void)
+{
+  std::remove(beforepath.c_str());
+  std::remove(afterpath.c_str());
+  std::remove(outpath.c_str());
+}
+
+std::string DifferTest::diff(Differ& differ, const std::string& before, const std::string& after)
+{
+  std::istringstream beforeStream(before);
+  std::istringstream afterStream(after);
+  std::ostringstream out;
+  differ.diff(beforeStream, afterStream, out);
+  return out.str();
+}
+
+void DifferTest::writeFile(const std::string& filepath, const std::string& data)
+{
+  std::ofstream stream(filepath.c_str(), std::ofstream::binary | std::ofstream::trunc);
+  stream << data;
+  stream.close();
+}
+
+void DifferTest::testDiff(void)
+{
+  Differ differ;
+
+  CPPUNIT_ASSERT_EQUAL(std::string("\"+\",\"d\",\"4\"\r\n"
+				   "\"+\",\"b\",\"5\"\r\n"
+				   "\"-\",\"b\",\"2\"\r\n"
+				   "\"-\",\"c\",\"3\"\r\n"),
+		       diff(differ, "a,1\r\nb,2\r\nc,3\r\n", "d,4\r\n\"a\",1\r\nb,5\r\n"));
+  CPPUNIT_ASSERT_EQUAL((std::size_t)2, differ.getAddedCount());
+  CPPUNIT_ASSERT_EQUAL((std::size_t)2, differ.getRemovedCount());
+  CPPUNIT_ASSERT_EQUAL((std::size_t)0, differ.getChangedCount());
+
+  CPPUNIT_ASSERT_EQUAL(std::string(""), diff(differ, "a,1\r\nb,2\r\n", "b,2\r\na,1\r\n"));
+  CPPUNIT_ASSERT_EQUAL(std::string("\"+\",\"a\"\r\n"), diff(differ, "", "a\r\n"));
+  CPPUNIT_ASSERT_EQUAL(std::string("\"-\",\"a\"\r\n"), diff(differ, "a\r\n", ""));
+}
+
+void DifferTest::testDiffKeys(void)
+{
+  Differ differ;
+  differ.addKey(0);
+
+  CPPUNIT_ASSERT_EQUAL(std::string("\"~\",\"b\",\"5\"\r\n"
+				   "\"+\",\"d\",\"4\"\r\n"
+				   "\"-\",\"c\",\"3\"\r\n"),
+		       diff(differ, "a,1\r\nb,2\r\nc,3\r\n", "b,5\r\na,1\r\nd,4\r\n"));
+  CPPUNIT_ASSERT_EQUAL((std::size_t)1, differ.getAddedCount());
+  CPPUNIT_ASSERT_EQUAL((std::size_t)1, differ.getRemovedCount());
+  CPPUNIT_ASSERT_EQUAL((std::size_t)1, differ.getChangedCount());
+}
+
+void DifferTest::testDiffDuplicates(void)
+{
+  Differ differ;
+
+  CPPUNIT_ASSERT_EQUAL(std::string("\"+\",\"a\"\r\n"),
+		       diff(differ, "a\r\nb\r\na\r\n", "a\r\na\r\nb\r\na\r\n"));
+  CPPUNIT_ASSERT_EQUAL(std::string("\"-\",\"a\"\r\n"),
+		       diff(differ, "a\r\nb\r\na\r\n", "b\r\na\r\n"));
+
+  differ.addKey(0);
+  CPPUNIT_ASSERT_EQUAL(std::string("\"~\",\"k\",\"3\"\r\n"), diff(differ, "k,1\r\nk,2\r\n", "k,1\r\nk,3\r\n"));
+  CPPUNIT_ASSERT_EQUAL(std::string("\"-\",\"k\",\"2\"\r\n"), diff(differ, "k,1\r\nk,2\r\n", "k,1\r\n"));
+}
+
+void DifferTest::testDiffSkippedHeader(void)
+{
+  Differ differ;
+  std::istringstream before("id,name\r\n1,a\r\n2,b\r\n3,c\r\n");
+  std::istringstream after("1,a\r\n3,c\r\n");
+  std::ostringstream out;
+  std::string header;
+
+  // the removed record is read again from the offset in the whole stream
+  std::getline(before, header);
+  differ.diff(before, after, out);
+
+  CPPUNIT_ASSERT_EQUAL(std::string("\"-\",\"2\",\"b\"\r\n"), out.str());
+  CPPUNIT_ASSERT_EQUAL((std::size_t)1, differ.getRemovedCount());
+}
+
+void DifferTest::testDiffLarge(void)
+{
+  std::ostringstream before;
+  std::ostringstream after;
+  std::ostringstream expected;
+
+  for (std::size_t i = 0; i < 10000; i++) {
+    before << i << ",v" << i << "\r\n";
+  }
+  for (std::size_t i = 0; i < 10000; i++) {
+    const std::size_t j = 9999 - i;
+    if (j % 10 == 0) {
+      continue;
+    } else if (j % 10 == 1) {
+      after << j << ",w" << j << "\r\n";
+      expected << "\"~\",\"" << j << "\",\"w" << j << "\"\r\n";
+    } else {
+      after << j << ",v" << j << "\r\n";
+    }
+  }
+  after << "10000,v10000\r\n";
+  expected << "\"+\",\"10000\",\"v10000\"\r\n";
+
+  // removed records are written in the order of the file before the change
+  std::string removedInOrder;
+  for (std::size_t i = 0; i < 10000; i += 10) {
+    std::ostringstream line;
+    line << "\"-\",\"" << i << "\",\"v" << i << "\"\r\n";
+    removedInOrder += line.str();
+  }
+
+  Differ differ;
+  differ.addKey(0);
+  CPPUNIT_ASSERT_EQUAL(expected.str() + removedInOrder, diff(differ, before.str(), after.str()));
+  CPPUNIT_ASSERT_EQUAL((std::size_t)1, differ.getAddedCount());
+  CPPUNIT_ASSERT_EQUAL((std::size_t)1000, differ.getRemovedCount());
+  CPPUNIT_ASSERT_EQUAL((std::size_t)1000, differ.getChangedCount());
+}
+
+void DifferTest::testDiffFile(void)
+{
+  writeFile(beforepath, "id,name\r\n1,x\r\n2,y\r\n");
+  writeFile(afterpath, "id,name\r\n1,z\r\n");
+
+  Differ differ;
+  differ.addKey(0);
+  differ.diff(beforepath, afterpath, outpath);
+
+  std::ifstream stream(outpath.c_str(), std::ifstream::binary);
+  const std::string result((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+  CPPUNIT_ASSERT_EQUAL(std::string("\"~\",\"1\",\"z\"\r\n\"-\",\"2\",\"y\"\r\n"), result);
+}
+
+void DifferTest::testDiffFileThrowFailure(void)
+{
+  Differ differ;
+  writeFile(afterpath, "a\r\n");
+
+  try {
+    differ.diff("./", afterpath, outpath);
+    CPPUNIT_FAIL("std::ios_base::failure must be throw.");
+  } catch (std::ios_base::failure& e) {
+  }
+
+  try {
+    differ.diff(afterpath, "./", outpath);
+    CPPUNIT_FAIL("std::ios_base::failure must be throw.");
+  } catch (std::ios_base::failure& e) {
+  }
+}
+
+void DifferTest::testDiffThrowInvalidArgument(void)
+{
+  Differ differ;
+  std::string data("a\r\n");
+  UnseekableBuffer buffer(data);
+  std::istream before(&buffer);
+  std::istringstream after("b\r\n");
+  std::ostringstream out;
+
+  try {
+    differ.diff(before, after, out);
+    CPPUNIT_FAIL("std::invalid_argument must be throw.");
+  } catch (std::invalid_argument&) {
+    CPPUNIT_ASSERT(out.str().empty());
+  }
+}
+
+} // namespace csv
+} // namespace csl
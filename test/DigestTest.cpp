@@ -0,0 +1,87 @@
+#include <cppunit/extensions/HelperMacros.h>
+#include "csl/csv/Digest.hpp"
+#include "csl/csv/LazyRecord.hpp"
+#include "csl/csv/Reader.hpp"
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace csl {
+namespace csv {
+
+class DigestTest : public CPPUNIT_NS::TestFixture
+{
+  CPPUNIT_TEST_SUITE(DigestTest);
+  CPPUNIT_TEST(testRecord);
+  CPPUNIT_TEST(testColumns);
+  CPPUNIT_TEST(testCompare);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  void testRecord(void);
+  void testColumns(void);
+  void testCompare(void);
+
+private:
+  Digest digest(const std::string& line);
+  Digest digest(const std::string& line, const std::vector<std::size_t>& columns);
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(DigestTest);
+
+Digest DigestTest::digest(const std::string& line)
+{
+  std::istringstream stream(line);
+  Reader reader(stream);
+  LazyRecord record;
+  reader.read(record);
+  return Digest(record);
+}
+
+Digest DigestTest::digest(const std::string& line, const std::vector<std::size_t>& columns)
+{
+  std::istringstream stream(line);
+  Reader reader(stream);
+  LazyRecord record;
+  reader.read(record);
+  return Digest(record, columns);
+}
+
+void DigestTest::testRecord(void)
+{
+  CPPUNIT_ASSERT(digest("a,b,c\r\n") == digest("a,b,c\r\n"));
+  CPPUNIT_ASSERT(digest("a,b,c\r\n") == digest("\"a\",b,\"c\"\r\n"));
+  CPPUNIT_ASSERT(digest("\"a\"\"b\",c\r\n") == digest("\"a\"\"b\",\"c\"\r\n"));
+  CPPUNIT_ASSERT(digest("ab,c\r\n") != digest("a,bc\r\n"));
+  CPPUNIT_ASSERT(digest("a,b,c\r\n") != digest("a,c,b\r\n"));
+  CPPUNIT_ASSERT(digest("a,,c\r\n") != digest("a,c\r\n"));
+  CPPUNIT_ASSERT(digest("a\r\n") != digest("\r\n"));
+  CPPUNIT_ASSERT(Digest() == Digest());
+  CPPUNIT_ASSERT(digest("\r\n") != Digest());
+}
+
+void DigestTest::testColumns(void)
+{
+  std::vector<std::size_t> columns;
+  columns.push_back(2);
+  columns.push_back(0);
+
+  CPPUNIT_ASSERT(digest("a,x,c\r\n", columns) == digest("a,y,c,d\r\n", columns));
+  CPPUNIT_ASSERT(digest("a,x,c\r\n", columns) != digest("c,x,a\r\n", columns));
+  CPPUNIT_ASSERT(digest("a,x\r\n", columns) == digest("a,y,\"\",z\r\n", columns));
+  CPPUNIT_ASSERT(digest("a,x,c\r\n", columns) != digest("a,x,c\r\n"));
+}
+
+void DigestTest::testCompare(void)
+{
+  const Digest a = digest("a\r\n");
+  const Digest b = digest("b\r\n");
+
+  CPPUNIT_ASSERT(a != b);
+  CPPUNIT_ASSERT((a < b) != (b < a));
+  CPPUNIT_ASSERT(!(a < a));
+  CPPUNIT_ASSERT_EQUAL(a.getHigh() < b.getHigh(), a < b);
+}
+
+} // namespace csv
+} // namespace csl
@@ -0,0 +1,204 @@
+#include <cppunit/extensions/HelperMacros.h>
+#include "csl/csv/EncodedTable.hpp"
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+namespace csl {
+namespace csv {
+
+class EncodedTableTest : public CPPUNIT_NS::TestFixture
+{
+  CPPUNIT_TEST_SUITE(EncodedTableTest);
+  CPPUNIT_TEST(testEncodedTable);
+  CPPUNIT_TEST(testAdd);
+  CPPUNIT_TEST(testAddRagged);
+  CPPUNIT_TEST(testGetCode);
+  CPPUNIT_TEST(testGetCodeThrowInvalidArgument);
+  CPPUNIT_TEST(testGetThrowOutOfRange);
+  CPPUNIT_TEST(testSetAutoEncodeLimit);
+  CPPUNIT_TEST(testSetEncoded);
+  CPPUNIT_TEST(testClear);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  virtual void setUp(void);
+  virtual void tearDown(void);
+
+private:
+  void testEncodedTable(void);
+  void testAdd(void);
+  void testAddRagged(void);
+  void testGetCode(void);
+  void testGetCodeThrowInvalidArgument(void);
+  void testGetThrowOutOfRange(void);
+  void testSetAutoEncodeLimit(void);
+  void testSetEncoded(void);
+  void testClear(void);
+
+private:
+  void addRecord(EncodedTable& table, const std::string& a, const std::string& b);
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(EncodedTableTest);
+
+void EncodedTableTest::setUp(void)
+{
+}
+
+void EncodedTableTest::tearDown(void)
+{
+}
+
+void EncodedTableTest::addRecord(EncodedTable& table, const std::string& a, const std::string& b)
+{
+  std::vector<std::string> record;
+  record.push_back(a);
+  record.push_back(b);
+  table.add(record);
+}
+
+void EncodedTableTest::testEncodedTable(void)
+{
+  EncodedTable table;
+  CPPUNIT_ASSERT_EQUAL((std::size_t)0, table.getRowCount());
+  CPPUNIT_ASSERT_EQUAL((std::size_t)0, table.getColumnCount());
+}
+
+void EncodedTableTest::testAdd(void)
+{
+  EncodedTable table;
+  addRecord(table, "1", "Tokyo");
+  addRecord(table, "2", "Osaka");
+  addRecord(table, "3", "Tokyo");
+
+  CPPUNIT_ASSERT_EQUAL((std::size_t)3, table.getRowCount());
+  CPPUNIT_ASSERT_EQUAL((std::size_t)2, table.getColumnCount());
+  CPPUNIT_ASSERT(table.get(0, 0) == "1");
+  CPPUNIT_ASSERT(table.get(1, 1) == "Osaka");
+  CPPUNIT_ASSERT(table.get(2, 1) == "Tokyo");
+  CPPUNIT_ASSERT(table.isEncoded(1));
+  CPPUNIT_ASSERT_EQUAL((std::size_t)2, table.getDictionary(1).size());
+
+  std::vector<std::string> record;
+  table.getRecord(2, record);
+  CPPUNIT_ASSERT(record.size() == 2);
+  CPPUNIT_ASSERT(record[0] == "3");
+  CPPUNIT_ASSERT(record[1] == "Tokyo");
+}
+
+void EncodedTableTest::testAddRagged(void)
+{
+  EncodedTable table;
+  std::vector<std::string> record;
+  record.push_back("a");
+  table.add(record);
+  record.push_back("b");
+  record.push_back("c");
+  table.add(record);
+  record.clear();
+  table.add(record);
+
+  CPPUNIT_ASSERT_EQUAL((std::size_t)3, table.getColumnCount());
+  CPPUNIT_ASSERT_EQUAL((std::size_t)1, table.getFieldCount(0));
+  CPPUNIT_ASSERT_EQUAL((std::size_t)3, table.getFieldCount(1));
+  CPPUNIT_ASSERT_EQUAL((std::size_t)0, table.getFieldCount(2));
+  CPPUNIT_ASSERT(table.get(1, 2) == "c");
+
+  table.getRecord(0, record);
+  CPPUNIT_ASSERT(record.size() == 1);
+  CPPUNIT_ASSERT(record[0] == "a");
+}
+
+void EncodedTableTest::testGetCode(void)
+{
+  EncodedTable table;
+  addRecord(table, "1", "Tokyo");
+  addRecord(table, "2", "Osaka");
+  addRecord(table, "3", "Tokyo");
+
+  CPPUNIT_ASSERT(table.getCode(0, 1) == table.getCode(2, 1));
+  CPPUNIT_ASSERT(table.getCode(0, 1) != table.getCode(1, 1));
+  CPPUNIT_ASSERT(table.getDictionary(1).get(table.getCode(1, 1)) == "Osaka");
+}
+
+void EncodedTableTest::testGetCodeThrowInvalidArgument(void)
+{
+  EncodedTable table;
+  table.setAutoEncodeLimit(0);
+  addRecord(table, "1", "Tokyo");
+
+  try {
+    table.getCode(0, 1);
+    CPPUNIT_FAIL("std::invalid_argument must be throw.");
+  } catch (std::invalid_argument&) {
+    CPPUNIT_ASSERT(true);
+  }
+}
+
+void EncodedTableTest::testGetThrowOutOfRange(void)
+{
+  EncodedTable table;
+  addRecord(table, "1", "Tokyo");
+
+  try {
+    table.get(0, 2);
+    CPPUNIT_FAIL("std::out_of_range must be throw.");
+  } catch (std::out_of_range&) {
+    CPPUNIT_ASSERT(true);
+  }
+
+  try {
+    table.get(1, 0);
+    CPPUNIT_FAIL("std::out_of_range must be throw.");
+  } catch (std::out_of_range&) {
+    CPPUNIT_ASSERT(true);
+  }
+}
+
+void EncodedTableTest::testSetAutoEncodeLimit(void)
+{
+  EncodedTable table;
+  table.setAutoEncodeLimit(2);
+  addRecord(table, "1", "Tokyo");
+  addRecord(table, "2", "Osaka");
+  CPPUNIT_ASSERT(table.isEncoded(0));
+
+  addRecord(table, "3", "Tokyo");
+  CPPUNIT_ASSERT(!table.isEncoded(0));
+  CPPUNIT_ASSERT(table.isEncoded(1));
+  CPPUNIT_ASSERT(table.get(0, 0) == "1");
+  CPPUNIT_ASSERT(table.get(1, 0) == "2");
+  CPPUNIT_ASSERT(table.get(2, 0) == "3");
+}
+
+void EncodedTableTest::testSetEncoded(void)
+{
+  EncodedTable table;
+  table.setAutoEncodeLimit(0);
+  table.setEncoded(1, true);
+  addRecord(table, "1", "Tokyo");
+  addRecord(table, "2", "Osaka");
+
+  CPPUNIT_ASSERT(!table.isEncoded(0));
+  CPPUNIT_ASSERT(table.isEncoded(1));
+  CPPUNIT_ASSERT(table.get(1, 1) == "Osaka");
+}
+
+void EncodedTableTest::testClear(void)
+{
+  EncodedTable table;
+  table.setAutoEncodeLimit(0);
+  table.setEncoded(0, true);
+  addRecord(table, "1", "Tokyo");
+  table.clear();
+  CPPUNIT_ASSERT_EQUAL((std::size_t)0, table.getRowCount());
+  CPPUNIT_ASSERT_EQUAL((std::size_t)0, table.getColumnCount());
+
+  addRecord(table, "1", "Tokyo");
+  CPPUNIT_ASSERT(table.isEncoded(0));
+  CPPUNIT_ASSERT(!table.isEncoded(1));
+}
+
+} // namespace csv
+} // namespace csl
@@ -0,0 +1,142 @@
+#include <cppunit/extensions/HelperMacros.h>
+#include "csl/csv/Filter.hpp"
+#include <string>
+#include <vector>
+
+namespace csl {
+namespace csv {
+
+class FilterTest : public CPPUNIT_NS::TestFixture
+{
+  CPPUNIT_TEST_SUITE(FilterTest);
+  CPPUNIT_TEST(testFilter);
+  CPPUNIT_TEST(testAddEquals);
+  CPPUNIT_TEST(testAddPrefix);
+  CPPUNIT_TEST(testAddIn);
+  CPPUNIT_TEST(testAddRange);
+  CPPUNIT_TEST(testMatchesMissingColumn);
+  CPPUNIT_TEST(testClear);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  virtual void setUp(void);
+  virtual void tearDown(void);
+
+private:
+  void testFilter(void);
+  void testAddEquals(void);
+  void testAddPrefix(void);
+  void testAddIn(void);
+  void testAddRange(void);
+  void testMatchesMissingColumn(void);
+  void testClear(void);
+
+private:
+  std::vector<std::string> makeRecord(const std::string& a, const std::string& b);
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(FilterTest);
+
+void FilterTest::setUp(void)
+{
+}
+
+void FilterTest::tearDown(void)
+{
+}
+
+std::vector<std::string> FilterTest::makeRecord(const std::string& a, const std::string& b)
+{
+  std::vector<std::string> record;
+  record.push_back(a);
+  record.push_back(b);
+  return record;
+}
+
+void FilterTest::testFilter(void)
+{
+  Filter filter;
+  CPPUNIT_ASSERT(filter.empty());
+  CPPUNIT_ASSERT(filter.matches(makeRecord("a", "b")));
+  CPPUNIT_ASSERT(filter.matches(std::vector<std::string>()));
+}
+
+void FilterTest::testAddEquals(void)
+{
+  Filter filter;
+  filter.addEquals(1, "Tokyo");
+  CPPUNIT_ASSERT(!filter.empty());
+  CPPUNIT_ASSERT(filter.matches(makeRecord("1", "Tokyo")));
+  CPPUNIT_ASSERT(!filter.matches(makeRecord("1", "Tokyo2")));
+  CPPUNIT_ASSERT(!filter.matches(makeRecord("Tokyo", "Osaka")));
+}
+
+void FilterTest::testAddPrefix(void)
+{
+  Filter filter;
+  filter.addPrefix(0, "2024-05");
+  CPPUNIT_ASSERT(filter.matches(makeRecord("2024-05-01", "x")));
+  CPPUNIT_ASSERT(filter.matches(makeRecord("2024-05", "x")));
+  CPPUNIT_ASSERT(!filter.matches(makeRecord("2024-0", "x")));
+  CPPUNIT_ASSERT(!filter.matches(makeRecord("2024-06-01", "x")));
+}
+
+void FilterTest::testAddIn(void)
+{
+  std::vector<std::string> values;
+  values.push_back("JP");
+  values.push_back("US");
+
+  Filter filter;
+  filter.addIn(1, values);
+  CPPUNIT_ASSERT(filter.matches(makeRecord("1", "JP")));
+  CPPUNIT_ASSERT(filter.matches(makeRecord("1", "US")));
+  CPPUNIT_ASSERT(!filter.matches(makeRecord("1", "UK")));
+  CPPUNIT_ASSERT(!filter.matches(makeRecord("1", "")));
+}
+
+void FilterTest::testAddRange(void)
+{
+  Filter filter;
+  filter.addRange(0, 10, 20);
+  CPPUNIT_ASSERT(filter.matches(makeRecord("10", "x")));
+  CPPUNIT_ASSERT(filter.matches(makeRecord("15.5", "x")));
+  CPPUNIT_ASSERT(filter.matches(makeRecord("2e1", "x")));
+  CPPUNIT_ASSERT(!filter.matches(makeRecord("20.01", "x")));
+  CPPUNIT_ASSERT(!filter.matches(makeRecord("-15", "x")));
+  CPPUNIT_ASSERT(!filter.matches(makeRecord("15x", "x")));
+  CPPUNIT_ASSERT(!filter.matches(makeRecord(" 15", "x")));
+  CPPUNIT_ASSERT(!filter.matches(makeRecord("", "x")));
+  CPPUNIT_ASSERT(!filter.matches(makeRecord("nan", "x")));
+
+  // every condition on a column must hold
+  filter.addRange(0, 12, 30);
+  CPPUNIT_ASSERT(!filter.matches(makeRecord("11", "x")));
+  CPPUNIT_ASSERT(filter.matches(makeRecord("12", "x")));
+}
+
+void FilterTest::testMatchesMissingColumn(void)
+{
+  Filter filter;
+  filter.addEquals(2, "");
+
+  CPPUNIT_ASSERT(!filter.matches(makeRecord("a", "b")));
+
+  std::vector<std::string> record = makeRecord("a", "b");
+  record.push_back("");
+  CPPUNIT_ASSERT(filter.matches(record));
+}
+
+void FilterTest::testClear(void)
+{
+  Filter filter;
+  filter.addEquals(0, "a");
+  CPPUNIT_ASSERT(!filter.matches(makeRecord("b", "b")));
+
+  filter.clear();
+  CPPUNIT_ASSERT(filter.empty());
+  CPPUNIT_ASSERT(filter.matches(makeRecord("b", "b")));
+}
+
+} // namespace csv
+} // namespace csl
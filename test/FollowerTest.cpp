@@ -0,0 +1,214 @@
+#include <cppunit/extensions/HelperMacros.h>
+#include "csl/csv/Follower.hpp"
+#include <string>
+#include <vector>
+#include <fstream>
+#include <cstdio>
+#include "csl/csv/Config.hpp"
+
+namespace csl {
+namespace csv {
+
+class FollowerTest : public CPPUNIT_NS::TestFixture
+{
+  CPPUNIT_TEST_SUITE(FollowerTest);
+  CPPUNIT_TEST(testFollowerString);
+  CPPUNIT_TEST(testFollowerStringConfig);
+  CPPUNIT_TEST(testFollowerStringThrowFailure);
+  CPPUNIT_TEST(testReadAppended);
+  CPPUNIT_TEST(testReadTruncated);
+  CPPUNIT_TEST(testReadTruncatedRegrown);
+  CPPUNIT_TEST(testReadGrowingRecord);
+  CPPUNIT_TEST(testReadRotated);
+  CPPUNIT_TEST(testWait);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  virtual void setUp(void);
+  virtual void tearDown(void);
+
+private:
+  void testFollowerString(void);
+  void testFollowerStringConfig(void);
+  void testFollowerStringThrowFailure(void);
+  void testReadAppended(void);
+  void testReadTruncated(void);
+  void testReadTruncatedRegrown(void);
+  void testReadGrowingRecord(void);
+  void testReadRotated(void);
+  void testWait(void);
+
+private:
+  void write(const std::string& data, const bool append);
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(FollowerTest);
+
+namespace {
+const char* FOLLOW_FILEPATH = "./test/follow.csv";
+const char* FOLLOW_ROTATED_FILEPATH = "./test/follow.csv.1";
+}
+
+void FollowerTest::setUp(void)
+{
+  write("", false);
+}
+
+void FollowerTest::tearDown(void)
+{
+  std::remove(FOLLOW_FILEPATH);
+  std::remove(FOLLOW_ROTATED_FILEPATH);
+}
+
+void FollowerTest::write(const std::string& data, const bool append)
+{
+  std::ofstream stream(FOLLOW_FILEPATH,
+		       append ? std::ofstream::binary | std::ofstream::app : std::ofstream::binary);
+  stream << data;
+}
+
+void FollowerTest::testFollowerString(void)
+{
+  Follower follower(FOLLOW_FILEPATH);
+  CPPUNIT_ASSERT_EQUAL((std::streamoff)0, follower.getOffset());
+}
+
+void FollowerTest::testFollowerStringConfig(void)
+{
+  Config config;
+  Follower follower(FOLLOW_FILEPATH, config);
+  CPPUNIT_ASSERT_EQUAL((std::streamoff)0, follower.getOffset());
+}
+
+void FollowerTest::testFollowerStringThrowFailure(void)
+{
+  try {
+    Follower follower("./");
+    CPPUNIT_FAIL("std::ios_base::failure must be throw.");
+  } catch (std::ios_base::failure&) {
+    CPPUNIT_ASSERT(true);
+  }
+}
+
+void FollowerTest::testReadAppended(void)
+{
+  write("aaa,bbb\r\n", true);
+  Follower follower(FOLLOW_FILEPATH);
+  std::vector<std::vector<std::string> > csv;
+
+  CPPUNIT_ASSERT_EQUAL(Follower::EVENT_APPENDED, follower.read(csv));
+  CPPUNIT_ASSERT(csv.size() == 1);
+  CPPUNIT_ASSERT(csv[0].size() == 2);
+  CPPUNIT_ASSERT(csv[0][0] == "aaa");
+  CPPUNIT_ASSERT(csv[0][1] == "bbb");
+  CPPUNIT_ASSERT_EQUAL((std::streamoff)9, follower.getOffset());
+
+  write("ccc,\"d\r\n", true);
+  CPPUNIT_ASSERT_EQUAL(Follower::EVENT_NONE, follower.read(csv));
+  CPPUNIT_ASSERT(csv.size() == 0);
+  CPPUNIT_ASSERT_EQUAL((std::streamoff)9, follower.getOffset());
+
+  write("d\"\r", true);
+  CPPUNIT_ASSERT_EQUAL(Follower::EVENT_NONE, follower.read(csv));
+  CPPUNIT_ASSERT(csv.size() == 0);
+
+  write("\neee\r\n", true);
+  CPPUNIT_ASSERT_EQUAL(Follower::EVENT_APPENDED, follower.read(csv));
+  CPPUNIT_ASSERT(csv.size() == 2);
+  CPPUNIT_ASSERT(csv[0].size() == 2);
+  CPPUNIT_ASSERT(csv[0][0] == "ccc");
+  CPPUNIT_ASSERT(csv[0][1] == "d\r\nd");
+  CPPUNIT_ASSERT(csv[1].size() == 1);
+  CPPUNIT_ASSERT(csv[1][0] == "eee");
+  CPPUNIT_ASSERT_EQUAL((std::streamoff)26, follower.getOffset());
+}
+
+void FollowerTest::testReadTruncated(void)
+{
+  write("aaa\r\nbbb\r\n", true);
+  Follower follower(FOLLOW_FILEPATH);
+  std::vector<std::vector<std::string> > csv;
+
+  CPPUNIT_ASSERT_EQUAL(Follower::EVENT_APPENDED, follower.read(csv));
+  CPPUNIT_ASSERT(csv.size() == 2);
+
+  write("ccc\r\n", false);
+  CPPUNIT_ASSERT_EQUAL(Follower::EVENT_TRUNCATED, follower.read(csv));
+  CPPUNIT_ASSERT(csv.size() == 1);
+  CPPUNIT_ASSERT(csv[0][0] == "ccc");
+  CPPUNIT_ASSERT_EQUAL((std::streamoff)5, follower.getOffset());
+}
+
+void FollowerTest::testReadTruncatedRegrown(void)
+{
+  write("aaa\r\nbbb\r\n", true);
+  Follower follower(FOLLOW_FILEPATH);
+  std::vector<std::vector<std::string> > csv;
+
+  CPPUNIT_ASSERT_EQUAL(Follower::EVENT_APPENDED, follower.read(csv));
+  CPPUNIT_ASSERT(csv.size() == 2);
+
+  write("ccc\r\nddd\r\neee\r\n", false);
+  CPPUNIT_ASSERT_EQUAL(Follower::EVENT_TRUNCATED, follower.read(csv));
+  CPPUNIT_ASSERT(csv.size() == 3);
+  CPPUNIT_ASSERT(csv[0][0] == "ccc");
+  CPPUNIT_ASSERT(csv[2][0] == "eee");
+  CPPUNIT_ASSERT_EQUAL((std::streamoff)15, follower.getOffset());
+}
+
+void FollowerTest::testReadGrowingRecord(void)
+{
+  Follower follower(FOLLOW_FILEPATH);
+  std::vector<std::vector<std::string> > csv;
+
+  write("\"", true);
+  for (int i = 0; i < 1000; i++) {
+    write("x\r\n", true);
+    CPPUNIT_ASSERT_EQUAL(Follower::EVENT_NONE, follower.read(csv));
+  }
+
+  write("\",y\r\n", true);
+  CPPUNIT_ASSERT_EQUAL(Follower::EVENT_APPENDED, follower.read(csv));
+  CPPUNIT_ASSERT(csv.size() == 1);
+  CPPUNIT_ASSERT(csv[0].size() == 2);
+  CPPUNIT_ASSERT_EQUAL((std::size_t)3000, csv[0][0].size());
+  CPPUNIT_ASSERT(csv[0][1] == "y");
+  CPPUNIT_ASSERT_EQUAL((std::streamoff)3006, follower.getOffset());
+}
+
+void FollowerTest::testReadRotated(void)
+{
+  write("aaa\r\n", true);
+  Follower follower(FOLLOW_FILEPATH);
+  std::vector<std::vector<std::string> > csv;
+
+  CPPUNIT_ASSERT_EQUAL(Follower::EVENT_APPENDED, follower.read(csv));
+  CPPUNIT_ASSERT(csv.size() == 1);
+
+  write("bbb", true);
+  std::rename(FOLLOW_FILEPATH, FOLLOW_ROTATED_FILEPATH);
+  write("ccc\r\n", false);
+
+  CPPUNIT_ASSERT_EQUAL(Follower::EVENT_ROTATED, follower.read(csv));
+  CPPUNIT_ASSERT(csv.size() == 2);
+  CPPUNIT_ASSERT(csv[0][0] == "bbb");
+  CPPUNIT_ASSERT(csv[1][0] == "ccc");
+  CPPUNIT_ASSERT_EQUAL((std::streamoff)5, follower.getOffset());
+}
+
+void FollowerTest::testWait(void)
+{
+  Follower follower(FOLLOW_FILEPATH);
+  std::vector<std::vector<std::string> > csv;
+
+  CPPUNIT_ASSERT_EQUAL(false, follower.wait(0));
+  CPPUNIT_ASSERT_EQUAL(false, follower.wait(10));
+
+  write("aaa\r\n", true);
+  CPPUNIT_ASSERT_EQUAL(true, follower.wait(1000));
+  CPPUNIT_ASSERT_EQUAL(Follower::EVENT_APPENDED, follower.read(csv));
+  CPPUNIT_ASSERT_EQUAL(false, follower.wait(0));
+}
+
+} // namespace csv
+} // namespace csl
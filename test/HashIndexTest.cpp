@@ -0,0 +1,213 @@
+#include <cppunit/extensions/HelperMacros.h>
+#include "csl/csv/HashIndex.hpp"
+#include "csl/csv/Util.hpp"
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace csl {
+namespace csv {
+
+class HashIndexTest : public CPPUNIT_NS::TestFixture
+{
+  CPPUNIT_TEST_SUITE(HashIndexTest);
+  CPPUNIT_TEST(testFind);
+  CPPUNIT_TEST(testFindRecord);
+  CPPUNIT_TEST(testFindAll);
+  CPPUNIT_TEST(testFindRagged);
+  CPPUNIT_TEST(testHashIndexThreadPool);
+  CPPUNIT_TEST(testHashIndexIndexFile);
+  CPPUNIT_TEST(testHashIndexIndexFileLarge);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  virtual void setUp(void);
+  virtual void tearDown(void);
+
+private:
+  void testFind(void);
+  void testFindRecord(void);
+  void testFindAll(void);
+  void testFindRagged(void);
+  void testHashIndexThreadPool(void);
+  void testHashIndexIndexFile(void);
+  void testHashIndexIndexFileLarge(void);
+
+private:
+  void addRecord(const std::string& a, const std::string& b);
+
+private:
+  std::vector<std::vector<std::string> > csv;
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(HashIndexTest);
+
+void HashIndexTest::setUp(void)
+{
+  csv.clear();
+  addRecord("1", "Tokyo");
+  addRecord("2", "Osaka");
+  addRecord("3", "Tokyo");
+  addRecord("4", "Nagoya");
+  addRecord("5", "Tokyo");
+}
+
+void HashIndexTest::tearDown(void)
+{
+}
+
+void HashIndexTest::addRecord(const std::string& a, const std::string& b)
+{
+  std::vector<std::string> record;
+  record.push_back(a);
+  record.push_back(b);
+  csv.push_back(record);
+}
+
+void HashIndexTest::testFind(void)
+{
+  HashIndex index(csv, 0);
+  CPPUNIT_ASSERT_EQUAL((std::size_t)0, index.getColumn());
+  CPPUNIT_ASSERT_EQUAL((std::size_t)5, index.size());
+  CPPUNIT_ASSERT(!index.isLoaded());
+
+  std::size_t row = 0;
+  CPPUNIT_ASSERT(index.find("4", row));
+  CPPUNIT_ASSERT_EQUAL((std::size_t)3, row);
+  CPPUNIT_ASSERT(!index.find("6", row));
+  CPPUNIT_ASSERT(!index.find("", row));
+}
+
+void HashIndexTest::testFindRecord(void)
+{
+  HashIndex index(csv, 0);
+
+  const std::vector<std::string>* record = index.find("2");
+  CPPUNIT_ASSERT(record != NULL);
+  CPPUNIT_ASSERT_EQUAL(std::string("Osaka"), (*record)[1]);
+  CPPUNIT_ASSERT(index.find("Osaka") == NULL);
+}
+
+void HashIndexTest::testFindAll(void)
+{
+  HashIndex index(csv, 1);
+  std::vector<std::size_t> rows;
+
+  index.findAll("Tokyo", rows);
+  CPPUNIT_ASSERT_EQUAL((std::size_t)3, rows.size());
+  CPPUNIT_ASSERT_EQUAL((std::size_t)0, rows[0]);
+  CPPUNIT_ASSERT_EQUAL((std::size_t)2, rows[1]);
+  CPPUNIT_ASSERT_EQUAL((std::size_t)4, rows[2]);
+
+  std::size_t row = 0;
+  CPPUNIT_ASSERT(index.find("Tokyo", row));
+  CPPUNIT_ASSERT_EQUAL((std::size_t)0, row);
+
+  index.findAll("Kyoto", rows);
+  CPPUNIT_ASSERT(rows.empty());
+}
+
+void HashIndexTest::testFindRagged(void)
+{
+  std::vector<std::string> record;
+  record.push_back("6");
+  csv.push_back(record);
+
+  HashIndex index(csv, 1);
+  CPPUNIT_ASSERT_EQUAL((std::size_t)5, index.size());
+
+  std::size_t row = 0;
+  CPPUNIT_ASSERT(index.find("Nagoya", row));
+  CPPUNIT_ASSERT_EQUAL((std::size_t)3, row);
+}
+
+void HashIndexTest::testHashIndexThreadPool(void)
+{
+  for (int i = 0; i < 1000; i++) {
+    addRecord(std::to_string(i % 300), std::to_string(i));
+  }
+
+  ThreadPool pool(4);
+  HashIndex parallel(csv, 0, pool);
+  HashIndex serial(csv, 0);
+  CPPUNIT_ASSERT_EQUAL(serial.size(), parallel.size());
+
+  std::vector<std::size_t> expected;
+  std::vector<std::size_t> actual;
+  for (int i = 0; i < 300; i++) {
+    serial.findAll(std::to_string(i), expected);
+    parallel.findAll(std::to_string(i), actual);
+    CPPUNIT_ASSERT(!actual.empty());
+    CPPUNIT_ASSERT(expected == actual);
+  }
+}
+
+void HashIndexTest::testHashIndexIndexFile(void)
+{
+  const std::string filepath = "./test/test.csv";
+  const std::string indexpath = "./test/test.csv.index";
+  std::remove(indexpath.c_str());
+
+  csv.clear();
+  Util::load(filepath, csv);
+
+  std::size_t expected = 0;
+  {
+    HashIndex index(csv, 0, filepath, indexpath);
+    CPPUNIT_ASSERT(!index.isLoaded());
+    CPPUNIT_ASSERT(index.find(csv.back()[0], expected));
+  }
+  {
+    HashIndex index(csv, 0, filepath, indexpath);
+    CPPUNIT_ASSERT(index.isLoaded());
+    CPPUNIT_ASSERT_EQUAL(csv.size(), index.size());
+
+    std::size_t row = 0;
+    CPPUNIT_ASSERT(index.find(csv.back()[0], row));
+    CPPUNIT_ASSERT_EQUAL(expected, row);
+  }
+  {
+    // a different column does not match the index file
+    HashIndex index(csv, 1, filepath, indexpath);
+    CPPUNIT_ASSERT(!index.isLoaded());
+  }
+
+  std::remove(indexpath.c_str());
+}
+
+void HashIndexTest::testHashIndexIndexFileLarge(void)
+{
+  const std::string filepath = "./test/index.csv";
+  const std::string indexpath = "./test/index.csv.index";
+  std::remove(indexpath.c_str());
+
+  // enough rows that shards round up to more than twice their row count
+  csv.clear();
+  for (int i = 0; i < 20000; i++) {
+    addRecord(std::to_string(i), std::to_string(i % 7));
+  }
+  Util::save(filepath, csv);
+
+  {
+    HashIndex index(csv, 0, filepath, indexpath);
+    CPPUNIT_ASSERT(!index.isLoaded());
+  }
+  {
+    HashIndex index(csv, 0, filepath, indexpath);
+    CPPUNIT_ASSERT(index.isLoaded());
+    CPPUNIT_ASSERT_EQUAL(csv.size(), index.size());
+
+    std::size_t row = 0;
+    for (int i = 0; i < 20000; i += 997) {
+      CPPUNIT_ASSERT(index.find(std::to_string(i), row));
+      CPPUNIT_ASSERT_EQUAL((std::size_t)i, row);
+    }
+    CPPUNIT_ASSERT(!index.find("20000", row));
+  }
+
+  std::remove(filepath.c_str());
+  std::remove(indexpath.c_str());
+}
+
+} // namespace csv
+} // namespace csl
@@ -0,0 +1,101 @@
+#include <cppunit/extensions/HelperMacros.h>
+#include "csl/csv/HyperLogLog.hpp"
+#include <cmath>
+#include <sstream>
+#include <string>
+#include <stdexcept>
+
+namespace csl {
+namespace csv {
+
+class HyperLogLogTest : public CPPUNIT_NS::TestFixture
+{
+  CPPUNIT_TEST_SUITE(HyperLogLogTest);
+  CPPUNIT_TEST(testEstimate);
+  CPPUNIT_TEST(testEstimateSmall);
+  CPPUNIT_TEST(testMerge);
+  CPPUNIT_TEST(testThrowInvalidArgument);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  void testEstimate(void);
+  void testEstimateSmall(void);
+  void testMerge(void);
+  void testThrowInvalidArgument(void);
+
+private:
+  void addRange(HyperLogLog& sketch, const std::size_t begin, const std::size_t end);
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(HyperLogLogTest);
+
+void HyperLogLogTest::addRange(HyperLogLog& sketch, const std::size_t begin, const std::size_t end)
+{
+  for (std::size_t i = begin; i < end; i++) {
+    std::ostringstream value;
+    value << "value" << i;
+    sketch.add(value.str().data(), value.str().size());
+  }
+}
+
+void HyperLogLogTest::testEstimate(void)
+{
+  HyperLogLog sketch;
+  CPPUNIT_ASSERT_EQUAL(HLL_PRECISION, sketch.getPrecision());
+  CPPUNIT_ASSERT_EQUAL(0.0, sketch.estimate());
+
+  addRange(sketch, 0, 100000);
+  addRange(sketch, 0, 100000);
+  CPPUNIT_ASSERT(std::fabs(sketch.estimate() - 100000.0) < 100000.0 * 0.03);
+
+  sketch.clear();
+  CPPUNIT_ASSERT_EQUAL(0.0, sketch.estimate());
+}
+
+void HyperLogLogTest::testEstimateSmall(void)
+{
+  HyperLogLog sketch;
+  addRange(sketch, 0, 10);
+  addRange(sketch, 5, 15);
+  CPPUNIT_ASSERT(std::fabs(sketch.estimate() - 15.0) < 0.5);
+}
+
+void HyperLogLogTest::testMerge(void)
+{
+  HyperLogLog a(12);
+  HyperLogLog b(12);
+  addRange(a, 0, 30000);
+  addRange(b, 20000, 50000);
+  a.merge(b);
+
+  HyperLogLog all(12);
+  addRange(all, 0, 50000);
+  CPPUNIT_ASSERT_EQUAL(all.estimate(), a.estimate());
+  CPPUNIT_ASSERT(std::fabs(a.estimate() - 50000.0) < 50000.0 * 0.06);
+}
+
+void HyperLogLogTest::testThrowInvalidArgument(void)
+{
+  try {
+    HyperLogLog sketch(3);
+    CPPUNIT_FAIL("std::invalid_argument must be throw.");
+  } catch (std::invalid_argument& e) {
+  }
+
+  try {
+    HyperLogLog sketch(19);
+    CPPUNIT_FAIL("std::invalid_argument must be throw.");
+  } catch (std::invalid_argument& e) {
+  }
+
+  try {
+    HyperLogLog a(10);
+    HyperLogLog b(11);
+    a.merge(b);
+    CPPUNIT_FAIL("std::invalid_argument must be throw.");
+  } catch (std::invalid_argument& e) {
+  }
+}
+
+} // namespace csv
+} // namespace csl
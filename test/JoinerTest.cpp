@@ -0,0 +1,268 @@
+#include <cppunit/extensions/HelperMacros.h>
+#include "csl/csv/Joiner.hpp"
+#include "csl/csv/Util.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <dirent.h>
+
+namespace csl {
+namespace csv {
+
+class JoinerTest : public CPPUNIT_NS::TestFixture
+{
+  CPPUNIT_TEST_SUITE(JoinerTest);
+  CPPUNIT_TEST(testJoinInner);
+  CPPUNIT_TEST(testJoinLeft);
+  CPPUNIT_TEST(testJoinOutputs);
+  CPPUNIT_TEST(testJoinPartitioned);
+  CPPUNIT_TEST(testJoinRepartitioned);
+  CPPUNIT_TEST(testJoinPartitionedThrowLengthError);
+  CPPUNIT_TEST(testJoinFile);
+  CPPUNIT_TEST(testJoinFileThrowFailure);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  virtual void setUp(void);
+  virtual void tearDown(void);
+
+private:
+  void testJoinInner(void);
+  void testJoinLeft(void);
+  void testJoinOutputs(void);
+  void testJoinPartitioned(void);
+  void testJoinRepartitioned(void);
+  void testJoinPartitionedThrowLengthError(void);
+  void testJoinFile(void);
+  void testJoinFileThrowFailure(void);
+
+private:
+  std::string join(Joiner& joiner, const std::string& probe, const std::string& build);
+  std::string makeData(const std::size_t count, const std::size_t modulo);
+  std::vector<std::string> sortLines(const std::string& data);
+  std::size_t countTempFiles(void);
+
+private:
+  std::string probepath;
+  std::string buildpath;
+  std::string outpath;
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(JoinerTest);
+
+void JoinerTest::setUp(void)
+{
+  probepath = "./test/join_probe.csv";
+  buildpath = "./test/join_build.csv";
+  outpath = "./test/join_out.csv";
+}
+
+void JoinerTest::tearDown(void)
+{
+  std::remove(probepath.c_str());
+  std::remove(buildpath.c_str());
+  std::remove(outpath.c_str());
+}
+
+std::string JoinerTest::join(Joiner& joiner, const std::string& probe, const std::string& build)
+{
+  std::istringstream probeStream(probe);
+  std::istringstream buildStream(build);
+  std::ostringstream out;
+  joiner.join(probeStream, buildStream, out);
+  return out.str();
+}
+
+std::string JoinerTest::makeData(const std::size_t count, const std::size_t modulo)
+{
+  std::ostringstream data;
+
+  for (std::size_t i = 0; i < count; i++) {
+    data << (i * 7919) % modulo << ",\"value " << i << "\"\r\n";
+  }
+
+  return data.str();
+}
+
+std::vector<std::string> JoinerTest::sortLines(const std::string& data)
+{
+  std::vector<std::string> lines;
+  std::istringstream stream(data);
+  std::string line;
+
+  while (std::getline(stream, line)) {
+    lines.push_back(line);
+  }
+  std::sort(lines.begin(), lines.end());
+
+  return lines;
+}
+
+std::size_t JoinerTest::countTempFiles(void)
+{
+  std::size_t count = 0;
+  DIR* dir = opendir("./test");
+  struct dirent* entry;
+
+  while ((entry = readdir(dir)) != NULL) {
+    if (std::string(entry->d_name).compare(0, 7, "cslcsv-") == 0) {
+      count++;
+    }
+  }
+  closedir(dir);
+
+  return count;
+}
+
+void JoinerTest::testJoinInner(void)
+{
+  Joiner joiner(0, 0);
+  CPPUNIT_ASSERT_EQUAL(Joiner::JOIN_INNER, joiner.getType());
+
+  CPPUNIT_ASSERT_EQUAL(std::string("\"1\",\"a\",\"1\",\"X\"\r\n"
+				   "\"1\",\"a\",\"1\",\"Z\"\r\n"
+				   "\"3\",\"c\",\"3\",\"Y\"\r\n"
+				   "\"1\",\"d\",\"1\",\"X\"\r\n"
+				   "\"1\",\"d\",\"1\",\"Z\"\r\n"),
+		       join(joiner, "1,a\r\n2,b\r\n3,c\r\n1,d\r\n", "1,X\r\n3,Y\r\n1,Z\r\n"));
+  CPPUNIT_ASSERT(!joiner.isPartitioned());
+}
+
+void JoinerTest::testJoinLeft(void)
+{
+  Joiner joiner(1, 0);
+  joiner.setType(Joiner::JOIN_LEFT);
+
+  CPPUNIT_ASSERT_EQUAL(std::string("\"a\",\"1\",\"1\",\"X\",\"x\"\r\n"
+				   "\"b\",\"2\",\"\",\"\",\"\"\r\n"
+				   "\"c\",\"\",\"\",\"\"\r\n"),
+		       join(joiner, "a,1\r\nb,2\r\nc\r\n\r\n", "1,X,x\r\n3\r\n"));
+}
+
+void JoinerTest::testJoinOutputs(void)
+{
+  Joiner joiner(0, 1);
+  joiner.setType(Joiner::JOIN_LEFT);
+  joiner.addOutput(Joiner::SIDE_BUILD, 0);
+  joiner.addOutput(Joiner::SIDE_PROBE, 1);
+  joiner.addOutput(Joiner::SIDE_BUILD, 5);
+
+  CPPUNIT_ASSERT_EQUAL(std::string("\"Tokyo\",\"a\",\"\"\r\n\"\",\"b\",\"\"\r\n"),
+		       join(joiner, "13,a\r\n27,b\r\n", "Tokyo,13\r\nOsaka,27 \r\n"));
+
+  joiner.clearOutputs();
+  joiner.setType(Joiner::JOIN_INNER);
+  CPPUNIT_ASSERT_EQUAL(std::string("\"13\",\"a\",\"Tokyo\",\"13\"\r\n"),
+		       join(joiner, "13,a\r\n27,b\r\n", "Tokyo,13\r\nOsaka,27 \r\n"));
+}
+
+void JoinerTest::testJoinPartitioned(void)
+{
+  const std::string probe = makeData(3000, 500) + "x\r\n";
+  const std::string build = makeData(1000, 700);
+
+  Joiner memory(0, 0);
+  memory.setType(Joiner::JOIN_LEFT);
+  const std::string expected = join(memory, probe, build);
+  CPPUNIT_ASSERT(!memory.isPartitioned());
+
+  Joiner partitioned(0, 0);
+  partitioned.setType(Joiner::JOIN_LEFT);
+  partitioned.setMemoryLimit(4096);
+  partitioned.setTempDirectory("./test");
+  const std::string result = join(partitioned, probe, build);
+  CPPUNIT_ASSERT(partitioned.isPartitioned());
+  CPPUNIT_ASSERT(sortLines(result) == sortLines(expected));
+  CPPUNIT_ASSERT_EQUAL((std::size_t)0, countTempFiles());
+}
+
+void JoinerTest::testJoinRepartitioned(void)
+{
+  const std::string probe = makeData(20000, 5000);
+  const std::string build = makeData(5000, 5000);
+
+  Joiner memory(0, 0);
+  const std::string expected = join(memory, probe, build);
+
+  // each of the first files still exceeds the limit and is split again
+  Joiner partitioned(0, 0);
+  partitioned.setMemoryLimit(2048);
+  partitioned.setTempDirectory("./test");
+  const std::string result = join(partitioned, probe, build);
+  CPPUNIT_ASSERT(partitioned.isPartitioned());
+  CPPUNIT_ASSERT(sortLines(result) == sortLines(expected));
+  CPPUNIT_ASSERT_EQUAL((std::size_t)0, countTempFiles());
+}
+
+void JoinerTest::testJoinPartitionedThrowLengthError(void)
+{
+  const std::string build = makeData(1000, 1);
+
+  Joiner joiner(0, 0);
+  joiner.setMemoryLimit(4096);
+  joiner.setTempDirectory("./test");
+
+  try {
+    join(joiner, "0,a\r\n", build);
+    CPPUNIT_FAIL("std::length_error must be throw.");
+  } catch (std::length_error&) {
+    CPPUNIT_ASSERT_EQUAL((std::size_t)0, countTempFiles());
+  }
+}
+
+void JoinerTest::testJoinFile(void)
+{
+  std::ofstream probe(probepath.c_str(), std::ofstream::binary);
+  probe << makeData(20000, 3000);
+  probe.close();
+  std::ofstream build(buildpath.c_str(), std::ofstream::binary);
+  build << makeData(2000, 2500);
+  build.close();
+
+  Joiner serial(0, 0);
+  serial.join(probepath, buildpath, outpath);
+  std::ifstream in(outpath.c_str(), std::ifstream::binary);
+  const std::string expected((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+  in.close();
+  CPPUNIT_ASSERT(!expected.empty());
+
+  Joiner parallel(0, 0);
+  parallel.setThreadCount(4);
+  parallel.setTempDirectory("./test");
+  parallel.join(probepath, buildpath, outpath);
+  std::ifstream result(outpath.c_str(), std::ifstream::binary);
+  CPPUNIT_ASSERT(expected == std::string((std::istreambuf_iterator<char>(result)), std::istreambuf_iterator<char>()));
+  result.close();
+  CPPUNIT_ASSERT_EQUAL((std::size_t)0, countTempFiles());
+}
+
+void JoinerTest::testJoinFileThrowFailure(void)
+{
+  Joiner joiner(0, 0);
+
+  try {
+    joiner.join("./", buildpath, outpath);
+    CPPUNIT_FAIL("std::ios_base::failure must be throw.");
+  } catch (std::ios_base::failure&) {
+    CPPUNIT_ASSERT(true);
+  }
+
+  std::ofstream probe(probepath.c_str(), std::ofstream::binary);
+  probe << "1\r\n";
+  probe.close();
+
+  try {
+    joiner.join(probepath, "./", outpath);
+    CPPUNIT_FAIL("std::ios_base::failure must be throw.");
+  } catch (std::ios_base::failure&) {
+    CPPUNIT_ASSERT(true);
+  }
+}
+
+} // namespace csv
+} // namespace csl
@@ -0,0 +1,111 @@
+#include <cppunit/extensions/HelperMacros.h>
+#include "csl/csv/KeyComparator.hpp"
+#include <cmath>
+#include <string>
+#include <vector>
+
+namespace csl {
+namespace csv {
+
+class KeyComparatorTest : public CPPUNIT_NS::TestFixture
+{
+  CPPUNIT_TEST_SUITE(KeyComparatorTest);
+  CPPUNIT_TEST(testCompareString);
+  CPPUNIT_TEST(testCompareNumeric);
+  CPPUNIT_TEST(testCompareKeys);
+  CPPUNIT_TEST(testCompareMissingColumn);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  virtual void setUp(void);
+  virtual void tearDown(void);
+
+private:
+  void testCompareString(void);
+  void testCompareNumeric(void);
+  void testCompareKeys(void);
+  void testCompareMissingColumn(void);
+
+private:
+  std::vector<std::string> makeRecord(const std::string& a, const std::string& b);
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(KeyComparatorTest);
+
+void KeyComparatorTest::setUp(void)
+{
+}
+
+void KeyComparatorTest::tearDown(void)
+{
+}
+
+std::vector<std::string> KeyComparatorTest::makeRecord(const std::string& a, const std::string& b)
+{
+  std::vector<std::string> record;
+  record.push_back(a);
+  record.push_back(b);
+  return record;
+}
+
+void KeyComparatorTest::testCompareString(void)
+{
+  KeyComparator comparator;
+  comparator.addKey(1, KeyComparator::COLLATION_STRING);
+
+  CPPUNIT_ASSERT_EQUAL((std::size_t)1, comparator.getKeyCount());
+  CPPUNIT_ASSERT_EQUAL((std::size_t)1, comparator.getColumn(0));
+  CPPUNIT_ASSERT_EQUAL(KeyComparator::COLLATION_STRING, comparator.getCollation(0));
+  CPPUNIT_ASSERT_EQUAL(-1, comparator.compare(makeRecord("2", "Nagoya"), makeRecord("1", "Osaka")));
+  CPPUNIT_ASSERT_EQUAL(1, comparator.compare(makeRecord("1", "b"), makeRecord("2", "a")));
+  CPPUNIT_ASSERT_EQUAL(0, comparator.compare(makeRecord("1", "a"), makeRecord("2", "a")));
+
+  // bytes are compared as unsigned
+  CPPUNIT_ASSERT_EQUAL(-1, comparator.compare(makeRecord("1", "a"), makeRecord("2", "\xe6\x9d\xb1")));
+}
+
+void KeyComparatorTest::testCompareNumeric(void)
+{
+  KeyComparator comparator;
+  comparator.addKey(0, KeyComparator::COLLATION_NUMERIC);
+
+  CPPUNIT_ASSERT_EQUAL(-1, comparator.compare(makeRecord("2.5", ""), makeRecord("10", "")));
+  CPPUNIT_ASSERT_EQUAL(-1, comparator.compare(makeRecord("-1e3", ""), makeRecord("0", "")));
+  CPPUNIT_ASSERT_EQUAL(0, comparator.compare(makeRecord("-0", ""), makeRecord("0", "")));
+
+  // values that are not numbers follow the numbers and are compared as strings
+  CPPUNIT_ASSERT_EQUAL(-1, comparator.compare(makeRecord("10", ""), makeRecord("abc", "")));
+  CPPUNIT_ASSERT_EQUAL(-1, comparator.compare(makeRecord("abc", ""), makeRecord("nan", "")));
+
+  double number;
+  CPPUNIT_ASSERT(KeyComparator::parseNumber("-0", number));
+  CPPUNIT_ASSERT(!std::signbit(number));
+  CPPUNIT_ASSERT(!KeyComparator::parseNumber(" 1", number));
+}
+
+void KeyComparatorTest::testCompareKeys(void)
+{
+  KeyComparator comparator;
+  comparator.addKey(0, KeyComparator::COLLATION_STRING);
+  comparator.addKey(1, KeyComparator::COLLATION_NUMERIC);
+
+  CPPUNIT_ASSERT_EQUAL(-1, comparator.compare(makeRecord("a", "2"), makeRecord("a", "10")));
+  CPPUNIT_ASSERT_EQUAL(1, comparator.compare(makeRecord("b", "1"), makeRecord("a", "10")));
+
+  comparator.clearKeys();
+  CPPUNIT_ASSERT_EQUAL((std::size_t)0, comparator.getKeyCount());
+  CPPUNIT_ASSERT_EQUAL(0, comparator.compare(makeRecord("b", "1"), makeRecord("a", "10")));
+}
+
+void KeyComparatorTest::testCompareMissingColumn(void)
+{
+  KeyComparator comparator;
+  comparator.addKey(1, KeyComparator::COLLATION_STRING);
+
+  // a record without the key column compares as an empty string
+  CPPUNIT_ASSERT_EQUAL(0, comparator.compare(std::vector<std::string>(1, "x"), makeRecord("y", "")));
+  CPPUNIT_ASSERT_EQUAL(-1, comparator.compare(std::vector<std::string>(1, "x"), makeRecord("y", "a")));
+}
+
+} // namespace csv
+} // namespace csl
@@ -0,0 +1,143 @@
+#include <cppunit/extensions/HelperMacros.h>
+#include "csl/csv/LazyRecord.hpp"
+#include <string>
+#include <sstream>
+#include <stdexcept>
+#include "csl/csv/Reader.hpp"
+
+namespace csl {
+namespace csv {
+
+class LazyRecordTest : public CPPUNIT_NS::TestFixture
+{
+  CPPUNIT_TEST_SUITE(LazyRecordTest);
+  CPPUNIT_TEST(testLazyRecord);
+  CPPUNIT_TEST(testClear);
+  CPPUNIT_TEST(testGetRaw);
+  CPPUNIT_TEST(testFlags);
+  CPPUNIT_TEST(testGet);
+  CPPUNIT_TEST(testGetQuoteDisabled);
+  CPPUNIT_TEST(testGetThrowOutOfRange);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  virtual void setUp(void);
+  virtual void tearDown(void);
+
+private:
+  void testLazyRecord(void);
+  void testClear(void);
+  void testGetRaw(void);
+  void testFlags(void);
+  void testGet(void);
+  void testGetQuoteDisabled(void);
+  void testGetThrowOutOfRange(void);
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(LazyRecordTest);
+
+void LazyRecordTest::setUp(void)
+{
+}
+
+void LazyRecordTest::tearDown(void)
+{
+}
+
+void LazyRecordTest::testLazyRecord(void)
+{
+  LazyRecord record;
+  CPPUNIT_ASSERT_EQUAL((std::size_t)0, record.size());
+}
+
+void LazyRecordTest::testClear(void)
+{
+  std::stringstream stream("aaa,bbb\r\n");
+  Reader reader(stream);
+  LazyRecord record;
+  reader.read(record);
+  CPPUNIT_ASSERT_EQUAL((std::size_t)2, record.size());
+
+  record.clear();
+  CPPUNIT_ASSERT_EQUAL((std::size_t)0, record.size());
+}
+
+void LazyRecordTest::testGetRaw(void)
+{
+  std::stringstream stream("aaa,\"b\"\"b\",\r\n");
+  Reader reader(stream);
+  LazyRecord record;
+  reader.read(record);
+
+  CPPUNIT_ASSERT_EQUAL((std::size_t)2, record.size());
+  CPPUNIT_ASSERT(std::string(record.getRawData(0), record.getRawSize(0)) == "aaa");
+  CPPUNIT_ASSERT(std::string(record.getRawData(1), record.getRawSize(1)) == "\"b\"\"b\"");
+}
+
+void LazyRecordTest::testFlags(void)
+{
+  std::stringstream stream("aaa,\"bbb\",\"c\"\"c\",\"d\r\nd\"\r\n");
+  Reader reader(stream);
+  LazyRecord record;
+  reader.read(record);
+
+  CPPUNIT_ASSERT_EQUAL((std::size_t)4, record.size());
+  CPPUNIT_ASSERT(!record.isQuoted(0));
+  CPPUNIT_ASSERT(!record.hasEscapedQuotes(0));
+  CPPUNIT_ASSERT(!record.hasLineBreaks(0));
+  CPPUNIT_ASSERT(record.isQuoted(1));
+  CPPUNIT_ASSERT(!record.hasEscapedQuotes(1));
+  CPPUNIT_ASSERT(!record.hasLineBreaks(1));
+  CPPUNIT_ASSERT(record.isQuoted(2));
+  CPPUNIT_ASSERT(record.hasEscapedQuotes(2));
+  CPPUNIT_ASSERT(!record.hasLineBreaks(2));
+  CPPUNIT_ASSERT(record.isQuoted(3));
+  CPPUNIT_ASSERT(!record.hasEscapedQuotes(3));
+  CPPUNIT_ASSERT(record.hasLineBreaks(3));
+}
+
+void LazyRecordTest::testGet(void)
+{
+  std::stringstream stream("aaa,\"bbb\",\"c\"\"c\",\"d\r\nd\"\r\n");
+  Reader reader(stream);
+  LazyRecord record;
+  reader.read(record);
+
+  CPPUNIT_ASSERT(record.get(0) == "aaa");
+  CPPUNIT_ASSERT(record.get(1) == "bbb");
+  CPPUNIT_ASSERT(record.get(2) == "c\"c");
+  CPPUNIT_ASSERT(record.get(3) == "d\r\nd");
+
+  std::string field;
+  record.get(2, field);
+  CPPUNIT_ASSERT(field == "c\"c");
+}
+
+void LazyRecordTest::testGetQuoteDisabled(void)
+{
+  std::stringstream stream("aaa,\"b\"\"b\"\r\n");
+  Config config;
+  config.setQuoteEnabled(false);
+  Reader reader(stream, config);
+  LazyRecord record;
+  reader.read(record);
+
+  CPPUNIT_ASSERT_EQUAL((std::size_t)2, record.size());
+  CPPUNIT_ASSERT(!record.isQuoted(1));
+  CPPUNIT_ASSERT(record.get(1) == "\"b\"\"b\"");
+}
+
+void LazyRecordTest::testGetThrowOutOfRange(void)
+{
+  LazyRecord record;
+
+  try {
+    record.get(0);
+    CPPUNIT_FAIL("std::out_of_range must be throw.");
+  } catch (std::out_of_range&) {
+    CPPUNIT_ASSERT(true);
+  }
+}
+
+} // namespace csv
+} // namespace csl
@@ -0,0 +1,112 @@
+#include <cppunit/extensions/HelperMacros.h>
+#include "csl/csv/LoserTree.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+namespace csl {
+namespace csv {
+
+class LoserTreeTest : public CPPUNIT_NS::TestFixture
+{
+  CPPUNIT_TEST_SUITE(LoserTreeTest);
+  CPPUNIT_TEST(testMerge);
+  CPPUNIT_TEST(testMergeSingle);
+  CPPUNIT_TEST(testLoserTreeThrowInvalidArgument);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  virtual void setUp(void);
+  virtual void tearDown(void);
+
+private:
+  void testMerge(void);
+  void testMergeSingle(void);
+  void testLoserTreeThrowInvalidArgument(void);
+
+private:
+  std::vector<int> merge(const std::vector<std::vector<int> >& inputs);
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(LoserTreeTest);
+
+void LoserTreeTest::setUp(void)
+{
+}
+
+void LoserTreeTest::tearDown(void)
+{
+}
+
+std::vector<int> LoserTreeTest::merge(const std::vector<std::vector<int> >& inputs)
+{
+  std::vector<std::size_t> positions(inputs.size(), 0);
+  const auto less = [&inputs, &positions](const std::size_t a, const std::size_t b) {
+    const bool aDone = positions[a] == inputs[a].size();
+    const bool bDone = positions[b] == inputs[b].size();
+    if (aDone || bDone) {
+      return !aDone;
+    }
+    const int x = inputs[a][positions[a]];
+    const int y = inputs[b][positions[b]];
+    return (x != y) ? (x < y) : (a < b);
+  };
+
+  LoserTree tree(inputs.size());
+  tree.build(less);
+
+  std::vector<int> output;
+  while (positions[tree.top()] < inputs[tree.top()].size()) {
+    output.push_back(inputs[tree.top()][positions[tree.top()]]);
+    positions[tree.top()]++;
+    tree.replay(less);
+  }
+  return output;
+}
+
+void LoserTreeTest::testMerge(void)
+{
+  for (std::size_t count = 1; count <= 9; count++) {
+    std::vector<std::vector<int> > inputs(count);
+    std::size_t total = 0;
+    for (std::size_t i = 0; i < count; i++) {
+      // some inputs are empty, values overlap between inputs
+      for (std::size_t j = 0; j < (i * 7) % 5; j++) {
+	inputs[i].push_back(static_cast<int>((j * 3 + i) % 11));
+	total++;
+      }
+      std::sort(inputs[i].begin(), inputs[i].end());
+    }
+
+    const std::vector<int> output = merge(inputs);
+    CPPUNIT_ASSERT_EQUAL(total, output.size());
+    for (std::size_t i = 1; i < output.size(); i++) {
+      CPPUNIT_ASSERT(output[i - 1] <= output[i]);
+    }
+  }
+}
+
+void LoserTreeTest::testMergeSingle(void)
+{
+  std::vector<std::vector<int> > inputs(1);
+  inputs[0].push_back(1);
+  inputs[0].push_back(2);
+
+  LoserTree tree(1);
+  CPPUNIT_ASSERT_EQUAL((std::size_t)1, tree.size());
+  CPPUNIT_ASSERT(merge(inputs) == inputs[0]);
+}
+
+void LoserTreeTest::testLoserTreeThrowInvalidArgument(void)
+{
+  try {
+    LoserTree tree(0);
+    CPPUNIT_FAIL("std::invalid_argument must be throw.");
+  } catch (std::invalid_argument&) {
+    CPPUNIT_ASSERT(true);
+  }
+}
+
+} // namespace csv
+} // namespace csl
@@ -0,0 +1,217 @@
+#include <cppunit/extensions/HelperMacros.h>
+#include "csl/csv/Merger.hpp"
+#include "csl/csv/Util.hpp"
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+namespace csl {
+namespace csv {
+
+class MergerTest : public CPPUNIT_NS::TestFixture
+{
+  CPPUNIT_TEST_SUITE(MergerTest);
+  CPPUNIT_TEST(testMerge);
+  CPPUNIT_TEST(testMergeUnique);
+  CPPUNIT_TEST(testMergeEmpty);
+  CPPUNIT_TEST(testMergeThrowInvalidArgument);
+  CPPUNIT_TEST(testMergeFile);
+  CPPUNIT_TEST(testMergeFileThrowFailure);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  virtual void setUp(void);
+  virtual void tearDown(void);
+
+private:
+  void testMerge(void);
+  void testMergeUnique(void);
+  void testMergeEmpty(void);
+  void testMergeThrowInvalidArgument(void);
+  void testMergeFile(void);
+  void testMergeFileThrowFailure(void);
+
+private:
+  std::string merge(Merger& merger, const std::vector<std::string>& inputs);
+  void writeFile(const std::string& filepath, const std::string& data);
+
+private:
+  std::vector<std::string> filepaths;
+  std::string outpath;
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(MergerTest);
+
+void MergerTest::setUp(void)
+{
+  filepaths.clear();
+  filepaths.push_back("./test/merge_0.csv");
+  filepaths.push_back("./test/merge_1.csv");
+  filepaths.push_back("./test/merge_2.csv");
+  outpath = "./test/merge_out.csv";
+}
+
+void MergerTest::tearDown(void)
+{
+  for (std::size_t i = 0; i < filepaths.size(); i++) {
+    std::remove(filepaths[i].c_str());
+  }
+  std::remove(outpath.c_str());
+}
+
+std::string MergerTest::merge(Merger& merger, const std::vector<std::string>& inputs)
+{
+  std::vector<std::istringstream*> owned;
+  std::vector<std::istream*> streams;
+  for (std::size_t i = 0; i < inputs.size(); i++) {
+    owned.push_back(new std::istringstream(inputs[i]));
+    streams.push_back(owned.back());
+  }
+
+  std::ostringstream out;
+  try {
+    merger.merge(streams, out);
+  } catch (...) {
+    for (std::size_t i = 0; i < owned.size(); i++) {
+      delete owned[i];
+    }
+    throw;
+  }
+
+  for (std::size_t i = 0; i < owned.size(); i++) {
+    delete owned[i];
+  }
+  return out.str();
+}
+
+void MergerTest::writeFile(const std::string& filepath, const std::string& data)
+{
+  std::ofstream stream(filepath.c_str(), std::ofstream::binary | std::ofstream::trunc);
+  stream << data;
+  stream.close();
+}
+
+void MergerTest::testMerge(void)
+{
+  Merger merger;
+  merger.addKey(0, KeyComparator::COLLATION_NUMERIC);
+
+  std::vector<std::string> inputs;
+  inputs.push_back("1,a\r\n5,a\r\n10,a\r\n");
+  inputs.push_back("");
+  inputs.push_back("2,c\r\n5,c\r\n5,d\r\n9,c\r\n");
+
+  CPPUNIT_ASSERT_EQUAL(std::string("\"1\",\"a\"\r\n\"2\",\"c\"\r\n\"5\",\"a\"\r\n\"5\",\"c\"\r\n\"5\",\"d\"\r\n"
+				   "\"9\",\"c\"\r\n\"10\",\"a\"\r\n"),
+		       merge(merger, inputs));
+  CPPUNIT_ASSERT_EQUAL((std::size_t)7, merger.getRecordCount());
+  CPPUNIT_ASSERT_EQUAL((std::size_t)0, merger.getDuplicateCount());
+}
+
+void MergerTest::testMergeUnique(void)
+{
+  Merger merger;
+  merger.addKey(0, KeyComparator::COLLATION_STRING);
+  merger.setUnique(true);
+  CPPUNIT_ASSERT(merger.getUnique());
+
+  std::vector<std::string> inputs;
+  inputs.push_back("a,1\r\nb,1\r\nb,2\r\n");
+  inputs.push_back("a,2\r\nc,2\r\n");
+
+  CPPUNIT_ASSERT_EQUAL(std::string("\"a\",\"1\"\r\n\"b\",\"1\"\r\n\"c\",\"2\"\r\n"),
+		       merge(merger, inputs));
+  CPPUNIT_ASSERT_EQUAL((std::size_t)3, merger.getRecordCount());
+  CPPUNIT_ASSERT_EQUAL((std::size_t)2, merger.getDuplicateCount());
+}
+
+void MergerTest::testMergeEmpty(void)
+{
+  Merger merger;
+  merger.addKey(0, KeyComparator::COLLATION_STRING);
+
+  CPPUNIT_ASSERT_EQUAL(std::string(""), merge(merger, std::vector<std::string>()));
+  CPPUNIT_ASSERT_EQUAL(std::string(""), merge(merger, std::vector<std::string>(2)));
+}
+
+void MergerTest::testMergeThrowInvalidArgument(void)
+{
+  Merger merger;
+  std::vector<std::string> inputs;
+  inputs.push_back("a\r\nc\r\n");
+  inputs.push_back("b\r\na\r\n");
+
+  try {
+    merge(merger, inputs);
+    CPPUNIT_FAIL("std::invalid_argument must be throw.");
+  } catch (std::invalid_argument&) {
+    CPPUNIT_ASSERT(true);
+  }
+
+  merger.addKey(0, KeyComparator::COLLATION_STRING);
+  try {
+    merge(merger, inputs);
+    CPPUNIT_FAIL("std::invalid_argument must be throw.");
+  } catch (std::invalid_argument&) {
+    CPPUNIT_ASSERT(true);
+  }
+}
+
+void MergerTest::testMergeFile(void)
+{
+  std::vector<std::string> expected;
+  for (std::size_t i = 0; i < filepaths.size(); i++) {
+    std::ostringstream data;
+    for (std::size_t j = 0; j < 100; j++) {
+      data << j * 3 + i << ",\"" << std::string(j % 7 + 1, 'x') << "\"\r\n";
+    }
+    writeFile(filepaths[i], data.str());
+  }
+  for (std::size_t i = 0; i < 300; i++) {
+    std::ostringstream line;
+    line << "\"" << i << "\",\"" << std::string((i / 3) % 7 + 1, 'x') << "\"\r\n";
+    expected.push_back(line.str());
+  }
+
+  Merger merger;
+  merger.addKey(0, KeyComparator::COLLATION_NUMERIC);
+  merger.setBufferSize(16);
+  CPPUNIT_ASSERT_EQUAL((std::size_t)16, merger.getBufferSize());
+  merger.merge(filepaths, outpath);
+  CPPUNIT_ASSERT_EQUAL((std::size_t)300, merger.getRecordCount());
+
+  std::ifstream in(outpath.c_str(), std::ifstream::binary);
+  const std::string result((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+  in.close();
+
+  std::string joined;
+  for (std::size_t i = 0; i < expected.size(); i++) {
+    joined += expected[i];
+  }
+  CPPUNIT_ASSERT_EQUAL(joined, result);
+}
+
+void MergerTest::testMergeFileThrowFailure(void)
+{
+  Merger merger;
+  merger.addKey(0, KeyComparator::COLLATION_STRING);
+  writeFile(filepaths[0], "a\r\n");
+
+  std::vector<std::string> inputs;
+  inputs.push_back(filepaths[0]);
+  inputs.push_back("./");
+
+  try {
+    merger.merge(inputs, outpath);
+    CPPUNIT_FAIL("std::ios_base::failure must be throw.");
+  } catch (std::ios_base::failure&) {
+    CPPUNIT_ASSERT(true);
+  }
+}
+
+} // namespace csv
+} // namespace csl
@@ -0,0 +1,219 @@
+#include <cppunit/extensions/HelperMacros.h>
+#include "csl/csv/PartitionedWriter.hpp"
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+namespace csl {
+namespace csv {
+
+class PartitionedWriterTest : public CPPUNIT_NS::TestFixture
+{
+  CPPUNIT_TEST_SUITE(PartitionedWriterTest);
+  CPPUNIT_TEST(testWrite);
+  CPPUNIT_TEST(testWriteHash);
+  CPPUNIT_TEST(testWriteMemoryLimit);
+  CPPUNIT_TEST(testWriteAfterClose);
+  CPPUNIT_TEST(testWriteThrowFailure);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  virtual void setUp(void);
+  virtual void tearDown(void);
+
+private:
+  void testWrite(void);
+  void testWriteHash(void);
+  void testWriteMemoryLimit(void);
+  void testWriteAfterClose(void);
+  void testWriteThrowFailure(void);
+
+private:
+  std::vector<std::string> makeRecord(const std::string& key, const std::string& value);
+  std::string readFile(const std::string& filepath);
+
+private:
+  std::vector<std::string> filepaths;
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(PartitionedWriterTest);
+
+void PartitionedWriterTest::setUp(void)
+{
+  filepaths.clear();
+}
+
+void PartitionedWriterTest::tearDown(void)
+{
+  for (std::size_t i = 0; i < filepaths.size(); i++) {
+    std::remove(filepaths[i].c_str());
+  }
+}
+
+std::vector<std::string> PartitionedWriterTest::makeRecord(const std::string& key, const std::string& value)
+{
+  std::vector<std::string> record;
+  record.push_back(key);
+  record.push_back(value);
+  return record;
+}
+
+std::string PartitionedWriterTest::readFile(const std::string& filepath)
+{
+  std::ifstream stream(filepath.c_str(), std::ifstream::binary);
+  return std::string(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+}
+
+void PartitionedWriterTest::testWrite(void)
+{
+  PartitionedWriter writer("./test/part_", ".csv", 0);
+  CPPUNIT_ASSERT_EQUAL((std::size_t)0, writer.getPartitionCount());
+  CPPUNIT_ASSERT_EQUAL(PARTITION_MEMORY_LIMIT, writer.getMemoryLimit());
+  CPPUNIT_ASSERT_EQUAL(PARTITION_OPEN_FILES, writer.getMaxOpenFiles());
+
+  writer.write(makeRecord("a", "1"));
+  writer.write(makeRecord("b/c", "2"));
+  writer.write(makeRecord("a", "3"));
+  writer.write(makeRecord("", "4"));
+  writer.write(makeRecord(".x", "5"));
+  writer.write(std::vector<std::string>());
+  CPPUNIT_ASSERT_EQUAL((std::size_t)4, writer.size());
+  for (std::size_t i = 0; i < writer.size(); i++) {
+    filepaths.push_back(writer.getPath(i));
+  }
+  writer.close();
+
+  CPPUNIT_ASSERT_EQUAL(std::string("./test/part_a.csv"), writer.getPath(0));
+  CPPUNIT_ASSERT_EQUAL(std::string("./test/part_b%2Fc.csv"), writer.getPath(1));
+  CPPUNIT_ASSERT_EQUAL(std::string("./test/part_%.csv"), writer.getPath(2));
+  CPPUNIT_ASSERT_EQUAL(std::string("./test/part_%2Ex.csv"), writer.getPath(3));
+
+  CPPUNIT_ASSERT_EQUAL(std::string("\"a\",\"1\"\r\n\"a\",\"3\"\r\n"), readFile(writer.getPath(0)));
+  CPPUNIT_ASSERT_EQUAL(std::string("\"b/c\",\"2\"\r\n"), readFile(writer.getPath(1)));
+  CPPUNIT_ASSERT_EQUAL(std::string("\"\",\"4\"\r\n\r\n"), readFile(writer.getPath(2)));
+  CPPUNIT_ASSERT_EQUAL(std::string("\".x\",\"5\"\r\n"), readFile(writer.getPath(3)));
+
+  try {
+    writer.getPath(4);
+    CPPUNIT_FAIL("std::out_of_range must be throw.");
+  } catch (std::out_of_range& e) {
+  }
+}
+
+void PartitionedWriterTest::testWriteHash(void)
+{
+  PartitionedWriter writer("./test/part_", ".csv", 1);
+  writer.setPartitionCount(4);
+  CPPUNIT_ASSERT_EQUAL((std::size_t)4, writer.getPartitionCount());
+
+  for (std::size_t i = 0; i < 100; i++) {
+    std::ostringstream key;
+    key << (i % 10);
+    writer.write(makeRecord("v", key.str()));
+  }
+  CPPUNIT_ASSERT_EQUAL((std::size_t)4, writer.size());
+  for (std::size_t i = 0; i < writer.size(); i++) {
+    std::ostringstream path;
+    path << "./test/part_" << i << ".csv";
+    CPPUNIT_ASSERT_EQUAL(path.str(), writer.getPath(i));
+    filepaths.push_back(path.str());
+  }
+  writer.close();
+
+  // every key lands in exactly one file, all of its records together
+  std::size_t total = 0;
+  for (std::size_t key = 0; key < 10; key++) {
+    std::ostringstream line;
+    line << "\"v\",\"" << key << "\"\r\n";
+    std::size_t files = 0;
+    for (std::size_t i = 0; i < filepaths.size(); i++) {
+      const std::string data = readFile(filepaths[i]);
+      std::size_t count = 0;
+      for (std::size_t pos = data.find(line.str()); pos != std::string::npos; pos = data.find(line.str(), pos + 1)) {
+	count++;
+      }
+      if (count > 0) {
+	CPPUNIT_ASSERT_EQUAL((std::size_t)10, count);
+	files++;
+      }
+      total += count;
+    }
+    CPPUNIT_ASSERT_EQUAL((std::size_t)1, files);
+  }
+  CPPUNIT_ASSERT_EQUAL((std::size_t)100, total);
+}
+
+void PartitionedWriterTest::testWriteMemoryLimit(void)
+{
+  Config config;
+  config.setQuoteEnabled(false);
+
+  PartitionedWriter writer("./test/part_", ".csv", 0, config);
+  writer.setMemoryLimit(64);
+  writer.setMaxOpenFiles(2);
+  CPPUNIT_ASSERT_EQUAL((std::size_t)64, writer.getMemoryLimit());
+  CPPUNIT_ASSERT_EQUAL((std::size_t)2, writer.getMaxOpenFiles());
+
+  std::vector<std::string> expected(10);
+  for (std::size_t i = 0; i < 1000; i++) {
+    std::ostringstream key;
+    std::ostringstream value;
+    key << "k" << (i * 7 % 10);
+    value << i;
+    writer.write(makeRecord(key.str(), value.str()));
+    expected[i * 7 % 10] += key.str() + "," + value.str() + "\r\n";
+  }
+  CPPUNIT_ASSERT_EQUAL((std::size_t)10, writer.size());
+  for (std::size_t i = 0; i < writer.size(); i++) {
+    filepaths.push_back(writer.getPath(i));
+  }
+  writer.close();
+
+  for (std::size_t i = 0; i < 10; i++) {
+    std::ostringstream path;
+    path << "./test/part_k" << i << ".csv";
+    CPPUNIT_ASSERT_EQUAL(expected[i], readFile(path.str()));
+  }
+}
+
+void PartitionedWriterTest::testWriteAfterClose(void)
+{
+  PartitionedWriter writer("./test/part_", ".csv", 0);
+  writer.write(makeRecord("a", "1"));
+  filepaths.push_back(writer.getPath(0));
+  writer.close();
+
+  writer.write(makeRecord("a", "2"));
+  writer.write(makeRecord("b", "3"));
+  filepaths.push_back(writer.getPath(1));
+  writer.close();
+
+  CPPUNIT_ASSERT_EQUAL(std::string("\"a\",\"1\"\r\n\"a\",\"2\"\r\n"), readFile(writer.getPath(0)));
+  CPPUNIT_ASSERT_EQUAL(std::string("\"b\",\"3\"\r\n"), readFile(writer.getPath(1)));
+
+  // a new writer truncates existing files
+  {
+    PartitionedWriter other("./test/part_", ".csv", 0);
+    other.write(makeRecord("a", "4"));
+  }
+  CPPUNIT_ASSERT_EQUAL(std::string("\"a\",\"4\"\r\n"), readFile(writer.getPath(0)));
+}
+
+void PartitionedWriterTest::testWriteThrowFailure(void)
+{
+  PartitionedWriter writer("./test/missing/part_", ".csv", 0);
+  writer.write(makeRecord("a", "1"));
+
+  try {
+    writer.flush();
+    CPPUNIT_FAIL("std::ios_base::failure must be throw.");
+  } catch (std::ios_base::failure& e) {
+  }
+}
+
+} // namespace csv
+} // namespace csl
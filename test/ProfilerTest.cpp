@@ -0,0 +1,167 @@
+#include <cppunit/extensions/HelperMacros.h>
+#include "csl/csv/Profiler.hpp"
+#include "csl/csv/Reader.hpp"
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <stdexcept>
+
+namespace csl {
+namespace csv {
+
+class ProfilerTest : public CPPUNIT_NS::TestFixture
+{
+  CPPUNIT_TEST_SUITE(ProfilerTest);
+  CPPUNIT_TEST(testProfile);
+  CPPUNIT_TEST(testProfileRagged);
+  CPPUNIT_TEST(testMerge);
+  CPPUNIT_TEST(testProfileFile);
+  CPPUNIT_TEST(testProfileFileThrowFailure);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  virtual void setUp(void);
+  virtual void tearDown(void);
+
+private:
+  void testProfile(void);
+  void testProfileRagged(void);
+  void testMerge(void);
+  void testProfileFile(void);
+  void testProfileFileThrowFailure(void);
+
+private:
+  std::string filepath;
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(ProfilerTest);
+
+void ProfilerTest::setUp(void)
+{
+  filepath = "./test/profile.csv";
+}
+
+void ProfilerTest::tearDown(void)
+{
+  std::remove(filepath.c_str());
+}
+
+void ProfilerTest::testProfile(void)
+{
+  std::istringstream stream("1,\"a\"\r\n2,\"b,c\"\r\n\r\n3,a\r\n");
+  Profiler profiler;
+  CPPUNIT_ASSERT_EQUAL((std::size_t)1, profiler.getThreadCount());
+  profiler.profile(stream);
+
+  CPPUNIT_ASSERT_EQUAL((std::uint64_t)3, profiler.getRecordCount());
+  CPPUNIT_ASSERT_EQUAL((std::size_t)2, profiler.size());
+
+  const ColumnProfile& id = profiler.getColumn(0);
+  CPPUNIT_ASSERT_EQUAL((std::uint64_t)3, id.getNumericCount());
+  CPPUNIT_ASSERT_EQUAL(1.0, id.getMinimum());
+  CPPUNIT_ASSERT_EQUAL(3.0, id.getMaximum());
+  CPPUNIT_ASSERT_EQUAL(2.0, id.getMean());
+
+  const ColumnProfile& name = profiler.getColumn(1);
+  CPPUNIT_ASSERT_EQUAL((std::uint64_t)3, name.getCount());
+  CPPUNIT_ASSERT_EQUAL((std::size_t)1, name.getMinLength());
+  CPPUNIT_ASSERT_EQUAL((std::size_t)3, name.getMaxLength());
+  CPPUNIT_ASSERT_EQUAL((std::uint64_t)2, name.getDistinctCount());
+
+  try {
+    profiler.getColumn(2);
+    CPPUNIT_FAIL("std::out_of_range must be throw.");
+  } catch (std::out_of_range& e) {
+  }
+
+  profiler.clear();
+  CPPUNIT_ASSERT_EQUAL((std::uint64_t)0, profiler.getRecordCount());
+  CPPUNIT_ASSERT_EQUAL((std::size_t)0, profiler.size());
+}
+
+void ProfilerTest::testProfileRagged(void)
+{
+  std::istringstream stream("a\r\nb,1\r\nc\r\nd,2,x\r\n");
+  Profiler profiler;
+  profiler.profile(stream);
+
+  CPPUNIT_ASSERT_EQUAL((std::size_t)3, profiler.size());
+  for (std::size_t i = 0; i < profiler.size(); i++) {
+    CPPUNIT_ASSERT_EQUAL((std::uint64_t)4, profiler.getColumn(i).getCount());
+  }
+  CPPUNIT_ASSERT_EQUAL((std::uint64_t)0, profiler.getColumn(0).getEmptyCount());
+  CPPUNIT_ASSERT_EQUAL((std::uint64_t)2, profiler.getColumn(1).getEmptyCount());
+  CPPUNIT_ASSERT_EQUAL((std::uint64_t)3, profiler.getColumn(2).getEmptyCount());
+}
+
+void ProfilerTest::testMerge(void)
+{
+  std::istringstream first("1,x\r\n2,y\r\n");
+  std::istringstream second("3\r\n4,z,w\r\n");
+  Profiler a;
+  Profiler b;
+  a.profile(first);
+  b.profile(second);
+  a.merge(b);
+
+  std::istringstream all("1,x\r\n2,y\r\n3\r\n4,z,w\r\n");
+  Profiler expected;
+  expected.profile(all);
+
+  CPPUNIT_ASSERT_EQUAL(expected.getRecordCount(), a.getRecordCount());
+  CPPUNIT_ASSERT_EQUAL(expected.size(), a.size());
+  for (std::size_t i = 0; i < a.size(); i++) {
+    CPPUNIT_ASSERT_EQUAL(expected.getColumn(i).getCount(), a.getColumn(i).getCount());
+    CPPUNIT_ASSERT_EQUAL(expected.getColumn(i).getEmptyCount(), a.getColumn(i).getEmptyCount());
+    CPPUNIT_ASSERT_EQUAL(expected.getColumn(i).getDistinctCount(), a.getColumn(i).getDistinctCount());
+  }
+  CPPUNIT_ASSERT_EQUAL(2.5, a.getColumn(0).getMean());
+}
+
+void ProfilerTest::testProfileFile(void)
+{
+  {
+    std::ofstream stream(filepath.c_str(), std::ofstream::binary);
+    for (std::size_t i = 0; i < 20000; i++) {
+      stream << i << ",\"name" << (i % 100) << "\"," << (i % 7 == 0 ? "" : "v") << "\r\n";
+    }
+  }
+
+  Profiler single;
+  single.profile(filepath);
+
+  Profiler parallel;
+  parallel.setThreadCount(4);
+  parallel.profile(filepath);
+
+  CPPUNIT_ASSERT_EQUAL((std::uint64_t)20000, parallel.getRecordCount());
+  CPPUNIT_ASSERT_EQUAL((std::size_t)3, parallel.size());
+  CPPUNIT_ASSERT_EQUAL(0.0, parallel.getColumn(0).getMinimum());
+  CPPUNIT_ASSERT_EQUAL(19999.0, parallel.getColumn(0).getMaximum());
+  CPPUNIT_ASSERT_DOUBLES_EQUAL(9999.5, parallel.getColumn(0).getMean(), 1e-9);
+  CPPUNIT_ASSERT_DOUBLES_EQUAL(10000.0, parallel.getColumn(0).getQuantile(0.5), 10000.0 * 0.011);
+  CPPUNIT_ASSERT_DOUBLES_EQUAL(100.0, (double)parallel.getColumn(1).getDistinctCount(), 2.0);
+  CPPUNIT_ASSERT_EQUAL((std::uint64_t)2858, parallel.getColumn(2).getEmptyCount());
+
+  for (std::size_t i = 0; i < single.size(); i++) {
+    CPPUNIT_ASSERT_EQUAL(single.getColumn(i).getCount(), parallel.getColumn(i).getCount());
+    CPPUNIT_ASSERT_EQUAL(single.getColumn(i).getEmptyCount(), parallel.getColumn(i).getEmptyCount());
+    CPPUNIT_ASSERT_EQUAL(single.getColumn(i).getDistinctCount(), parallel.getColumn(i).getDistinctCount());
+  }
+  CPPUNIT_ASSERT_EQUAL(single.getColumn(0).getQuantile(0.5), parallel.getColumn(0).getQuantile(0.5));
+}
+
+void ProfilerTest::testProfileFileThrowFailure(void)
+{
+  Profiler profiler;
+
+  try {
+    profiler.profile("./");
+    CPPUNIT_FAIL("std::ios_base::failure must be throw.");
+  } catch (std::ios_base::failure& e) {
+  }
+}
+
+} // namespace csv
+} // namespace csl
@@ -0,0 +1,125 @@
+#include <cppunit/extensions/HelperMacros.h>
+#include "csl/csv/QuantileSketch.hpp"
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace csl {
+namespace csv {
+
+class QuantileSketchTest : public CPPUNIT_NS::TestFixture
+{
+  CPPUNIT_TEST_SUITE(QuantileSketchTest);
+  CPPUNIT_TEST(testQuantile);
+  CPPUNIT_TEST(testQuantileNegative);
+  CPPUNIT_TEST(testQuantileEmpty);
+  CPPUNIT_TEST(testMerge);
+  CPPUNIT_TEST(testThrowInvalidArgument);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  void testQuantile(void);
+  void testQuantileNegative(void);
+  void testQuantileEmpty(void);
+  void testMerge(void);
+  void testThrowInvalidArgument(void);
+
+private:
+  bool isClose(const double expected, const double actual, const double accuracy);
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(QuantileSketchTest);
+
+bool QuantileSketchTest::isClose(const double expected, const double actual, const double accuracy)
+{
+  return std::fabs(actual - expected) <= std::fabs(expected) * accuracy + 1e-12;
+}
+
+void QuantileSketchTest::testQuantile(void)
+{
+  QuantileSketch sketch;
+  CPPUNIT_ASSERT_EQUAL(QUANTILE_ACCURACY, sketch.getAccuracy());
+
+  for (int i = 10000; i >= 1; i--) {
+    sketch.add(i);
+  }
+  sketch.add(std::numeric_limits<double>::quiet_NaN());
+  sketch.add(std::numeric_limits<double>::infinity());
+
+  CPPUNIT_ASSERT_EQUAL((std::uint64_t)10000, sketch.size());
+  CPPUNIT_ASSERT_EQUAL(1.0, sketch.quantile(0.0));
+  CPPUNIT_ASSERT_EQUAL(10000.0, sketch.quantile(1.0));
+  CPPUNIT_ASSERT(isClose(5000.0, sketch.quantile(0.5), 0.011));
+  CPPUNIT_ASSERT(isClose(9900.0, sketch.quantile(0.99), 0.011));
+  CPPUNIT_ASSERT(isClose(100.0, sketch.quantile(0.01), 0.011));
+
+  sketch.clear();
+  CPPUNIT_ASSERT_EQUAL((std::uint64_t)0, sketch.size());
+}
+
+void QuantileSketchTest::testQuantileNegative(void)
+{
+  QuantileSketch sketch(0.001);
+
+  for (int i = -500; i <= 500; i++) {
+    sketch.add(i * 0.5);
+  }
+
+  CPPUNIT_ASSERT_EQUAL(-250.0, sketch.quantile(0.0));
+  CPPUNIT_ASSERT_EQUAL(250.0, sketch.quantile(1.0));
+  CPPUNIT_ASSERT_EQUAL(0.0, sketch.quantile(0.5));
+  CPPUNIT_ASSERT(isClose(-200.0, sketch.quantile(0.1), 0.0011));
+  CPPUNIT_ASSERT(isClose(200.0, sketch.quantile(0.9), 0.0011));
+}
+
+void QuantileSketchTest::testQuantileEmpty(void)
+{
+  QuantileSketch sketch;
+  CPPUNIT_ASSERT(std::isnan(sketch.quantile(0.5)));
+  CPPUNIT_ASSERT(std::isnan(sketch.quantile(0.0)));
+}
+
+void QuantileSketchTest::testMerge(void)
+{
+  QuantileSketch a;
+  QuantileSketch b;
+  QuantileSketch all;
+
+  for (int i = 1; i <= 1000; i++) {
+    ((i % 3 == 0) ? a : b).add(i * 1.5);
+    all.add(i * 1.5);
+  }
+  a.merge(b);
+
+  CPPUNIT_ASSERT_EQUAL(all.size(), a.size());
+  for (int i = 0; i <= 10; i++) {
+    CPPUNIT_ASSERT_EQUAL(all.quantile(i / 10.0), a.quantile(i / 10.0));
+  }
+}
+
+void QuantileSketchTest::testThrowInvalidArgument(void)
+{
+  try {
+    QuantileSketch sketch(0.0);
+    CPPUNIT_FAIL("std::invalid_argument must be throw.");
+  } catch (std::invalid_argument& e) {
+  }
+
+  try {
+    QuantileSketch sketch;
+    sketch.quantile(1.5);
+    CPPUNIT_FAIL("std::invalid_argument must be throw.");
+  } catch (std::invalid_argument& e) {
+  }
+
+  try {
+    QuantileSketch a(0.01);
+    QuantileSketch b(0.02);
+    a.merge(b);
+    CPPUNIT_FAIL("std::invalid_argument must be throw.");
+  } catch (std::invalid_argument& e) {
+  }
+}
+
+} // namespace csv
+} // namespace csl
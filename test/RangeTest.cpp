@@ -0,0 +1,69 @@
+#include <cppunit/extensions/HelperMacros.h>
+#include "csl/csv/Range.hpp"
+#include <stdexcept>
+
+namespace csl {
+namespace csv {
+
+class RangeTest : public CPPUNIT_NS::TestFixture
+{
+  CPPUNIT_TEST_SUITE(RangeTest);
+  CPPUNIT_TEST(testRange);
+  CPPUNIT_TEST(testRangeStreamoffStreamoff);
+  CPPUNIT_TEST(testRangeStreamoffStreamoffThrowInvalidArgument);
+  CPPUNIT_TEST(testGetSize);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  virtual void setUp(void);
+  virtual void tearDown(void);
+
+private:
+  void testRange(void);
+  void testRangeStreamoffStreamoff(void);
+  void testRangeStreamoffStreamoffThrowInvalidArgument(void);
+  void testGetSize(void);
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(RangeTest);
+
+void RangeTest::setUp(void)
+{
+}
+
+void RangeTest::tearDown(void)
+{
+}
+
+void RangeTest::testRange(void)
+{
+  Range range;
+  CPPUNIT_ASSERT_EQUAL((std::streamoff)0, range.getBegin());
+  CPPUNIT_ASSERT_EQUAL((std::streamoff)0, range.getEnd());
+}
+
+void RangeTest::testRangeStreamoffStreamoff(void)
+{
+  Range range(3, 10);
+  CPPUNIT_ASSERT_EQUAL((std::streamoff)3, range.getBegin());
+  CPPUNIT_ASSERT_EQUAL((std::streamoff)10, range.getEnd());
+}
+
+void RangeTest::testRangeStreamoffStreamoffThrowInvalidArgument(void)
+{
+  try {
+    Range range(10, 3);
+    CPPUNIT_FAIL("std::invalid_argument must be throw.");
+  } catch (std::invalid_argument&) {
+    CPPUNIT_ASSERT(true);
+  }
+}
+
+void RangeTest::testGetSize(void)
+{
+  Range range(3, 10);
+  CPPUNIT_ASSERT_EQUAL((std::streamoff)7, range.getSize());
+}
+
+} // namespace csv
+} // namespace csl
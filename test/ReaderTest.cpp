@@ -14,11 +14,22 @@ class ReaderTest : public CPPUNIT_NS::TestFixture
   CPPUNIT_TEST_SUITE(ReaderTest);
   CPPUNIT_TEST(testReaderIstream);
   CPPUNIT_TEST(testReaderIstreamConfig);
+  CPPUNIT_TEST(testReaderIstreamConfigOffsetRecordNumber);
+  CPPUNIT_TEST(testReaderIstreamConfigOffsetRecordNumberThrowFailure);
   CPPUNIT_TEST(testReadQuoteEnabled);
   CPPUNIT_TEST(testReadQuoteDisabled);
   CPPUNIT_TEST(testReadCommentEnabled);
   CPPUNIT_TEST(testReadCommentDisabled);
+  CPPUNIT_TEST(testReadConfigChanged);
   CPPUNIT_TEST(testReadThrowFailure);
+  CPPUNIT_TEST(testGetOffset);
+  CPPUNIT_TEST(testGetRecordNumber);
+  CPPUNIT_TEST(testSetStats);
+  CPPUNIT_TEST(testReadLazyRecord);
+  CPPUNIT_TEST(testReadFilter);
+#if __cplusplus >= 201703L
+  CPPUNIT_TEST(testReadPmr);
+#endif
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -28,12 +39,23 @@ public:
 private:
   void testReaderIstream(void);
   void testReaderIstreamConfig(void);
+  void testReaderIstreamConfigOffsetRecordNumber(void);
+  void testReaderIstreamConfigOffsetRecordNumberThrowFailure(void);
   void testHasNext(void);
   void testReadQuoteEnabled(void);
   void testReadQuoteDisabled(void);
   void testReadCommentEnabled(void);
   void testReadCommentDisabled(void);
+  void testReadConfigChanged(void);
   void testReadThrowFailure(void);
+  void testGetOffset(void);
+  void testGetRecordNumber(void);
+  void testSetStats(void);
+  void testReadLazyRecord(void);
+  void testReadFilter(void);
+#if __cplusplus >= 201703L
+  void testReadPmr(void);
+#endif
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(ReaderTest);
@@ -59,6 +81,41 @@ void ReaderTest::testReaderIstreamConfig(void)
   Reader reader(stream, config);
 }
 
+void ReaderTest::testReaderIstreamConfigOffsetRecordNumber(void)
+{
+  std::stringstream stream("aaa,bbb\r\n"
+			   "\"c\r\nc\",ddd\r\n"
+			   "eee\r\n");
+  Config config;
+  Reader reader(stream, config, 9, 1);
+  std::vector<std::string> record;
+
+  CPPUNIT_ASSERT_EQUAL((std::streamoff)9, reader.getOffset());
+  CPPUNIT_ASSERT_EQUAL((std::size_t)1, reader.getRecordNumber());
+
+  CPPUNIT_ASSERT_EQUAL(true, reader.hasNext());
+  reader.read(record);
+  CPPUNIT_ASSERT(record.size() == 2);
+  CPPUNIT_ASSERT(record[0] == "c\r\nc");
+  CPPUNIT_ASSERT(record[1] == "ddd");
+  CPPUNIT_ASSERT_EQUAL((std::streamoff)21, reader.getOffset());
+  CPPUNIT_ASSERT_EQUAL((std::size_t)2, reader.getRecordNumber());
+}
+
+void ReaderTest::testReaderIstreamConfigOffsetRecordNumberThrowFailure(void)
+{
+  std::stringstream stream("aaa");
+  stream.setstate(std::ios_base::badbit);
+  Config config;
+
+  try {
+    Reader reader(stream, config, 1, 0);
+    CPPUNIT_FAIL("std::ios_base::failure must be throw.");
+  } catch (std::ios_base::failure&) {
+    CPPUNIT_ASSERT(true);
+  }
+}
+
 void ReaderTest::testHasNext(void)
 {
   std::stringstream stream("a");
@@ -225,6 +282,49 @@ void ReaderTest::testReadCommentDisabled(void)
   CPPUNIT_ASSERT_EQUAL(false, reader.hasNext());
 }
 
+void ReaderTest::testReadConfigChanged(void)
+{
+  const char* data = "#comment line1\r\n"
+    "\"a\"\"a\",bbb\r\n"
+    "#comment line2\r\n"
+    "'c',ddd\r\n";
+  Config config;
+  config.setCommentEnabled(true);
+  std::stringstream stream(data);
+  std::stringstream lazyStream(data);
+  Reader reader(stream, config);
+  Reader lazyReader(lazyStream, config);
+
+  // changes after construction are not reflected
+  config.setCommentEnabled(false);
+  config.setQuoteMark('\'');
+  config.setCommentMark('"');
+
+  std::vector<std::string> record;
+  LazyRecord lazyRecord;
+
+  CPPUNIT_ASSERT_EQUAL(true, reader.hasNext());
+  reader.read(record);
+  CPPUNIT_ASSERT(record.size() == 2);
+  CPPUNIT_ASSERT(record[0] == "a\"a");
+  CPPUNIT_ASSERT(record[1] == "bbb");
+  lazyReader.read(lazyRecord);
+  CPPUNIT_ASSERT(lazyRecord.size() == 2);
+  CPPUNIT_ASSERT(lazyRecord.get(0) == "a\"a");
+
+  CPPUNIT_ASSERT_EQUAL(true, reader.hasNext());
+  reader.read(record);
+  CPPUNIT_ASSERT(record.size() == 2);
+  CPPUNIT_ASSERT(record[0] == "'c'");
+  CPPUNIT_ASSERT(record[1] == "ddd");
+  lazyReader.read(lazyRecord);
+  CPPUNIT_ASSERT(lazyRecord.size() == 2);
+  CPPUNIT_ASSERT(lazyRecord.get(0) == "'c'");
+
+  CPPUNIT_ASSERT_EQUAL(false, reader.hasNext());
+  CPPUNIT_ASSERT_EQUAL(false, lazyReader.hasNext());
+}
+
 void ReaderTest::testReadThrowFailure(void)
 {
   std::ifstream stream("");
@@ -239,5 +339,165 @@ void ReaderTest::testReadThrowFailure(void)
   }
 }
 
+void ReaderTest::testGetOffset(void)
+{
+  std::stringstream stream("#comment\r\n"
+			   "aaa,\"b\r\nb\"\r\n"
+			   "ccc");
+  Config config;
+  config.setCommentEnabled(true);
+  Reader reader(stream, config);
+  std::vector<std::string> record;
+
+  CPPUNIT_ASSERT_EQUAL((std::streamoff)0, reader.getOffset());
+  reader.read(record);
+  CPPUNIT_ASSERT_EQUAL((std::streamoff)22, reader.getOffset());
+  reader.read(record);
+  CPPUNIT_ASSERT_EQUAL((std::streamoff)25, reader.getOffset());
+  CPPUNIT_ASSERT_EQUAL(false, reader.hasNext());
+}
+
+void ReaderTest::testGetRecordNumber(void)
+{
+  std::stringstream stream("aaa\r\n"
+			   "bbb\r\n");
+  Reader reader(stream);
+  std::vector<std::string> record;
+
+  CPPUNIT_ASSERT_EQUAL((std::size_t)0, reader.getRecordNumber());
+  reader.read(record);
+  CPPUNIT_ASSERT_EQUAL((std::size_t)1, reader.getRecordNumber());
+  reader.read(record);
+  CPPUNIT_ASSERT_EQUAL((std::size_t)2, reader.getRecordNumber());
+}
+
+void ReaderTest::testSetStats(void)
+{
+  std::stringstream stream("# comment\r\n"
+			   "\"a\"\"b\",cc\r\n"
+			   "ddd\r\n");
+  Config config;
+  config.setCommentEnabled(true);
+  Reader reader(stream, config);
+  std::vector<std::string> record;
+  Stats stats;
+
+  reader.setStats(&stats);
+  while (reader.hasNext()) {
+    reader.read(record);
+  }
+
+  CPPUNIT_ASSERT_EQUAL(27ULL, stats.getBytes());
+  CPPUNIT_ASSERT_EQUAL((std::size_t)2, stats.getRecords());
+  CPPUNIT_ASSERT_EQUAL((std::size_t)3, stats.getFields());
+  CPPUNIT_ASSERT_EQUAL((std::size_t)1, stats.getQuotedFields());
+  CPPUNIT_ASSERT_EQUAL((std::size_t)1, stats.getEscapedQuotes());
+  CPPUNIT_ASSERT_EQUAL((std::size_t)1, stats.getCommentLines());
+  CPPUNIT_ASSERT_EQUAL((std::size_t)3, stats.getMaxFieldLength());
+  CPPUNIT_ASSERT_EQUAL((std::size_t)11, stats.getMaxRecordLength());
+  CPPUNIT_ASSERT_EQUAL(0ULL, stats.getIoTime());
+}
+
+#if __cplusplus >= 201703L
+void ReaderTest::testReadPmr(void)
+{
+  std::stringstream stream("aaa,\"bbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbb\"\r\n"
+			   "ccc\r\n");
+  char buffer[1024];
+  std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer), std::pmr::null_memory_resource());
+  std::pmr::vector<std::pmr::string> record(&arena);
+  Reader reader(stream);
+
+  reader.read(record);
+  CPPUNIT_ASSERT(record.size() == 2);
+  CPPUNIT_ASSERT(record[0] == "aaa");
+  CPPUNIT_ASSERT(record[1] == "bbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbb");
+  CPPUNIT_ASSERT(record[1].get_allocator().resource() == &arena);
+
+  reader.read(record);
+  CPPUNIT_ASSERT(record.size() == 1);
+  CPPUNIT_ASSERT(record[0] == "ccc");
+  CPPUNIT_ASSERT(!reader.hasNext());
+}
+#endif
+
+void ReaderTest::testReadLazyRecord(void)
+{
+  const char* data = "# comment\r\n"
+    "aaa,\"b\"\"b\",\"c\r\nc\",d\re,\"\"\r\n"
+    "a\"b,c\"d,\r\n"
+    "\r\n"
+    "\"x\"\"\"\r";
+  Config config;
+  config.setCommentEnabled(true);
+  std::stringstream expectedStream(data);
+  std::stringstream stream(data);
+  Reader expectedReader(expectedStream, config);
+  Reader reader(stream, config);
+  std::vector<std::string> expected;
+  LazyRecord record;
+
+  while (expectedReader.hasNext()) {
+    CPPUNIT_ASSERT(reader.hasNext());
+    expectedReader.read(expected);
+    reader.read(record);
+
+    CPPUNIT_ASSERT_EQUAL(expected.size(), record.size());
+    for (std::size_t i = 0; i < expected.size(); i++) {
+      CPPUNIT_ASSERT(expected[i] == record.get(i));
+    }
+    CPPUNIT_ASSERT_EQUAL(expectedReader.getOffset(), reader.getOffset());
+  }
+  CPPUNIT_ASSERT(!reader.hasNext());
+  CPPUNIT_ASSERT_EQUAL(expectedReader.getRecordNumber(), reader.getRecordNumber());
+}
+
+void ReaderTest::testReadFilter(void)
+{
+  const char* data = "# comment\r\n"
+    "1,Tokyo,\"a\r\nb\",x\r\n"
+    "2,Osaka,\"c\"\"\r\n,d\",y\r\n"
+    "3,\"Tokyo\",e\r\n"
+    "4,Tokyo\r\n"
+    "5\r\n"
+    "6,Tokyo,\"\"\r";
+  Config config;
+  config.setCommentEnabled(true);
+
+  std::vector<Filter> filters(4);
+  filters[1].addEquals(1, "Tokyo");
+  filters[2].addRange(0, 2, 5);
+  filters[3].addEquals(1, "Tokyo");
+  filters[3].addPrefix(2, "e");
+
+  for (std::size_t i = 0; i < filters.size(); i++) {
+    std::stringstream expectedStream(data);
+    std::stringstream stream(data);
+    Reader expectedReader(expectedStream, config);
+    Reader reader(stream, config);
+    std::vector<std::string> expected;
+    LazyRecord record;
+
+    while (expectedReader.hasNext()) {
+      CPPUNIT_ASSERT(reader.hasNext());
+      expectedReader.read(expected);
+      const bool matched = reader.read(record, filters[i]);
+
+      CPPUNIT_ASSERT_EQUAL(filters[i].matches(expected), matched);
+      if (matched) {
+	CPPUNIT_ASSERT_EQUAL(expected.size(), record.size());
+	for (std::size_t j = 0; j < expected.size(); j++) {
+	  CPPUNIT_ASSERT(expected[j] == record.get(j));
+	}
+      } else {
+	CPPUNIT_ASSERT_EQUAL((std::size_t)0, record.size());
+      }
+      CPPUNIT_ASSERT_EQUAL(expectedReader.getOffset(), reader.getOffset());
+    }
+    CPPUNIT_ASSERT(!reader.hasNext());
+    CPPUNIT_ASSERT_EQUAL(expectedReader.getRecordNumber(), reader.getRecordNumber());
+  }
+}
+
 } // namespace csv
 } // namespace csl
@@ -0,0 +1,260 @@
+#include <cppunit/extensions/HelperMacros.h>
+#include "csl/csv/Sampler.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+namespace csl {
+namespace csv {
+
+class SamplerTest : public CPPUNIT_NS::TestFixture
+{
+  CPPUNIT_TEST_SUITE(SamplerTest);
+  CPPUNIT_TEST(testSample);
+  CPPUNIT_TEST(testSampleSeed);
+  CPPUNIT_TEST(testSampleUniform);
+  CPPUNIT_TEST(testSampleStratified);
+  CPPUNIT_TEST(testSampleApproximate);
+  CPPUNIT_TEST(testSampleApproximateSmall);
+  CPPUNIT_TEST(testSampleThrow);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  virtual void setUp(void);
+  virtual void tearDown(void);
+
+private:
+  void testSample(void);
+  void testSampleSeed(void);
+  void testSampleUniform(void);
+  void testSampleStratified(void);
+  void testSampleApproximate(void);
+  void testSampleApproximateSmall(void);
+  void testSampleThrow(void);
+
+private:
+  std::string makeData(const std::size_t count);
+
+private:
+  std::string filepath;
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(SamplerTest);
+
+void SamplerTest::setUp(void)
+{
+  filepath = "./test/sample.csv";
+}
+
+void SamplerTest::tearDown(void)
+{
+  std::remove(filepath.c_str());
+}
+
+std::string SamplerTest::makeData(const std::size_t count)
+{
+  std::ostringstream data;
+  for (std::size_t i = 0; i < count; i++) {
+    data << i << ",\"line\r\nbreak " << i << "\"\r\n";
+  }
+  return data.str();
+}
+
+void SamplerTest::testSample(void)
+{
+  std::istringstream stream("a,1\r\n\r\nb,2\r\nc,3\r\n");
+  Sampler sampler(5);
+  CPPUNIT_ASSERT_EQUAL((std::size_t)5, sampler.getSampleSize());
+  CPPUNIT_ASSERT(!sampler.isStratified());
+  sampler.sample(stream);
+
+  CPPUNIT_ASSERT_EQUAL((std::uint64_t)3, sampler.getRecordCount());
+  CPPUNIT_ASSERT_EQUAL((std::size_t)3, sampler.size());
+
+  std::vector<std::vector<std::string> > csv;
+  sampler.getSample(csv);
+  CPPUNIT_ASSERT_EQUAL((std::size_t)3, csv.size());
+  CPPUNIT_ASSERT_EQUAL(std::string("a"), csv[0][0]);
+  CPPUNIT_ASSERT_EQUAL(std::string("b"), csv[1][0]);
+  CPPUNIT_ASSERT_EQUAL(std::string("3"), csv[2][1]);
+
+  std::ostringstream out;
+  Writer writer(out);
+  sampler.write(writer);
+  CPPUNIT_ASSERT_EQUAL(std::string("\"a\",\"1\"\r\n\"b\",\"2\"\r\n\"c\",\"3\"\r\n"), out.str());
+
+  sampler.clear();
+  CPPUNIT_ASSERT_EQUAL((std::size_t)0, sampler.size());
+  CPPUNIT_ASSERT_EQUAL((std::uint64_t)0, sampler.getRecordCount());
+}
+
+void SamplerTest::testSampleSeed(void)
+{
+  const std::string data = makeData(1000);
+  std::vector<std::vector<std::string> > first;
+  std::vector<std::vector<std::string> > second;
+
+  Sampler sampler(20);
+  sampler.setSeed(42);
+  CPPUNIT_ASSERT_EQUAL((std::uint64_t)42, sampler.getSeed());
+  std::istringstream stream(data);
+  sampler.sample(stream);
+  sampler.getSample(first);
+
+  Sampler other(20);
+  other.setSeed(42);
+  std::istringstream otherStream(data);
+  other.sample(otherStream);
+  other.getSample(second);
+
+  CPPUNIT_ASSERT_EQUAL((std::size_t)20, first.size());
+  CPPUNIT_ASSERT(first == second);
+  for (std::size_t i = 1; i < first.size(); i++) {
+    CPPUNIT_ASSERT(std::atoi(first[i - 1][0].c_str()) < std::atoi(first[i][0].c_str()));
+    CPPUNIT_ASSERT_EQUAL("line\r\nbreak " + first[i][0], first[i][1]);
+  }
+}
+
+void SamplerTest::testSampleUniform(void)
+{
+  const std::string data = makeData(100);
+  std::vector<std::size_t> counts(100, 0);
+  std::vector<std::vector<std::string> > csv;
+
+  for (std::uint64_t seed = 0; seed < 3000; seed++) {
+    Sampler sampler(10);
+    sampler.setSeed(seed);
+    std::istringstream stream(data);
+    sampler.sample(stream);
+    sampler.getSample(csv);
+
+    CPPUNIT_ASSERT_EQUAL((std::size_t)10, csv.size());
+    for (std::size_t i = 0; i < csv.size(); i++) {
+      counts[std::atoi(csv[i][0].c_str())]++;
+    }
+  }
+
+  // each record is expected 300 times, the bounds are about six standard deviations
+  for (std::size_t i = 0; i < counts.size(); i++) {
+    CPPUNIT_ASSERT(counts[i] > 200 && counts[i] < 400);
+  }
+}
+
+void SamplerTest::testSampleStratified(void)
+{
+  std::ostringstream data;
+  for (std::size_t i = 0; i < 75; i++) {
+    const char* stratum = (i % 15 == 0) ? "b" : (i % 3 == 0) ? "c" : "a";
+    data << i << "," << stratum << "\r\n";
+  }
+  data << "75\r\n";
+
+  Sampler sampler(10);
+  sampler.setSeed(7);
+  sampler.setStratumColumn(1);
+  CPPUNIT_ASSERT(sampler.isStratified());
+  std::istringstream stream(data.str());
+  sampler.sample(stream);
+
+  std::vector<std::vector<std::string> > csv;
+  sampler.getSample(csv);
+  CPPUNIT_ASSERT_EQUAL((std::uint64_t)76, sampler.getRecordCount());
+  CPPUNIT_ASSERT_EQUAL((std::size_t)26, csv.size());
+
+  // strata in the order of first appearance: b (5 records), a (50), c (20), missing (1)
+  for (std::size_t i = 0; i < 5; i++) {
+    CPPUNIT_ASSERT_EQUAL(std::string("b"), csv[i][1]);
+  }
+  for (std::size_t i = 5; i < 15; i++) {
+    CPPUNIT_ASSERT_EQUAL(std::string("a"), csv[i][1]);
+  }
+  for (std::size_t i = 15; i < 25; i++) {
+    CPPUNIT_ASSERT_EQUAL(std::string("c"), csv[i][1]);
+  }
+  CPPUNIT_ASSERT_EQUAL(std::string("75"), csv[25][0]);
+
+  sampler.clearStratumColumn();
+  CPPUNIT_ASSERT(!sampler.isStratified());
+  CPPUNIT_ASSERT_EQUAL((std::size_t)0, sampler.size());
+}
+
+void SamplerTest::testSampleApproximate(void)
+{
+  {
+    std::ofstream stream(filepath.c_str(), std::ofstream::binary);
+    stream << makeData(5000);
+  }
+
+  Sampler sampler(100);
+  sampler.setSeed(1);
+  sampler.sampleApproximate(filepath);
+
+  std::vector<std::vector<std::string> > csv;
+  sampler.getSample(csv);
+  CPPUNIT_ASSERT_EQUAL((std::size_t)100, csv.size());
+  CPPUNIT_ASSERT_EQUAL((std::uint64_t)100, sampler.getRecordCount());
+
+  std::set<int> seen;
+  for (std::size_t i = 0; i < csv.size(); i++) {
+    CPPUNIT_ASSERT_EQUAL((std::size_t)2, csv[i].size());
+    CPPUNIT_ASSERT_EQUAL("line\r\nbreak " + csv[i][0], csv[i][1]);
+    const int id = std::atoi(csv[i][0].c_str());
+    CPPUNIT_ASSERT(seen.insert(id).second);
+    CPPUNIT_ASSERT(i == 0 || std::atoi(csv[i - 1][0].c_str()) < id);
+  }
+}
+
+void SamplerTest::testSampleApproximateSmall(void)
+{
+  {
+    std::ofstream stream(filepath.c_str(), std::ofstream::binary);
+    stream << makeData(5);
+  }
+
+  Sampler sampler(50);
+  sampler.setSeed(3);
+  sampler.sampleApproximate(filepath);
+
+  std::vector<std::vector<std::string> > csv;
+  sampler.getSample(csv);
+  CPPUNIT_ASSERT(csv.size() <= 5);
+  CPPUNIT_ASSERT(csv.size() >= 3);
+
+  {
+    std::ofstream stream(filepath.c_str(), std::ofstream::binary | std::ofstream::trunc);
+  }
+  sampler.sampleApproximate(filepath);
+  CPPUNIT_ASSERT_EQUAL((std::size_t)0, sampler.size());
+}
+
+void SamplerTest::testSampleThrow(void)
+{
+  Sampler sampler(10);
+
+  try {
+    sampler.sample("./");
+    CPPUNIT_FAIL("std::ios_base::failure must be throw.");
+  } catch (std::ios_base::failure& e) {
+  }
+
+  try {
+    sampler.sampleApproximate("./");
+    CPPUNIT_FAIL("std::ios_base::failure must be throw.");
+  } catch (std::ios_base::failure& e) {
+  }
+
+  sampler.setStratumColumn(0);
+  try {
+    sampler.sampleApproximate(filepath);
+    CPPUNIT_FAIL("std::invalid_argument must be throw.");
+  } catch (std::invalid_argument& e) {
+  }
+}
+
+} // namespace csv
+} // namespace csl
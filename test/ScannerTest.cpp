@@ -0,0 +1,99 @@
+#include <cppunit/extensions/HelperMacros.h>
+#include "csl/csv/Scanner.hpp"
+#include <string>
+#include "csl/csv/Config.hpp"
+
+namespace csl {
+namespace csv {
+
+class ScannerTest : public CPPUNIT_NS::TestFixture
+{
+  CPPUNIT_TEST_SUITE(ScannerTest);
+  CPPUNIT_TEST(testScanner);
+  CPPUNIT_TEST(testScannerConfig);
+  CPPUNIT_TEST(testScanQuoteEnabled);
+  CPPUNIT_TEST(testScanQuoteDisabled);
+  CPPUNIT_TEST(testScanCommentEnabled);
+  CPPUNIT_TEST(testScanNotFound);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  virtual void setUp(void);
+  virtual void tearDown(void);
+
+private:
+  void testScanner(void);
+  void testScannerConfig(void);
+  void testScanQuoteEnabled(void);
+  void testScanQuoteDisabled(void);
+  void testScanCommentEnabled(void);
+  void testScanNotFound(void);
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(ScannerTest);
+
+void ScannerTest::setUp(void)
+{
+}
+
+void ScannerTest::tearDown(void)
+{
+}
+
+void ScannerTest::testScanner(void)
+{
+  Scanner scanner;
+}
+
+void ScannerTest::testScannerConfig(void)
+{
+  Config config;
+  Scanner scanner(config);
+}
+
+void ScannerTest::testScanQuoteEnabled(void)
+{
+  std::string data("aaa,bbb\r\n"
+		   "\"a\r\na\",\"b\"\"\r\n\"\r\n"
+		   "\r\r\n");
+  Scanner scanner;
+
+  CPPUNIT_ASSERT_EQUAL((std::size_t)9, scanner.scan(data.data(), 0, data.size()));
+  CPPUNIT_ASSERT_EQUAL((std::size_t)25, scanner.scan(data.data(), 9, data.size()));
+  CPPUNIT_ASSERT_EQUAL((std::size_t)28, scanner.scan(data.data(), 25, data.size()));
+}
+
+void ScannerTest::testScanQuoteDisabled(void)
+{
+  std::string data("\"a\r\na\",\"b\"\r\n");
+  Config config;
+  config.setQuoteEnabled(false);
+  Scanner scanner(config);
+
+  CPPUNIT_ASSERT_EQUAL((std::size_t)4, scanner.scan(data.data(), 0, data.size()));
+  CPPUNIT_ASSERT_EQUAL((std::size_t)12, scanner.scan(data.data(), 4, data.size()));
+}
+
+void ScannerTest::testScanCommentEnabled(void)
+{
+  std::string data("#\"comment\r\n"
+		   "aaa\r\n");
+  Config config;
+  config.setCommentEnabled(true);
+  Scanner scanner(config);
+
+  CPPUNIT_ASSERT_EQUAL((std::size_t)16, scanner.scan(data.data(), 0, data.size()));
+  CPPUNIT_ASSERT_EQUAL((std::size_t)16, scanner.scan(data.data(), 11, data.size()));
+}
+
+void ScannerTest::testScanNotFound(void)
+{
+  std::string data("aaa,\"bbb\r\n");
+  Scanner scanner;
+
+  CPPUNIT_ASSERT_EQUAL(Scanner::npos, scanner.scan(data.data(), 0, data.size()));
+  CPPUNIT_ASSERT_EQUAL(Scanner::npos, scanner.scan(data.data(), 0, 3));
+}
+
+} // namespace csv
+} // namespace csl
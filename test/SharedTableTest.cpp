@@ -0,0 +1,207 @@
+#include <cppunit/extensions/HelperMacros.h>
+#include "csl/csv/SharedTable.hpp"
+#include "csl/csv/Util.hpp"
+#include <string>
+#include <vector>
+#include <stdexcept>
+#include <thread>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+namespace csl {
+namespace csv {
+
+class SharedTableTest : public CPPUNIT_NS::TestFixture
+{
+  CPPUNIT_TEST_SUITE(SharedTableTest);
+  CPPUNIT_TEST(testPublish);
+  CPPUNIT_TEST(testPublishFile);
+  CPPUNIT_TEST(testPublishGeneration);
+  CPPUNIT_TEST(testPublishConcurrent);
+  CPPUNIT_TEST(testUnlink);
+  CPPUNIT_TEST(testSharedTableThrowIosBaseFailure);
+  CPPUNIT_TEST(testSharedTableThrowInvalidArgument);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  virtual void setUp(void);
+  virtual void tearDown(void);
+
+private:
+  void testPublish(void);
+  void testPublishFile(void);
+  void testPublishGeneration(void);
+  void testPublishConcurrent(void);
+  void testUnlink(void);
+  void testSharedTableThrowIosBaseFailure(void);
+  void testSharedTableThrowInvalidArgument(void);
+
+private:
+  void addRecord(std::vector<std::vector<std::string> >& csv, const std::string& a, const std::string& b);
+
+private:
+  std::string name;
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(SharedTableTest);
+
+void SharedTableTest::setUp(void)
+{
+  name = "/cslcsv-test-" + std::to_string(getpid());
+  SharedTable::unlink(name);
+}
+
+void SharedTableTest::tearDown(void)
+{
+  SharedTable::unlink(name);
+}
+
+void SharedTableTest::addRecord(std::vector<std::vector<std::string> >& csv, const std::string& a, const std::string& b)
+{
+  std::vector<std::string> record;
+  record.push_back(a);
+  record.push_back(b);
+  csv.push_back(record);
+}
+
+void SharedTableTest::testPublish(void)
+{
+  std::vector<std::vector<std::string> > csv;
+  addRecord(csv, "1", "Tokyo");
+  addRecord(csv, "2", "Osaka");
+
+  const std::uint64_t generation = SharedTable::publish(name, csv);
+
+  SharedTable table(name);
+  CPPUNIT_ASSERT_EQUAL(generation, table.getGeneration());
+  CPPUNIT_ASSERT(table.isLatest());
+  CPPUNIT_ASSERT_EQUAL((std::size_t)2, table.getRowCount());
+  CPPUNIT_ASSERT_EQUAL((std::size_t)2, table.getColumnCount());
+  CPPUNIT_ASSERT_EQUAL((std::int64_t)2, table.getInteger(1, 0));
+  CPPUNIT_ASSERT_EQUAL(std::string("Osaka"), table.get(1, 1));
+}
+
+void SharedTableTest::testPublishFile(void)
+{
+  SharedTable::publish(name, "./test/test.csv");
+
+  std::vector<std::vector<std::string> > csv;
+  Util::load("./test/test.csv", csv);
+
+  SharedTable table(name);
+  CPPUNIT_ASSERT_EQUAL(csv.size(), table.getRowCount());
+
+  std::vector<std::string> record;
+  for (std::size_t i = 0; i < csv.size(); i++) {
+    table.getRecord(i, record);
+    CPPUNIT_ASSERT(record == csv[i]);
+  }
+}
+
+void SharedTableTest::testPublishGeneration(void)
+{
+  std::vector<std::vector<std::string> > csv;
+  addRecord(csv, "1", "Tokyo");
+  const std::uint64_t first = SharedTable::publish(name, csv);
+  SharedTable older(name);
+
+  csv.clear();
+  addRecord(csv, "1", "Nagoya");
+  addRecord(csv, "2", "Fukuoka");
+  const std::uint64_t second = SharedTable::publish(name, csv);
+  CPPUNIT_ASSERT(second > first);
+
+  // the older generation stays readable after it was replaced
+  CPPUNIT_ASSERT(!older.isLatest());
+  CPPUNIT_ASSERT_EQUAL(first, older.getGeneration());
+  CPPUNIT_ASSERT_EQUAL((std::size_t)1, older.getRowCount());
+  CPPUNIT_ASSERT_EQUAL(std::string("Tokyo"), older.get(0, 1));
+
+  SharedTable newer(name);
+  CPPUNIT_ASSERT(newer.isLatest());
+  CPPUNIT_ASSERT_EQUAL(second, newer.getGeneration());
+  CPPUNIT_ASSERT_EQUAL((std::size_t)2, newer.getRowCount());
+  CPPUNIT_ASSERT_EQUAL(std::string("Fukuoka"), newer.get(1, 1));
+}
+
+void SharedTableTest::testPublishConcurrent(void)
+{
+  const std::size_t threadCount = 4;
+  const std::size_t publishCount = 20;
+  std::vector<std::vector<std::string> > csv;
+  addRecord(csv, "1", "Tokyo");
+
+  std::vector<std::thread> threads;
+  for (std::size_t i = 0; i < threadCount; i++) {
+    threads.push_back(std::thread([&]() {
+	  for (std::size_t j = 0; j < publishCount; j++) {
+	    SharedTable::publish(name, csv);
+	  }
+	}));
+  }
+  for (std::size_t i = 0; i < threads.size(); i++) {
+    threads[i].join();
+  }
+
+  // the last allocated generation wins and every other segment is gone
+  SharedTable table(name);
+  CPPUNIT_ASSERT_EQUAL((std::uint64_t)(threadCount * publishCount), table.getGeneration());
+  for (std::uint64_t generation = 1; generation < threadCount * publishCount; generation++) {
+    const std::string segment = name + "." + std::to_string(generation);
+    const int fd = shm_open(segment.c_str(), O_RDONLY, 0);
+    if (fd >= 0) {
+      close(fd);
+    }
+    CPPUNIT_ASSERT(fd < 0);
+  }
+}
+
+void SharedTableTest::testUnlink(void)
+{
+  std::vector<std::vector<std::string> > csv;
+  addRecord(csv, "1", "Tokyo");
+  SharedTable::publish(name, csv);
+  SharedTable table(name);
+
+  SharedTable::unlink(name);
+  CPPUNIT_ASSERT_EQUAL(std::string("Tokyo"), table.get(0, 1));
+
+  try {
+    SharedTable removed(name);
+    CPPUNIT_FAIL("std::ios_base::failure must be throw.");
+  } catch (std::ios_base::failure&) {
+    CPPUNIT_ASSERT(true);
+  }
+}
+
+void SharedTableTest::testSharedTableThrowIosBaseFailure(void)
+{
+  try {
+    SharedTable table(name);
+    CPPUNIT_FAIL("std::ios_base::failure must be throw.");
+  } catch (std::ios_base::failure&) {
+    CPPUNIT_ASSERT(true);
+  }
+}
+
+void SharedTableTest::testSharedTableThrowInvalidArgument(void)
+{
+  try {
+    SharedTable table("./");
+    CPPUNIT_FAIL("std::invalid_argument must be throw.");
+  } catch (std::invalid_argument&) {
+    CPPUNIT_ASSERT(true);
+  }
+
+  std::vector<std::vector<std::string> > csv;
+  try {
+    SharedTable::publish("cslcsv", csv);
+    CPPUNIT_FAIL("std::invalid_argument must be throw.");
+  } catch (std::invalid_argument&) {
+    CPPUNIT_ASSERT(true);
+  }
+}
+
+} // namespace csv
+} // namespace csl
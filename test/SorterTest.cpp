@@ -0,0 +1,259 @@
+#include <cppunit/extensions/HelperMacros.h>
+#include "csl/csv/Sorter.hpp"
+#include "csl/csv/Util.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <stdexcept>
+#include <dirent.h>
+
+namespace csl {
+namespace csv {
+
+class SorterTest : public CPPUNIT_NS::TestFixture
+{
+  CPPUNIT_TEST_SUITE(SorterTest);
+  CPPUNIT_TEST(testSortString);
+  CPPUNIT_TEST(testSortNumeric);
+  CPPUNIT_TEST(testSortStable);
+  CPPUNIT_TEST(testSortMissingColumn);
+  CPPUNIT_TEST(testSortSpill);
+  CPPUNIT_TEST(testSortParallel);
+  CPPUNIT_TEST(testSortFile);
+  CPPUNIT_TEST(testSortThrowInvalidArgument);
+  CPPUNIT_TEST(testSortThrowIosBaseFailure);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  virtual void setUp(void);
+  virtual void tearDown(void);
+
+private:
+  void testSortString(void);
+  void testSortNumeric(void);
+  void testSortStable(void);
+  void testSortMissingColumn(void);
+  void testSortSpill(void);
+  void testSortParallel(void);
+  void testSortFile(void);
+  void testSortThrowInvalidArgument(void);
+  void testSortThrowIosBaseFailure(void);
+
+private:
+  std::string sort(Sorter& sorter, const std::string& data);
+  std::vector<std::vector<std::string> > makeCsv(const std::size_t count);
+  std::size_t countRuns(void);
+
+private:
+  std::string inpath;
+  std::string outpath;
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(SorterTest);
+
+void SorterTest::setUp(void)
+{
+  inpath = "./test/sort_in.csv";
+  outpath = "./test/sort_out.csv";
+}
+
+void SorterTest::tearDown(void)
+{
+  std::remove(inpath.c_str());
+  std::remove(outpath.c_str());
+}
+
+std::string SorterTest::sort(Sorter& sorter, const std::string& data)
+{
+  std::istringstream in(data);
+  std::ostringstream out;
+  sorter.sort(in, out);
+  return out.str();
+}
+
+std::vector<std::vector<std::string> > SorterTest::makeCsv(const std::size_t count)
+{
+  std::vector<std::vector<std::string> > csv;
+
+  for (std::size_t i = 0; i < count; i++) {
+    std::vector<std::string> record;
+    std::ostringstream number;
+    number << static_cast<long>((i * 7919) % 1000) - 500;
+    record.push_back(std::string(1, static_cast<char>('a' + (i * 31) % 7)) + ",x");
+    record.push_back(number.str());
+    record.push_back(std::string(i % 20 + 1, 'z'));
+    csv.push_back(record);
+  }
+
+  return csv;
+}
+
+std::size_t SorterTest::countRuns(void)
+{
+  std::size_t count = 0;
+  DIR* dir = opendir("./test");
+  struct dirent* entry;
+
+  while ((entry = readdir(dir)) != NULL) {
+    if (std::string(entry->d_name).compare(0, 7, "cslcsv-") == 0) {
+      count++;
+    }
+  }
+  closedir(dir);
+
+  return count;
+}
+
+void SorterTest::testSortString(void)
+{
+  Sorter sorter;
+  sorter.addKey(1, Sorter::COLLATION_STRING);
+
+  CPPUNIT_ASSERT_EQUAL(std::string("\"3\",\"Nagoya\"\r\n\"2\",\"Osaka\"\r\n\"1\",\"Tokyo\"\r\n"),
+		       sort(sorter, "1,Tokyo\r\n2,Osaka\r\n3,Nagoya\r\n"));
+  CPPUNIT_ASSERT_EQUAL((std::size_t)0, sorter.getRunCount());
+
+  // bytes are compared as unsigned
+  CPPUNIT_ASSERT_EQUAL(std::string("\"2\",\"Z\"\r\n\"3\",\"a\"\r\n\"1\",\"\xe6\x9d\xb1\"\r\n\"4\",\"\xe6\x9d\xb1\xe4\xba\xac\"\r\n"),
+		       sort(sorter, "1,\xe6\x9d\xb1\r\n2,Z\r\n3,a\r\n4,\xe6\x9d\xb1\xe4\xba\xac\r\n"));
+  CPPUNIT_ASSERT_EQUAL(std::string(""), sort(sorter, ""));
+}
+
+void SorterTest::testSortNumeric(void)
+{
+  Sorter sorter;
+  sorter.addKey(0, Sorter::COLLATION_NUMERIC);
+
+  CPPUNIT_ASSERT_EQUAL(std::string("\"-1e3\"\r\n\"-0\"\r\n\"0\"\r\n\"2.5\"\r\n\"10\"\r\n\r\n\" 1\"\r\n\"abc\"\r\n\"nan\"\r\n"),
+		       sort(sorter, "nan\r\n10\r\n-0\r\nabc\r\n2.5\r\n\" 1\"\r\n-1e3\r\n\"\"\r\n0\r\n"));
+}
+
+void SorterTest::testSortStable(void)
+{
+  Sorter sorter;
+  sorter.addKey(0, Sorter::COLLATION_STRING);
+  sorter.addKey(1, Sorter::COLLATION_NUMERIC);
+
+  CPPUNIT_ASSERT_EQUAL(std::string("\"a\",\"2\",\"1\"\r\n\"a\",\"10\",\"3\"\r\n\"a\",\"10\",\"5\"\r\n\"b\",\"1\",\"2\"\r\n\"b\",\"1\",\"4\"\r\n"),
+		       sort(sorter, "a,10,3\r\nb,1,2\r\na,2,1\r\nb,1,4\r\na,10,5\r\n"));
+}
+
+void SorterTest::testSortMissingColumn(void)
+{
+  Sorter sorter;
+  sorter.addKey(1, Sorter::COLLATION_STRING);
+
+  CPPUNIT_ASSERT_EQUAL(std::string("\"2\"\r\n\"3\",\"\"\r\n\"1\",\"a\"\r\n"),
+		       sort(sorter, "1,a\r\n2\r\n3,\"\",\r\n"));
+}
+
+void SorterTest::testSortSpill(void)
+{
+  std::vector<std::vector<std::string> > csv = makeCsv(1000);
+  Util::save(inpath, csv);
+
+  Sorter sorter;
+  sorter.addKey(0, Sorter::COLLATION_STRING);
+  sorter.addKey(1, Sorter::COLLATION_NUMERIC);
+  sorter.setTempDirectory("./test");
+  sorter.setMemoryLimit(1024);
+  sorter.sort(inpath, outpath);
+  CPPUNIT_ASSERT(sorter.getRunCount() > SORT_MERGE_WAYS);
+  CPPUNIT_ASSERT_EQUAL((std::size_t)0, countRuns());
+
+  std::stable_sort(csv.begin(), csv.end(),
+		   [](const std::vector<std::string>& a, const std::vector<std::string>& b) {
+		     if (a[0] != b[0]) {
+		       return a[0] < b[0];
+		     }
+		     return std::atol(a[1].c_str()) < std::atol(b[1].c_str());
+		   });
+
+  std::vector<std::vector<std::string> > result;
+  Util::load(outpath, result);
+  CPPUNIT_ASSERT(result == csv);
+}
+
+void SorterTest::testSortParallel(void)
+{
+  std::vector<std::vector<std::string> > csv = makeCsv(20000);
+  std::ostringstream data;
+  Util::save(data, csv);
+
+  Sorter serial;
+  serial.addKey(1, Sorter::COLLATION_NUMERIC);
+  serial.addKey(0, Sorter::COLLATION_STRING);
+  const std::string expected = sort(serial, data.str());
+
+  Sorter parallel;
+  parallel.addKey(1, Sorter::COLLATION_NUMERIC);
+  parallel.addKey(0, Sorter::COLLATION_STRING);
+  parallel.setThreadCount(4);
+  CPPUNIT_ASSERT_EQUAL(expected, sort(parallel, data.str()));
+
+  parallel.setTempDirectory("./test");
+  parallel.setMemoryLimit(256 * 1024);
+  CPPUNIT_ASSERT_EQUAL(expected, sort(parallel, data.str()));
+  CPPUNIT_ASSERT(parallel.getRunCount() > 1);
+}
+
+void SorterTest::testSortFile(void)
+{
+  std::vector<std::vector<std::string> > csv = makeCsv(10);
+  Config config;
+  config.setDelimitMark('\t');
+  config.setQuoteEnabled(false);
+  Util::save(inpath, config, csv);
+
+  Sorter sorter;
+  sorter.addKey(2, Sorter::COLLATION_STRING);
+  sorter.sort(inpath, config, outpath);
+
+  std::vector<std::vector<std::string> > result;
+  Util::load(outpath, config, result);
+  CPPUNIT_ASSERT_EQUAL(csv.size(), result.size());
+  for (std::size_t i = 1; i < result.size(); i++) {
+    CPPUNIT_ASSERT(result[i - 1][2] <= result[i][2]);
+  }
+}
+
+void SorterTest::testSortThrowInvalidArgument(void)
+{
+  Sorter sorter;
+
+  try {
+    sort(sorter, "1\r\n");
+    CPPUNIT_FAIL("std::invalid_argument must be throw.");
+  } catch (std::invalid_argument&) {
+    CPPUNIT_ASSERT(true);
+  }
+}
+
+void SorterTest::testSortThrowIosBaseFailure(void)
+{
+  Sorter sorter;
+  sorter.addKey(0, Sorter::COLLATION_STRING);
+
+  try {
+    sorter.sort("./", outpath);
+    CPPUNIT_FAIL("std::ios_base::failure must be throw.");
+  } catch (std::ios_base::failure&) {
+    CPPUNIT_ASSERT(true);
+  }
+
+  sorter.setTempDirectory("./test/no_such_directory");
+  sorter.setMemoryLimit(1);
+
+  try {
+    sort(sorter, "1\r\n2\r\n");
+    CPPUNIT_FAIL("std::ios_base::failure must be throw.");
+  } catch (std::ios_base::failure&) {
+    CPPUNIT_ASSERT(true);
+  }
+}
+
+} // namespace csv
+} // namespace csl
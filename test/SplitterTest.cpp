@@ -0,0 +1,222 @@
+#include <cppunit/extensions/HelperMacros.h>
+#include "csl/csv/Splitter.hpp"
+#include <string>
+#include <vector>
+#include <sstream>
+#include <fstream>
+#include "csl/csv/Config.hpp"
+#include "csl/csv/Reader.hpp"
+#include "csl/csv/Util.hpp"
+
+namespace csl {
+namespace csv {
+
+class SplitterTest : public CPPUNIT_NS::TestFixture
+{
+  CPPUNIT_TEST_SUITE(SplitterTest);
+  CPPUNIT_TEST(testPlanIstreamSizeVectorRange);
+  CPPUNIT_TEST(testPlanIstreamConfigSizeVectorRange);
+  CPPUNIT_TEST(testPlanIstreamSizeVectorRangeLenient);
+  CPPUNIT_TEST(testPlanStringSizeVectorRange);
+  CPPUNIT_TEST(testPlanStringSizeVectorRangeThrowFailure);
+  CPPUNIT_TEST(testAlign);
+  CPPUNIT_TEST(testAlignLookahead);
+  CPPUNIT_TEST(testAlignLongQuotedField);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  virtual void setUp(void);
+  virtual void tearDown(void);
+
+private:
+  void testPlanIstreamSizeVectorRange(void);
+  void testPlanIstreamConfigSizeVectorRange(void);
+  void testPlanIstreamSizeVectorRangeLenient(void);
+  void testPlanStringSizeVectorRange(void);
+  void testPlanStringSizeVectorRangeThrowFailure(void);
+  void testAlign(void);
+  void testAlignLookahead(void);
+  void testAlignLongQuotedField(void);
+
+private:
+  void assertRanges(std::istream& stream, const Config& config, const std::vector<Range>& ranges);
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(SplitterTest);
+
+void SplitterTest::setUp(void)
+{
+}
+
+void SplitterTest::tearDown(void)
+{
+}
+
+void SplitterTest::assertRanges(std::istream& stream, const Config& config, const std::vector<Range>& ranges)
+{
+  std::vector<std::vector<std::string> > expected;
+  std::vector<std::vector<std::string> > csv;
+  std::vector<std::string> record;
+
+  stream.clear();
+  stream.seekg(0);
+  Util::load(stream, config, expected);
+
+  for (std::size_t i = 0; i < ranges.size(); i++) {
+    if (i > 0) {
+      CPPUNIT_ASSERT_EQUAL(ranges[i - 1].getEnd(), ranges[i].getBegin());
+    }
+    stream.clear();
+    Reader reader(stream, config, ranges[i]);
+    while (reader.hasNext()) {
+      reader.read(record);
+      csv.push_back(record);
+    }
+  }
+
+  CPPUNIT_ASSERT(csv == expected);
+}
+
+void SplitterTest::testPlanIstreamSizeVectorRange(void)
+{
+  std::stringstream data;
+  for (int i = 0; i < 50000; i++) {
+    data << i << ",\"quoted\r\n" << i << "\"\"\r\n\",plain\r\n";
+    if (i % 1000 == 0) {
+      data << "\"" << std::string(100000, '\n') << "\"\r\n";
+    }
+  }
+  std::stringstream stream(data.str());
+  std::vector<Range> ranges;
+
+  Splitter::plan(stream, 7, ranges);
+
+  CPPUNIT_ASSERT(ranges.size() == 7);
+  CPPUNIT_ASSERT_EQUAL((std::streamoff)0, ranges.front().getBegin());
+  CPPUNIT_ASSERT_EQUAL((std::streamoff)data.str().size(), ranges.back().getEnd());
+  assertRanges(stream, DEFAULT_CONFIG, ranges);
+}
+
+void SplitterTest::testPlanIstreamConfigSizeVectorRange(void)
+{
+  std::stringstream data;
+  for (int i = 0; i < 50000; i++) {
+    data << "#\"comment\" " << i << "\r\n";
+    data << i << ",\"q\r\n\",\"\"\r\n";
+  }
+  std::stringstream stream(data.str());
+  std::vector<Range> ranges;
+
+  Config config;
+  config.setCommentEnabled(true);
+  Splitter::plan(stream, config, 13, ranges);
+
+  CPPUNIT_ASSERT(ranges.size() == 13);
+  assertRanges(stream, config, ranges);
+}
+
+void SplitterTest::testPlanIstreamSizeVectorRangeLenient(void)
+{
+  // a quote mark opens in the middle of a field, which Reader accepts;
+  // only the wrong guess about the quote state looks like strict CSV
+  std::stringstream data;
+  for (int i = 0; i < 50000; i++) {
+    data << i << ",a\",x\r\n\"," << i << "\r\n";
+  }
+  std::stringstream stream(data.str());
+  std::vector<Range> ranges;
+
+  Splitter::plan(stream, 7, ranges);
+
+  CPPUNIT_ASSERT(ranges.size() == 7);
+  assertRanges(stream, DEFAULT_CONFIG, ranges);
+}
+
+void SplitterTest::testPlanStringSizeVectorRange(void)
+{
+  std::string filepath = "./test/test.csv";
+  std::vector<Range> ranges;
+
+  Splitter::plan(filepath, 10, ranges);
+
+  CPPUNIT_ASSERT(ranges.size() == 10);
+
+  std::ifstream stream(filepath.c_str(), std::ifstream::binary);
+  assertRanges(stream, DEFAULT_CONFIG, ranges);
+}
+
+void SplitterTest::testPlanStringSizeVectorRangeThrowFailure(void)
+{
+  std::string filepath = "./";
+  std::vector<Range> ranges;
+
+  try {
+    Splitter::plan(filepath, 2, ranges);
+    CPPUNIT_FAIL("std::ios_base::failure must be throw.");
+  } catch (std::ios_base::failure&) {
+    CPPUNIT_ASSERT(true);
+  }
+}
+
+void SplitterTest::testAlign(void)
+{
+  std::stringstream stream("aaa,bbb\r\n"
+			   "\"c\r\nc\",ddd\r\n"
+			   "eee\r\n");
+  Config config;
+
+  CPPUNIT_ASSERT_EQUAL((std::streamoff)0, Splitter::align(stream, config, 0, 0));
+  CPPUNIT_ASSERT_EQUAL((std::streamoff)9, Splitter::align(stream, config, 0, 1));
+  CPPUNIT_ASSERT_EQUAL((std::streamoff)9, Splitter::align(stream, config, 0, 9));
+  CPPUNIT_ASSERT_EQUAL((std::streamoff)21, Splitter::align(stream, config, 0, 13));
+  CPPUNIT_ASSERT_EQUAL((std::streamoff)26, Splitter::align(stream, config, 21, 22));
+  CPPUNIT_ASSERT_EQUAL((std::streamoff)26, Splitter::align(stream, config, 0, 30));
+}
+
+void SplitterTest::testAlignLookahead(void)
+{
+  std::string data;
+  for (int i = 0; i < 100; i++) {
+    data += "\"x\r\n,x\",yyyyyyyyyy\r\n";
+  }
+  std::stringstream stream(data);
+  Config config;
+
+  // a short window cannot tell quoted line breaks apart, so the exact scan decides
+  for (std::streamoff offset = 1; offset < 60; offset++) {
+    const std::streamoff expected = Splitter::align(stream, config, 0, offset);
+    CPPUNIT_ASSERT_EQUAL(expected, Splitter::align(stream, config, 0, offset, 4));
+    CPPUNIT_ASSERT_EQUAL((std::streamoff)0, expected % 20);
+  }
+}
+
+void SplitterTest::testAlignLongQuotedField(void)
+{
+  // the quoted field is longer than the lookahead, so only the guess outside quotes finds a boundary
+  std::string field;
+  for (int i = 0; i < 40000; i++) {
+    field += "ab,c\r\n";
+  }
+  const std::string head = "id,v\r\n1,x\r\n";
+  const std::string data = head + "2,\"" + field + "\"\r\n3,y\r\n";
+  const std::streamoff end = static_cast<std::streamoff>(data.size() - 5);
+  std::stringstream stream(data);
+  Config config;
+
+  for (std::streamoff offset = static_cast<std::streamoff>(head.size() + 1); offset < end; offset += 4099) {
+    CPPUNIT_ASSERT_EQUAL(end, Splitter::align(stream, config, 0, offset));
+  }
+
+  config.setCommentEnabled(true);
+  for (std::streamoff offset = static_cast<std::streamoff>(head.size() + 1); offset < end; offset += 40009) {
+    CPPUNIT_ASSERT_EQUAL(end, Splitter::align(stream, config, 0, offset));
+  }
+
+  std::vector<Range> ranges;
+  Splitter::plan(stream, 8, ranges);
+  CPPUNIT_ASSERT(ranges.size() == 8);
+  assertRanges(stream, DEFAULT_CONFIG, ranges);
+}
+
+} // namespace csv
+} // namespace csl
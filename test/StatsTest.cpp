@@ -0,0 +1,94 @@
+#include <cppunit/extensions/HelperMacros.h>
+#include "csl/csv/Stats.hpp"
+#include <string>
+#include <vector>
+#include <sstream>
+#include "csl/csv/Reader.hpp"
+
+namespace csl {
+namespace csv {
+
+class StatsTest : public CPPUNIT_NS::TestFixture
+{
+  CPPUNIT_TEST_SUITE(StatsTest);
+  CPPUNIT_TEST(testStats);
+  CPPUNIT_TEST(testReset);
+  CPPUNIT_TEST(testAddIoTime);
+  CPPUNIT_TEST(testToJson);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  virtual void setUp(void);
+  virtual void tearDown(void);
+
+private:
+  void testStats(void);
+  void testReset(void);
+  void testAddIoTime(void);
+  void testToJson(void);
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(StatsTest);
+
+void StatsTest::setUp(void)
+{
+}
+
+void StatsTest::tearDown(void)
+{
+}
+
+void StatsTest::testStats(void)
+{
+  Stats stats;
+  CPPUNIT_ASSERT_EQUAL(0ULL, stats.getBytes());
+  CPPUNIT_ASSERT_EQUAL((std::size_t)0, stats.getRecords());
+  CPPUNIT_ASSERT_EQUAL((std::size_t)0, stats.getFields());
+  CPPUNIT_ASSERT_EQUAL((std::size_t)0, stats.getQuotedFields());
+  CPPUNIT_ASSERT_EQUAL((std::size_t)0, stats.getEscapedQuotes());
+  CPPUNIT_ASSERT_EQUAL((std::size_t)0, stats.getCommentLines());
+  CPPUNIT_ASSERT_EQUAL((std::size_t)0, stats.getMaxFieldLength());
+  CPPUNIT_ASSERT_EQUAL((std::size_t)0, stats.getMaxRecordLength());
+  CPPUNIT_ASSERT_EQUAL(0ULL, stats.getIoTime());
+  CPPUNIT_ASSERT_EQUAL(0ULL, stats.getParseTime());
+}
+
+void StatsTest::testReset(void)
+{
+  std::stringstream stream("aaa,bbb\r\n");
+  Reader reader(stream);
+  std::vector<std::string> record;
+  Stats stats;
+
+  reader.setStats(&stats);
+  reader.read(record);
+  CPPUNIT_ASSERT_EQUAL((std::size_t)1, stats.getRecords());
+
+  stats.reset();
+  CPPUNIT_ASSERT_EQUAL(0ULL, stats.getBytes());
+  CPPUNIT_ASSERT_EQUAL((std::size_t)0, stats.getRecords());
+  CPPUNIT_ASSERT_EQUAL((std::size_t)0, stats.getFields());
+  CPPUNIT_ASSERT_EQUAL((std::size_t)0, stats.getMaxFieldLength());
+  CPPUNIT_ASSERT_EQUAL(0ULL, stats.getParseTime());
+}
+
+void StatsTest::testAddIoTime(void)
+{
+  Stats stats;
+  stats.addIoTime(10);
+  stats.addIoTime(5);
+  CPPUNIT_ASSERT_EQUAL(15ULL, stats.getIoTime());
+}
+
+void StatsTest::testToJson(void)
+{
+  Stats stats;
+  stats.addIoTime(7);
+  CPPUNIT_ASSERT_EQUAL(std::string("{\"bytes\":0,\"records\":0,\"fields\":0,\"quoted_fields\":0,"
+				   "\"escaped_quotes\":0,\"comment_lines\":0,\"max_field_length\":0,"
+				   "\"max_record_length\":0,\"io_time_ns\":7,\"parse_time_ns\":0}"),
+		       stats.toJson());
+}
+
+} // namespace csv
+} // namespace csl
@@ -0,0 +1,119 @@
+#include <cppunit/extensions/HelperMacros.h>
+#include "csl/csv/TempFiles.hpp"
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <sys/stat.h>
+
+namespace csl {
+namespace csv {
+
+class TempFilesTest : public CPPUNIT_NS::TestFixture
+{
+  CPPUNIT_TEST_SUITE(TempFilesTest);
+  CPPUNIT_TEST(testCreate);
+  CPPUNIT_TEST(testCreateThrowFailure);
+  CPPUNIT_TEST(testWriteRead);
+  CPPUNIT_TEST(testReadThrowFailure);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  virtual void setUp(void);
+  virtual void tearDown(void);
+
+private:
+  void testCreate(void);
+  void testCreateThrowFailure(void);
+  void testWriteRead(void);
+  void testReadThrowFailure(void);
+
+private:
+  bool exists(const std::string& path);
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TempFilesTest);
+
+void TempFilesTest::setUp(void)
+{
+}
+
+void TempFilesTest::tearDown(void)
+{
+}
+
+bool TempFilesTest::exists(const std::string& path)
+{
+  struct stat st;
+  return stat(path.c_str(), &st) == 0;
+}
+
+void TempFilesTest::testCreate(void)
+{
+  std::string first;
+  std::string second;
+  {
+    TempFiles files("./test");
+    first = files.create();
+    second = files.create();
+    CPPUNIT_ASSERT(first != second);
+    CPPUNIT_ASSERT_EQUAL(std::string("./test/cslcsv-"), first.substr(0, 14));
+    CPPUNIT_ASSERT(exists(first));
+    CPPUNIT_ASSERT_EQUAL((std::size_t)2, files.getPaths().size());
+
+    files.remove(first);
+    CPPUNIT_ASSERT(!exists(first));
+    CPPUNIT_ASSERT_EQUAL((std::size_t)1, files.getPaths().size());
+    CPPUNIT_ASSERT_EQUAL(second, files.getPaths()[0]);
+  }
+  CPPUNIT_ASSERT(!exists(second));
+}
+
+void TempFilesTest::testCreateThrowFailure(void)
+{
+  TempFiles files("./test/no_such_directory");
+
+  try {
+    files.create();
+    CPPUNIT_FAIL("std::ios_base::failure must be throw.");
+  } catch (std::ios_base::failure&) {
+    CPPUNIT_ASSERT(true);
+  }
+}
+
+void TempFilesTest::testWriteRead(void)
+{
+  std::vector<std::string> record;
+  record.push_back("a\"b");
+  record.push_back("");
+  record.push_back(std::string("c\r\n\0d", 5));
+
+  std::stringstream stream;
+  TempFiles::write(stream, record);
+  TempFiles::write(stream, std::vector<std::string>());
+
+  std::vector<std::string> result;
+  CPPUNIT_ASSERT(TempFiles::read(stream, result));
+  CPPUNIT_ASSERT(result == record);
+  CPPUNIT_ASSERT(TempFiles::read(stream, result));
+  CPPUNIT_ASSERT(result.empty());
+  CPPUNIT_ASSERT(!TempFiles::read(stream, result));
+}
+
+void TempFilesTest::testReadThrowFailure(void)
+{
+  std::vector<std::string> record(1, "abc");
+  std::stringstream written;
+  TempFiles::write(written, record);
+
+  std::istringstream stream(written.str().substr(0, written.str().size() - 1));
+  try {
+    TempFiles::read(stream, record);
+    CPPUNIT_FAIL("std::ios_base::failure must be throw.");
+  } catch (std::ios_base::failure&) {
+    CPPUNIT_ASSERT(true);
+  }
+}
+
+} // namespace csv
+} // namespace csl
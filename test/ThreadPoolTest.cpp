@@ -0,0 +1,99 @@
+#include <cppunit/extensions/HelperMacros.h>
+#include "csl/csv/ThreadPool.hpp"
+#include <atomic>
+#include <stdexcept>
+
+namespace csl {
+namespace csv {
+
+class ThreadPoolTest : public CPPUNIT_NS::TestFixture
+{
+  CPPUNIT_TEST_SUITE(ThreadPoolTest);
+  CPPUNIT_TEST(testThreadPool);
+  CPPUNIT_TEST(testThreadPoolSize);
+  CPPUNIT_TEST(testSubmit);
+  CPPUNIT_TEST(testSubmitNested);
+  CPPUNIT_TEST(testWaitThrowException);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  virtual void setUp(void);
+  virtual void tearDown(void);
+
+private:
+  void testThreadPool(void);
+  void testThreadPoolSize(void);
+  void testSubmit(void);
+  void testSubmitNested(void);
+  void testWaitThrowException(void);
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(ThreadPoolTest);
+
+void ThreadPoolTest::setUp(void)
+{
+}
+
+void ThreadPoolTest::tearDown(void)
+{
+}
+
+void ThreadPoolTest::testThreadPool(void)
+{
+  ThreadPool pool;
+  CPPUNIT_ASSERT(pool.getSize() > 0);
+}
+
+void ThreadPoolTest::testThreadPoolSize(void)
+{
+  ThreadPool pool(3);
+  CPPUNIT_ASSERT_EQUAL((std::size_t)3, pool.getSize());
+}
+
+void ThreadPoolTest::testSubmit(void)
+{
+  ThreadPool pool(4);
+  std::atomic<int> count(0);
+
+  for (int i = 0; i < 1000; i++) {
+    pool.submit([&count]() { count++; });
+  }
+  pool.wait();
+
+  CPPUNIT_ASSERT_EQUAL(1000, count.load());
+}
+
+void ThreadPoolTest::testSubmitNested(void)
+{
+  ThreadPool pool(2);
+  std::atomic<int> count(0);
+
+  for (int i = 0; i < 10; i++) {
+    pool.submit([&pool, &count]() {
+	for (int j = 0; j < 10; j++) {
+	  pool.submit([&count]() { count++; });
+	}
+      });
+  }
+  pool.wait();
+
+  CPPUNIT_ASSERT_EQUAL(100, count.load());
+}
+
+void ThreadPoolTest::testWaitThrowException(void)
+{
+  ThreadPool pool(2);
+  pool.submit([]() { throw std::runtime_error("error"); });
+
+  try {
+    pool.wait();
+    CPPUNIT_FAIL("std::runtime_error must be throw.");
+  } catch (std::runtime_error&) {
+    CPPUNIT_ASSERT(true);
+  }
+
+  pool.wait();
+}
+
+} // namespace csv
+} // namespace csl
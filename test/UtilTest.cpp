@@ -2,10 +2,29 @@
 #include "csl/csv/Util.hpp"
 #include <string>
 #include <vector>
+#include <sstream>
+#include <cmath>
+#include <stdexcept>
 
 namespace csl {
 namespace csv {
 
+namespace {
+
+/**
+ * @brief 最初の読み込みで例外を投げる入力ストリームバッファです。
+ */
+class BrokenInputBuffer : public std::streambuf
+{
+protected:
+  virtual int_type underflow(void)
+  {
+    throw std::runtime_error("broken");
+  }
+};
+
+} // namespace
+
 class UtilTest : public CPPUNIT_NS::TestFixture
 {
   CPPUNIT_TEST_SUITE(UtilTest);
@@ -16,7 +35,29 @@ class UtilTest : public CPPUNIT_NS::TestFixture
   CPPUNIT_TEST(testLoadStringVectorVectorString);
   CPPUNIT_TEST(testLoadStringVectorVectorStringThrowFailure);
   CPPUNIT_TEST(testLoadStringConfigVectorVectorString);
+  CPPUNIT_TEST(testLoadIstreamConfigVectorVectorStringStats);
+  CPPUNIT_TEST(testLoadIstreamConfigVectorVectorStringStatsThrowFailure);
+  CPPUNIT_TEST(testLoadStringConfigVectorVectorStringStats);
+  CPPUNIT_TEST(testLoadIstreamConfigEncodedTable);
+  CPPUNIT_TEST(testLoadStringConfigEncodedTable);
+  CPPUNIT_TEST(testLoadStringConfigEncodedTableThrowFailure);
+  CPPUNIT_TEST(testLoadIstreamConfigFilter);
+  CPPUNIT_TEST(testLoadStringConfigFilter);
+  CPPUNIT_TEST(testLoadStringConfigFilterThrowFailure);
+#if __cplusplus >= 201703L
+  CPPUNIT_TEST(testLoadIstreamConfigPmrVectorVectorString);
+  CPPUNIT_TEST(testLoadStringConfigPmrVectorVectorString);
+  CPPUNIT_TEST(testLoadStringConfigPmrVectorVectorStringThrowFailure);
+#endif
   CPPUNIT_TEST(testLoadStringConfigVectorVectorStringThrowFailure);
+  CPPUNIT_TEST(testLoadManyVectorStringVectorVectorVectorString);
+  CPPUNIT_TEST(testLoadManyVectorStringVectorVectorVectorStringThrowFailure);
+  CPPUNIT_TEST(testLoadManyVectorStringConfigThreadPoolLoadCallback);
+  CPPUNIT_TEST(testTailIstreamSizeVectorVectorString);
+  CPPUNIT_TEST(testTailIstreamConfigSizeVectorVectorString);
+  CPPUNIT_TEST(testTailIstreamConfigSizeVectorVectorStringLarge);
+  CPPUNIT_TEST(testTailStringSizeVectorVectorString);
+  CPPUNIT_TEST(testTailStringSizeVectorVectorStringThrowFailure);
   CPPUNIT_TEST(testSaveOstreamVectorVectorString);
   CPPUNIT_TEST(testSaveOstreamVectorVectorStringThrowFailure);
   CPPUNIT_TEST(testSaveOstreamConfigVectorVectorString);
@@ -25,6 +66,8 @@ class UtilTest : public CPPUNIT_NS::TestFixture
   CPPUNIT_TEST(testSaveStringVectorVectorStringThrowFailure);
   CPPUNIT_TEST(testSaveStringConfigVectorVectorString);
   CPPUNIT_TEST(testSaveStringConfigVectorVectorStringThrowFailure);
+  CPPUNIT_TEST(testSaveOstreamConfigVectorVectorStringStats);
+  CPPUNIT_TEST(testParseNumber);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -39,7 +82,29 @@ private:
   void testLoadStringVectorVectorString(void);
   void testLoadStringVectorVectorStringThrowFailure(void);
   void testLoadStringConfigVectorVectorString(void);
+  void testLoadIstreamConfigVectorVectorStringStats(void);
+  void testLoadIstreamConfigVectorVectorStringStatsThrowFailure(void);
+  void testLoadStringConfigVectorVectorStringStats(void);
+  void testLoadIstreamConfigEncodedTable(void);
+  void testLoadStringConfigEncodedTable(void);
+  void testLoadStringConfigEncodedTableThrowFailure(void);
+  void testLoadIstreamConfigFilter(void);
+  void testLoadStringConfigFilter(void);
+  void testLoadStringConfigFilterThrowFailure(void);
+#if __cplusplus >= 201703L
+  void testLoadIstreamConfigPmrVectorVectorString(void);
+  void testLoadStringConfigPmrVectorVectorString(void);
+  void testLoadStringConfigPmrVectorVectorStringThrowFailure(void);
+#endif
   void testLoadStringConfigVectorVectorStringThrowFailure(void);
+  void testLoadManyVectorStringVectorVectorVectorString(void);
+  void testLoadManyVectorStringVectorVectorVectorStringThrowFailure(void);
+  void testLoadManyVectorStringConfigThreadPoolLoadCallback(void);
+  void testTailIstreamSizeVectorVectorString(void);
+  void testTailIstreamConfigSizeVectorVectorString(void);
+  void testTailIstreamConfigSizeVectorVectorStringLarge(void);
+  void testTailStringSizeVectorVectorString(void);
+  void testTailStringSizeVectorVectorStringThrowFailure(void);
   void testSaveOstreamVectorVectorString(void);
   void testSaveOstreamVectorVectorStringThrowFailure(void);
   void testSaveOstreamConfigVectorVectorString(void);
@@ -48,6 +113,8 @@ private:
   void testSaveStringVectorVectorStringThrowFailure(void);
   void testSaveStringConfigVectorVectorString(void);
   void testSaveStringConfigVectorVectorStringThrowFailure(void);
+  void testSaveOstreamConfigVectorVectorStringStats(void);
+  void testParseNumber(void);
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(UtilTest);
@@ -243,6 +310,164 @@ void UtilTest::testLoadStringConfigVectorVectorStringThrowFailure(void)
   }
 }
 
+void UtilTest::testLoadManyVectorStringVectorVectorVectorString(void)
+{
+  std::vector<std::string> filepaths;
+  for (int i = 0; i < 100; i++) {
+    filepaths.push_back("./test/test.csv");
+  }
+  std::vector<std::vector<std::vector<std::string> > > csvs;
+  std::vector<std::vector<std::string> > expected;
+
+  Util::load(filepaths.front(), expected);
+  Util::loadMany(filepaths, csvs);
+
+  CPPUNIT_ASSERT(csvs.size() == 100);
+  for (std::size_t i = 0; i < csvs.size(); i++) {
+    CPPUNIT_ASSERT(csvs[i] == expected);
+  }
+}
+
+void UtilTest::testLoadManyVectorStringVectorVectorVectorStringThrowFailure(void)
+{
+  std::vector<std::string> filepaths;
+  filepaths.push_back("./test/test.csv");
+  filepaths.push_back("./");
+  std::vector<std::vector<std::vector<std::string> > > csvs;
+
+  try {
+    Util::loadMany(filepaths, csvs);
+    CPPUNIT_FAIL("std::ios_base::failure must be throw.");
+  } catch (std::ios_base::failure&) {
+    CPPUNIT_ASSERT(true);
+  }
+}
+
+void UtilTest::testLoadManyVectorStringConfigThreadPoolLoadCallback(void)
+{
+  std::vector<std::string> filepaths;
+  for (int i = 0; i < 100; i++) {
+    filepaths.push_back("./test/test.csv");
+  }
+  std::vector<int> counts(filepaths.size());
+  std::size_t records = 0;
+
+  ThreadPool pool(4);
+  Util::loadMany(filepaths, DEFAULT_CONFIG, pool,
+		 [&](std::size_t index, std::vector<std::vector<std::string> >& csv) {
+		   counts[index]++;
+		   records += csv.size();
+		 });
+
+  CPPUNIT_ASSERT_EQUAL((std::size_t)400, records);
+  for (std::size_t i = 0; i < counts.size(); i++) {
+    CPPUNIT_ASSERT_EQUAL(1, counts[i]);
+  }
+}
+
+void UtilTest::testTailIstreamSizeVectorVectorString(void)
+{
+  std::stringstream stream("aaa,bbb\r\n"
+			   "\"c\r\nc\",ddd\r\n"
+			   "eee,\"f\r\n\r\nf\"\r\n");
+  std::vector<std::vector<std::string> > csv;
+
+  Util::tail(stream, 2, csv);
+
+  CPPUNIT_ASSERT(csv.size() == 2);
+
+  CPPUNIT_ASSERT(csv[0].size() == 2);
+  CPPUNIT_ASSERT(csv[0][0] == "c\r\nc");
+  CPPUNIT_ASSERT(csv[0][1] == "ddd");
+
+  CPPUNIT_ASSERT(csv[1].size() == 2);
+  CPPUNIT_ASSERT(csv[1][0] == "eee");
+  CPPUNIT_ASSERT(csv[1][1] == "f\r\n\r\nf");
+
+  Util::tail(stream, 5, csv);
+
+  CPPUNIT_ASSERT(csv.size() == 3);
+  CPPUNIT_ASSERT(csv[0][0] == "aaa");
+}
+
+void UtilTest::testTailIstreamConfigSizeVectorVectorString(void)
+{
+  std::stringstream stream("aaa\r\n"
+			   "#\"comment\r\n"
+			   "bbb\r\n"
+			   "ccc\r\n"
+			   "#comment");
+  std::vector<std::vector<std::string> > csv;
+
+  Config config;
+  config.setCommentEnabled(true);
+  Util::tail(stream, config, 2, csv);
+
+  CPPUNIT_ASSERT(csv.size() == 2);
+  CPPUNIT_ASSERT(csv[0].size() == 1);
+  CPPUNIT_ASSERT(csv[0][0] == "ccc");
+  CPPUNIT_ASSERT(csv[1].size() == 0);
+
+  Util::tail(stream, config, 3, csv);
+
+  CPPUNIT_ASSERT(csv.size() == 3);
+  CPPUNIT_ASSERT(csv[0].size() == 1);
+  CPPUNIT_ASSERT(csv[0][0] == "bbb");
+}
+
+void UtilTest::testTailIstreamConfigSizeVectorVectorStringLarge(void)
+{
+  std::stringstream data;
+  for (int i = 0; i < 20000; i++) {
+    if (i % 7 == 0) {
+      data << "#\"comment " << i << "\r\n";
+    }
+    data << i << ",\"quoted\r\n" << i << "\"\"\r\n\",plain\r\n";
+  }
+  std::vector<std::vector<std::string> > expected;
+  std::vector<std::vector<std::string> > csv;
+
+  Config config;
+  config.setCommentEnabled(true);
+  std::stringstream stream(data.str());
+  Util::load(stream, config, expected);
+  stream.clear();
+  Util::tail(stream, config, 15000, csv);
+
+  CPPUNIT_ASSERT(csv.size() == 15000);
+  CPPUNIT_ASSERT(csv.front() == expected[expected.size() - 15000]);
+  CPPUNIT_ASSERT(csv.back() == expected.back());
+}
+
+void UtilTest::testTailStringSizeVectorVectorString(void)
+{
+  std::string filepath = "./test/test.csv";
+  std::vector<std::vector<std::string> > csv;
+
+  Util::tail(filepath, 2, csv);
+
+  CPPUNIT_ASSERT(csv.size() == 2);
+
+  CPPUNIT_ASSERT(csv[0].size() == 5);
+  CPPUNIT_ASSERT(csv[0][4] == "e,e");
+
+  CPPUNIT_ASSERT(csv[1].size() == 5);
+  CPPUNIT_ASSERT(csv[1][4] == "e\ne");
+}
+
+void UtilTest::testTailStringSizeVectorVectorStringThrowFailure(void)
+{
+  std::string filepath = "./";
+  std::vector<std::vector<std::string> > csv;
+
+  try {
+    Util::tail(filepath, 1, csv);
+    CPPUNIT_FAIL("std::ios_base::failure must be throw.");
+  } catch (std::ios_base::failure&) {
+    CPPUNIT_ASSERT(true);
+  }
+}
+
 void UtilTest::testSaveOstreamVectorVectorString(void)
 {
   std::stringstream stream("");
@@ -440,5 +665,276 @@ void UtilTest::testSaveStringConfigVectorVectorStringThrowFailure(void)
   }
 }
 
+void UtilTest::testLoadIstreamConfigVectorVectorStringStats(void)
+{
+  std::stringstream stream("aaa,\"b\"\"b\"\r\n"
+			   "ccc\r\n");
+  std::vector<std::vector<std::string> > csv;
+  Config config;
+  Stats stats;
+  Util::load(stream, config, csv, stats);
+
+  CPPUNIT_ASSERT(csv.size() == 2);
+  CPPUNIT_ASSERT(csv[0].size() == 2);
+  CPPUNIT_ASSERT(csv[0][1] == "b\"b");
+  CPPUNIT_ASSERT(stream.eof());
+
+  CPPUNIT_ASSERT_EQUAL(17ULL, stats.getBytes());
+  CPPUNIT_ASSERT_EQUAL((std::size_t)2, stats.getRecords());
+  CPPUNIT_ASSERT_EQUAL((std::size_t)3, stats.getFields());
+  CPPUNIT_ASSERT_EQUAL((std::size_t)1, stats.getQuotedFields());
+  CPPUNIT_ASSERT_EQUAL((std::size_t)1, stats.getEscapedQuotes());
+  CPPUNIT_ASSERT(stats.getIoTime() > 0);
+}
+
+void UtilTest::testLoadIstreamConfigVectorVectorStringStatsThrowFailure(void)
+{
+  std::stringstream stream("aaa");
+  std::vector<std::vector<std::string> > csv;
+  Config config;
+  Stats stats;
+  stream.setstate(std::ios_base::badbit);
+
+  try {
+    Util::load(stream, config, csv, stats);
+    CPPUNIT_FAIL("std::ios_base::failure must be throw.");
+  } catch (std::ios_base::failure&) {
+    CPPUNIT_ASSERT(csv.empty());
+  }
+
+  BrokenInputBuffer buffer;
+  std::istream broken(&buffer);
+
+  try {
+    Util::load(broken, config, csv, stats);
+    CPPUNIT_FAIL("std::ios_base::failure must be throw.");
+  } catch (std::ios_base::failure&) {
+    CPPUNIT_ASSERT(broken.bad());
+  }
+}
+
+void UtilTest::testLoadStringConfigVectorVectorStringStats(void)
+{
+  std::string filepath = "./test/test.csv";
+  std::vector<std::vector<std::string> > expected;
+  std::vector<std::vector<std::string> > csv;
+  Config config;
+  Stats stats;
+  Util::load(filepath, config, expected);
+  Util::load(filepath, config, csv, stats);
+
+  CPPUNIT_ASSERT(csv == expected);
+  CPPUNIT_ASSERT_EQUAL(expected.size(), stats.getRecords());
+}
+
+void UtilTest::testSaveOstreamConfigVectorVectorStringStats(void)
+{
+  std::vector<std::vector<std::string> > csv;
+  std::vector<std::string> record;
+  record.push_back("aaa");
+  record.push_back("bbb");
+  csv.push_back(record);
+  csv.push_back(record);
+
+  std::stringstream stream("");
+  Config config;
+  Stats stats;
+  Util::save(stream, config, csv, stats);
+
+  CPPUNIT_ASSERT(stream.str() == "\"aaa\",\"bbb\"\r\n\"aaa\",\"bbb\"\r\n");
+  CPPUNIT_ASSERT_EQUAL(26ULL, stats.getBytes());
+  CPPUNIT_ASSERT_EQUAL((std::size_t)2, stats.getRecords());
+  CPPUNIT_ASSERT_EQUAL((std::size_t)4, stats.getFields());
+}
+
+#if __cplusplus >= 201703L
+void UtilTest::testLoadIstreamConfigPmrVectorVectorString(void)
+{
+  std::stringstream stream("aaa,bbb\r\n"
+			   "# comment\r\n"
+			   "\"cccccccccccccccccccccccccccccccccccccccc\"\r\n");
+  char buffer[4096];
+  std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer), std::pmr::null_memory_resource());
+  std::pmr::vector<std::pmr::vector<std::pmr::string> > csv(&arena);
+
+  Config config;
+  config.setCommentEnabled(true);
+  Util::load(stream, config, csv);
+
+  CPPUNIT_ASSERT(csv.size() == 2);
+  CPPUNIT_ASSERT(csv[0].size() == 2);
+  CPPUNIT_ASSERT(csv[0][0] == "aaa");
+  CPPUNIT_ASSERT(csv[0][1] == "bbb");
+  CPPUNIT_ASSERT(csv[1].size() == 1);
+  CPPUNIT_ASSERT(csv[1][0] == "cccccccccccccccccccccccccccccccccccccccc");
+  CPPUNIT_ASSERT(csv[1].get_allocator().resource() == &arena);
+  CPPUNIT_ASSERT(csv[1][0].get_allocator().resource() == &arena);
+}
+
+void UtilTest::testLoadStringConfigPmrVectorVectorString(void)
+{
+  std::string filepath = "./test/test.csv";
+  std::vector<std::vector<std::string> > expected;
+  std::pmr::monotonic_buffer_resource arena;
+  std::pmr::vector<std::pmr::vector<std::pmr::string> > csv(&arena);
+
+  Config config;
+  Util::load(filepath, config, expected);
+  Util::load(filepath, config, csv);
+
+  CPPUNIT_ASSERT(csv.size() == expected.size());
+  for (std::size_t i = 0; i < csv.size(); i++) {
+    CPPUNIT_ASSERT(csv[i].size() == expected[i].size());
+    for (std::size_t j = 0; j < csv[i].size(); j++) {
+      CPPUNIT_ASSERT(csv[i][j] == expected[i][j].c_str());
+    }
+  }
+}
+
+void UtilTest::testLoadStringConfigPmrVectorVectorStringThrowFailure(void)
+{
+  std::string filepath = "./";
+  std::pmr::vector<std::pmr::vector<std::pmr::string> > csv;
+
+  try {
+    Config config;
+    Util::load(filepath, config, csv);
+    CPPUNIT_FAIL("std::ios_base::failure must be throw.");
+  } catch (std::ios_base::failure&) {
+    CPPUNIT_ASSERT(true);
+  }
+}
+#endif
+
+void UtilTest::testLoadIstreamConfigEncodedTable(void)
+{
+  std::stringstream stream("1,\"Tokyo\",a\r\n"
+			   "2,Osaka\r\n"
+			   "3,\"Tok\"\"yo\",b\r\n"
+			   "4,Tokyo,c\r\n");
+  EncodedTable table;
+  Config config;
+  Util::load(stream, config, table);
+
+  CPPUNIT_ASSERT_EQUAL((std::size_t)4, table.getRowCount());
+  CPPUNIT_ASSERT_EQUAL((std::size_t)3, table.getColumnCount());
+  CPPUNIT_ASSERT_EQUAL((std::size_t)2, table.getFieldCount(1));
+  CPPUNIT_ASSERT(table.get(0, 1) == "Tokyo");
+  CPPUNIT_ASSERT(table.get(2, 1) == "Tok\"yo");
+  CPPUNIT_ASSERT(table.getCode(0, 1) == table.getCode(3, 1));
+  CPPUNIT_ASSERT(table.getCode(0, 1) != table.getCode(2, 1));
+}
+
+void UtilTest::testLoadStringConfigEncodedTable(void)
+{
+  std::string filepath = "./test/test.csv";
+  std::vector<std::vector<std::string> > expected;
+  EncodedTable table;
+  Config config;
+  Util::load(filepath, config, expected);
+  Util::load(filepath, config, table);
+
+  CPPUNIT_ASSERT_EQUAL(expected.size(), table.getRowCount());
+  std::vector<std::string> record;
+  for (std::size_t i = 0; i < expected.size(); i++) {
+    table.getRecord(i, record);
+    CPPUNIT_ASSERT(record == expected[i]);
+  }
+}
+
+void UtilTest::testLoadStringConfigEncodedTableThrowFailure(void)
+{
+  std::string filepath = "./";
+  EncodedTable table;
+
+  try {
+    Config config;
+    Util::load(filepath, config, table);
+    CPPUNIT_FAIL("std::ios_base::failure must be throw.");
+  } catch (std::ios_base::failure&) {
+    CPPUNIT_ASSERT(true);
+  }
+}
+
+void UtilTest::testLoadIstreamConfigFilter(void)
+{
+  std::stringstream stream("1,\"Tokyo\",a\r\n"
+			   "2,Osaka,\"b\r\nc\"\r\n"
+			   "3,\"Tok\"\"yo\",d\r\n"
+			   "4,Tokyo,e\r\n");
+  std::vector<std::vector<std::string> > csv;
+  Config config;
+  Filter filter;
+  filter.addEquals(1, "Tokyo");
+  Util::load(stream, config, filter, csv);
+
+  CPPUNIT_ASSERT_EQUAL((std::size_t)2, csv.size());
+  CPPUNIT_ASSERT(csv[0][0] == "1");
+  CPPUNIT_ASSERT(csv[0][2] == "a");
+  CPPUNIT_ASSERT(csv[1][0] == "4");
+  CPPUNIT_ASSERT(csv[1][2] == "e");
+}
+
+void UtilTest::testLoadStringConfigFilter(void)
+{
+  std::string filepath = "./test/test.csv";
+  std::vector<std::vector<std::string> > all;
+  std::vector<std::vector<std::string> > csv;
+  Config config;
+  Filter filter;
+  filter.addPrefix(4, "e");
+  Util::load(filepath, config, all);
+  Util::load(filepath, config, filter, csv);
+
+  std::vector<std::vector<std::string> > expected;
+  for (std::size_t i = 0; i < all.size(); i++) {
+    if (filter.matches(all[i])) {
+      expected.push_back(all[i]);
+    }
+  }
+  CPPUNIT_ASSERT(!expected.empty());
+  CPPUNIT_ASSERT(expected == csv);
+}
+
+void UtilTest::testLoadStringConfigFilterThrowFailure(void)
+{
+  std::string filepath = "./";
+  std::vector<std::vector<std::string> > csv;
+
+  try {
+    Config config;
+    Filter filter;
+    Util::load(filepath, config, filter, csv);
+    CPPUNIT_FAIL("std::ios_base::failure must be throw.");
+  } catch (std::ios_base::failure&) {
+    CPPUNIT_ASSERT(true);
+  }
+}
+
+void UtilTest::testParseNumber(void)
+{
+  double number = 0;
+
+  CPPUNIT_ASSERT(Util::parseNumber("12.5", 4, number));
+  CPPUNIT_ASSERT_EQUAL(12.5, number);
+  CPPUNIT_ASSERT(Util::parseNumber("-3e2,", 4, number));
+  CPPUNIT_ASSERT_EQUAL(-300.0, number);
+  CPPUNIT_ASSERT(Util::parseNumber("inf", 3, number));
+  CPPUNIT_ASSERT(std::isinf(number));
+
+  // longer than the stack buffer
+  const std::string digits = "0." + std::string(100, '0') + "1";
+  CPPUNIT_ASSERT(Util::parseNumber(digits.data(), digits.size(), number));
+  CPPUNIT_ASSERT(number > 0 && number < 1e-99);
+
+  CPPUNIT_ASSERT(!Util::parseNumber("", 0, number));
+  CPPUNIT_ASSERT(!Util::parseNumber(" 1", 2, number));
+  CPPUNIT_ASSERT(!Util::parseNumber("\n1", 2, number));
+  CPPUNIT_ASSERT(!Util::parseNumber("1 ", 2, number));
+  CPPUNIT_ASSERT(!Util::parseNumber("1a", 2, number));
+  CPPUNIT_ASSERT(!Util::parseNumber("nan", 3, number));
+  CPPUNIT_ASSERT(!Util::parseNumber(std::string("1\0", 2).data(), 2, number));
+}
+
 } // namespace csv
 } // namespace csl
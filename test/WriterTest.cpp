@@ -16,7 +16,9 @@ class WriterTest : public CPPUNIT_NS::TestFixture
   CPPUNIT_TEST(testWriterOstreamConfig);
   CPPUNIT_TEST(testWriteQuoteEnabled);
   CPPUNIT_TEST(testWriteQuoteDisabled);
+  CPPUNIT_TEST(testWriteEscapedQuotes);
   CPPUNIT_TEST(testWriteThrowFailure);
+  CPPUNIT_TEST(testSetStats);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -28,7 +30,9 @@ private:
   void testWriterOstreamConfig(void);
   void testWriteQuoteEnabled(void);
   void testWriteQuoteDisabled(void);
+  void testWriteEscapedQuotes(void);
   void testWriteThrowFailure(void);
+  void testSetStats(void);
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(WriterTest);
@@ -86,6 +90,21 @@ void WriterTest::testWriteQuoteDisabled(void)
   CPPUNIT_ASSERT(stream.str() == "aaa,bbb,ccc\r\n");
 }
 
+void WriterTest::testWriteEscapedQuotes(void)
+{
+  std::vector<std::string> record;
+  record.push_back("a\"b");
+  record.push_back("\"\"");
+  record.push_back("c");
+
+  std::stringstream stream("");
+  Writer writer(stream);
+
+  writer.write(record);
+
+  CPPUNIT_ASSERT(stream.str() == "\"a\"\"b\",\"\"\"\"\"\",\"c\"\r\n");
+}
+
 void WriterTest::testWriteThrowFailure(void)
 {
   std::vector<std::string> record;
@@ -104,5 +123,27 @@ void WriterTest::testWriteThrowFailure(void)
   }
 }
 
+void WriterTest::testSetStats(void)
+{
+  std::vector<std::string> record;
+  record.push_back("aaa");
+  record.push_back("bb");
+
+  std::stringstream stream("");
+  Writer writer(stream);
+  Stats stats;
+  writer.setStats(&stats);
+  writer.write(record);
+  writer.write(record);
+
+  CPPUNIT_ASSERT(stream.str() == "\"aaa\",\"bb\"\r\n\"aaa\",\"bb\"\r\n");
+  CPPUNIT_ASSERT_EQUAL(24ULL, stats.getBytes());
+  CPPUNIT_ASSERT_EQUAL((std::size_t)2, stats.getRecords());
+  CPPUNIT_ASSERT_EQUAL((std::size_t)4, stats.getFields());
+  CPPUNIT_ASSERT_EQUAL((std::size_t)4, stats.getQuotedFields());
+  CPPUNIT_ASSERT_EQUAL((std::size_t)3, stats.getMaxFieldLength());
+  CPPUNIT_ASSERT_EQUAL((std::size_t)12, stats.getMaxRecordLength());
+}
+
 } // namespace csv
 } // namespace csl
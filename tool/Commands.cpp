@@ -0,0 +1,753 @@
+/**
+ * @file  Commands.cpp
+ * @brief Commandsクラス実装ファイル
+ */
+#include "Commands.hpp"
+#include <cerrno>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include <sys/stat.h>
+#include "csl/csv/Automaton.hpp"
+#include "csl/csv/Filter.hpp"
+#include "csl/csv/LazyRecord.hpp"
+#include "csl/csv/PartitionedWriter.hpp"
+#include "csl/csv/Profiler.hpp"
+#include "csl/csv/Range.hpp"
+#include "csl/csv/Reader.hpp"
+#include "csl/csv/Sorter.hpp"
+#include "csl/csv/Splitter.hpp"
+#include "csl/csv/ThreadPool.hpp"
+#include "csl/csv/Util.hpp"
+#include "csl/csv/Writer.hpp"
+
+namespace csl {
+namespace csv {
+namespace tool {
+
+namespace {
+
+/**
+ * @brief 数値を文字列に変換する際の最大文字数です。
+ */
+const std::size_t NUMBER_MAX_SIZE = 64;
+
+/**
+ * @brief splitで1つのファイルに書き込むデフォルトのCSVレコードの数です。
+ */
+const std::size_t SPLIT_LINES = 1000;
+
+/**
+ * @brief 入力のファイルを開きます。
+ * @param path ファイルパス("-"の場合は標準入力)
+ * @param file ファイルの入力ストリーム
+ * @return 入力ストリーム
+ * @exception std::ios_base::failure ファイルを開けなかった場合
+ */
+std::istream& openInput(const std::string& path, std::ifstream& file)
+{
+  if (path == "-") {
+    return std::cin;
+  }
+
+  struct stat st;
+  if (stat(path.c_str(), &st) != 0 || !S_ISREG(st.st_mode)) {
+    throw std::ios_base::failure("Failed to open file for reading: " + path);
+  }
+
+  file.open(path.c_str(), std::ios_base::in | std::ios_base::binary);
+  if (!file.is_open()) {
+    throw std::ios_base::failure("Failed to open file for reading: " + path);
+  }
+  return file;
+}
+
+/**
+ * @brief --threadsオプションのスレッド数を返します。
+ * @param options オプション
+ * @return スレッド数(指定されていない場合はCPUの数)
+ * @exception std::invalid_argument スレッド数が0の場合
+ */
+std::size_t getThreadCount(const Options& options)
+{
+  const std::size_t cpus = std::thread::hardware_concurrency();
+  const std::size_t threadCount = options.getSize("threads", cpus > 0 ? cpus : 1);
+  if (threadCount == 0) {
+    throw std::invalid_argument("Invalid option: --threads");
+  }
+  return threadCount;
+}
+
+/**
+ * @brief 列の番号を解釈します。
+ * @param name オプションの名前
+ * @param text 列の番号
+ * @return 列の番号
+ * @exception std::invalid_argument 列の番号が正しくない場合
+ */
+std::size_t parseColumn(const std::string& name, const std::string& text)
+{
+  if (text.empty() || text.find_first_not_of("0123456789") != std::string::npos) {
+    throw std::invalid_argument("Invalid option: --" + name);
+  }
+
+  errno = 0;
+  const unsigned long long column = std::strtoull(text.c_str(), NULL, 10);
+  if (errno != 0 || column > std::numeric_limits<std::size_t>::max()) {
+    throw std::invalid_argument("Invalid option: --" + name);
+  }
+  return static_cast<std::size_t>(column);
+}
+
+/**
+ * @brief "列の番号:値"の形のオプションの値を解釈します。
+ * @param name オプションの名前
+ * @param text オプションの値
+ * @param value 値
+ * @return 列の番号
+ * @exception std::invalid_argument オプションの値が正しくない場合
+ */
+std::size_t parseColumnValue(const std::string& name, const std::string& text, std::string& value)
+{
+  const std::string::size_type colon = text.find(':');
+  if (colon == std::string::npos) {
+    throw std::invalid_argument("Invalid option: --" + name);
+  }
+  value = text.substr(colon + 1);
+  return parseColumn(name, text.substr(0, colon));
+}
+
+/**
+ * @brief 数値を解釈します。
+ * @param name オプションの名前
+ * @param text 数値(空文字列の場合はdefaultValue)
+ * @param defaultValue 空文字列の場合の値
+ * @return 数値
+ * @exception std::invalid_argument 数値が正しくない場合
+ */
+double parseNumber(const std::string& name, const std::string& text, const double defaultValue)
+{
+  if (text.empty()) {
+    return defaultValue;
+  }
+
+  char* end = NULL;
+  const double number = std::strtod(text.c_str(), &end);
+  if (*end != '\0' || std::isnan(number)) {
+    throw std::invalid_argument("Invalid option: --" + name);
+  }
+  return number;
+}
+
+/**
+ * @brief 数値を文字列に変換します。
+ * @param number 数値
+ * @return 文字列(NaNの場合は空文字列)
+ */
+std::string formatNumber(const double number)
+{
+  if (std::isnan(number)) {
+    return std::string();
+  }
+
+  char buffer[NUMBER_MAX_SIZE];
+  std::snprintf(buffer, sizeof(buffer), "%.15g", number);
+  return buffer;
+}
+
+/**
+ * @brief 入力ストリームのCSVレコードの数を、フィールドを解釈せずに数えます。
+ *
+ * 入力ストリームの現在の位置は、CSVレコードの先頭でなければなりません。
+ * @param stream 入力ストリーム
+ * @param config Configオブジェクト
+ * @param limit 読み込むバイト数(負の場合は入力ストリームの終わりまで)
+ * @return CSVレコードの数
+ * @exception std::ios_base::failure 入力ストリームにエラーが発生した場合
+ */
+std::uint64_t countRecords(std::istream& stream, const Config& config, std::streamoff limit)
+{
+  const Automaton automaton(config);
+  std::vector<char> buffer(COUNT_CHUNK_SIZE);
+  std::uint64_t records = 0;
+
+  // the scan state is kept across chunks, as Follower does, so that a long record is scanned only once
+  unsigned char state = Automaton::STATE_NORMAL;
+  bool recordStart = true;
+  bool commentFlag = false;
+  bool carriageReturnFlag = false;
+  bool pendingFlag = false;
+
+  while (limit != 0) {
+    std::size_t size = COUNT_CHUNK_SIZE;
+    if (limit > 0 && static_cast<std::streamoff>(size) > limit) {
+      size = static_cast<std::size_t>(limit);
+    }
+
+    stream.read(&buffer[0], size);
+    const std::size_t count = static_cast<std::size_t>(stream.gcount());
+    if (stream.bad()) {
+      throw std::ios_base::failure("Failed to read.");
+    }
+    if (count == 0) {
+      break;
+    }
+    if (limit > 0) {
+      limit -= count;
+    }
+
+    for (std::size_t i = 0; i < count; i++) {
+      const char c = buffer[i];
+
+      if (commentFlag) {
+	if (carriageReturnFlag && c == '\n') {
+	  commentFlag = false;
+	}
+	carriageReturnFlag = (c == '\r');
+	continue;
+      }
+
+      if (recordStart) {
+	recordStart = false;
+	pendingFlag = true;
+	if (automaton.isCommentMark(c)) {
+	  // a comment line is counted together with the record after it, as Scanner does
+	  commentFlag = true;
+	  carriageReturnFlag = false;
+	  continue;
+	}
+      }
+
+      const Automaton::Transition transition = automaton.step(state, c);
+      if ((transition.actions & Automaton::ACTION_END_RECORD) != 0) {
+	records++;
+	state = Automaton::STATE_NORMAL;
+	recordStart = true;
+	pendingFlag = false;
+      } else {
+	state = transition.state;
+      }
+    }
+  }
+
+  if (pendingFlag) {
+    records++; // the last record without a line break
+  }
+  return records;
+}
+
+/**
+ * @brief ファイルをスレッド数の範囲に分けて、CSVレコードの数を並列に数えます。
+ * @param filepath ファイルパス
+ * @param config Configオブジェクト
+ * @param threadCount スレッド数
+ * @return CSVレコードの数
+ * @exception std::ios_base::failure ファイルの読み込みに失敗した場合
+ */
+std::uint64_t countParallel(const std::string& filepath, const Config& config, const std::size_t threadCount)
+{
+  std::vector<Range> ranges;
+  Splitter::plan(filepath, config, threadCount, ranges);
+
+  std::vector<std::uint64_t> counts(ranges.size(), 0);
+  ThreadPool pool(threadCount);
+
+  for (std::size_t i = 0; i < ranges.size(); i++) {
+    pool.submit([&filepath, &config, &ranges, &counts, i]() {
+	std::ifstream stream(filepath.c_str(), std::ifstream::binary);
+
+	if (!stream.is_open()) {
+	  throw std::ios_base::failure("Failed to open file for reading: " + filepath);
+	}
+
+	stream.seekg(ranges[i].getBegin());
+	counts[i] = countRecords(stream, config, ranges[i].getSize());
+      });
+  }
+  pool.wait();
+
+  std::uint64_t records = 0;
+  for (std::size_t i = 0; i < counts.size(); i++) {
+    records += counts[i];
+  }
+  return records;
+}
+
+/**
+ * @brief 入力のCSV形式のオプションの名前です。
+ */
+#define INPUT_OPTIONS "delimiter", "quote", "no-quote", "comment"
+
+/**
+ * @brief 出力のCSV形式のオプションの名前です。
+ */
+#define OUTPUT_OPTIONS "out-delimiter", "out-quote", "out-no-quote"
+
+} // namespace
+
+/**
+ * @brief CSVレコードの数を出力します。
+ *
+ * フィールドは解釈せずに、CSVレコードの境界だけを走査します。
+ * ファイルを指定した場合は、--threadsオプションのスレッド数で並列に数えます。
+ * @param options オプション
+ */
+void Commands::count(const Options& options)
+{
+  static const char* const names[] = { INPUT_OPTIONS, "threads", NULL };
+  options.check(names);
+
+  Config config;
+  options.getInputConfig(config);
+
+  const std::string input = options.getInput();
+  std::uint64_t records;
+
+  if (input != "-" && getThreadCount(options) > 1) {
+    std::ifstream file;
+    openInput(input, file);
+    file.close();
+    records = countParallel(input, config, getThreadCount(options));
+  } else {
+    std::ifstream file;
+    records = countRecords(openInput(input, file), config, -1);
+  }
+
+  std::cout << records << '\n';
+}
+
+/**
+ * @brief 先頭の--linesオプションの数(デフォルトはDEFAULT_LINES)のCSVレコードを出力します。
+ * @param options オプション
+ */
+void Commands::head(const Options& options)
+{
+  static const char* const names[] = { INPUT_OPTIONS, OUTPUT_OPTIONS, "lines", NULL };
+  options.check(names);
+
+  Config config;
+  Config outConfig;
+  options.getInputConfig(config);
+  options.getOutputConfig(outConfig);
+  const std::size_t lines = options.getSize("lines", DEFAULT_LINES);
+
+  std::ifstream file;
+  Reader reader(openInput(options.getInput(), file), config);
+  Writer writer(std::cout, outConfig);
+  std::vector<std::string> record;
+
+  for (std::size_t i = 0; i < lines && reader.hasNext(); i++) {
+    reader.read(record);
+    writer.write(record);
+    record.clear();
+  }
+}
+
+/**
+ * @brief 末尾の--linesオプションの数(デフォルトはDEFAULT_LINES)のCSVレコードを出力します。
+ *
+ * ファイルを指定した場合は、Util::tailで末尾から必要な分だけ読み込みます。
+ * 標準入力の場合は、最後のCSVレコードを--linesオプションの数だけ保持しながら最後まで読み込みます。
+ * @param options オプション
+ */
+void Commands::tail(const Options& options)
+{
+  static const char* const names[] = { INPUT_OPTIONS, OUTPUT_OPTIONS, "lines", NULL };
+  options.check(names);
+
+  Config config;
+  Config outConfig;
+  options.getInputConfig(config);
+  options.getOutputConfig(outConfig);
+  const std::size_t lines = options.getSize("lines", DEFAULT_LINES);
+  const std::string input = options.getInput();
+  Writer writer(std::cout, outConfig);
+
+  if (input != "-") {
+    std::vector<std::vector<std::string> > csv;
+    Util::tail(input, config, lines, csv);
+    for (std::size_t i = 0; i < csv.size(); i++) {
+      writer.write(csv[i]);
+    }
+    return;
+  }
+
+  if (lines == 0) {
+    return;
+  }
+
+  Reader reader(std::cin, config);
+  std::vector<std::vector<std::string> > ring;
+  std::size_t next = 0;
+
+  while (reader.hasNext()) {
+    if (ring.size() < lines) {
+      ring.emplace_back();
+    }
+    std::vector<std::string>& record = ring[next];
+    record.clear();
+    reader.read(record);
+    next = (next + 1) % lines;
+  }
+
+  const std::size_t first = (ring.size() < lines) ? 0 : next;
+  for (std::size_t i = 0; i < ring.size(); i++) {
+    writer.write(ring[(first + i) % ring.size()]);
+  }
+}
+
+/**
+ * @brief --columnsオプションの列(カンマ区切りの列の番号)を、指定された順に出力します。
+ *
+ * CSVレコードはLazyRecordで読み込み、出力する列のフィールドだけを解釈します。
+ * 列がないCSVレコードは、その列を空文字列として出力します。
+ * @param options オプション
+ * @exception std::invalid_argument --columnsオプションがない場合
+ */
+void Commands::select(const Options& options)
+{
+  static const char* const names[] = { INPUT_OPTIONS, OUTPUT_OPTIONS, "columns", NULL };
+  options.check(names);
+
+  if (!options.has("columns")) {
+    throw std::invalid_argument("Missing option: --columns");
+  }
+
+  Config config;
+  Config outConfig;
+  options.getInputConfig(config);
+  options.getOutputConfig(outConfig);
+
+  std::vector<std::size_t> columns;
+  const std::string text = options.get("columns", "");
+  std::string::size_type begin = 0;
+  for (;;) {
+    const std::string::size_type comma = text.find(',', begin);
+    columns.push_back(parseColumn("columns", text.substr(begin, comma - begin)));
+    if (comma == std::string::npos) {
+      break;
+    }
+    begin = comma + 1;
+  }
+
+  std::ifstream file;
+  Reader reader(openInput(options.getInput(), file), config);
+  Writer writer(std::cout, outConfig);
+  LazyRecord record;
+  std::vector<std::string> fields;
+  const std::vector<std::string> empty;
+
+  while (reader.hasNext()) {
+    reader.read(record);
+    if (record.size() == 0) {
+      writer.write(empty);
+      continue;
+    }
+
+    fields.resize(columns.size());
+    for (std::size_t i = 0; i < columns.size(); i++) {
+      if (columns[i] < record.size()) {
+	record.get(columns[i], fields[i]);
+      } else {
+	fields[i].clear();
+      }
+    }
+    writer.write(fields);
+  }
+}
+
+/**
+ * @brief 条件をすべて満たすCSVレコードを出力します。
+ *
+ * 条件は--eq=列:値、--prefix=列:値、--in=列:値|値...、--range=列:最小値:最大値(省略した側は無限)で指定し、それぞれ複数指定できます。
+ * 条件を満たさないCSVレコードは、Filterで読み込みながら判定してフィールドを解釈せずに読み飛ばします。
+ * @param options オプション
+ */
+void Commands::filter(const Options& options)
+{
+  static const char* const names[] = { INPUT_OPTIONS, OUTPUT_OPTIONS, "eq", "prefix", "in", "range", NULL };
+  options.check(names);
+
+  Config config;
+  Config outConfig;
+  options.getInputConfig(config);
+  options.getOutputConfig(outConfig);
+
+  Filter filter;
+  std::vector<std::string> values;
+  std::string value;
+
+  options.getAll("eq", values);
+  for (std::size_t i = 0; i < values.size(); i++) {
+    const std::size_t column = parseColumnValue("eq", values[i], value);
+    filter.addEquals(column, value);
+  }
+
+  options.getAll("prefix", values);
+  for (std::size_t i = 0; i < values.size(); i++) {
+    const std::size_t column = parseColumnValue("prefix", values[i], value);
+    filter.addPrefix(column, value);
+  }
+
+  options.getAll("in", values);
+  for (std::size_t i = 0; i < values.size(); i++) {
+    const std::size_t column = parseColumnValue("in", values[i], value);
+    std::vector<std::string> candidates;
+    std::string::size_type begin = 0;
+    for (;;) {
+      const std::string::size_type bar = value.find('|', begin);
+      candidates.push_back(value.substr(begin, bar - begin));
+      if (bar == std::string::npos) {
+	break;
+      }
+      begin = bar + 1;
+    }
+    filter.addIn(column, candidates);
+  }
+
+  options.getAll("range", values);
+  for (std::size_t i = 0; i < values.size(); i++) {
+    const std::size_t column = parseColumnValue("range", values[i], value);
+    const std::string::size_type colon = value.find(':');
+    if (colon == std::string::npos) {
+      throw std::invalid_argument("Invalid option: --range");
+    }
+    const double infinity = std::numeric_limits<double>::infinity();
+    filter.addRange(column,
+		    parseNumber("range", value.substr(0, colon), -infinity),
+		    parseNumber("range", value.substr(colon + 1), infinity));
+  }
+
+  std::ifstream file;
+  Reader reader(openInput(options.getInput(), file), config);
+  Writer writer(std::cout, outConfig);
+  LazyRecord record;
+  std::vector<std::string> fields;
+
+  while (reader.hasNext()) {
+    if (!reader.read(record, filter)) {
+      continue;
+    }
+
+    fields.resize(record.size());
+    for (std::size_t i = 0; i < record.size(); i++) {
+      record.get(i, fields[i]);
+    }
+    writer.write(fields);
+  }
+}
+
+/**
+ * @brief --keyオプションの列(列の番号、数値として比較する場合は"列:n")の順にCSVレコードを並べ替えて出力します。
+ *
+ * Sorterで並べ替えるため、--memoryオプションのメモリの上限を超えた分は--tmpdirオプションのディレクトリの一時ファイルに書き出します。
+ * 出力のCSV形式は、入力のCSV形式と同じです。
+ * @param options オプション
+ * @exception std::invalid_argument --keyオプションがない場合
+ */
+void Commands::sort(const Options& options)
+{
+  static const char* const names[] = { INPUT_OPTIONS, "key", "memory", "tmpdir", "threads", NULL };
+  options.check(names);
+
+  Config config;
+  options.getInputConfig(config);
+
+  Sorter sorter;
+  std::vector<std::string> keys;
+  options.getAll("key", keys);
+  if (keys.empty()) {
+    throw std::invalid_argument("Missing option: --key");
+  }
+
+  for (std::size_t i = 0; i < keys.size(); i++) {
+    const std::string::size_type colon = keys[i].find(':');
+    Sorter::Collation collation = Sorter::COLLATION_STRING;
+    if (colon != std::string::npos) {
+      if (keys[i].compare(colon + 1, std::string::npos, "n") != 0) {
+	throw std::invalid_argument("Invalid option: --key");
+      }
+      collation = Sorter::COLLATION_NUMERIC;
+    }
+    sorter.addKey(parseColumn("key", keys[i].substr(0, colon)), collation);
+  }
+
+  sorter.setMemoryLimit(options.getSize("memory", SORT_MEMORY_LIMIT));
+  sorter.setTempDirectory(options.get("tmpdir", sorter.getTempDirectory()));
+  sorter.setThreadCount(getThreadCount(options));
+
+  std::ifstream file;
+  sorter.sort(openInput(options.getInput(), file), config, std::cout);
+}
+
+/**
+ * @brief 列ごとの統計情報を、列ごとに1件のCSVレコードとして出力します。
+ *
+ * 先頭に見出しのCSVレコードを出力します。数値の統計情報は、数値のフィールドがない列では空文字列です。
+ * ファイルを指定した場合は、--threadsオプションのスレッド数で並列に集計します。
+ * @param options オプション
+ */
+void Commands::stats(const Options& options)
+{
+  static const char* const names[] = { INPUT_OPTIONS, OUTPUT_OPTIONS, "threads", NULL };
+  options.check(names);
+
+  Config config;
+  Config outConfig;
+  options.getInputConfig(config);
+  options.getOutputConfig(outConfig);
+
+  const std::string input = options.getInput();
+  Profiler profiler;
+
+  if (input != "-") {
+    profiler.setThreadCount(getThreadCount(options));
+    profiler.profile(input, config);
+  } else {
+    profiler.profile(std::cin, config);
+  }
+
+  Writer writer(std::cout, outConfig);
+  std::vector<std::string> record;
+  record.push_back("column");
+  record.push_back("count");
+  record.push_back("empty");
+  record.push_back("min_length");
+  record.push_back("max_length");
+  record.push_back("numeric");
+  record.push_back("min");
+  record.push_back("max");
+  record.push_back("mean");
+  record.push_back("median");
+  record.push_back("p99");
+  record.push_back("distinct");
+  writer.write(record);
+
+  for (std::size_t i = 0; i < profiler.size(); i++) {
+    const ColumnProfile& column = profiler.getColumn(i);
+    record.clear();
+    record.push_back(std::to_string(i));
+    record.push_back(std::to_string(column.getCount()));
+    record.push_back(std::to_string(column.getEmptyCount()));
+    record.push_back(std::to_string(column.getMinLength()));
+    record.push_back(std::to_string(column.getMaxLength()));
+    record.push_back(std::to_string(column.getNumericCount()));
+    record.push_back(formatNumber(column.getMinimum()));
+    record.push_back(formatNumber(column.getMaximum()));
+    record.push_back(formatNumber(column.getMean()));
+    record.push_back(formatNumber(column.getQuantile(0.5)));
+    record.push_back(formatNumber(column.getQuantile(0.99)));
+    record.push_back(std::to_string(column.getDistinctCount()));
+    writer.write(record);
+  }
+}
+
+/**
+ * @brief CSVレコードを複数のファイルに分けて書き込みます。
+ *
+ * ファイルパスは、--prefixオプションの接頭辞、番号、--suffixオプションの接尾辞(デフォルトは".csv")をつなげたものです。
+ * --byオプションを指定した場合は、PartitionedWriterでその列の値ごとのファイルに分けます(--partitions、--memory、--max-openオプションを渡します)。
+ * 指定しない場合は、--linesオプションの数(デフォルトは1000)ずつ0から番号を付けたファイルに分けます。
+ * @param options オプション
+ * @exception std::invalid_argument --prefixオプションがない場合
+ * @exception std::ios_base::failure ファイルの書き込みに失敗した場合
+ */
+void Commands::split(const Options& options)
+{
+  static const char* const names[] = {
+    INPUT_OPTIONS, OUTPUT_OPTIONS, "prefix", "suffix", "lines", "by", "partitions", "memory", "max-open", NULL
+  };
+  options.check(names);
+
+  if (!options.has("prefix")) {
+    throw std::invalid_argument("Missing option: --prefix");
+  }
+
+  Config config;
+  Config outConfig;
+  options.getInputConfig(config);
+  options.getOutputConfig(outConfig);
+
+  const std::string prefix = options.get("prefix", "");
+  const std::string suffix = options.get("suffix", ".csv");
+  std::ifstream file;
+  Reader reader(openInput(options.getInput(), file), config);
+  std::vector<std::string> record;
+
+  if (options.has("by")) {
+    PartitionedWriter writer(prefix, suffix, parseColumn("by", options.get("by", "")), outConfig);
+    writer.setPartitionCount(options.getSize("partitions", 0));
+    writer.setMemoryLimit(options.getSize("memory", PARTITION_MEMORY_LIMIT));
+    writer.setMaxOpenFiles(options.getSize("max-open", PARTITION_OPEN_FILES));
+
+    while (reader.hasNext()) {
+      reader.read(record);
+      writer.write(record);
+      record.clear();
+    }
+    writer.close();
+    return;
+  }
+
+  const std::size_t lines = options.getSize("lines", SPLIT_LINES);
+  if (lines == 0) {
+    throw std::invalid_argument("Invalid option: --lines");
+  }
+
+  for (std::size_t chunk = 0; reader.hasNext(); chunk++) {
+    const std::string path = prefix + std::to_string(chunk) + suffix;
+    std::ofstream out(path.c_str(), std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+    if (!out.is_open()) {
+      throw std::ios_base::failure("Failed to open file for writing: " + path);
+    }
+
+    Writer writer(out, outConfig);
+    for (std::size_t i = 0; i < lines && reader.hasNext(); i++) {
+      reader.read(record);
+      writer.write(record);
+      record.clear();
+    }
+
+    out.close();
+    if (out.fail()) {
+      throw std::ios_base::failure("Failed to write: " + path);
+    }
+  }
+}
+
+/**
+ * @brief CSVレコードを出力のCSV形式に変換して出力します。
+ * @param options オプション
+ */
+void Commands::convert(const Options& options)
+{
+  static const char* const names[] = { INPUT_OPTIONS, OUTPUT_OPTIONS, NULL };
+  options.check(names);
+
+  Config config;
+  Config outConfig;
+  options.getInputConfig(config);
+  options.getOutputConfig(outConfig);
+
+  std::ifstream file;
+  Reader reader(openInput(options.getInput(), file), config);
+  Writer writer(std::cout, outConfig);
+  std::vector<std::string> record;
+
+  while (reader.hasNext()) {
+    reader.read(record);
+    writer.write(record);
+    record.clear();
+  }
+}
+
+} // namespace tool
+} // namespace csv
+} // namespace csl
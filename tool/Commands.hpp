@@ -0,0 +1,56 @@
+/**
+ * @file  Commands.hpp
+ * @brief Commandsクラスヘッダーファイル
+ */
+#ifndef CSL_CSV_TOOL_COMMANDS_HPP_
+#define CSL_CSV_TOOL_COMMANDS_HPP_
+
+#include <cstddef>
+#include <string>
+#include "Options.hpp"
+
+namespace csl {
+namespace csv {
+namespace tool {
+
+/**
+ * @brief cslcsvコマンドのサブコマンドを実行します。
+ *
+ * 入力はオプション以外の最初の引数のファイル(ないか"-"の場合は標準入力)から読み込み、結果は標準出力に書き込みます。
+ * ファイルを指定した場合は、スレッド数に応じてSplitterで分けた範囲を並列に処理するサブコマンドがあります。
+ */
+class Commands
+{
+public:
+  static void count(const Options& options);
+  static void head(const Options& options);
+  static void tail(const Options& options);
+  static void select(const Options& options);
+  static void filter(const Options& options);
+  static void sort(const Options& options);
+  static void stats(const Options& options);
+  static void split(const Options& options);
+  static void convert(const Options& options);
+
+private:
+  Commands(void);
+  ~Commands(void);
+  Commands(const Commands& commands);
+  Commands& operator=(const Commands& commands);
+};
+
+/**
+ * @brief countで一度に読み込むバイト数です。
+ */
+constexpr std::size_t COUNT_CHUNK_SIZE = 1024 * 1024;
+
+/**
+ * @brief head、tailで出力するデフォルトのCSVレコードの数です。
+ */
+constexpr std::size_t DEFAULT_LINES = 10;
+
+} // namespace tool
+} // namespace csv
+} // namespace csl
+
+#endif // #ifndef CSL_CSV_TOOL_COMMANDS_HPP_
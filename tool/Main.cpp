@@ -0,0 +1,108 @@
+/**
+ * @file  Main.cpp
+ * @brief cslcsvコマンド実装ファイル
+ *
+ * "cslcsv サブコマンド [オプション...] [ファイル]"の形で、CSVデータを数える、取り出す、並べ替える、集計する、分ける、変換するなどの処理をします。
+ * エラーの場合は標準エラー出力にメッセージを出力し、使い方の誤りは2、それ以外は1の終了コードで終了します。
+ */
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include "Commands.hpp"
+#include "Options.hpp"
+
+namespace {
+
+/**
+ * @brief サブコマンドの関数の型です。
+ */
+typedef void (*Command)(const csl::csv::tool::Options& options);
+
+/**
+ * @brief サブコマンドの名前と関数です。
+ */
+struct Entry
+{
+  const char* name;  ///< サブコマンドの名前
+  Command command;   ///< サブコマンドの関数
+};
+
+/**
+ * @brief サブコマンドの一覧です。
+ */
+const Entry COMMANDS[] = {
+  { "count", &csl::csv::tool::Commands::count },
+  { "head", &csl::csv::tool::Commands::head },
+  { "tail", &csl::csv::tool::Commands::tail },
+  { "select", &csl::csv::tool::Commands::select },
+  { "filter", &csl::csv::tool::Commands::filter },
+  { "sort", &csl::csv::tool::Commands::sort },
+  { "stats", &csl::csv::tool::Commands::stats },
+  { "split", &csl::csv::tool::Commands::split },
+  { "convert", &csl::csv::tool::Commands::convert },
+};
+
+/**
+ * @brief 使い方です。
+ */
+const char* const USAGE =
+  "usage: cslcsv <command> [options] [file]\n"
+  "\n"
+  "commands:\n"
+  "  count    [--threads=N]\n"
+  "  head     [--lines=N]\n"
+  "  tail     [--lines=N]\n"
+  "  select   --columns=COL,COL,...\n"
+  "  filter   [--eq=COL:V] [--prefix=COL:V] [--in=COL:V|V...] [--range=COL:MIN:MAX]\n"
+  "  sort     --key=COL[:n] [--memory=SIZE] [--tmpdir=DIR] [--threads=N]\n"
+  "  stats    [--threads=N]\n"
+  "  split    --prefix=P [--suffix=S] [--lines=N | --by=COL [--partitions=N] [--memory=SIZE] [--max-open=N]]\n"
+  "  convert\n"
+  "\n"
+  "input format:  --delimiter=C --quote=C --no-quote --comment=C\n"
+  "output format: --out-delimiter=C --out-quote=C --out-no-quote\n"
+  "\n"
+  "Reads standard input if no file or \"-\" is given. C may be \"tab\".\n";
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+  if (argc < 2 || std::strcmp(argv[1], "--help") == 0) {
+    std::cerr << USAGE;
+    return (argc < 2) ? 2 : 0;
+  }
+
+  Command command = NULL;
+  for (std::size_t i = 0; i < sizeof(COMMANDS) / sizeof(COMMANDS[0]); i++) {
+    if (std::strcmp(argv[1], COMMANDS[i].name) == 0) {
+      command = COMMANDS[i].command;
+    }
+  }
+
+  if (command == NULL) {
+    std::cerr << "cslcsv: Unknown command: " << argv[1] << '\n' << USAGE;
+    return 2;
+  }
+
+  std::ios_base::sync_with_stdio(false);
+
+  try {
+    const csl::csv::tool::Options options(argc, argv, 2);
+    command(options);
+
+    std::cout.flush();
+    if (std::cout.fail()) {
+      throw std::ios_base::failure("Failed to write: standard output");
+    }
+  } catch (const std::invalid_argument& e) {
+    std::cerr << "cslcsv: " << e.what() << '\n';
+    return 2;
+  } catch (const std::exception& e) {
+    std::cerr << "cslcsv: " << e.what() << '\n';
+    return 1;
+  }
+
+  return 0;
+}
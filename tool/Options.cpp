@@ -0,0 +1,231 @@
+/**
+ * @file  Options.cpp
+ * @brief Optionsクラス実装ファイル
+ */
+#include "Options.hpp"
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+
+namespace csl {
+namespace csv {
+namespace tool {
+
+/**
+ * @brief コマンドライン引数を解釈して、Optionsオブジェクトを構築します。
+ * @param argc 引数の数
+ * @param argv 引数
+ * @param first 解釈を始める引数の番号
+ */
+Options::Options(int argc, char* argv[], const int first)
+{
+  bool optionFlag = true;
+
+  for (int i = first; i < argc; i++) {
+    const std::string arg = argv[i];
+
+    if (optionFlag && arg == "--") {
+      optionFlag = false;
+    } else if (optionFlag && arg.size() > 2 && arg.compare(0, 2, "--") == 0) {
+      const std::string::size_type eq = arg.find('=');
+      if (eq == std::string::npos) {
+	options.push_back(std::make_pair(arg.substr(2), std::string()));
+      } else {
+	options.push_back(std::make_pair(arg.substr(2, eq - 2), arg.substr(eq + 1)));
+      }
+    } else {
+      arguments.push_back(arg);
+    }
+  }
+}
+
+/**
+ * @brief Optionsオブジェクトを破棄します。
+ */
+Options::~Options(void)
+{
+}
+
+/**
+ * @brief 指定された名前のオプションがあるかどうかを返します。
+ * @param name オプションの名前
+ * @return ある場合はtrue
+ */
+bool Options::has(const std::string& name) const
+{
+  for (std::size_t i = 0; i < options.size(); i++) {
+    if (options[i].first == name) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * @brief 指定された名前のオプションの値を返します。複数ある場合は最後の値です。
+ * @param name オプションの名前
+ * @param value オプションがない場合の値
+ * @return オプションの値
+ */
+std::string Options::get(const std::string& name, const std::string& value) const
+{
+  for (std::size_t i = options.size(); i > 0; i--) {
+    if (options[i - 1].first == name) {
+      return options[i - 1].second;
+    }
+  }
+  return value;
+}
+
+/**
+ * @brief 指定された名前のオプションの値を、すべて指定された順に返します。
+ * @param name オプションの名前
+ * @param values オプションの値
+ */
+void Options::getAll(const std::string& name, std::vector<std::string>& values) const
+{
+  values.clear();
+  for (std::size_t i = 0; i < options.size(); i++) {
+    if (options[i].first == name) {
+      values.push_back(options[i].second);
+    }
+  }
+}
+
+/**
+ * @brief 指定された名前のオプションの値を、0以上の整数として返します。
+ *
+ * 値の末尾にK、M、Gを付けると、それぞれ2^10、2^20、2^30倍します。
+ * @param name オプションの名前
+ * @param value オプションがない場合の値
+ * @return オプションの値
+ * @exception std::invalid_argument 値が整数でない場合
+ */
+std::size_t Options::getSize(const std::string& name, const std::size_t value) const
+{
+  if (!has(name)) {
+    return value;
+  }
+
+  const std::string text = get(name, "");
+  char* end = NULL;
+  errno = 0;
+  unsigned long long number = std::strtoull(text.c_str(), &end, 10);
+
+  if (text.empty() || text[0] == '-' || errno != 0) {
+    throw std::invalid_argument("Invalid option: --" + name);
+  }
+
+  if (*end == 'K' || *end == 'k') {
+    number <<= 10;
+    end++;
+  } else if (*end == 'M' || *end == 'm') {
+    number <<= 20;
+    end++;
+  } else if (*end == 'G' || *end == 'g') {
+    number <<= 30;
+    end++;
+  }
+
+  if (*end != '\0') {
+    throw std::invalid_argument("Invalid option: --" + name);
+  }
+  return static_cast<std::size_t>(number);
+}
+
+/**
+ * @brief 指定された名前のオプションの値を、1文字の記号として返します。
+ *
+ * "tab"はタブ文字として扱います。
+ * @param name オプションの名前
+ * @param mark オプションがない場合の値
+ * @return 記号
+ * @exception std::invalid_argument 値が1文字でない場合
+ */
+char Options::getMark(const std::string& name, const char mark) const
+{
+  if (!has(name)) {
+    return mark;
+  }
+
+  const std::string text = get(name, "");
+  if (text == "tab") {
+    return '\t';
+  }
+  if (text.size() != 1) {
+    throw std::invalid_argument("Invalid option: --" + name);
+  }
+  return text[0];
+}
+
+/**
+ * @brief 指定された名前以外のオプションがないことを確認します。
+ * @param names オプションの名前(NULLで終わる配列)
+ * @exception std::invalid_argument 指定された名前以外のオプションがある場合
+ */
+void Options::check(const char* const names[]) const
+{
+  for (std::size_t i = 0; i < options.size(); i++) {
+    bool known = false;
+    for (std::size_t j = 0; names[j] != NULL && !known; j++) {
+      known = (options[i].first == names[j]);
+    }
+    if (!known) {
+      throw std::invalid_argument("Unknown option: --" + options[i].first);
+    }
+  }
+}
+
+/**
+ * @brief オプション以外の引数を返します。
+ * @return 引数
+ */
+const std::vector<std::string>& Options::getArguments(void) const
+{
+  return arguments;
+}
+
+/**
+ * @brief 入力ファイルのパスを返します。
+ * @return 最初のオプション以外の引数、ない場合は標準入力を表す"-"
+ */
+std::string Options::getInput(void) const
+{
+  return arguments.empty() ? "-" : arguments[0];
+}
+
+/**
+ * @brief 入力のCSV形式のオプション(--delimiter、--quote、--no-quote、--comment)をConfigオブジェクトに設定します。
+ * @param config Configオブジェクト
+ * @exception std::invalid_argument オプションの値が正しくない場合
+ */
+void Options::getInputConfig(Config& config) const
+{
+  if (has("comment")) {
+    config.setCommentMark(getMark("comment", config.getCommentMark()));
+    config.setCommentEnabled(true);
+  }
+  config.setQuoteMark(getMark("quote", config.getQuoteMark()));
+  config.setQuoteEnabled(!has("no-quote"));
+  config.setDelimitMark(getMark("delimiter", config.getDelimitMark()));
+}
+
+/**
+ * @brief 出力のCSV形式のオプション(--out-delimiter、--out-quote、--out-no-quote)をConfigオブジェクトに設定します。
+ *
+ * 指定されていない項目は、入力のCSV形式と同じにします。
+ * @param config Configオブジェクト
+ * @exception std::invalid_argument オプションの値が正しくない場合
+ */
+void Options::getOutputConfig(Config& config) const
+{
+  getInputConfig(config);
+  config.setQuoteMark(getMark("out-quote", config.getQuoteMark()));
+  config.setQuoteEnabled(has("out-quote") || (config.getQuoteEnabled() && !has("out-no-quote")));
+  config.setDelimitMark(getMark("out-delimiter", config.getDelimitMark()));
+}
+
+} // namespace tool
+} // namespace csv
+} // namespace csl
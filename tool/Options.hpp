@@ -0,0 +1,58 @@
+/**
+ * @file  Options.hpp
+ * @brief Optionsクラスヘッダーファイル
+ */
+#ifndef CSL_CSV_TOOL_OPTIONS_HPP_
+#define CSL_CSV_TOOL_OPTIONS_HPP_
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+#include "csl/csv/Config.hpp"
+
+namespace csl {
+namespace csv {
+namespace tool {
+
+/**
+ * @brief コマンドライン引数を、"--名前=値"または"--名前"の形のオプションと、それ以外の引数に分けて保持します。
+ *
+ * "--"より後の引数は、すべてオプション以外の引数として扱います。
+ */
+class Options
+{
+public:
+  Options(int argc, char* argv[], const int first);
+
+public:
+  ~Options(void);
+
+public:
+  bool has(const std::string& name) const;
+  std::string get(const std::string& name, const std::string& value) const;
+  void getAll(const std::string& name, std::vector<std::string>& values) const;
+  std::size_t getSize(const std::string& name, const std::size_t value) const;
+  char getMark(const std::string& name, const char mark) const;
+  void check(const char* const names[]) const;
+
+  const std::vector<std::string>& getArguments(void) const;
+  std::string getInput(void) const;
+
+  void getInputConfig(Config& config) const;
+  void getOutputConfig(Config& config) const;
+
+private:
+  std::vector<std::pair<std::string, std::string> > options;
+  std::vector<std::string> arguments;
+
+private:
+  Options(const Options& options);
+  Options& operator=(const Options& options);
+};
+
+} // namespace tool
+} // namespace csv
+} // namespace csl
+
+#endif // #ifndef CSL_CSV_TOOL_OPTIONS_HPP_